@@ -9,12 +9,16 @@
 // 这个头文件包含了 mystl 的一系列算法
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
+#include <utility>
 
 #include "algobase.h"
 #include "heap_algo.h"
 #include "memory.h"
 #include "functional.h"
+#include "random.h"
 
 namespace mystl
 {
@@ -69,7 +73,7 @@ bool none_of(InputIter first, InputIter last, UnaryPredicate unary_pred)
 // 对[first, last)区间内的元素与给定值进行比较，缺省使用 operator==，返回元素相等的个数
 /*****************************************************************************************/
 template <class InputIter, class T>
-size_t count(InputIter first, InputIter last, const T& value)
+size_t unchecked_count(InputIter first, InputIter last, const T& value)
 {
   size_t n = 0;
   for (; first != last; ++first)
@@ -80,12 +84,36 @@ size_t count(InputIter first, InputIter last, const T& value)
   return n;
 }
 
+// 为连续内存中的算术类型提供向量化的特化版本
+template <class Tp, class Up>
+typename std::enable_if<
+  mystl::simd::is_comparable<Tp, Up>::value,
+  size_t>::type
+unchecked_count(Tp* first, Tp* last, const Up& value)
+{
+  typedef typename std::remove_cv<Tp>::type T;
+  if (!mystl::simd::value_fits<T>(value))
+  { // 值无法用 T 精确表示，逐个比较
+    size_t n = 0;
+    for (; first != last; ++first)
+      n += *first == value;
+    return n;
+  }
+  return mystl::simd::count<T>(first, last, static_cast<T>(value));
+}
+
+template <class InputIter, class T>
+size_t count(InputIter first, InputIter last, const T& value)
+{
+  return mystl::unchecked_count(first, last, value);
+}
+
 /*****************************************************************************************/
 // count_if
 // 对[first, last)区间内的每个元素都进行一元 unary_pred 操作，返回结果为 true 的个数
 /*****************************************************************************************/
 template <class InputIter, class UnaryPredicate>
-size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
+size_t unchecked_count_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
 {
   size_t n = 0;
   for (; first != last; ++first)
@@ -96,19 +124,62 @@ size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
   return n;
 }
 
+// 为连续内存中的算术类型提供无分支的特化版本，简单的谓词可以被编译器自动向量化
+template <class Tp, class UnaryPredicate>
+typename std::enable_if<
+  std::is_arithmetic<Tp>::value,
+  size_t>::type
+unchecked_count_if(Tp* first, Tp* last, UnaryPredicate unary_pred)
+{
+  size_t n = 0;
+  for (; first != last; ++first)
+    n += unary_pred(*first) ? 1 : 0;
+  return n;
+}
+
+template <class InputIter, class UnaryPredicate>
+size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+  return mystl::unchecked_count_if(first, last, unary_pred);
+}
+
 /*****************************************************************************************/
 // find
 // 在[first, last)区间内找到等于 value 的元素，返回指向该元素的迭代器
 /*****************************************************************************************/
 template <class InputIter, class T>
 InputIter
-find(InputIter first, InputIter last, const T& value)
+unchecked_find(InputIter first, InputIter last, const T& value)
 {
   while (first != last && *first != value)
     ++first;
   return first;
 }
 
+// 为连续内存中的算术类型提供向量化的特化版本，单字节类型使用 memchr
+template <class Tp, class Up>
+typename std::enable_if<
+  mystl::simd::is_comparable<Tp, Up>::value,
+  Tp*>::type
+unchecked_find(Tp* first, Tp* last, const Up& value)
+{
+  typedef typename std::remove_cv<Tp>::type T;
+  if (!mystl::simd::value_fits<T>(value))
+  { // 值无法用 T 精确表示，逐个比较
+    while (first != last && *first != value)
+      ++first;
+    return first;
+  }
+  return first + (mystl::simd::find<T>(first, last, static_cast<T>(value)) - first);
+}
+
+template <class InputIter, class T>
+InputIter
+find(InputIter first, InputIter last, const T& value)
+{
+  return mystl::unchecked_find(first, last, value);
+}
+
 /*****************************************************************************************/
 // find_if
 // 在[first, last)区间内找到第一个令一元操作 unary_pred 为 true 的元素并返回指向该元素的迭代器
@@ -138,11 +209,159 @@ find_if_not(InputIter first, InputIter last, UnaryPredicate unary_pred)
 /*****************************************************************************************/
 // search
 // 在[first1, last1)中查找[first2, last2)的首次出现点
+// 两个区间都是连续的单字节整数时自动选择查找算法：模式串较短时用 SIMD 比较首尾字符筛选候选位置，
+// 较长时用双向查找（two-way），保证最坏情况为线性时间
+// 另有一个版本接受查找器 searcher（见 searcher.h），返回 searcher(first, last).first
 /*****************************************************************************************/
+constexpr static size_t kSimdSearchMaxLen = 64;  // 使用 SIMD 筛选的模式串的最大长度
+
+// 单字节整数的连续区间
+template <class T1, class T2>
+struct is_byte_range :public m_bool_constant<
+  sizeof(T1) == 1 && std::is_integral<T1>::value &&
+  !std::is_same<typename std::remove_cv<T1>::type, bool>::value &&
+  std::is_same<typename std::remove_cv<T1>::type, typename std::remove_cv<T2>::type>::value>
+{
+};
+
+// 双向查找的预处理：maximal_suffix 求模式串在顺序 (reverse 为 false) 或逆序 (reverse 为 true) 下
+// 最大后缀的起点的前一个位置，并求出该后缀的周期
+template <class RandomIter>
+typename iterator_traits<RandomIter>::difference_type
+maximal_suffix(RandomIter pattern, typename iterator_traits<RandomIter>::difference_type m,
+               bool reverse, typename iterator_traits<RandomIter>::difference_type& period)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type diff_t;
+  diff_t ms = -1, j = 0, k = 1;
+  period = 1;
+  while (j + k < m)
+  {
+    const auto& a = pattern[j + k];
+    const auto& b = pattern[ms + k];
+    if (reverse ? b < a : a < b)
+    { // 后缀 j + k 之前的部分不可能是最大后缀的起点
+      j += k;
+      k = 1;
+      period = j - ms;
+    }
+    else if (a == b)
+    {
+      if (k != period)
+      {
+        ++k;
+      }
+      else
+      {
+        j += period;
+        k = 1;
+      }
+    }
+    else
+    { // 找到更大的后缀
+      ms = j;
+      j = ms + 1;
+      k = period = 1;
+    }
+  }
+  return ms;
+}
+
+// 求模式串的临界分解 pattern = u v，ell 为 u 的最后一个位置，period 为模式串的周期（若 u 为 v 的后缀）
+// 或者一个保证正确的跳跃距离，periodic 表示属于前一种情况
+template <class RandomIter>
+void two_way_factorize(RandomIter pattern, typename iterator_traits<RandomIter>::difference_type m,
+                       typename iterator_traits<RandomIter>::difference_type& ell,
+                       typename iterator_traits<RandomIter>::difference_type& period,
+                       bool& periodic)
+{
+  typename iterator_traits<RandomIter>::difference_type p, q;
+  const auto i = mystl::maximal_suffix(pattern, m, false, p);
+  const auto j = mystl::maximal_suffix(pattern, m, true, q);
+  ell = i > j ? i : j;
+  period = i > j ? p : q;
+  periodic = ell + 1 + period <= m;
+  for (decltype(m) k = 0; periodic && k <= ell; ++k)
+    periodic = pattern[k] == pattern[k + period];
+  if (!periodic)
+    period = (ell + 1 > m - ell - 1 ? ell + 1 : m - ell - 1) + 1;
+}
+
+// 双向查找：先从左向右比较 v，再从右向左比较 u，periodic 时记住已经匹配的前缀避免重复比较
+// skip(x) 为窗口最后一个元素是 x 时可以直接跳过的距离（坏字符规则），为 0 时进行双向比较
+template <class RandomIter1, class RandomIter2, class Skip>
+RandomIter1
+two_way_search(RandomIter1 first, RandomIter1 last, RandomIter2 pattern,
+               typename iterator_traits<RandomIter2>::difference_type m,
+               typename iterator_traits<RandomIter2>::difference_type ell,
+               typename iterator_traits<RandomIter2>::difference_type period,
+               bool periodic, Skip skip)
+{
+  typedef typename iterator_traits<RandomIter2>::difference_type diff_t;
+  const diff_t n = static_cast<diff_t>(last - first);
+  diff_t memory = -1;
+  for (diff_t pos = 0; pos <= n - m; )
+  {
+    diff_t shift = static_cast<diff_t>(skip(first[pos + m - 1]));
+    if (shift > 0)
+    { // 跳过的距离小于周期时，只能移动到下一个与已匹配的前缀一致的位置
+      if (memory != -1 && shift < period)
+        shift = m - period;
+      memory = -1;
+      pos += shift;
+      continue;
+    }
+    diff_t i = (ell > memory ? ell : memory) + 1;
+    while (i < m && pattern[i] == first[pos + i])
+      ++i;
+    if (i < m)
+    {
+      pos += i - ell;
+      memory = -1;
+      continue;
+    }
+    i = ell;
+    while (i > memory && pattern[i] == first[pos + i])
+      --i;
+    if (i <= memory)
+      return first + pos;
+    pos += period;
+    memory = periodic ? m - period - 1 : -1;
+  }
+  return last;
+}
+
+// 单字节连续区间的查找
+template <class T>
+const T* byte_search(const T* first1, const T* last1, const T* first2, const T* last2)
+{
+  const size_t n = static_cast<size_t>(last1 - first1);
+  const size_t m = static_cast<size_t>(last2 - first2);
+  if (m == 0)
+    return first1;
+  if (n < m)
+    return last1;
+  if (m == 1)
+    return mystl::simd::find(first1, last1, *first2);
+  if (m <= kSimdSearchMaxLen)
+    return mystl::simd::search(first1, last1, first2, m);
+  // 模式串较长时，用双向查找配合坏字符表
+  ptrdiff_t ell, period;
+  bool periodic;
+  mystl::two_way_factorize(first2, static_cast<ptrdiff_t>(m), ell, period, periodic);
+  size_t table[256];
+  for (size_t i = 0; i < 256; ++i)
+    table[i] = m;
+  for (size_t i = 0; i < m; ++i)
+    table[static_cast<unsigned char>(first2[i])] = m - 1 - i;
+  return mystl::two_way_search(first1, last1, first2, static_cast<ptrdiff_t>(m),
+                               ell, period, periodic,
+                               [&table](T x) { return table[static_cast<unsigned char>(x)]; });
+}
+
 template <class ForwardIter1, class ForwardIter2>
 ForwardIter1
-search(ForwardIter1 first1, ForwardIter1 last1,
-       ForwardIter2 first2, ForwardIter2 last2)
+unchecked_search(ForwardIter1 first1, ForwardIter1 last1,
+                 ForwardIter2 first2, ForwardIter2 last2)
 {
   auto d1 = mystl::distance(first1, last1);
   auto d2 = mystl::distance(first2, last2);
@@ -174,6 +393,23 @@ search(ForwardIter1 first1, ForwardIter1 last1,
   return first1;
 }
 
+template <class T1, class T2>
+typename std::enable_if<mystl::is_byte_range<T1, T2>::value, T1*>::type
+unchecked_search(T1* first1, T1* last1, T2* first2, T2* last2)
+{
+  typedef typename std::remove_cv<T1>::type value_type;
+  const value_type* p = mystl::byte_search<value_type>(first1, last1, first2, last2);
+  return first1 + (p - first1);
+}
+
+template <class ForwardIter1, class ForwardIter2>
+ForwardIter1
+search(ForwardIter1 first1, ForwardIter1 last1,
+       ForwardIter2 first2, ForwardIter2 last2)
+{
+  return mystl::unchecked_search(first1, last1, first2, last2);
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class ForwardIter1, class ForwardIter2, class Compared>
 ForwardIter1
@@ -210,13 +446,25 @@ search(ForwardIter1 first1, ForwardIter1 last1,
   return first1;
 }
 
+// 重载版本使用查找器 searcher
+template <class ForwardIter, class Searcher>
+ForwardIter
+search(ForwardIter first, ForwardIter last, const Searcher& searcher)
+{
+  return searcher(first, last).first;
+}
+
 /*****************************************************************************************/
 // search_n
 // 在[first, last)中查找连续 n 个 value 所形成的子序列，返回一个迭代器指向该子序列的起始处
+// random_access_iterator_tag 版本从窗口的末尾向前比较，遇到不等于 value 的元素时，
+// 包含该元素的窗口都不可能匹配，可以直接跳到它之后，平均每 n 个元素只需比较一次
 /*****************************************************************************************/
+// search_n_dispatch 的 forward_iterator_tag 版本
 template <class ForwardIter, class Size, class T>
 ForwardIter
-search_n(ForwardIter first, ForwardIter last, Size n, const T& value)
+search_n_dispatch(ForwardIter first, ForwardIter last, Size n, const T& value,
+                  forward_iterator_tag)
 {
   if (n <= 0)
   {
@@ -248,11 +496,57 @@ search_n(ForwardIter first, ForwardIter last, Size n, const T& value)
   }
 }
 
+// 随机访问迭代器的跳跃查找，comp(x, value) 为 true 表示 x 匹配
+template <class RandomIter, class Size, class T, class Compared>
+RandomIter
+search_n_skip(RandomIter first, RandomIter last, Size count, const T& value, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type diff_t;
+  if (count <= 0)
+    return first;
+  const diff_t n = static_cast<diff_t>(count);
+  const diff_t len = last - first;
+  diff_t start = 0;  // 当前窗口的起点
+  diff_t known = 0;  // 窗口开头已知等于 value 的元素个数
+  while (len - start >= n)
+  {
+    // 从窗口末尾向前比较到已知匹配的部分为止
+    diff_t i = start + n - 1;
+    while (i >= start + known && comp(first[i], value))
+      --i;
+    if (i < start + known)
+      return first + start;
+    // first[i] 不匹配，(i, start + n) 已经匹配，下一个窗口从 i + 1 开始
+    known = start + n - 1 - i;
+    start = i + 1;
+  }
+  return last;
+}
+
+// search_n_dispatch 的 random_access_iterator_tag 版本
+template <class RandomIter, class Size, class T>
+RandomIter
+search_n_dispatch(RandomIter first, RandomIter last, Size n, const T& value,
+                  random_access_iterator_tag)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  return mystl::search_n_skip(first, last, n, value,
+                              [](const value_type& x, const T& v) { return x == v; });
+}
+
+template <class ForwardIter, class Size, class T>
+ForwardIter
+search_n(ForwardIter first, ForwardIter last, Size n, const T& value)
+{
+  return mystl::search_n_dispatch(first, last, n, value, iterator_category(first));
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
+// search_n_dispatch 的 forward_iterator_tag 版本
 template <class ForwardIter, class Size, class T, class Compared>
 ForwardIter
-search_n(ForwardIter first, ForwardIter last,
-         Size n, const T& value, Compared comp)
+search_n_dispatch(ForwardIter first, ForwardIter last,
+                  Size n, const T& value, forward_iterator_tag, Compared comp)
 {
   if (n <= 0)
   {
@@ -295,6 +589,23 @@ search_n(ForwardIter first, ForwardIter last,
   }
 }
 
+// search_n_dispatch 的 random_access_iterator_tag 版本
+template <class RandomIter, class Size, class T, class Compared>
+RandomIter
+search_n_dispatch(RandomIter first, RandomIter last,
+                  Size n, const T& value, random_access_iterator_tag, Compared comp)
+{
+  return mystl::search_n_skip(first, last, n, value, comp);
+}
+
+template <class ForwardIter, class Size, class T, class Compared>
+ForwardIter
+search_n(ForwardIter first, ForwardIter last,
+         Size n, const T& value, Compared comp)
+{
+  return mystl::search_n_dispatch(first, last, n, value, iterator_category(first), comp);
+}
+
 /*****************************************************************************************/
 // find_end
 // 在[first1, last1)区间中查找[first2, last2)最后一次出现的地方，若不存在返回 last1
@@ -548,29 +859,26 @@ lbound_dispatch(ForwardIter first, ForwardIter last,
 }
 
 // lbound_dispatch 的 random_access_iterator_tag 版本
+// 无分支版本：每次只根据比较结果选择 first 的偏移量，编译器可以生成条件传送指令，
+// 循环次数只与区间长度有关，不会因分支预测失败而清空流水线
+// 比较之前预取下一步两个可能访问的元素，弥补没有分支预测时无法提前访存的损失
 template <class RandomIter, class T>
 RandomIter
 lbound_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag)
 {
   auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0)
+  if (len == 0)
+    return first;
+  while (len > 1)
   {
-    half = len >> 1;
-    middle = first + half;
-    if (*middle < value)
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
-    else
-    {
-      len = half;
-    }
+    const auto half = len >> 1;
+    mystl::simd::prefetch(&*(first + (len - half) / 2));
+    mystl::simd::prefetch(&*(first + half + (len - half) / 2));
+    first += *(first + half) < value ? half : 0;
+    len -= half;
   }
-  return first;
+  return first + (*first < value ? 1 : 0);
 }
 
 template <class ForwardIter, class T>
@@ -616,23 +924,17 @@ lbound_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag, Compared comp)
 {
   auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0)
+  if (len == 0)
+    return first;
+  while (len > 1)
   {
-    half = len >> 1;
-    middle = first + half;
-    if (comp(*middle, value))
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
-    else
-    {
-      len = half;
-    }
+    const auto half = len >> 1;
+    mystl::simd::prefetch(&*(first + (len - half) / 2));
+    mystl::simd::prefetch(&*(first + half + (len - half) / 2));
+    first += comp(*(first + half), value) ? half : 0;
+    len -= half;
   }
-  return first;
+  return first + (comp(*first, value) ? 1 : 0);
 }
 
 template <class ForwardIter, class T, class Compared>
@@ -674,30 +976,24 @@ ubound_dispatch(ForwardIter first, ForwardIter last,
   return first;
 }
 
-// ubound_dispatch 的 random_access_iterator_tag 版本
+// ubound_dispatch 的 random_access_iterator_tag 版本，与 lbound_dispatch 一样没有分支
 template <class RandomIter, class T>
 RandomIter
 ubound_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag)
 {
   auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0)
+  if (len == 0)
+    return first;
+  while (len > 1)
   {
-    half = len >> 1;
-    middle = first + half;
-    if (value < *middle)
-    {
-      len = half;
-    }
-    else
-    {
-      first = middle + 1;
-      len = len - half - 1;
-    }
+    const auto half = len >> 1;
+    mystl::simd::prefetch(&*(first + (len - half) / 2));
+    mystl::simd::prefetch(&*(first + half + (len - half) / 2));
+    first += value < *(first + half) ? 0 : half;
+    len -= half;
   }
-  return first;
+  return first + (value < *first ? 0 : 1);
 }
 
 template <class ForwardIter, class T>
@@ -741,6 +1037,108 @@ template <class RandomIter, class T, class Compared>
 RandomIter
 ubound_dispatch(RandomIter first, RandomIter last,
                 const T& value, random_access_iterator_tag, Compared comp)
+{
+  auto len = last - first;
+  if (len == 0)
+    return first;
+  while (len > 1)
+  {
+    const auto half = len >> 1;
+    mystl::simd::prefetch(&*(first + (len - half) / 2));
+    mystl::simd::prefetch(&*(first + half + (len - half) / 2));
+    first += comp(value, *(first + half)) ? 0 : half;
+    len -= half;
+  }
+  return first + (comp(value, *first) ? 0 : 1);
+}
+
+template <class ForwardIter, class T, class Compared>
+ForwardIter
+upper_bound(ForwardIter first, ForwardIter last, const T& value, Compared comp)
+{
+  return mystl::ubound_dispatch(first, last, value, iterator_category(first), comp);
+}
+
+/*****************************************************************************************/
+// lower_bound_branchy / upper_bound_branchy
+// 随机访问区间上每次比较后分支的经典二分查找，即 lower_bound / upper_bound 改为无分支之前的实现，
+// 结果与 lower_bound / upper_bound 相同，保留下来用于与无分支的版本比较性能
+/*****************************************************************************************/
+template <class RandomIter, class T>
+RandomIter
+lower_bound_branchy(RandomIter first, RandomIter last, const T& value)
+{
+  auto len = last - first;
+  auto half = len;
+  RandomIter middle;
+  while (len > 0)
+  {
+    half = len >> 1;
+    middle = first + half;
+    if (*middle < value)
+    {
+      first = middle + 1;
+      len = len - half - 1;
+    }
+    else
+    {
+      len = half;
+    }
+  }
+  return first;
+}
+
+template <class RandomIter, class T, class Compared>
+RandomIter
+lower_bound_branchy(RandomIter first, RandomIter last, const T& value, Compared comp)
+{
+  auto len = last - first;
+  auto half = len;
+  RandomIter middle;
+  while (len > 0)
+  {
+    half = len >> 1;
+    middle = first + half;
+    if (comp(*middle, value))
+    {
+      first = middle + 1;
+      len = len - half - 1;
+    }
+    else
+    {
+      len = half;
+    }
+  }
+  return first;
+}
+
+template <class RandomIter, class T>
+RandomIter
+upper_bound_branchy(RandomIter first, RandomIter last, const T& value)
+{
+  auto len = last - first;
+  auto half = len;
+  RandomIter middle;
+  while (len > 0)
+  {
+    half = len >> 1;
+    middle = first + half;
+    if (value < *middle)
+    {
+      len = half;
+    }
+    else
+    {
+      first = middle + 1;
+      len = len - half - 1;
+    }
+  }
+  return first;
+}
+
+template <class RandomIter, class T, class Compared>
+RandomIter
+upper_bound_branchy(RandomIter first, RandomIter last, const T& value, Compared comp)
 {
   auto len = last - first;
   auto half = len;
@@ -762,11 +1160,65 @@ ubound_dispatch(RandomIter first, RandomIter last,
   return first;
 }
 
-template <class ForwardIter, class T, class Compared>
-ForwardIter
-upper_bound(ForwardIter first, ForwardIter last, const T& value, Compared comp)
+/*****************************************************************************************/
+// lower_bound_batch
+// 对 [queries_first, queries_last) 中的每个值在有序区间 [first, last) 中做 lower_bound，
+// 依次把结果迭代器写入以 result 为起始的位置，返回写入结束的位置
+// 每次交错执行 kBatchWidth 个查找：它们的步数相同，每一步推进所有查找并预取下一步要访问的元素，
+// 使多个查找的缓存缺失可以重叠
+/*****************************************************************************************/
+constexpr static size_t kBatchWidth = 16;
+
+template <class RandomIter, class ForwardIter, class OutputIter, class Compared>
+OutputIter
+lower_bound_batch(RandomIter first, RandomIter last,
+                  ForwardIter queries_first, ForwardIter queries_last,
+                  OutputIter result, Compared comp)
 {
-  return mystl::ubound_dispatch(first, last, value, iterator_category(first), comp);
+  const auto len = last - first;
+  RandomIter  base[kBatchWidth];
+  ForwardIter query[kBatchWidth];
+  while (queries_first != queries_last)
+  {
+    size_t m = 0;
+    for (; m < kBatchWidth && queries_first != queries_last; ++m, ++queries_first)
+    {
+      base[m] = first;
+      query[m] = queries_first;
+    }
+    if (len > 0)
+    {
+      auto n = len;
+      while (n > 1)
+      {
+        const auto half = n >> 1;
+        const auto next = (n - half) >> 1;  // 下一步的偏移量
+        for (size_t i = 0; i < m; ++i)
+        {
+          base[i] += comp(*(base[i] + half), *query[i]) ? half : 0;
+          mystl::simd::prefetch(&*(base[i] + next));
+        }
+        n -= half;
+      }
+      for (size_t i = 0; i < m; ++i)
+        base[i] += comp(*base[i], *query[i]) ? 1 : 0;
+    }
+    for (size_t i = 0; i < m; ++i, ++result)
+      *result = base[i];
+  }
+  return result;
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter>
+OutputIter
+lower_bound_batch(RandomIter first, RandomIter last,
+                  ForwardIter queries_first, ForwardIter queries_last,
+                  OutputIter result)
+{
+  typedef typename iterator_traits<RandomIter>::value_type  value_type;
+  typedef typename iterator_traits<ForwardIter>::value_type query_type;
+  return mystl::lower_bound_batch(first, last, queries_first, queries_last, result,
+                                  [](const value_type& x, const query_type& q) { return x < q; });
 }
 
 /*****************************************************************************************/
@@ -1416,34 +1868,92 @@ reverse_copy(BidirectionalIter first, BidirectionalIter last,
   return result;
 }
 
+/*****************************************************************************************/
+// shuffle
+// 使用随机数引擎 g 将[first, last)内的元素次序随机重排（Fisher-Yates），每种排列的概率相同
+/*****************************************************************************************/
+template <class RandomIter, class URBG>
+void shuffle(RandomIter first, RandomIter last, URBG&& g)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type diff_t;
+  const diff_t len = last - first;
+  for (diff_t i = len - 1; i > 0; --i)
+  {
+    mystl::iter_swap(first + i, first + static_cast<diff_t>(
+      mystl::uniform_int(g, static_cast<uint64_t>(i) + 1)));
+  }
+}
+
+/*****************************************************************************************/
+// sample
+// 从[first, last)中随机选取 n 个元素复制到 result，元素不足 n 个时全部复制，返回输出的尾部
+/*****************************************************************************************/
+// sample_dispatch 的 input_iterator_tag 版本，蓄水池抽样，result 必须是随机访问迭代器
+template <class InputIter, class RandomIter, class Distance, class URBG>
+RandomIter sample_dispatch(InputIter first, InputIter last, RandomIter result,
+                           Distance n, URBG& g, input_iterator_tag)
+{
+  if (n <= 0)
+    return result;
+  Distance k = 0;
+  for (; first != last && k < n; ++first, ++k)
+    result[k] = *first;
+  for (uint64_t seen = static_cast<uint64_t>(k); first != last; ++first)
+  { // 第 seen + 1 个元素以 n / (seen + 1) 的概率替换蓄水池中的一个元素
+    const uint64_t j = mystl::uniform_int(g, ++seen);
+    if (j < static_cast<uint64_t>(n))
+      result[static_cast<Distance>(j)] = *first;
+  }
+  return result + k;
+}
+
+// sample_dispatch 的 forward_iterator_tag 版本，依次以 (还需选取的个数 / 剩余元素个数) 的概率选取，
+// 输出保持元素原来的相对顺序
+template <class ForwardIter, class OutputIter, class Distance, class URBG>
+OutputIter sample_dispatch(ForwardIter first, ForwardIter last, OutputIter result,
+                           Distance n, URBG& g, forward_iterator_tag)
+{
+  uint64_t remain = static_cast<uint64_t>(mystl::distance(first, last));
+  uint64_t need = n < 0 ? 0 : static_cast<uint64_t>(n);
+  for (; need > 0 && remain > 0; ++first, --remain)
+  {
+    if (mystl::uniform_int(g, remain) < need)
+    {
+      *result = *first;
+      ++result;
+      --need;
+    }
+  }
+  return result;
+}
+
+template <class InputIter, class OutputIter, class Distance, class URBG>
+OutputIter sample(InputIter first, InputIter last, OutputIter result, Distance n, URBG&& g)
+{
+  return mystl::sample_dispatch(first, last, result, n, g, iterator_category(first));
+}
+
 /*****************************************************************************************/
 // random_shuffle
 // 将[first, last)内的元素次序随机重排
-// 重载版本使用一个产生随机数的函数对象 rand
+// 使用当前线程的 mystl::thread_engine()，结果不可重现，需要固定种子时使用 shuffle
 /*****************************************************************************************/
 template <class RandomIter>
 void random_shuffle(RandomIter first, RandomIter last)
 {
-  if (first == last)
-    return;
-  srand((unsigned)time(0));
-  for (auto i = first + 1; i != last; ++i)
-  {
-    mystl::iter_swap(i, first + (rand() % (i - first + 1)));
-  }
+  mystl::shuffle(first, last, mystl::thread_engine());
 }
 
-// 重载版本使用一个产生随机数的函数对象 rand
+// 重载版本使用一个产生随机数的函数对象 rand，rand(n) 返回 [0, n) 中的随机数
 template <class RandomIter, class RandomNumberGenerator>
 void random_shuffle(RandomIter first, RandomIter last,
                     RandomNumberGenerator& rand)
 {
   if (first == last)
     return;
-  auto len = mystl::distance(first, last);
   for (auto i = first + 1; i != last; ++i)
   {
-    mystl::iter_swap(i, first + (rand(i - first + 1) % len));
+    mystl::iter_swap(i, first + rand(i - first + 1));
   }
 }
 
@@ -1597,44 +2107,59 @@ rotate_copy(ForwardIter first, ForwardIter middle,
 /*****************************************************************************************/
 // is_permutation
 // 判断[first1,last1)是否为[first2, last2)的排列组合
+// 去掉相同的前缀后，剩余部分较短时逐个计数，复杂度为 O(n^2)；较长且以 mystl::equal_to 比较时，
+// 元素可以用 mystl::hash 求哈希值则用哈希表计数，否则元素支持 operator< 时排序后比较
 /*****************************************************************************************/
-template <class ForwardIter1, class ForwardIter2, class BinaryPred>
-bool is_permutation_aux(ForwardIter1 first1, ForwardIter1 last1,
-                        ForwardIter2 first2, ForwardIter2 last2,
-                        BinaryPred pred)
+constexpr static ptrdiff_t kPermutationCountThreshold = 32;  // 超过该长度时不再逐个计数
+
+// 元素类型是否有 mystl::hash 的特化版本
+template <class T, class = void>
+struct is_mystl_hashable :public m_false_type
 {
-  constexpr bool is_ra_it = mystl::is_random_access_iterator<ForwardIter1>::value
-    && mystl::is_random_access_iterator<ForwardIter2>::value;
-  if (is_ra_it)
-  {
-    auto len1 = last1 - first1;
-    auto len2 = last2 - first2;
-    if (len1 != len2)
-      return false;
-  }
+};
 
-  // 先找出相同的前缀段
-  for (; first1 != last1 && first2 != last2; ++first1, (void) ++first2)
-  {
-    if (!pred(*first1, *first2))
-      break;
-  }
-  if (is_ra_it)
-  {
-    if (first1 == last1)
-      return true;
-  }
-  else
-  {
-    auto len1 = mystl::distance(first1, last1);
-    auto len2 = mystl::distance(first2, last2);
-    if (len1 == 0 && len2 == 0)
-      return true;
-    if (len1 != len2)
-      return false;
-  }
+template <class T>
+struct is_mystl_hashable<T, decltype(void(std::declval<const mystl::hash<T>&>()(
+  std::declval<const T&>())))> :public m_true_type
+{
+};
 
-  // 判断剩余部分
+// 元素类型是否支持 operator<
+template <class T, class = void>
+struct has_less_operator :public m_false_type
+{
+};
+
+template <class T>
+struct has_less_operator<T, decltype(void(std::declval<const T&>() < std::declval<const T&>()))>
+  :public m_true_type
+{
+};
+
+template <class T>
+struct is_less_comparable :public has_less_operator<T>
+{
+};
+
+// pair 的 operator< 没有约束，总能通过上面的检查，需要检查它的两个成员
+template <class T1, class T2>
+struct is_less_comparable<mystl::pair<T1, T2>>
+  :public m_bool_constant<is_less_comparable<typename std::remove_cv<T1>::type>::value &&
+                          is_less_comparable<typename std::remove_cv<T2>::type>::value>
+{
+};
+
+template <class RandomIter>
+void sort(RandomIter first, RandomIter last);
+template <class RandomIter, class Compared>
+void sort(RandomIter first, RandomIter last, Compared comp);
+
+// 逐个计数：对 [first1, last1) 中第一次出现的每个元素，比较它在两个区间中出现的次数
+template <class ForwardIter1, class ForwardIter2, class BinaryPred>
+bool is_permutation_count(ForwardIter1 first1, ForwardIter1 last1,
+                          ForwardIter2 first2, ForwardIter2 last2,
+                          BinaryPred pred)
+{
   for (auto i = first1; i != last1; ++i)
   {
     bool is_repeated = false;
@@ -1659,19 +2184,200 @@ bool is_permutation_aux(ForwardIter1 first1, ForwardIter1 last1,
       if (c2 == 0)
         return false;
 
-      // 计算 *i 在 [first1, last1) 的数目
-      auto c1 = 1;
-      auto j = i;
-      for (++j; j != last1; ++j)
-      {
-        if (pred(*i, *j))
-          ++c1;
-      }
-      if (c1 != c2)
-        return false;
-    }
+      // 计算 *i 在 [first1, last1) 的数目
+      auto c1 = 1;
+      auto j = i;
+      for (++j; j != last1; ++j)
+      {
+        if (pred(*i, *j))
+          ++c1;
+      }
+      if (c1 != c2)
+        return false;
+    }
+  }
+  return true;
+}
+
+// 排序后比较：分别对指向两个区间元素的指针排序，不复制、不修改元素
+template <class ForwardIter1, class ForwardIter2, class BinaryPred>
+bool is_permutation_sort(ForwardIter1 first1, ForwardIter1 last1,
+                         ForwardIter2 first2, ForwardIter2 last2,
+                         ptrdiff_t len, BinaryPred pred, m_true_type)
+{
+  typedef const typename iterator_traits<ForwardIter1>::value_type* pointer;
+  auto buf1 = mystl::get_temporary_buffer<pointer>(len);
+  auto buf2 = mystl::get_temporary_buffer<pointer>(len);
+  if (buf1.second != len || buf2.second != len)
+  { // 申请失败时改为逐个计数
+    mystl::release_temporary_buffer(buf1.first);
+    mystl::release_temporary_buffer(buf2.first);
+    return mystl::is_permutation_count(first1, last1, first2, last2, pred);
+  }
+  pointer* p1 = buf1.first;
+  pointer* p2 = buf2.first;
+  for (ptrdiff_t i = 0; i < len; ++i, ++first1, ++first2)
+  {
+    p1[i] = &*first1;
+    p2[i] = &*first2;
+  }
+  bool result = true;
+  try
+  {
+    auto comp = [](pointer a, pointer b) { return *a < *b; };
+    mystl::sort(p1, p1 + len, comp);
+    mystl::sort(p2, p2 + len, comp);
+    for (ptrdiff_t i = 0; i < len && result; ++i)
+      result = pred(*p1[i], *p2[i]);
+  }
+  catch (...)
+  {
+    mystl::release_temporary_buffer(p1);
+    mystl::release_temporary_buffer(p2);
+    throw;
+  }
+  mystl::release_temporary_buffer(p1);
+  mystl::release_temporary_buffer(p2);
+  return result;
+}
+
+template <class ForwardIter1, class ForwardIter2, class BinaryPred>
+bool is_permutation_sort(ForwardIter1 first1, ForwardIter1 last1,
+                         ForwardIter2 first2, ForwardIter2 last2,
+                         ptrdiff_t, BinaryPred pred, m_false_type)
+{
+  return mystl::is_permutation_count(first1, last1, first2, last2, pred);
+}
+
+// 哈希表的一个槽，rep 指向 [first1, last1) 中第一次出现的元素，count 为两个区间中出现次数之差
+template <class T>
+struct permutation_slot
+{
+  const T*    rep;
+  size_t      hash;
+  ptrdiff_t   count;
+  bool        used;
+};
+
+// 哈希计数：开放定址的哈希表，[first1, last1) 的元素计数加一，[first2, last2) 的元素计数减一，
+// 区间长度相等，所以只要减一时元素存在且计数不为负，两个区间就互为排列
+template <class ForwardIter1, class ForwardIter2, class BinaryPred>
+bool is_permutation_hash(ForwardIter1 first1, ForwardIter1 last1,
+                         ForwardIter2 first2, ForwardIter2 last2,
+                         ptrdiff_t len, BinaryPred pred, m_true_type)
+{
+  typedef typename iterator_traits<ForwardIter1>::value_type value_type;
+  typedef permutation_slot<value_type>                       slot_type;
+  size_t bits = 1;
+  while ((static_cast<size_t>(1) << bits) < static_cast<size_t>(len) * 2)
+    ++bits;
+  const size_t cap = static_cast<size_t>(1) << bits;
+  const size_t mask = cap - 1;
+  auto buf = mystl::get_temporary_buffer<slot_type>(static_cast<ptrdiff_t>(cap));
+  if (buf.second != static_cast<ptrdiff_t>(cap))
+  { // 申请失败时改为排序后比较
+    mystl::release_temporary_buffer(buf.first);
+    return mystl::is_permutation_sort(first1, last1, first2, last2, len, pred,
+                                      m_bool_constant<is_less_comparable<value_type>::value>());
+  }
+  slot_type* table = buf.first;
+  mystl::uninitialized_fill_n(table, cap, slot_type{ nullptr, 0, 0, false });
+  const mystl::hash<value_type> hf;
+  // mystl::hash 对整数直接返回原值，乘以黄金分割常数后取高位作为槽的位置
+  auto home = [bits](size_t h)
+  {
+    return static_cast<size_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+  };
+  bool result = true;
+  try
+  {
+    for (; first1 != last1; ++first1)
+    {
+      const size_t h = hf(*first1);
+      size_t k = home(h);
+      while (table[k].used && !(table[k].hash == h && pred(*table[k].rep, *first1)))
+        k = (k + 1) & mask;
+      if (!table[k].used)
+      {
+        table[k].rep = &*first1;
+        table[k].hash = h;
+        table[k].used = true;
+      }
+      ++table[k].count;
+    }
+    for (; first2 != last2 && result; ++first2)
+    {
+      const size_t h = hf(*first2);
+      size_t k = home(h);
+      while (table[k].used && !(table[k].hash == h && pred(*table[k].rep, *first2)))
+        k = (k + 1) & mask;
+      result = table[k].used && --table[k].count >= 0;
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(table, table + cap);
+    mystl::release_temporary_buffer(table);
+    throw;
+  }
+  mystl::destroy(table, table + cap);
+  mystl::release_temporary_buffer(table);
+  return result;
+}
+
+template <class ForwardIter1, class ForwardIter2, class BinaryPred>
+bool is_permutation_hash(ForwardIter1 first1, ForwardIter1 last1,
+                         ForwardIter2 first2, ForwardIter2 last2,
+                         ptrdiff_t len, BinaryPred pred, m_false_type)
+{
+  typedef typename iterator_traits<ForwardIter1>::value_type value_type;
+  typedef typename iterator_traits<ForwardIter2>::value_type value_type2;
+  constexpr bool use_sort = std::is_same<value_type, value_type2>::value &&
+    std::is_same<BinaryPred, mystl::equal_to<value_type>>::value &&
+    is_less_comparable<value_type>::value;
+  return mystl::is_permutation_sort(first1, last1, first2, last2, len, pred,
+                                    m_bool_constant<use_sort>());
+}
+
+template <class ForwardIter1, class ForwardIter2, class BinaryPred>
+bool is_permutation_aux(ForwardIter1 first1, ForwardIter1 last1,
+                        ForwardIter2 first2, ForwardIter2 last2,
+                        BinaryPred pred)
+{
+  constexpr bool is_ra_it = mystl::is_random_access_iterator<ForwardIter1>::value
+    && mystl::is_random_access_iterator<ForwardIter2>::value;
+  if (is_ra_it)
+  {
+    if (mystl::distance(first1, last1) != mystl::distance(first2, last2))
+      return false;
+  }
+
+  // 先找出相同的前缀段
+  for (; first1 != last1 && first2 != last2; ++first1, (void) ++first2)
+  {
+    if (!pred(*first1, *first2))
+      break;
   }
-  return true;
+  if (first1 == last1 && first2 == last2)
+    return true;
+  const auto len = mystl::distance(first1, last1);
+  if (!is_ra_it)
+  {
+    if (len != mystl::distance(first2, last2))
+      return false;
+  }
+
+  // 判断剩余部分
+  if (len <= kPermutationCountThreshold)
+    return mystl::is_permutation_count(first1, last1, first2, last2, pred);
+  typedef typename iterator_traits<ForwardIter1>::value_type value_type;
+  typedef typename iterator_traits<ForwardIter2>::value_type value_type2;
+  constexpr bool use_hash = std::is_same<value_type, value_type2>::value &&
+    std::is_same<BinaryPred, mystl::equal_to<value_type>>::value &&
+    is_mystl_hashable<value_type>::value;
+  return mystl::is_permutation_hash(first1, last1, first2, last2,
+                                    static_cast<ptrdiff_t>(len), pred,
+                                    m_bool_constant<use_hash>());
 }
 
 template <class ForwardIter1, class ForwardIter2, class BinaryPred>
@@ -2170,11 +2876,30 @@ inplace_merge(BidirectionalIter first, BidirectionalIter middle,
 /*****************************************************************************************/
 // partial_sort
 // 对整个序列做部分排序，保证较小的 N 个元素以递增顺序置于[first, first + N)中
+// N 较小时用大小为 N 的堆筛选，N 较大时先用 nth_element 选出较小的 N 个元素再排序，
+// 复杂度由 O(n log N) 降为 O(n + N log N)
 /*****************************************************************************************/
+constexpr static size_t kPartialSortHeapRatio = 64;  // N 不超过 n / kPartialSortHeapRatio 时使用堆
+
+template <class RandomIter>
+void nth_element(RandomIter first, RandomIter nth, RandomIter last);
+template <class RandomIter, class Compared>
+void nth_element(RandomIter first, RandomIter nth, RandomIter last, Compared comp);
+template <class RandomIter>
+void sort(RandomIter first, RandomIter last);
+template <class RandomIter, class Compared>
+void sort(RandomIter first, RandomIter last, Compared comp);
+
 template <class RandomIter>
 void partial_sort(RandomIter first, RandomIter middle,
                   RandomIter last)
 {
+  if (static_cast<size_t>(middle - first) > static_cast<size_t>(last - first) / kPartialSortHeapRatio)
+  {
+    mystl::nth_element(first, middle, last);
+    mystl::sort(first, middle);
+    return;
+  }
   mystl::make_heap(first, middle);
   for (auto i = middle; i < last; ++i)
   {
@@ -2191,6 +2916,12 @@ template <class RandomIter, class Compared>
 void partial_sort(RandomIter first, RandomIter middle,
                   RandomIter last, Compared comp)
 {
+  if (static_cast<size_t>(middle - first) > static_cast<size_t>(last - first) / kPartialSortHeapRatio)
+  {
+    mystl::nth_element(first, middle, last, comp);
+    mystl::sort(first, middle, comp);
+    return;
+  }
   mystl::make_heap(first, middle, comp);
   for (auto i = middle; i < last; ++i)
   {
@@ -2382,7 +3113,8 @@ void intro_sort(RandomIter first, RandomIter last, Size depth_limit)
   {
     if (depth_limit == 0)
     {                      // 到达最大分割深度限制
-      mystl::partial_sort(first, last, last);  // 改用 heap_sort
+      mystl::make_heap(first, last);  // 改用 heap_sort
+      mystl::sort_heap(first, last);
       return;
     }
     --depth_limit;
@@ -2395,17 +3127,17 @@ void intro_sort(RandomIter first, RandomIter last, Size depth_limit)
 
 // 插入排序辅助函数 unchecked_linear_insert
 template <class RandomIter, class T>
-void unchecked_linear_insert(RandomIter last, const T& value)
+void unchecked_linear_insert(RandomIter last, T& value)
 {
   auto next = last;
   --next;
   while (value < *next)
   {
-    *last = *next;
+    *last = mystl::move(*next);
     last = next;
     --next;
   }
-  *last = value;
+  *last = mystl::move(value);
 }
 
 // 插入排序函数 unchecked_insertion_sort
@@ -2414,7 +3146,8 @@ void unchecked_insertion_sort(RandomIter first, RandomIter last)
 {
   for (auto i = first; i != last; ++i)
   {
-    mystl::unchecked_linear_insert(i, *i);
+    auto value = mystl::move(*i);  // 必须先取出，插入过程中 *i 会被覆盖
+    mystl::unchecked_linear_insert(i, value);
   }
 }
 
@@ -2426,11 +3159,11 @@ void insertion_sort(RandomIter first, RandomIter last)
     return;
   for (auto i = first + 1; i != last; ++i)
   {
-    auto value = *i;
+    auto value = mystl::move(*i);
     if (value < *first)
     {
-      mystl::copy_backward(first, i, i + 1);
-      *first = value;
+      mystl::move_backward(first, i, i + 1);
+      *first = mystl::move(value);
     }
     else
     {
@@ -2495,11 +3228,12 @@ void intro_sort(RandomIter first, RandomIter last,
   {
     if (depth_limit == 0)
     {                            // 到达最大分割深度限制
-      mystl::partial_sort(first, last, last, comp);  // 改用 heap_sort
+      mystl::make_heap(first, last, comp);  // 改用 heap_sort
+      mystl::sort_heap(first, last, comp);
       return;
     }
     --depth_limit;
-    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
+    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1), comp);
     auto cut = mystl::unchecked_partition(first, last, mid, comp);
     mystl::intro_sort(cut, last, depth_limit, comp);
     last = cut;
@@ -2508,17 +3242,17 @@ void intro_sort(RandomIter first, RandomIter last,
 
 // 插入排序辅助函数 unchecked_linear_insert
 template <class RandomIter, class T, class Compared>
-void unchecked_linear_insert(RandomIter last, const T& value, Compared comp)
+void unchecked_linear_insert(RandomIter last, T& value, Compared comp)
 {
   auto next = last;
   --next;
   while (comp(value, *next))
   {  // 从尾部开始寻找第一个可插入位置
-    *last = *next;
+    *last = mystl::move(*next);
     last = next;
     --next;
   }
-  *last = value;
+  *last = mystl::move(value);
 }
 
 // 插入排序函数 unchecked_insertion_sort
@@ -2528,7 +3262,8 @@ void unchecked_insertion_sort(RandomIter first, RandomIter last,
 {
   for (auto i = first; i != last; ++i)
   {
-    mystl::unchecked_linear_insert(i, *i, comp);
+    auto value = mystl::move(*i);  // 必须先取出，插入过程中 *i 会被覆盖
+    mystl::unchecked_linear_insert(i, value, comp);
   }
 }
 
@@ -2540,11 +3275,11 @@ void insertion_sort(RandomIter first, RandomIter last, Compared comp)
     return;
   for (auto i = first + 1; i != last; ++i)
   {
-    auto value = *i;
+    auto value = mystl::move(*i);
     if (comp(value, *first))
     {
-      mystl::copy_backward(first, i, i + 1);
-      *first = value;
+      mystl::move_backward(first, i, i + 1);
+      *first = mystl::move(value);
     }
     else
     {
@@ -2580,48 +3315,499 @@ void sort(RandomIter first, RandomIter last, Compared comp)
 }
 
 /*****************************************************************************************/
-// nth_element
-// 对序列重排，使得所有小于第 n 个元素的元素出现在它的前面，大于它的出现在它的后面
+// stable_sort
+// 将[first, last)内的元素以递增的方式排序，相等元素保持原有的相对次序
+// 随机访问迭代器：先对长度为 kStableChunkSize 的块做插入排序，再借助临时缓冲区逐轮归并，
+//                 缓冲区不足时分割递归并使用 merge_adaptive 合并，申请不到缓冲区时原地归并
+// 双向迭代器（如 list）：把元素移动到缓冲区中排序后移回，申请不到缓冲区时递归地原地归并
+/*****************************************************************************************/
+constexpr static size_t kStableChunkSize = 7;  // 归并之前插入排序的块长度
+
+// 把两个有序区间移动归并到 result 中，相等时先取第一个区间的元素
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter move_merge(InputIter1 first1, InputIter1 last1,
+                      InputIter2 first2, InputIter2 last2,
+                      OutputIter result, Compared comp)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first2, *first1))
+    {
+      *result = mystl::move(*first2);
+      ++first2;
+    }
+    else
+    {
+      *result = mystl::move(*first1);
+      ++first1;
+    }
+    ++result;
+  }
+  result = mystl::move(first1, last1, result);
+  return mystl::move(first2, last2, result);
+}
+
+// 对每个长度为 chunk_size 的块做插入排序
+template <class RandomIter, class Distance, class Compared>
+void chunk_insertion_sort(RandomIter first, RandomIter last,
+                          Distance chunk_size, Compared comp)
+{
+  while (last - first >= chunk_size)
+  {
+    mystl::insertion_sort(first, first + chunk_size, comp);
+    first += chunk_size;
+  }
+  mystl::insertion_sort(first, last, comp);
+}
+
+// 把 [first, last) 中长度为 step_size 的有序段两两归并到 result 中
+template <class RandomIter1, class RandomIter2, class Distance, class Compared>
+void merge_sort_loop(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+                     Distance step_size, Compared comp)
+{
+  const Distance two_step = step_size * 2;
+  while (last - first >= two_step)
+  {
+    result = mystl::move_merge(first, first + step_size, first + step_size,
+                               first + two_step, result, comp);
+    first += two_step;
+  }
+  step_size = mystl::min(static_cast<Distance>(last - first), step_size);
+  mystl::move_merge(first, first + step_size, first + step_size, last, result, comp);
+}
+
+// 缓冲区至少与区间等长时的归并排序，数据在区间与缓冲区之间来回归并
+template <class RandomIter, class Pointer, class Compared>
+void merge_sort_with_buffer(RandomIter first, RandomIter last,
+                            Pointer buffer, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const Distance len = last - first;
+  const Pointer buffer_last = buffer + len;
+  Distance step_size = kStableChunkSize;
+  mystl::chunk_insertion_sort(first, last, step_size, comp);
+  while (step_size < len)
+  {
+    mystl::merge_sort_loop(first, last, buffer, step_size, comp);
+    step_size *= 2;
+    mystl::merge_sort_loop(buffer, buffer_last, first, step_size, comp);
+    step_size *= 2;
+  }
+}
+
+// 缓冲区可能不足以容纳半个区间时，分割递归后用 merge_adaptive 合并
+template <class RandomIter, class Pointer, class Distance, class Compared>
+void stable_sort_adaptive(RandomIter first, RandomIter last, Pointer buffer,
+                          Distance buffer_size, Compared comp)
+{
+  const Distance len = (last - first + 1) / 2;
+  const RandomIter middle = first + len;
+  if (len > buffer_size)
+  {
+    mystl::stable_sort_adaptive(first, middle, buffer, buffer_size, comp);
+    mystl::stable_sort_adaptive(middle, last, buffer, buffer_size, comp);
+  }
+  else
+  {
+    mystl::merge_sort_with_buffer(first, middle, buffer, comp);
+    mystl::merge_sort_with_buffer(middle, last, buffer, comp);
+  }
+  mystl::merge_adaptive(first, middle, last, static_cast<Distance>(middle - first),
+                        static_cast<Distance>(last - middle), buffer, buffer_size, comp);
+}
+
+// 没有缓冲区时的原地归并排序
+template <class RandomIter, class Compared>
+void inplace_stable_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  if (last - first < 15)
+  {
+    mystl::insertion_sort(first, last, comp);
+    return;
+  }
+  const RandomIter middle = first + (last - first) / 2;
+  mystl::inplace_stable_sort(first, middle, comp);
+  mystl::inplace_stable_sort(middle, last, comp);
+  mystl::merge_without_buffer(first, middle, last, middle - first, last - middle, comp);
+}
+
+template <class RandomIter, class T, class Compared>
+void stable_sort_dispatch(RandomIter first, RandomIter last, T*, Compared comp,
+                          random_access_iterator_tag)
+{
+  // 只需要半个区间长度的缓冲区
+  temporary_buffer<RandomIter, T> buf(first, first + (last - first + 1) / 2);
+  if (!buf.begin())
+    mystl::inplace_stable_sort(first, last, comp);
+  else
+    mystl::stable_sort_adaptive(first, last, buf.begin(), buf.size(), comp);
+}
+
+template <class BidirectionalIter, class Compared>
+void stable_sort(BidirectionalIter first, BidirectionalIter last, Compared comp);
+
+// 双向迭代器没有缓冲区时，递归地原地归并
+template <class BidirectionalIter, class Distance, class Compared>
+void inplace_stable_sort(BidirectionalIter first, BidirectionalIter last,
+                         Distance len, Compared comp)
+{
+  if (len < 2)
+    return;
+  auto middle = first;
+  mystl::advance(middle, len / 2);
+  mystl::inplace_stable_sort(first, middle, len / 2, comp);
+  mystl::inplace_stable_sort(middle, last, len - len / 2, comp);
+  mystl::inplace_merge(first, middle, last, comp);
+}
+
+template <class BidirectionalIter, class T, class Compared>
+void stable_sort_dispatch(BidirectionalIter first, BidirectionalIter last, T*, Compared comp,
+                          bidirectional_iterator_tag)
+{
+  temporary_buffer<BidirectionalIter, T> buf(first, last);
+  if (buf.size() != buf.requested_size())
+  {
+    mystl::inplace_stable_sort(first, last, buf.requested_size(), comp);
+    return;
+  }
+  mystl::move(first, last, buf.begin());
+  mystl::stable_sort(buf.begin(), buf.end(), comp);
+  mystl::move(buf.begin(), buf.end(), first);
+}
+
+template <class BidirectionalIter>
+void stable_sort(BidirectionalIter first, BidirectionalIter last)
+{
+  typedef typename iterator_traits<BidirectionalIter>::value_type value_type;
+  mystl::stable_sort(first, last, mystl::less<value_type>());
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class BidirectionalIter, class Compared>
+void stable_sort(BidirectionalIter first, BidirectionalIter last, Compared comp)
+{
+  if (first == last)
+    return;
+  mystl::stable_sort_dispatch(first, last, value_type(first), comp, iterator_category(first));
+}
+
 /*****************************************************************************************/
+// radix_sort
+// 对[first, last)内的元素按键值以递增的方式进行基数排序，键值须为整数或浮点数类型
+// 每趟处理 8 位，先一次性统计出所有趟的计数，若某一趟所有元素的该位都相同则跳过该趟
+// 辅助空间由 temporary_buffer 提供，申请失败时改用原地的 MSD 基数排序
+/*****************************************************************************************/
+constexpr static size_t kRadixBits      = 8;                 // 每趟处理的位数
+constexpr static size_t kRadixSize      = 1 << kRadixBits;   // 每趟的桶数
+constexpr static size_t kRadixSmallSize = 64;                // 小型区间的大小，在这个大小内采用插入排序
+
+// radix_key_traits : 把整数、浮点数键值映射为保持大小顺序的无符号整数
+template <class Key, bool = std::is_floating_point<Key>::value>
+struct radix_key_traits
+{
+  static_assert(std::is_integral<Key>::value && !std::is_same<Key, bool>::value,
+                "radix_sort requires an integral or floating point key");
+
+  typedef typename std::make_unsigned<Key>::type unsigned_type;
+
+  static unsigned_type encode(Key k)
+  { // 有符号整数翻转符号位，使负数排在正数之前
+    return static_cast<unsigned_type>(k) ^
+      (std::is_signed<Key>::value
+       ? static_cast<unsigned_type>(static_cast<unsigned_type>(1) << (sizeof(Key) * 8 - 1))
+       : static_cast<unsigned_type>(0));
+  }
+};
+
+template <class Key>
+struct radix_key_traits<Key, true>
+{
+  static_assert(sizeof(Key) == 4 || sizeof(Key) == 8,
+                "radix_sort supports only float and double keys");
+
+  typedef typename std::conditional<sizeof(Key) == 4,
+    uint32_t, uint64_t>::type unsigned_type;
+
+  static unsigned_type encode(Key k)
+  { // 负数翻转所有位，非负数只翻转符号位
+    unsigned_type bits;
+    std::memcpy(&bits, &k, sizeof(bits));
+    const unsigned_type sign = static_cast<unsigned_type>(1) << (sizeof(Key) * 8 - 1);
+    return (bits & sign) ? ~bits : (bits | sign);
+  }
+};
+
+template <class Key>
+typename radix_key_traits<Key>::unsigned_type radix_encode(Key k)
+{
+  return radix_key_traits<Key>::encode(k);
+}
+
+// 取出键值第 shift 位开始的一个数位
+template <class UKey>
+size_t radix_digit(UKey ukey, size_t shift)
+{
+  return static_cast<size_t>((ukey >> shift) & (kRadixSize - 1));
+}
+
+// 小型区间按键值做插入排序
+template <class RandomIter, class KeyFunction>
+void radix_insertion_sort(RandomIter first, RandomIter last, KeyFunction key_fn)
+{
+  if (first == last)
+    return;
+  for (auto i = first + 1; i != last; ++i)
+  {
+    auto value = mystl::move(*i);
+    const auto ukey = mystl::radix_encode(key_fn(value));
+    auto hole = i;
+    for (; hole != first && ukey < mystl::radix_encode(key_fn(*(hole - 1))); --hole)
+      *hole = mystl::move(*(hole - 1));
+    *hole = mystl::move(value);
+  }
+}
+
+// 没有辅助空间时使用的原地 MSD 基数排序（American flag sort）
+template <class RandomIter, class KeyFunction>
+void radix_msd_sort(RandomIter first, RandomIter last, KeyFunction key_fn, size_t shift)
+{
+  const size_t len = static_cast<size_t>(last - first);
+  if (len <= kRadixSmallSize)
+  {
+    mystl::radix_insertion_sort(first, last, key_fn);
+    return;
+  }
+  size_t count[kRadixSize];
+  while (true)
+  {
+    mystl::fill_n(count, kRadixSize, static_cast<size_t>(0));
+    for (auto i = first; i != last; ++i)
+      ++count[mystl::radix_digit(mystl::radix_encode(key_fn(*i)), shift)];
+    if (count[mystl::radix_digit(mystl::radix_encode(key_fn(*first)), shift)] != len)
+      break;
+    // 所有元素的该位都相同，直接处理下一位
+    if (shift == 0)
+      return;
+    shift -= kRadixBits;
+  }
+
+  size_t head[kRadixSize], tail[kRadixSize];
+  size_t sum = 0;
+  for (size_t b = 0; b < kRadixSize; ++b)
+  {
+    head[b] = sum;
+    sum += count[b];
+    tail[b] = sum;
+  }
+  // 每次交换都把一个元素放入它最终所在的桶
+  for (size_t b = 0; b < kRadixSize; ++b)
+  {
+    while (head[b] < tail[b])
+    {
+      const size_t d = mystl::radix_digit(mystl::radix_encode(key_fn(*(first + head[b]))), shift);
+      if (d == b)
+        ++head[b];
+      else
+        mystl::iter_swap(first + head[b], first + head[d]++);
+    }
+  }
+  if (shift == 0)
+    return;
+  size_t start = 0;
+  for (size_t b = 0; b < kRadixSize; ++b)
+  {
+    if (tail[b] - start > 1)
+      mystl::radix_msd_sort(first + start, first + tail[b], key_fn, shift - kRadixBits);
+    start = tail[b];
+  }
+}
+
+// 按第 shift 位开始的数位把 [first, last) 分配到 result 中
+template <class InputIter, class OutputIter, class KeyFunction>
+void radix_scatter(InputIter first, InputIter last, OutputIter result,
+                   KeyFunction key_fn, size_t shift, size_t* offset)
+{
+  for (; first != last; ++first)
+  {
+    const size_t d = mystl::radix_digit(mystl::radix_encode(key_fn(*first)), shift);
+    *(result + offset[d]++) = mystl::move(*first);
+  }
+}
+
+template <class RandomIter, class KeyFunction>
+void radix_sort(RandomIter first, RandomIter last, KeyFunction key_fn);
+
 template <class RandomIter>
-void nth_element(RandomIter first, RandomIter nth,
-                 RandomIter last)
+void radix_sort(RandomIter first, RandomIter last)
 {
-  if (nth == last)
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::radix_sort(first, last, mystl::identity<value_type>());
+}
+
+// 重载版本使用函数对象 key_fn 从元素中取出排序所依据的键值
+template <class RandomIter, class KeyFunction>
+void radix_sort(RandomIter first, RandomIter last, KeyFunction key_fn)
+{
+  typedef typename iterator_traits<RandomIter>::value_type        value_type;
+  typedef typename std::decay<decltype(key_fn(*first))>::type     key_type;
+  typedef typename radix_key_traits<key_type>::unsigned_type      ukey_type;
+  constexpr size_t kPasses = sizeof(ukey_type) * 8 / kRadixBits;
+
+  const size_t len = static_cast<size_t>(last - first);
+  if (len <= kRadixSmallSize)
+  {
+    mystl::radix_insertion_sort(first, last, key_fn);
+    return;
+  }
+  temporary_buffer<RandomIter, value_type> buf(first, last);
+  if (buf.begin() == nullptr || static_cast<size_t>(buf.size()) != len)
+  {
+    mystl::radix_msd_sort(first, last, key_fn, (kPasses - 1) * kRadixBits);
     return;
-  while (last - first > 3)
+  }
+
+  // 一次遍历统计出所有趟的计数
+  size_t count[kPasses][kRadixSize] = {};
+  for (auto i = first; i != last; ++i)
+  {
+    const auto ukey = mystl::radix_encode(key_fn(*i));
+    for (size_t pass = 0; pass < kPasses; ++pass)
+      ++count[pass][mystl::radix_digit(ukey, pass * kRadixBits)];
+  }
+
+  const auto ukey0 = mystl::radix_encode(key_fn(*first));
+  bool in_buffer = false;  // 当前数据是否位于缓冲区中
+  for (size_t pass = 0; pass < kPasses; ++pass)
+  {
+    const size_t shift = pass * kRadixBits;
+    if (count[pass][mystl::radix_digit(ukey0, shift)] == len)
+      continue;  // 所有元素的该位都相同，跳过该趟
+    size_t offset[kRadixSize];
+    size_t sum = 0;
+    for (size_t b = 0; b < kRadixSize; ++b)
+    {
+      offset[b] = sum;
+      sum += count[pass][b];
+    }
+    if (in_buffer)
+      mystl::radix_scatter(buf.begin(), buf.end(), first, key_fn, shift, offset);
+    else
+      mystl::radix_scatter(first, last, buf.begin(), key_fn, shift, offset);
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer)
+    mystl::move(buf.begin(), buf.end(), first);
+}
+
+/*****************************************************************************************/
+// nth_element
+// 对序列重排，使得所有小于第 n 个元素的元素出现在它的前面，大于它的出现在它的后面
+// 内省式选择：先以三点中值为枢轴做快速选择，当分割次数超过限制时改用中位数的中位数为枢轴，
+// 保证最坏情况下为线性时间
+/*****************************************************************************************/
+constexpr static size_t kSmallSelectSize = 16;  // 小型区间的大小，在这个大小内采用插入排序
+
+template <class RandomIter, class Compared>
+void mom_select(RandomIter first, RandomIter nth, RandomIter last, Compared comp);
+
+// 若 *b 小于 *a 则交换两者
+template <class RandomIter, class Compared>
+void compare_swap(RandomIter a, RandomIter b, Compared comp)
+{
+  if (comp(*b, *a))
+    mystl::iter_swap(a, b);
+}
+
+// 用 7 次比较交换把 [i, i + 5) 的中位数放到 i + 2
+template <class RandomIter, class Compared>
+void median_of_five(RandomIter i, Compared comp)
+{
+  mystl::compare_swap(i, i + 1, comp);
+  mystl::compare_swap(i + 3, i + 4, comp);
+  mystl::compare_swap(i, i + 3, comp);
+  mystl::compare_swap(i + 1, i + 4, comp);
+  mystl::compare_swap(i + 1, i + 2, comp);
+  mystl::compare_swap(i + 2, i + 3, comp);
+  mystl::compare_swap(i + 1, i + 2, comp);
+}
+
+// 把每 5 个元素的中位数依次移到区间的前部，返回这些中位数的中位数的位置
+template <class RandomIter, class Compared>
+RandomIter median_of_medians(RandomIter first, RandomIter last, Compared comp)
+{
+  auto store = first;
+  for (auto i = first; last - i >= 5; i += 5)
   {
-    auto cut = mystl::unchecked_partition(first, last, mystl::median(*first,
-										  *(first + (last - first) / 2),
-										  *(last - 1)));
+    mystl::median_of_five(i, comp);
+    mystl::iter_swap(store, i + 2);
+    ++store;
+  }
+  auto mid = first + (store - first) / 2;
+  mystl::mom_select(first, mid, store, comp);
+  return mid;
+}
+
+// 以中位数的中位数为枢轴的快速选择，每次分割至少排除约 30% 的元素
+template <class RandomIter, class Compared>
+void mom_select(RandomIter first, RandomIter nth, RandomIter last, Compared comp)
+{
+  while (static_cast<size_t>(last - first) > kSmallSelectSize)
+  {
+    auto pivot = *mystl::median_of_medians(first, last, comp);
+    auto cut = mystl::unchecked_partition(first, last, pivot, comp);
     if (cut <= nth)  // 如果 nth 位于右段
       first = cut;   // 对右段进行分割
     else
       last = cut;    // 对左段进行分割
   }
-  mystl::insertion_sort(first, last);
+  mystl::insertion_sort(first, last, comp);
 }
 
-// 重载版本使用函数对象 comp 代替比较操作
-template <class RandomIter, class Compared>
-void nth_element(RandomIter first, RandomIter nth,
-                 RandomIter last, Compared comp)
+// 内省式选择，bad_limit 为允许的失败分割次数：分割后保留的区间超过原区间的 3/4 即视为失败
+template <class RandomIter, class Size, class Compared>
+void intro_select(RandomIter first, RandomIter nth, RandomIter last,
+                  Size bad_limit, Compared comp)
 {
-  if (nth == last)
-    return;
-  while (last - first > 3)
+  while (static_cast<size_t>(last - first) > kSmallSelectSize)
   {
-    auto cut = mystl::unchecked_partition(first, last, mystl::median(*first, 
-										  *(first + (last - first) / 2),
-										  *(last - 1)), comp);
+    const auto len = last - first;
+    auto pivot = mystl::median(*first, *(first + len / 2), *(last - 1), comp);
+    auto cut = mystl::unchecked_partition(first, last, pivot, comp);
     if (cut <= nth)  // 如果 nth 位于右段
       first = cut;   // 对右段进行分割
     else
       last = cut;    // 对左段进行分割
+    if ((last - first) > len / 4 * 3)
+    {
+      if (bad_limit == 0)
+      {                      // 分割行为恶化，改用中位数的中位数
+        mystl::mom_select(first, nth, last, comp);
+        return;
+      }
+      --bad_limit;
+    }
   }
   mystl::insertion_sort(first, last, comp);
 }
 
+template <class RandomIter>
+void nth_element(RandomIter first, RandomIter nth,
+                 RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::nth_element(first, nth, last, mystl::less<value_type>());
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class RandomIter, class Compared>
+void nth_element(RandomIter first, RandomIter nth,
+                 RandomIter last, Compared comp)
+{
+  if (nth == last)
+    return;
+  mystl::intro_select(first, nth, last, slg2(last - first) / 2, comp);
+}
+
 /*****************************************************************************************/
 // unique_copy
 // 从[first, last)中将元素复制到 result 上，序列必须有序，如果有重复的元素，只会复制一次
@@ -6,6 +6,7 @@
 #include <cstring>
 
 #include "iterator.h"
+#include "simd.h"
 #include "util.h"
 
 namespace mystl
@@ -350,7 +351,7 @@ move_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIt
 // 比较第一序列在 [first, last)区间上的元素值是否和第二序列相等
 /*****************************************************************************************/
 template <class InputIter1, class InputIter2>
-bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+bool unchecked_equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
 {
   for (; first1 != last1; ++first1, ++first2)
   {
@@ -360,6 +361,35 @@ bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
   return true;
 }
 
+// 为整数与指针类型提供特化版本，直接比较内存
+template <class Tp, class Up>
+typename std::enable_if<
+  mystl::simd::is_bitwise_comparable<Tp, Up>::value,
+  bool>::type
+unchecked_equal(Tp* first1, Tp* last1, Up* first2)
+{
+  const auto n = static_cast<size_t>(last1 - first1);
+  return n == 0 || std::memcmp(first1, first2, n * sizeof(Tp)) == 0;
+}
+
+// 为浮点类型提供向量化的特化版本
+template <class Tp, class Up>
+typename std::enable_if<
+  std::is_floating_point<Tp>::value &&
+  mystl::simd::is_comparable<Tp, Up>::value,
+  bool>::type
+unchecked_equal(Tp* first1, Tp* last1, Up* first2)
+{
+  typedef typename std::remove_cv<Tp>::type T;
+  return mystl::simd::mismatch<T>(first1, last1, first2) == last1;
+}
+
+template <class InputIter1, class InputIter2>
+bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+{
+  return mystl::unchecked_equal(first1, last1, first2);
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class InputIter1, class InputIter2, class Compared>
 bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2, Compared comp)
@@ -426,7 +456,7 @@ template <class RandomIter, class T>
 void fill_cat(RandomIter first, RandomIter last, const T& value,
               mystl::random_access_iterator_tag)
 {
-  fill_n(first, last - first, value);
+  mystl::fill_n(first, last - first, value);
 }
 
 template <class ForwardIter, class T>
@@ -492,7 +522,7 @@ bool lexicographical_compare(const unsigned char* first1,
 /*****************************************************************************************/
 template <class InputIter1, class InputIter2>
 mystl::pair<InputIter1, InputIter2> 
-mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+unchecked_mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
 {
   while (first1 != last1 && *first1 == *first2)
   {
@@ -502,6 +532,26 @@ mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
   return mystl::pair<InputIter1, InputIter2>(first1, first2);
 }
 
+// 为相同的算术类型提供向量化的特化版本
+template <class Tp, class Up>
+typename std::enable_if<
+  std::is_same<typename std::remove_cv<Tp>::type, typename std::remove_cv<Up>::type>::value &&
+  mystl::simd::is_comparable<Tp, Up>::value,
+  mystl::pair<Tp*, Up*>>::type
+unchecked_mismatch(Tp* first1, Tp* last1, Up* first2)
+{
+  typedef typename std::remove_cv<Tp>::type T;
+  const auto n = mystl::simd::mismatch<T>(first1, last1, first2) - first1;
+  return mystl::pair<Tp*, Up*>(first1 + n, first2 + n);
+}
+
+template <class InputIter1, class InputIter2>
+mystl::pair<InputIter1, InputIter2> 
+mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+{
+  return mystl::unchecked_mismatch(first1, last1, first2);
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class InputIter1, class InputIter2, class Compred>
 mystl::pair<InputIter1, InputIter2> 
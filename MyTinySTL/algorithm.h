@@ -2,10 +2,13 @@
 #define MYTINYSTL_ALGORITHM_H_
 
 // 这个头文件包含了 mystl 的所有算法，包括基本算法，数值算法，heap 算法，set 算法和其他算法
+// 以及接受执行策略的并行算法
 
 #include "algobase.h"
 #include "algo.h"
+#include "set_algo.h"
 #include "numeric.h"
+#include "execution.h"
 
 namespace mystl
 {
@@ -0,0 +1,21 @@
+﻿#ifndef MYTINYSTL_ASTRING_H_
+#define MYTINYSTL_ASTRING_H_
+
+// 定义了 string, wstring, u16string, u32string 类型，以及 string 的透明哈希函数与相等比较
+
+#include "basic_string.h"
+
+namespace mystl
+{
+
+using string    = mystl::basic_string<char>;
+using wstring   = mystl::basic_string<wchar_t>;
+using u16string = mystl::basic_string<char16_t>;
+using u32string = mystl::basic_string<char32_t>;
+
+using string_hash  = mystl::basic_string_hash<char>;
+using string_equal = mystl::basic_string_equal<char>;
+
+}
+#endif // !MYTINYSTL_ASTRING_H_
+
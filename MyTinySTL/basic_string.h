@@ -0,0 +1,1111 @@
+﻿#ifndef MYTINYSTL_BASIC_STRING_H_
+#define MYTINYSTL_BASIC_STRING_H_
+
+// 这个头文件包含一个模板类 basic_string
+// 用于表示字符串类型
+
+// notes:
+//
+// 1. 短字符串优化（SSO）：对象本身占三个指针大小（64 位平台上为 24 字节），
+//    长字符串时储存 { 指针, 长度, 容量 }，短字符串时直接把字符放在这 24 字节中，
+//    char 类型最多可以放 23 个字符，不需要分配内存
+// 2. 最后一个字节是标记字节：短字符串时保存 small_cap - size，字符串恰好有 23 个字符时它为 0，
+//    同时充当结尾的空字符；长字符串时它是容量字段的一部分，最高位为 1
+// 3. 移动构造与移动赋值只复制这 24 字节，增长策略与 vector 相同：至少增长到原来的 1.5 倍
+// 4. 查找与比较委托给 basic_string_view，char 版本以 memchr、memcmp 实现
+// 5. hash<basic_string> 与 hash<basic_string_view> 对相同的字符序列给出相同的结果
+//
+// 异常保证：
+// mystl::basic_string<CharType> 满足基本异常保证，分配内存失败时字符串保持不变
+
+#include <initializer_list>
+#include <ostream>
+#include <type_traits>
+
+#include "algobase.h"
+#include "exceptdef.h"
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "string_view.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// 模板类 basic_string
+// 参数一代表字符类型，参数二代表萃取字符类型的方式，缺省使用 mystl::char_traits
+template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+class basic_string
+{
+public:
+  typedef CharTraits                               traits_type;
+  typedef CharTraits                               char_traits;
+
+  typedef mystl::allocator<CharType>               allocator_type;
+  typedef mystl::allocator<CharType>               data_allocator;
+
+  typedef typename allocator_type::value_type      value_type;
+  typedef typename allocator_type::pointer         pointer;
+  typedef typename allocator_type::const_pointer   const_pointer;
+  typedef typename allocator_type::reference       reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::size_type       size_type;
+  typedef typename allocator_type::difference_type difference_type;
+
+  typedef value_type*                              iterator;
+  typedef const value_type*                        const_iterator;
+  typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+  typedef mystl::basic_string_view<CharType, CharTraits> view_type;
+
+  allocator_type get_allocator() { return allocator_type(); }
+
+  static_assert(std::is_pod<CharType>::value, "Character type of basic_string must be a POD");
+  static_assert(std::is_same<CharType, typename traits_type::char_type>::value,
+                "CharType must be same as traits_type::char_type");
+
+public:
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+  // 长字符串的表示
+  struct long_rep
+  {
+    pointer   data;
+    size_type size;
+    size_type cap;   // 容量与长字符串标记，见 encode_cap
+  };
+
+  static constexpr size_type rep_bytes = sizeof(long_rep);
+  // 短字符串最多容纳的字符个数，最后一个字符位置留给结尾的空字符与标记字节
+  static constexpr size_type small_cap = rep_bytes / sizeof(CharType) - 1;
+
+  static_assert(small_cap > 0 && small_cap < 0x80, "CharType is too large for basic_string SSO");
+
+  union rep
+  {
+    long_rep  l;
+    CharType  s[small_cap + 1];
+  };
+
+  rep rep_;
+
+public:
+  // 构造、复制、移动、析构函数
+
+  basic_string() noexcept
+  { set_small_size(0); }
+
+  basic_string(size_type n, value_type ch)
+  {
+    traits_type::fill(init(n), ch, n);
+  }
+
+  basic_string(const basic_string& other, size_type pos)
+  {
+    THROW_OUT_OF_RANGE_IF(pos > other.size(), "basic_string<Char>'s pos out of range");
+    init_from(other.data() + pos, other.size() - pos);
+  }
+  basic_string(const basic_string& other, size_type pos, size_type count)
+  {
+    THROW_OUT_OF_RANGE_IF(pos > other.size(), "basic_string<Char>'s pos out of range");
+    init_from(other.data() + pos, mystl::min(count, other.size() - pos));
+  }
+
+  basic_string(const_pointer str)
+  { init_from(str, traits_type::length(str)); }
+  basic_string(const_pointer str, size_type count)
+  { init_from(str, count); }
+
+  explicit basic_string(view_type sv)
+  { init_from(sv.data(), sv.size()); }
+
+  basic_string(std::initializer_list<value_type> ilist)
+  { init_from(ilist.begin(), ilist.size()); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  basic_string(Iter first, Iter last)
+  {
+    set_small_size(0);
+    append_range(first, last, iterator_category(first));
+  }
+
+  basic_string(const basic_string& rhs)
+  {
+    if (rhs.is_small())
+      rep_ = rhs.rep_;
+    else
+      init_from(rhs.rep_.l.data, rhs.rep_.l.size);
+  }
+  basic_string(basic_string&& rhs) noexcept
+    :rep_(rhs.rep_)
+  {
+    rhs.set_small_size(0);
+  }
+
+  basic_string& operator=(const basic_string& rhs)
+  {
+    if (this != &rhs)
+    {
+      if (rhs.is_small() && is_small())
+        rep_ = rhs.rep_;
+      else
+        assign(rhs.data(), rhs.size());
+    }
+    return *this;
+  }
+  basic_string& operator=(basic_string&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      destroy_buffer();
+      rep_ = rhs.rep_;
+      rhs.set_small_size(0);
+    }
+    return *this;
+  }
+
+  basic_string& operator=(const_pointer str)
+  { return assign(str, traits_type::length(str)); }
+  basic_string& operator=(value_type ch)
+  { return assign(&ch, 1); }
+  basic_string& operator=(view_type sv)
+  { return assign(sv.data(), sv.size()); }
+  basic_string& operator=(std::initializer_list<value_type> ilist)
+  { return assign(ilist.begin(), ilist.size()); }
+
+  ~basic_string() { destroy_buffer(); }
+
+public:
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return data_ptr(); }
+  const_iterator         begin()   const noexcept
+  { return data_ptr(); }
+  iterator               end()           noexcept
+  { return data_ptr() + size(); }
+  const_iterator         end()     const noexcept
+  { return data_ptr() + size(); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return size() == 0; }
+  size_type size()     const noexcept
+  { return is_small() ? small_cap - tag() : rep_.l.size; }
+  size_type length()   const noexcept { return size(); }
+  size_type capacity() const noexcept
+  { return is_small() ? small_cap : decode_cap(rep_.l.cap); }
+  size_type max_size() const noexcept
+  { return (static_cast<size_type>(-1) >> 9) / sizeof(CharType); }
+
+  void      reserve(size_type n);
+  void      shrink_to_fit();
+
+  // 访问元素相关操作
+  reference       operator[](size_type n)
+  {
+    MYSTL_DEBUG(n <= size());
+    return data_ptr()[n];
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n <= size());
+    return data_ptr()[n];
+  }
+
+  reference       at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(n >= size(), "basic_string<Char>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(n >= size(), "basic_string<Char>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference       front()
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  reference       back()
+  {
+    MYSTL_DEBUG(!empty());
+    return *(end() - 1);
+  }
+  const_reference back()  const
+  {
+    MYSTL_DEBUG(!empty());
+    return *(end() - 1);
+  }
+
+  pointer         data()        noexcept { return data_ptr(); }
+  const_pointer   data()  const noexcept { return data_ptr(); }
+  const_pointer   c_str() const noexcept { return data_ptr(); }
+
+  operator view_type() const noexcept { return view_type(data(), size()); }
+
+  // 添加删除相关操作
+
+  // insert
+  iterator insert(const_iterator pos, value_type ch)
+  {
+    const size_type n = static_cast<size_type>(pos - begin());
+    replace_aux(n, 0, &ch, 1);
+    return begin() + n;
+  }
+  iterator insert(const_iterator pos, size_type count, value_type ch)
+  {
+    const size_type n = static_cast<size_type>(pos - begin());
+    replace_fill(n, 0, count, ch);
+    return begin() + n;
+  }
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last)
+  {
+    const size_type n = static_cast<size_type>(pos - begin());
+    const basic_string tmp(first, last);
+    replace_aux(n, 0, tmp.data(), tmp.size());
+    return begin() + n;
+  }
+
+  basic_string& insert(size_type pos, const basic_string& str)
+  { return insert(pos, str.data(), str.size()); }
+  basic_string& insert(size_type pos, view_type sv)
+  { return insert(pos, sv.data(), sv.size()); }
+  basic_string& insert(size_type pos, const_pointer str)
+  { return insert(pos, str, traits_type::length(str)); }
+  basic_string& insert(size_type pos, const_pointer str, size_type count)
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size(), "basic_string<Char>::insert() pos out of range");
+    return replace_aux(pos, 0, str, count);
+  }
+  basic_string& insert(size_type pos, size_type count, value_type ch)
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size(), "basic_string<Char>::insert() pos out of range");
+    return replace_fill(pos, 0, count, ch);
+  }
+
+  // push_back / pop_back
+  void push_back(value_type ch)
+  {
+    const size_type n = size();
+    if (n < capacity())
+    {
+      data_ptr()[n] = ch;
+      set_size(n + 1);
+    }
+    else
+    {
+      append(&ch, 1);
+    }
+  }
+  void pop_back() noexcept
+  {
+    MYSTL_DEBUG(!empty());
+    set_size(size() - 1);
+  }
+
+  // append
+  basic_string& append(size_type count, value_type ch)
+  { return replace_fill(size(), 0, count, ch); }
+
+  basic_string& append(const basic_string& str)
+  { return append(str.data(), str.size()); }
+  basic_string& append(const basic_string& str, size_type pos, size_type count = npos)
+  {
+    THROW_OUT_OF_RANGE_IF(pos > str.size(), "basic_string<Char>::append() pos out of range");
+    return append(str.data() + pos, mystl::min(count, str.size() - pos));
+  }
+  basic_string& append(view_type sv)
+  { return append(sv.data(), sv.size()); }
+
+  basic_string& append(const_pointer s)
+  { return append(s, traits_type::length(s)); }
+  basic_string& append(const_pointer s, size_type count);
+
+  basic_string& append(std::initializer_list<value_type> ilist)
+  { return append(ilist.begin(), ilist.size()); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  basic_string& append(Iter first, Iter last)
+  { return append_range(first, last, iterator_category(first)); }
+
+  // operator+=
+  basic_string& operator+=(const basic_string& str)
+  { return append(str.data(), str.size()); }
+  basic_string& operator+=(value_type ch)
+  {
+    push_back(ch);
+    return *this;
+  }
+  basic_string& operator+=(const_pointer str)
+  { return append(str, traits_type::length(str)); }
+  basic_string& operator+=(view_type sv)
+  { return append(sv.data(), sv.size()); }
+  basic_string& operator+=(std::initializer_list<value_type> ilist)
+  { return append(ilist.begin(), ilist.size()); }
+
+  // assign
+  basic_string& assign(size_type count, value_type ch)
+  {
+    clear();
+    return replace_fill(0, 0, count, ch);
+  }
+  basic_string& assign(const basic_string& str)
+  { return *this = str; }
+  basic_string& assign(basic_string&& str) noexcept
+  { return *this = mystl::move(str); }
+  basic_string& assign(view_type sv)
+  { return assign(sv.data(), sv.size()); }
+  basic_string& assign(const_pointer str)
+  { return assign(str, traits_type::length(str)); }
+  basic_string& assign(const_pointer str, size_type count);
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  basic_string& assign(Iter first, Iter last)
+  {
+    basic_string tmp(first, last);
+    return *this = mystl::move(tmp);
+  }
+
+  // erase / clear
+  iterator erase(const_iterator pos)
+  {
+    MYSTL_DEBUG(pos != end());
+    const size_type n = static_cast<size_type>(pos - begin());
+    erase(n, 1);
+    return begin() + n;
+  }
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    const size_type n = static_cast<size_type>(first - begin());
+    erase(n, static_cast<size_type>(last - first));
+    return begin() + n;
+  }
+  basic_string& erase(size_type pos = 0, size_type count = npos)
+  {
+    const size_type n = size();
+    THROW_OUT_OF_RANGE_IF(pos > n, "basic_string<Char>::erase() pos out of range");
+    count = mystl::min(count, n - pos);
+    pointer p = data_ptr();
+    traits_type::move(p + pos, p + pos + count, n - pos - count);
+    set_size(n - count);
+    return *this;
+  }
+
+  void clear() noexcept
+  { set_size(0); }
+
+  // resize
+  void resize(size_type count)
+  { resize(count, value_type()); }
+  void resize(size_type count, value_type ch)
+  {
+    const size_type n = size();
+    if (count <= n)
+      set_size(count);
+    else
+      append(count - n, ch);
+  }
+
+  // replace
+  basic_string& replace(size_type pos, size_type count, const basic_string& str)
+  { return replace(pos, count, str.data(), str.size()); }
+  basic_string& replace(size_type pos, size_type count, view_type sv)
+  { return replace(pos, count, sv.data(), sv.size()); }
+  basic_string& replace(size_type pos, size_type count, const_pointer str)
+  { return replace(pos, count, str, traits_type::length(str)); }
+  basic_string& replace(size_type pos, size_type count, const_pointer str, size_type count2)
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size(), "basic_string<Char>::replace() pos out of range");
+    return replace_aux(pos, mystl::min(count, size() - pos), str, count2);
+  }
+  basic_string& replace(size_type pos, size_type count, size_type count2, value_type ch)
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size(), "basic_string<Char>::replace() pos out of range");
+    return replace_fill(pos, mystl::min(count, size() - pos), count2, ch);
+  }
+  basic_string& replace(const_iterator first, const_iterator last, const basic_string& str)
+  {
+    return replace_aux(static_cast<size_type>(first - begin()),
+                       static_cast<size_type>(last - first), str.data(), str.size());
+  }
+  basic_string& replace(const_iterator first, const_iterator last, const_pointer str)
+  {
+    return replace_aux(static_cast<size_type>(first - begin()),
+                       static_cast<size_type>(last - first), str, traits_type::length(str));
+  }
+
+  // substr / copy
+  basic_string substr(size_type pos = 0, size_type count = npos) const
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size(), "basic_string<Char>::substr() pos out of range");
+    return basic_string(data() + pos, mystl::min(count, size() - pos));
+  }
+  size_type copy(pointer dst, size_type count, size_type pos = 0) const
+  { return view().copy(dst, count, pos); }
+
+  // compare
+  int compare(const basic_string& other) const noexcept
+  { return view().compare(other.view()); }
+  int compare(view_type sv) const noexcept
+  { return view().compare(sv); }
+  int compare(const_pointer str) const
+  { return view().compare(view_type(str)); }
+  int compare(size_type pos, size_type count, const basic_string& other) const
+  { return view().substr(pos, count).compare(other.view()); }
+  int compare(size_type pos, size_type count, const_pointer str) const
+  { return view().substr(pos, count).compare(view_type(str)); }
+
+  bool starts_with(view_type sv) const noexcept { return view().starts_with(sv); }
+  bool starts_with(value_type ch) const noexcept { return view().starts_with(ch); }
+  bool ends_with(view_type sv) const noexcept { return view().ends_with(sv); }
+  bool ends_with(value_type ch) const noexcept { return view().ends_with(ch); }
+
+  // 查找相关操作，委托给 basic_string_view
+
+  size_type find(const basic_string& str, size_type pos = 0) const noexcept
+  { return view().find(str.view(), pos); }
+  size_type find(view_type sv, size_type pos = 0) const noexcept
+  { return view().find(sv, pos); }
+  size_type find(const_pointer str, size_type pos, size_type count) const noexcept
+  { return view().find(view_type(str, count), pos); }
+  size_type find(const_pointer str, size_type pos = 0) const
+  { return view().find(view_type(str), pos); }
+  size_type find(value_type ch, size_type pos = 0) const noexcept
+  { return view().find(ch, pos); }
+
+  size_type rfind(const basic_string& str, size_type pos = npos) const noexcept
+  { return view().rfind(str.view(), pos); }
+  size_type rfind(view_type sv, size_type pos = npos) const noexcept
+  { return view().rfind(sv, pos); }
+  size_type rfind(const_pointer str, size_type pos, size_type count) const noexcept
+  { return view().rfind(view_type(str, count), pos); }
+  size_type rfind(const_pointer str, size_type pos = npos) const
+  { return view().rfind(view_type(str), pos); }
+  size_type rfind(value_type ch, size_type pos = npos) const noexcept
+  { return view().rfind(ch, pos); }
+
+  size_type find_first_of(const basic_string& str, size_type pos = 0) const noexcept
+  { return view().find_first_of(str.view(), pos); }
+  size_type find_first_of(const_pointer str, size_type pos = 0) const
+  { return view().find_first_of(view_type(str), pos); }
+  size_type find_first_of(value_type ch, size_type pos = 0) const noexcept
+  { return view().find_first_of(ch, pos); }
+
+  size_type find_last_of(const basic_string& str, size_type pos = npos) const noexcept
+  { return view().find_last_of(str.view(), pos); }
+  size_type find_last_of(const_pointer str, size_type pos = npos) const
+  { return view().find_last_of(view_type(str), pos); }
+  size_type find_last_of(value_type ch, size_type pos = npos) const noexcept
+  { return view().find_last_of(ch, pos); }
+
+  size_type find_first_not_of(const basic_string& str, size_type pos = 0) const noexcept
+  { return view().find_first_not_of(str.view(), pos); }
+  size_type find_first_not_of(const_pointer str, size_type pos = 0) const
+  { return view().find_first_not_of(view_type(str), pos); }
+  size_type find_first_not_of(value_type ch, size_type pos = 0) const noexcept
+  { return view().find_first_not_of(ch, pos); }
+
+  size_type find_last_not_of(const basic_string& str, size_type pos = npos) const noexcept
+  { return view().find_last_not_of(str.view(), pos); }
+  size_type find_last_not_of(const_pointer str, size_type pos = npos) const
+  { return view().find_last_not_of(view_type(str), pos); }
+  size_type find_last_not_of(value_type ch, size_type pos = npos) const noexcept
+  { return view().find_last_not_of(ch, pos); }
+
+  size_type count(value_type ch, size_type pos = 0) const noexcept
+  { return pos >= size() ? 0 : view().substr(pos).count(ch); }
+
+  // swap
+  void swap(basic_string& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      rep tmp = rep_;
+      rep_ = rhs.rep_;
+      rhs.rep_ = tmp;
+    }
+  }
+
+private:
+  // helper functions
+
+  view_type view() const noexcept
+  { return view_type(data(), size()); }
+
+  // 标记字节，即表示的最后一个字节
+  unsigned char tag() const noexcept
+  { return reinterpret_cast<const unsigned char*>(&rep_)[rep_bytes - 1]; }
+  void set_tag(unsigned char t) noexcept
+  { reinterpret_cast<unsigned char*>(&rep_)[rep_bytes - 1] = t; }
+
+  bool is_small() const noexcept
+  { return (tag() & 0x80) == 0; }
+
+  // 长字符串的容量字段同时带有标记：标记字节的最高位为 1
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  static size_type encode_cap(size_type cap) noexcept
+  { return (cap << 8) | static_cast<size_type>(0x80); }
+  static size_type decode_cap(size_type word) noexcept
+  { return word >> 8; }
+#else
+  static constexpr size_type long_flag = static_cast<size_type>(0x80) << (8 * (sizeof(size_type) - 1));
+  static size_type encode_cap(size_type cap) noexcept
+  { return cap | long_flag; }
+  static size_type decode_cap(size_type word) noexcept
+  { return word & ~long_flag; }
+#endif
+
+  pointer data_ptr() noexcept
+  { return is_small() ? rep_.s : rep_.l.data; }
+  const_pointer data_ptr() const noexcept
+  { return is_small() ? rep_.s : rep_.l.data; }
+
+  // 短字符串时先写入结尾的空字符，再写入标记；长度为 small_cap 时二者重叠，标记恰好为 0
+  void set_small_size(size_type n) noexcept
+  {
+    rep_.s[n] = value_type();
+    set_tag(static_cast<unsigned char>(small_cap - n));
+  }
+
+  void set_size(size_type n) noexcept
+  {
+    if (is_small())
+    {
+      set_small_size(n);
+    }
+    else
+    {
+      rep_.l.size = n;
+      rep_.l.data[n] = value_type();
+    }
+  }
+
+  // 切换为长字符串，接管 buf
+  void set_long(pointer buf, size_type n, size_type cap) noexcept
+  {
+    rep_.l.data = buf;
+    rep_.l.size = n;
+    rep_.l.cap = encode_cap(cap);
+    buf[n] = value_type();
+  }
+
+  pointer allocate_buffer(size_type cap)
+  {
+    THROW_LENGTH_ERROR_IF(cap > max_size(), "basic_string<Char>'s size too big");
+    return data_allocator::allocate(cap + 1);
+  }
+
+  void destroy_buffer() noexcept
+  {
+    if (!is_small())
+      data_allocator::deallocate(rep_.l.data, decode_cap(rep_.l.cap) + 1);
+  }
+
+  // 为构造准备 n 个字符的空间并设置长度，返回可以写入的位置
+  pointer init(size_type n)
+  {
+    if (n <= small_cap)
+    {
+      set_small_size(n);
+      return rep_.s;
+    }
+    pointer buf = allocate_buffer(n);
+    set_long(buf, n, n);
+    return buf;
+  }
+
+  void init_from(const_pointer src, size_type n)
+  {
+    traits_type::copy(init(n), src, n);
+  }
+
+  size_type get_new_cap(size_type add_size) const;
+
+  basic_string& replace_aux(size_type pos, size_type count, const_pointer str, size_type count2);
+  basic_string& replace_fill(size_type pos, size_type count, size_type count2, value_type ch);
+
+  template <class Iter>
+  basic_string& append_range(Iter first, Iter last, input_iterator_tag);
+  template <class Iter>
+  basic_string& append_range(Iter first, Iter last, forward_iterator_tag);
+};
+
+template <class CharType, class CharTraits>
+constexpr typename basic_string<CharType, CharTraits>::size_type
+basic_string<CharType, CharTraits>::npos;
+
+/*****************************************************************************************/
+
+// 预留储存空间，n 不大于当前容量时什么都不做
+template <class CharType, class CharTraits>
+void basic_string<CharType, CharTraits>::
+reserve(size_type n)
+{
+  if (n <= capacity())
+    return;
+  const size_type len = size();
+  pointer buf = allocate_buffer(n);
+  traits_type::copy(buf, data_ptr(), len);
+  destroy_buffer();
+  set_long(buf, len, n);
+}
+
+// 释放多余的储存空间，能放入短字符串时回到短字符串
+template <class CharType, class CharTraits>
+void basic_string<CharType, CharTraits>::
+shrink_to_fit()
+{
+  if (is_small())
+    return;
+  const size_type len = rep_.l.size;
+  if (len == decode_cap(rep_.l.cap))
+    return;
+  if (len <= small_cap)
+  {
+    pointer old = rep_.l.data;
+    const size_type old_cap = decode_cap(rep_.l.cap);
+    traits_type::copy(rep_.s, old, len);
+    set_small_size(len);
+    data_allocator::deallocate(old, old_cap + 1);
+    return;
+  }
+  pointer buf = allocate_buffer(len);
+  traits_type::copy(buf, rep_.l.data, len);
+  destroy_buffer();
+  set_long(buf, len, len);
+}
+
+// 在末尾追加 [s, s + count)，s 可以指向字符串自身
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>&
+basic_string<CharType, CharTraits>::
+append(const_pointer s, size_type count)
+{
+  const size_type len = size();
+  if (count <= capacity() - len)
+  { // 追加的位置在现有字符之后，与 s 不会重叠
+    traits_type::copy(data_ptr() + len, s, count);
+    set_size(len + count);
+    return *this;
+  }
+  const size_type new_cap = get_new_cap(count);
+  pointer buf = allocate_buffer(new_cap);
+  traits_type::copy(buf, data_ptr(), len);
+  traits_type::copy(buf + len, s, count);
+  destroy_buffer();
+  set_long(buf, len + count, new_cap);
+  return *this;
+}
+
+// 以 [str, str + count) 替换现有内容，str 可以指向字符串自身
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>&
+basic_string<CharType, CharTraits>::
+assign(const_pointer str, size_type count)
+{
+  if (count <= capacity())
+  {
+    traits_type::move(data_ptr(), str, count);
+    set_size(count);
+    return *this;
+  }
+  pointer buf = allocate_buffer(count);
+  traits_type::copy(buf, str, count);
+  destroy_buffer();
+  set_long(buf, count, count);
+  return *this;
+}
+
+// 与 vector 相同的增长策略：至少增长到原来的 1.5 倍
+template <class CharType, class CharTraits>
+typename basic_string<CharType, CharTraits>::size_type
+basic_string<CharType, CharTraits>::
+get_new_cap(size_type add_size) const
+{
+  const size_type len = size();
+  const size_type old_cap = capacity();
+  THROW_LENGTH_ERROR_IF(len > max_size() - add_size, "basic_string<Char>'s size too big");
+  if (old_cap > max_size() - old_cap / 2)
+    return len + add_size;
+  return mystl::max(old_cap + old_cap / 2, len + add_size);
+}
+
+// 把 [pos, pos + count) 替换为 [str, str + count2)，str 可以指向字符串自身
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>&
+basic_string<CharType, CharTraits>::
+replace_aux(size_type pos, size_type count, const_pointer str, size_type count2)
+{
+  const size_type len = size();
+  MYSTL_DEBUG(pos + count <= len);
+  if (count2 > count && count2 - count > capacity() - len)
+  { // 需要重新分配，旧的内容在复制完成之前保持有效
+    const size_type new_cap = get_new_cap(count2 - count);
+    pointer buf = allocate_buffer(new_cap);
+    const_pointer old = data_ptr();
+    traits_type::copy(buf, old, pos);
+    traits_type::copy(buf + pos, str, count2);
+    traits_type::copy(buf + pos + count2, old + pos + count, len - pos - count);
+    destroy_buffer();
+    set_long(buf, len - count + count2, new_cap);
+    return *this;
+  }
+  pointer p = data_ptr();
+  if (str >= p && str < p + len)
+  { // str 指向自身时先复制一份，避免移动尾部时覆盖 str
+    const basic_string tmp(str, count2);
+    return replace_aux(pos, count, tmp.data(), count2);
+  }
+  traits_type::move(p + pos + count2, p + pos + count, len - pos - count);
+  traits_type::copy(p + pos, str, count2);
+  set_size(len - count + count2);
+  return *this;
+}
+
+// 把 [pos, pos + count) 替换为 count2 个 ch
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>&
+basic_string<CharType, CharTraits>::
+replace_fill(size_type pos, size_type count, size_type count2, value_type ch)
+{
+  const size_type len = size();
+  MYSTL_DEBUG(pos + count <= len);
+  if (count2 > count && count2 - count > capacity() - len)
+  {
+    const size_type new_cap = get_new_cap(count2 - count);
+    pointer buf = allocate_buffer(new_cap);
+    const_pointer old = data_ptr();
+    traits_type::copy(buf, old, pos);
+    traits_type::fill(buf + pos, ch, count2);
+    traits_type::copy(buf + pos + count2, old + pos + count, len - pos - count);
+    destroy_buffer();
+    set_long(buf, len - count + count2, new_cap);
+    return *this;
+  }
+  pointer p = data_ptr();
+  traits_type::move(p + pos + count2, p + pos + count, len - pos - count);
+  traits_type::fill(p + pos, ch, count2);
+  set_size(len - count + count2);
+  return *this;
+}
+
+// 逐个追加输入迭代器区间中的字符
+template <class CharType, class CharTraits>
+template <class Iter>
+basic_string<CharType, CharTraits>&
+basic_string<CharType, CharTraits>::
+append_range(Iter first, Iter last, input_iterator_tag)
+{
+  for (; first != last; ++first)
+    push_back(*first);
+  return *this;
+}
+
+// 前向迭代器区间先算出长度，至多分配一次
+template <class CharType, class CharTraits>
+template <class Iter>
+basic_string<CharType, CharTraits>&
+basic_string<CharType, CharTraits>::
+append_range(Iter first, Iter last, forward_iterator_tag)
+{
+  const size_type count = static_cast<size_type>(mystl::distance(first, last));
+  const size_type len = size();
+  if (count <= capacity() - len)
+  {
+    pointer p = data_ptr() + len;
+    for (; first != last; ++first, ++p)
+      *p = *first;
+    set_size(len + count);
+    return *this;
+  }
+  const size_type new_cap = get_new_cap(count);
+  pointer buf = allocate_buffer(new_cap);
+  traits_type::copy(buf, data_ptr(), len);
+  pointer p = buf + len;
+  for (; first != last; ++first, ++p)
+    *p = *first;
+  destroy_buffer();
+  set_long(buf, len + count, new_cap);
+  return *this;
+}
+
+/*****************************************************************************************/
+// 重载全局操作符
+
+// 重载 operator+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(const basic_string<CharType, CharTraits>& lhs,
+          const basic_string<CharType, CharTraits>& rhs)
+{
+  basic_string<CharType, CharTraits> tmp;
+  tmp.reserve(lhs.size() + rhs.size());
+  tmp.append(lhs);
+  tmp.append(rhs);
+  return tmp;
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+  const size_t len = CharTraits::length(lhs);
+  basic_string<CharType, CharTraits> tmp;
+  tmp.reserve(len + rhs.size());
+  tmp.append(lhs, len);
+  tmp.append(rhs);
+  return tmp;
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(CharType ch, const basic_string<CharType, CharTraits>& rhs)
+{
+  basic_string<CharType, CharTraits> tmp;
+  tmp.reserve(rhs.size() + 1);
+  tmp.push_back(ch);
+  tmp.append(rhs);
+  return tmp;
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+  basic_string<CharType, CharTraits> tmp(lhs);
+  tmp.append(rhs);
+  return tmp;
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(const basic_string<CharType, CharTraits>& lhs, CharType ch)
+{
+  basic_string<CharType, CharTraits> tmp(lhs);
+  tmp.push_back(ch);
+  return tmp;
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(basic_string<CharType, CharTraits>&& lhs,
+          const basic_string<CharType, CharTraits>& rhs)
+{
+  return mystl::move(lhs.append(rhs));
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(const basic_string<CharType, CharTraits>& lhs,
+          basic_string<CharType, CharTraits>&& rhs)
+{
+  return mystl::move(rhs.insert(0, lhs));
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(basic_string<CharType, CharTraits>&& lhs,
+          basic_string<CharType, CharTraits>&& rhs)
+{
+  return mystl::move(lhs.append(rhs));
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(const CharType* lhs, basic_string<CharType, CharTraits>&& rhs)
+{
+  return mystl::move(rhs.insert(0, lhs));
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(CharType ch, basic_string<CharType, CharTraits>&& rhs)
+{
+  rhs.insert(rhs.begin(), ch);
+  return mystl::move(rhs);
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(basic_string<CharType, CharTraits>&& lhs, const CharType* rhs)
+{
+  return mystl::move(lhs.append(rhs));
+}
+
+template <class CharType, class CharTraits>
+basic_string<CharType, CharTraits>
+operator+(basic_string<CharType, CharTraits>&& lhs, CharType ch)
+{
+  lhs.push_back(ch);
+  return mystl::move(lhs);
+}
+
+// 重载比较操作符
+template <class CharType, class CharTraits>
+bool operator==(const basic_string<CharType, CharTraits>& lhs,
+                const basic_string<CharType, CharTraits>& rhs) noexcept
+{
+  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator!=(const basic_string<CharType, CharTraits>& lhs,
+                const basic_string<CharType, CharTraits>& rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+template <class CharType, class CharTraits>
+bool operator<(const basic_string<CharType, CharTraits>& lhs,
+               const basic_string<CharType, CharTraits>& rhs) noexcept
+{
+  return lhs.compare(rhs) < 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator<=(const basic_string<CharType, CharTraits>& lhs,
+                const basic_string<CharType, CharTraits>& rhs) noexcept
+{
+  return lhs.compare(rhs) <= 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator>(const basic_string<CharType, CharTraits>& lhs,
+               const basic_string<CharType, CharTraits>& rhs) noexcept
+{
+  return lhs.compare(rhs) > 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator>=(const basic_string<CharType, CharTraits>& lhs,
+                const basic_string<CharType, CharTraits>& rhs) noexcept
+{
+  return lhs.compare(rhs) >= 0;
+}
+
+// 与 C 风格字符串比较
+template <class CharType, class CharTraits>
+bool operator==(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) == 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator==(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+  return rhs.compare(lhs) == 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator!=(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) != 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator!=(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+  return rhs.compare(lhs) != 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator<(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+  return lhs.compare(rhs) < 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator<(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+  return rhs.compare(lhs) > 0;
+}
+
+// 重载 operator<<
+template <class CharType, class CharTraits>
+std::basic_ostream<CharType>& operator<<(std::basic_ostream<CharType>& os,
+                                         const basic_string<CharType, CharTraits>& str)
+{
+  return os.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+// 重载 mystl 的 swap
+template <class CharType, class CharTraits>
+void swap(basic_string<CharType, CharTraits>& lhs,
+          basic_string<CharType, CharTraits>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// 特化 mystl::hash，与 hash<basic_string_view> 的结果相同
+template <class CharType, class CharTraits>
+struct hash<basic_string<CharType, CharTraits>>
+{
+  size_t operator()(const basic_string<CharType, CharTraits>& str) const noexcept
+  {
+    return bitwise_hash(reinterpret_cast<const unsigned char*>(str.data()),
+                        str.size() * sizeof(CharType));
+  }
+};
+
+// 透明的字符串哈希函数与相等比较，都声明了 is_transparent
+// 用作以 basic_string 为键值的 unordered_map 的 Hash 与 KeyEqual 时，可以直接用 basic_string_view
+// 或 C 风格字符串查找，参数统一转换为 basic_string_view，不会构造临时的 basic_string
+template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+struct basic_string_hash
+{
+  typedef void is_transparent;
+
+  size_t operator()(basic_string_view<CharType, CharTraits> sv) const noexcept
+  {
+    return mystl::hash<basic_string_view<CharType, CharTraits>>()(sv);
+  }
+};
+
+template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+struct basic_string_equal
+{
+  typedef void is_transparent;
+
+  bool operator()(basic_string_view<CharType, CharTraits> lhs,
+                  basic_string_view<CharType, CharTraits> rhs) const noexcept
+  {
+    return lhs == rhs;
+  }
+};
+
+} // namespace mystl
+#endif // !MYTINYSTL_BASIC_STRING_H_
+
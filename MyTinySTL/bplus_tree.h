@@ -0,0 +1,1501 @@
+﻿#ifndef MYTINYSTL_BPLUS_TREE_H_
+#define MYTINYSTL_BPLUS_TREE_H_
+
+// 这个头文件包含一个模板类 bplus_tree
+// bplus_tree : B+ 树，作为 map / multimap / set / multiset 的底层实现
+
+// notes:
+//
+// 1. 元素只储存在叶节点中，叶节点之间以双向链表相连，顺序遍历与区间扫描只需沿着链表前进
+// 2. 节点的大小为 4 个缓存行（256 字节），每个节点能容纳的元素个数由元素的大小算出，
+//    例如 map<int, int> 每个叶节点容纳 27 个元素，内部节点有 19 个分支，树高约为红黑树的 1/4
+// 3. 元素在节点内连续储存，插入与删除会移动同一节点中的其它元素，因此插入与删除会使所有迭代器失效，
+//    这一点与 std::map 不同
+// 4. 内部节点储存分隔键，第 i 棵子树中的键都不小于第 i - 1 个分隔键，且不大于第 i 个分隔键
+// 5. 在最右侧的叶节点末尾插入时（例如按顺序插入、复制）不平分节点，原节点保持满载
+//
+// 异常保证：
+// mystl::bplus_tree<T> 满足基本异常保证，要求元素的移动构造函数不抛出异常，
+// 单个元素的插入满足强异常安全保证
+
+#include <initializer_list>
+#include <cstring>
+#include <type_traits>
+
+#include "algobase.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// B+ 树节点的目标大小（字节），为缓存行大小的整数倍
+constexpr size_t bplus_tree_node_bytes = 256;
+
+// value traits
+template <class T, bool>
+struct bplus_tree_value_traits_imp
+{
+  typedef T key_type;
+  typedef T mapped_type;
+  typedef T value_type;
+
+  template <class Ty>
+  static const key_type& get_key(const Ty& value)
+  {
+    return value;
+  }
+
+  template <class Ty>
+  static const value_type& get_value(const Ty& value)
+  {
+    return value;
+  }
+};
+
+template <class T>
+struct bplus_tree_value_traits_imp<T, true>
+{
+  typedef typename std::remove_cv<typename T::first_type>::type key_type;
+  typedef typename T::second_type                               mapped_type;
+  typedef T                                                     value_type;
+
+  template <class Ty>
+  static const key_type& get_key(const Ty& value)
+  {
+    return value.first;
+  }
+
+  template <class Ty>
+  static const value_type& get_value(const Ty& value)
+  {
+    return value;
+  }
+};
+
+template <class T>
+struct bplus_tree_value_traits
+{
+  static constexpr bool is_map = mystl::is_pair<T>::value;
+
+  typedef bplus_tree_value_traits_imp<T, is_map> value_traits_type;
+
+  typedef typename value_traits_type::key_type    key_type;
+  typedef typename value_traits_type::mapped_type mapped_type;
+  typedef typename value_traits_type::value_type  value_type;
+
+  template <class Ty>
+  static const key_type& get_key(const Ty& value)
+  {
+    return value_traits_type::get_key(value);
+  }
+
+  template <class Ty>
+  static const value_type& get_value(const Ty& value)
+  {
+    return value_traits_type::get_value(value);
+  }
+};
+
+// B+ 树的节点定义
+
+struct bplus_tree_node_base
+{
+  bplus_tree_node_base* parent;   // 父节点，根节点为 nullptr
+  size_t                count;    // 叶节点中的元素个数，或内部节点中的分隔键个数
+  bool                  is_leaf;
+};
+
+// 叶节点，元素储存在未初始化的槽中，只有 [0, count) 中的槽构造了元素
+template <class T>
+struct bplus_tree_leaf :public bplus_tree_node_base
+{
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot_type;
+
+  static constexpr size_t header = sizeof(bplus_tree_node_base) + 2 * sizeof(void*);
+  static constexpr size_t capacity = (bplus_tree_node_bytes - header) / sizeof(T) < 4
+    ? 4 : (bplus_tree_node_bytes - header) / sizeof(T);
+  static constexpr size_t min_count = capacity / 2;
+
+  bplus_tree_leaf* prev;  // 前一个叶节点
+  bplus_tree_leaf* next;  // 后一个叶节点
+  slot_type        slots[capacity];
+
+  T* value(size_t n) { return reinterpret_cast<T*>(&slots[n]); }
+};
+
+// 内部节点，有 count 个分隔键与 count + 1 个子节点
+template <class Key>
+struct bplus_tree_inner :public bplus_tree_node_base
+{
+  typedef typename std::aligned_storage<sizeof(Key), alignof(Key)>::type slot_type;
+
+  static constexpr size_t header = sizeof(bplus_tree_node_base) + sizeof(void*);
+  static constexpr size_t capacity =
+    (bplus_tree_node_bytes - header) / (sizeof(Key) + sizeof(void*)) < 4
+    ? 4 : (bplus_tree_node_bytes - header) / (sizeof(Key) + sizeof(void*));
+  static constexpr size_t min_count = capacity / 2;
+
+  slot_type             keys[capacity];
+  bplus_tree_node_base* children[capacity + 1];
+
+  Key* key(size_t n) { return reinterpret_cast<Key*>(&keys[n]); }
+};
+
+// 将 [first, first + n) 中的对象搬移到 result 开始的位置，两段可以重叠，搬移后原位置视为未初始化
+template <class T>
+void bplus_tree_relocate(T* first, size_t n, T* result, std::true_type)
+{
+  if (n != 0)
+    std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+}
+
+template <class T>
+void bplus_tree_relocate(T* first, size_t n, T* result, std::false_type)
+{
+  if (result < first)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      mystl::construct(result + i, mystl::move(first[i]));
+      mystl::destroy(first + i);
+    }
+  }
+  else if (result > first)
+  {
+    for (size_t i = n; i > 0; --i)
+    {
+      mystl::construct(result + i - 1, mystl::move(first[i - 1]));
+      mystl::destroy(first + i - 1);
+    }
+  }
+}
+
+template <class T>
+void bplus_tree_relocate(T* first, size_t n, T* result)
+{
+  bplus_tree_relocate(first, n, result, std::integral_constant<bool,
+                      std::is_trivially_copy_constructible<T>::value &&
+                      std::is_trivially_destructible<T>::value>{});
+}
+
+// bplus_tree 的迭代器，由所在的叶节点与节点中的位置表示
+// end() 为最右侧叶节点的 count 位置，空树的 begin() 与 end() 都为 (nullptr, 0)
+
+template <class T>
+struct bplus_tree_iterator;
+
+template <class T>
+struct bplus_tree_const_iterator;
+
+template <class T>
+struct bplus_tree_iterator_base :public mystl::iterator<mystl::bidirectional_iterator_tag, T>
+{
+  typedef bplus_tree_leaf<T>*      leaf_ptr;
+  typedef bplus_tree_iterator_base base;
+
+  leaf_ptr leaf;   // 所在的叶节点
+  size_t   index;  // 在叶节点中的位置
+
+  bplus_tree_iterator_base() :leaf(nullptr), index(0) {}
+
+  // 使迭代器前进
+  void inc()
+  {
+    MYSTL_DEBUG(leaf != nullptr && index < leaf->count);
+    if (++index == leaf->count && leaf->next != nullptr)
+    {
+      leaf = leaf->next;
+      index = 0;
+    }
+  }
+
+  // 使迭代器后退
+  void dec()
+  {
+    if (index == 0)
+    {
+      leaf = leaf->prev;
+      MYSTL_DEBUG(leaf != nullptr);
+      index = leaf->count - 1;
+    }
+    else
+    {
+      --index;
+    }
+  }
+
+  bool operator==(const base& rhs) const { return leaf == rhs.leaf && index == rhs.index; }
+  bool operator!=(const base& rhs) const { return !(*this == rhs); }
+};
+
+template <class T>
+struct bplus_tree_iterator :public bplus_tree_iterator_base<T>
+{
+  typedef T                               value_type;
+  typedef T*                              pointer;
+  typedef T&                              reference;
+  typedef typename bplus_tree_iterator_base<T>::leaf_ptr leaf_ptr;
+
+  typedef bplus_tree_iterator<T>          iterator;
+  typedef bplus_tree_const_iterator<T>    const_iterator;
+  typedef iterator                        self;
+
+  using bplus_tree_iterator_base<T>::leaf;
+  using bplus_tree_iterator_base<T>::index;
+
+  // 构造函数
+  bplus_tree_iterator() {}
+  bplus_tree_iterator(leaf_ptr x, size_t n)
+  {
+    leaf = x;
+    index = n;
+  }
+  bplus_tree_iterator(const iterator& rhs)
+  {
+    leaf = rhs.leaf;
+    index = rhs.index;
+  }
+  bplus_tree_iterator(const const_iterator& rhs)
+  {
+    leaf = rhs.leaf;
+    index = rhs.index;
+  }
+  self& operator=(const self& rhs)
+  {
+    leaf = rhs.leaf;
+    index = rhs.index;
+    return *this;
+  }
+
+  // 重载操作符
+  reference operator*()  const { return *leaf->value(index); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    this->inc();
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp(*this);
+    this->inc();
+    return tmp;
+  }
+
+  self& operator--()
+  {
+    this->dec();
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp(*this);
+    this->dec();
+    return tmp;
+  }
+};
+
+template <class T>
+struct bplus_tree_const_iterator :public bplus_tree_iterator_base<T>
+{
+  typedef T                               value_type;
+  typedef const T*                        pointer;
+  typedef const T&                        reference;
+  typedef typename bplus_tree_iterator_base<T>::leaf_ptr leaf_ptr;
+
+  typedef bplus_tree_iterator<T>          iterator;
+  typedef bplus_tree_const_iterator<T>    const_iterator;
+  typedef const_iterator                  self;
+
+  using bplus_tree_iterator_base<T>::leaf;
+  using bplus_tree_iterator_base<T>::index;
+
+  // 构造函数
+  bplus_tree_const_iterator() {}
+  bplus_tree_const_iterator(leaf_ptr x, size_t n)
+  {
+    leaf = x;
+    index = n;
+  }
+  bplus_tree_const_iterator(const iterator& rhs)
+  {
+    leaf = rhs.leaf;
+    index = rhs.index;
+  }
+  bplus_tree_const_iterator(const const_iterator& rhs)
+  {
+    leaf = rhs.leaf;
+    index = rhs.index;
+  }
+  self& operator=(const self& rhs)
+  {
+    leaf = rhs.leaf;
+    index = rhs.index;
+    return *this;
+  }
+
+  // 重载操作符
+  reference operator*()  const { return *leaf->value(index); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    this->inc();
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp(*this);
+    this->inc();
+    return tmp;
+  }
+
+  self& operator--()
+  {
+    this->dec();
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp(*this);
+    this->dec();
+    return tmp;
+  }
+};
+
+// 模板类 bplus_tree
+// 参数一代表数据类型，参数二代表键值比较类型
+template <class T, class Compare>
+class bplus_tree
+{
+public:
+  // bplus_tree 的嵌套型别定义
+
+  typedef bplus_tree_value_traits<T>                value_traits;
+
+  typedef typename value_traits::key_type           key_type;
+  typedef typename value_traits::mapped_type        mapped_type;
+  typedef typename value_traits::value_type         value_type;
+  typedef Compare                                   key_compare;
+
+  typedef bplus_tree_node_base*                     base_ptr;
+  typedef bplus_tree_leaf<T>                        leaf_type;
+  typedef bplus_tree_leaf<T>*                       leaf_ptr;
+  typedef bplus_tree_inner<key_type>                inner_type;
+  typedef bplus_tree_inner<key_type>*               inner_ptr;
+
+  typedef mystl::allocator<T>                       allocator_type;
+  typedef mystl::allocator<T>                       data_allocator;
+  typedef mystl::allocator<leaf_type>               leaf_allocator;
+  typedef mystl::allocator<inner_type>              inner_allocator;
+
+  typedef typename allocator_type::pointer          pointer;
+  typedef typename allocator_type::const_pointer    const_pointer;
+  typedef typename allocator_type::reference        reference;
+  typedef typename allocator_type::const_reference  const_reference;
+  typedef typename allocator_type::size_type        size_type;
+  typedef typename allocator_type::difference_type  difference_type;
+
+  typedef bplus_tree_iterator<T>                    iterator;
+  typedef bplus_tree_const_iterator<T>              const_iterator;
+  typedef mystl::reverse_iterator<iterator>         reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+  allocator_type get_allocator() const { return allocator_type(); }
+  key_compare    key_comp()      const { return key_comp_; }
+
+private:
+  // 用以下五个数据表现 bplus_tree
+  base_ptr    root_;        // 根节点，空树为 nullptr
+  leaf_ptr    leftmost_;    // 最左侧的叶节点，即 begin() 所在的节点
+  leaf_ptr    rightmost_;   // 最右侧的叶节点，即 end() 所在的节点
+  size_type   node_count_;  // 元素个数
+  key_compare key_comp_;    // 键值比较的准则
+
+public:
+  // 构造、复制、析构函数
+  bplus_tree() :root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0) {}
+
+  bplus_tree(const bplus_tree& rhs)
+    :root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0),
+    key_comp_(rhs.key_comp_)
+  {
+    copy_from(rhs);
+  }
+  bplus_tree(bplus_tree&& rhs) noexcept
+    :root_(rhs.root_), leftmost_(rhs.leftmost_), rightmost_(rhs.rightmost_),
+    node_count_(rhs.node_count_), key_comp_(rhs.key_comp_)
+  {
+    rhs.reset();
+  }
+
+  bplus_tree& operator=(const bplus_tree& rhs);
+  bplus_tree& operator=(bplus_tree&& rhs);
+
+  ~bplus_tree() { clear(); }
+
+public:
+  // 迭代器相关操作
+
+  iterator               begin()         noexcept
+  { return iterator(leftmost_, 0); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(leftmost_, 0); }
+  iterator               end()           noexcept
+  { return iterator(rightmost_, rightmost_ ? rightmost_->count : 0); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(rightmost_, rightmost_ ? rightmost_->count : 0); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+
+  bool      empty()    const noexcept { return node_count_ == 0; }
+  size_type size()     const noexcept { return node_count_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+  // 插入删除相关操作
+
+  // emplace
+
+  template <class ...Args>
+  iterator  emplace_multi(Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return insert_multi_value(mystl::move(tmp));
+  }
+
+  template <class ...Args>
+  mystl::pair<iterator, bool> emplace_unique(Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return insert_unique_value(mystl::move(tmp));
+  }
+
+  template <class ...Args>
+  iterator  emplace_multi_use_hint(const_iterator hint, Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return insert_multi_use_hint(hint, mystl::move(tmp));
+  }
+
+  template <class ...Args>
+  iterator  emplace_unique_use_hint(const_iterator hint, Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return insert_unique_use_hint(hint, mystl::move(tmp));
+  }
+
+  // insert
+
+  iterator  insert_multi(const value_type& value)
+  { return insert_multi_value(value); }
+  iterator  insert_multi(value_type&& value)
+  { return insert_multi_value(mystl::move(value)); }
+
+  iterator  insert_multi(const_iterator hint, const value_type& value)
+  { return insert_multi_use_hint(hint, value); }
+  iterator  insert_multi(const_iterator hint, value_type&& value)
+  { return insert_multi_use_hint(hint, mystl::move(value)); }
+
+  template <class InputIterator>
+  void      insert_multi(InputIterator first, InputIterator last)
+  {
+    for (; first != last; ++first)
+      insert_multi_use_hint(end(), *first);
+  }
+
+  mystl::pair<iterator, bool> insert_unique(const value_type& value)
+  { return insert_unique_value(value); }
+  mystl::pair<iterator, bool> insert_unique(value_type&& value)
+  { return insert_unique_value(mystl::move(value)); }
+
+  iterator  insert_unique(const_iterator hint, const value_type& value)
+  { return insert_unique_use_hint(hint, value); }
+  iterator  insert_unique(const_iterator hint, value_type&& value)
+  { return insert_unique_use_hint(hint, mystl::move(value)); }
+
+  template <class InputIterator>
+  void      insert_unique(InputIterator first, InputIterator last)
+  {
+    for (; first != last; ++first)
+      insert_unique_use_hint(end(), *first);
+  }
+
+  // erase
+
+  iterator  erase(const_iterator position);
+  iterator  erase(const_iterator first, const_iterator last);
+
+  size_type erase_multi(const key_type& key);
+  size_type erase_unique(const key_type& key);
+
+  void      clear();
+
+  // bplus_tree 相关操作
+
+  iterator       find(const key_type& key);
+  const_iterator find(const key_type& key) const;
+
+  size_type      count_multi(const key_type& key) const
+  {
+    auto p = equal_range_multi(key);
+    return static_cast<size_type>(mystl::distance(p.first, p.second));
+  }
+  size_type      count_unique(const key_type& key) const
+  {
+    return find(key) != end() ? 1 : 0;
+  }
+
+  iterator       lower_bound(const key_type& key)
+  { return lower_bound_aux(key); }
+  const_iterator lower_bound(const key_type& key) const
+  { return lower_bound_aux(key); }
+
+  iterator       upper_bound(const key_type& key)
+  { return upper_bound_aux(key); }
+  const_iterator upper_bound(const key_type& key) const
+  { return upper_bound_aux(key); }
+
+  mystl::pair<iterator, iterator>
+    equal_range_multi(const key_type& key)
+  {
+    return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+  mystl::pair<const_iterator, const_iterator>
+    equal_range_multi(const key_type& key) const
+  {
+    return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+  }
+
+  mystl::pair<iterator, iterator>
+    equal_range_unique(const key_type& key)
+  {
+    iterator it = find(key);
+    iterator next = it;
+    if (it != end())
+      ++next;
+    return mystl::pair<iterator, iterator>(it, next);
+  }
+  mystl::pair<const_iterator, const_iterator>
+    equal_range_unique(const key_type& key) const
+  {
+    const_iterator it = find(key);
+    const_iterator next = it;
+    if (it != end())
+      ++next;
+    return mystl::pair<const_iterator, const_iterator>(it, next);
+  }
+
+  void swap(bplus_tree& rhs) noexcept;
+
+private:
+  // 键值比较与节点操作
+
+  static const key_type& key_of(leaf_ptr leaf, size_type n)
+  { return value_traits::get_key(*leaf->value(n)); }
+
+  leaf_ptr  create_leaf();
+  inner_ptr create_inner();
+  inner_ptr create_spare_inners(leaf_ptr leaf);
+  void      destroy_spare_inners(inner_ptr spare) noexcept;
+  void      destroy_subtree(base_ptr x);
+  void      reset() noexcept;
+  void      copy_from(const bplus_tree& rhs);
+
+  // 查找相关的辅助函数
+  size_type leaf_lower(leaf_ptr leaf, const key_type& key) const;
+  size_type leaf_upper(leaf_ptr leaf, const key_type& key) const;
+  size_type inner_lower(inner_ptr inner, const key_type& key) const;
+  size_type inner_upper(inner_ptr inner, const key_type& key) const;
+  leaf_ptr  descend_lower(const key_type& key) const;
+  leaf_ptr  descend_upper(const key_type& key) const;
+  iterator  normalize(leaf_ptr leaf, size_type n) const
+  {
+    return n == leaf->count && leaf->next != nullptr ? iterator(leaf->next, 0) : iterator(leaf, n);
+  }
+  iterator  lower_bound_aux(const key_type& key) const;
+  iterator  upper_bound_aux(const key_type& key) const;
+
+  // 插入相关的辅助函数
+  template <class V>
+  mystl::pair<iterator, bool> insert_unique_value(V&& value);
+  template <class V>
+  iterator  insert_multi_value(V&& value);
+  template <class V>
+  iterator  insert_unique_use_hint(const_iterator hint, V&& value);
+  template <class V>
+  iterator  insert_multi_use_hint(const_iterator hint, V&& value);
+  template <class V>
+  iterator  insert_at(leaf_ptr leaf, size_type n, V&& value);
+  void      insert_into_parent(base_ptr left, key_type&& key, base_ptr right, bool append,
+                               inner_ptr& spare);
+  void      inner_insert(inner_ptr inner, size_type pos, key_type&& key, base_ptr child);
+
+  // 删除相关的辅助函数
+  static size_type child_index(inner_ptr parent, base_ptr child);
+  void      rebalance_leaf(leaf_ptr& leaf, size_type& n);
+  void      inner_erase(inner_ptr inner, size_type pos);
+  void      rebalance_inner(inner_ptr inner);
+};
+
+/*****************************************************************************************/
+
+// 复制赋值操作符
+template <class T, class Compare>
+bplus_tree<T, Compare>&
+bplus_tree<T, Compare>::
+operator=(const bplus_tree& rhs)
+{
+  if (this != &rhs)
+  {
+    clear();
+    key_comp_ = rhs.key_comp_;
+    copy_from(rhs);
+  }
+  return *this;
+}
+
+// 移动赋值操作符
+template <class T, class Compare>
+bplus_tree<T, Compare>&
+bplus_tree<T, Compare>::
+operator=(bplus_tree&& rhs)
+{
+  if (this != &rhs)
+  {
+    clear();
+    root_ = rhs.root_;
+    leftmost_ = rhs.leftmost_;
+    rightmost_ = rhs.rightmost_;
+    node_count_ = rhs.node_count_;
+    key_comp_ = mystl::move(rhs.key_comp_);
+    rhs.reset();
+  }
+  return *this;
+}
+
+// 删除 position 位置的元素，返回被删除元素的下一个位置
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+erase(const_iterator position)
+{
+  leaf_ptr leaf = position.leaf;
+  size_type n = position.index;
+  MYSTL_DEBUG(leaf != nullptr && n < leaf->count);
+  mystl::destroy(leaf->value(n));
+  mystl::bplus_tree_relocate(leaf->value(n + 1), leaf->count - n - 1, leaf->value(n));
+  --leaf->count;
+  --node_count_;
+  if (leaf == root_)
+  {
+    if (leaf->count == 0)
+    {
+      leaf_allocator::deallocate(leaf);
+      reset();
+      return end();
+    }
+  }
+  else if (leaf->count < leaf_type::min_count)
+  {
+    rebalance_leaf(leaf, n);
+  }
+  return normalize(leaf, n);
+}
+
+// 删除[first, last)区间内的元素
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+erase(const_iterator first, const_iterator last)
+{
+  if (first == begin() && last == end())
+  {
+    clear();
+    return end();
+  }
+  // 删除会使迭代器失效，因此先数出个数，再逐个删除
+  auto n = mystl::distance(first, last);
+  iterator cur(first);
+  while (n-- > 0)
+    cur = erase(cur);
+  return cur;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::size_type
+bplus_tree<T, Compare>::
+erase_multi(const key_type& key)
+{
+  auto p = equal_range_multi(key);
+  const size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
+  erase(p.first, p.second);
+  return n;
+}
+
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::size_type
+bplus_tree<T, Compare>::
+erase_unique(const key_type& key)
+{
+  auto it = find(key);
+  if (it != end())
+  {
+    erase(it);
+    return 1;
+  }
+  return 0;
+}
+
+// 清空 bplus_tree
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+clear()
+{
+  if (root_ != nullptr)
+  {
+    destroy_subtree(root_);
+    reset();
+  }
+}
+
+// 查找键值为 key 的元素，返回指向它的迭代器
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+find(const key_type& key)
+{
+  iterator it = lower_bound_aux(key);
+  return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+}
+
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::const_iterator
+bplus_tree<T, Compare>::
+find(const key_type& key) const
+{
+  const_iterator it = lower_bound_aux(key);
+  return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+}
+
+// 交换 bplus_tree
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+swap(bplus_tree& rhs) noexcept
+{
+  if (this != &rhs)
+  {
+    mystl::swap(root_, rhs.root_);
+    mystl::swap(leftmost_, rhs.leftmost_);
+    mystl::swap(rightmost_, rhs.rightmost_);
+    mystl::swap(node_count_, rhs.node_count_);
+    mystl::swap(key_comp_, rhs.key_comp_);
+  }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 创建一个空的叶节点
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::leaf_ptr
+bplus_tree<T, Compare>::
+create_leaf()
+{
+  leaf_ptr leaf = leaf_allocator::allocate(1);
+  leaf->parent = nullptr;
+  leaf->count = 0;
+  leaf->is_leaf = true;
+  leaf->prev = nullptr;
+  leaf->next = nullptr;
+  return leaf;
+}
+
+// 创建一个空的内部节点
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::inner_ptr
+bplus_tree<T, Compare>::
+create_inner()
+{
+  inner_ptr inner = inner_allocator::allocate(1);
+  inner->parent = nullptr;
+  inner->count = 0;
+  inner->is_leaf = false;
+  return inner;
+}
+
+// 分裂叶节点 leaf 时，为向上逐层分裂预先分配所需的内部节点：leaf 之上每个满载的祖先需要一个兄弟节点，
+// 一直满载到根节点时还需要一个新的根节点。这些节点用 parent 指针串成链表，由 insert_into_parent 逐个取用
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::inner_ptr
+bplus_tree<T, Compare>::
+create_spare_inners(leaf_ptr leaf)
+{
+  size_type need = 0;
+  base_ptr x = leaf;
+  for (; x->parent != nullptr && static_cast<inner_ptr>(x->parent)->count == inner_type::capacity;
+       x = x->parent)
+    ++need;
+  if (x->parent == nullptr)
+    ++need;
+  inner_ptr spare = nullptr;
+  try
+  {
+    for (; need > 0; --need)
+    {
+      inner_ptr inner = create_inner();
+      inner->parent = spare;
+      spare = inner;
+    }
+  }
+  catch (...)
+  {
+    destroy_spare_inners(spare);
+    throw;
+  }
+  return spare;
+}
+
+// 释放预先分配而未使用的内部节点
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+destroy_spare_inners(inner_ptr spare) noexcept
+{
+  while (spare != nullptr)
+  {
+    inner_ptr next = static_cast<inner_ptr>(spare->parent);
+    inner_allocator::deallocate(spare);
+    spare = next;
+  }
+}
+
+// 销毁以 x 为根的子树
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+destroy_subtree(base_ptr x)
+{
+  if (x->is_leaf)
+  {
+    leaf_ptr leaf = static_cast<leaf_ptr>(x);
+    for (size_type i = 0; i < leaf->count; ++i)
+      mystl::destroy(leaf->value(i));
+    leaf_allocator::deallocate(leaf);
+  }
+  else
+  {
+    inner_ptr inner = static_cast<inner_ptr>(x);
+    for (size_type i = 0; i <= inner->count; ++i)
+      destroy_subtree(inner->children[i]);
+    for (size_type i = 0; i < inner->count; ++i)
+      mystl::destroy(inner->key(i));
+    inner_allocator::deallocate(inner);
+  }
+}
+
+// 将 bplus_tree 置为空树，不释放节点
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+reset() noexcept
+{
+  root_ = nullptr;
+  leftmost_ = nullptr;
+  rightmost_ = nullptr;
+  node_count_ = 0;
+}
+
+// 按顺序把 rhs 的元素追加到末尾，每个叶节点都保持满载
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+copy_from(const bplus_tree& rhs)
+{
+  for (auto it = rhs.begin(); it != rhs.end(); ++it)
+    insert_at(rightmost_, rightmost_ ? rightmost_->count : 0, *it);
+}
+
+// 在叶节点中找到第一个不小于 key 的位置
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::size_type
+bplus_tree<T, Compare>::
+leaf_lower(leaf_ptr leaf, const key_type& key) const
+{
+  size_type lo = 0, hi = leaf->count;
+  while (lo < hi)
+  {
+    const size_type mid = (lo + hi) / 2;
+    if (key_comp_(key_of(leaf, mid), key))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// 在叶节点中找到第一个大于 key 的位置
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::size_type
+bplus_tree<T, Compare>::
+leaf_upper(leaf_ptr leaf, const key_type& key) const
+{
+  size_type lo = 0, hi = leaf->count;
+  while (lo < hi)
+  {
+    const size_type mid = (lo + hi) / 2;
+    if (key_comp_(key, key_of(leaf, mid)))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+// 在内部节点中找到第一个不小于 key 的分隔键，返回应当进入的子节点
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::size_type
+bplus_tree<T, Compare>::
+inner_lower(inner_ptr inner, const key_type& key) const
+{
+  size_type lo = 0, hi = inner->count;
+  while (lo < hi)
+  {
+    const size_type mid = (lo + hi) / 2;
+    if (key_comp_(*inner->key(mid), key))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// 在内部节点中找到第一个大于 key 的分隔键，返回应当进入的子节点
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::size_type
+bplus_tree<T, Compare>::
+inner_upper(inner_ptr inner, const key_type& key) const
+{
+  size_type lo = 0, hi = inner->count;
+  while (lo < hi)
+  {
+    const size_type mid = (lo + hi) / 2;
+    if (key_comp_(key, *inner->key(mid)))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+// 从根节点下降到可能含有第一个不小于 key 的元素的叶节点，树不能为空
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::leaf_ptr
+bplus_tree<T, Compare>::
+descend_lower(const key_type& key) const
+{
+  base_ptr x = root_;
+  while (!x->is_leaf)
+  {
+    inner_ptr inner = static_cast<inner_ptr>(x);
+    x = inner->children[inner_lower(inner, key)];
+  }
+  return static_cast<leaf_ptr>(x);
+}
+
+// 从根节点下降到可能含有第一个大于 key 的元素的叶节点，树不能为空
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::leaf_ptr
+bplus_tree<T, Compare>::
+descend_upper(const key_type& key) const
+{
+  base_ptr x = root_;
+  while (!x->is_leaf)
+  {
+    inner_ptr inner = static_cast<inner_ptr>(x);
+    x = inner->children[inner_upper(inner, key)];
+  }
+  return static_cast<leaf_ptr>(x);
+}
+
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+lower_bound_aux(const key_type& key) const
+{
+  if (root_ == nullptr)
+    return iterator();
+  leaf_ptr leaf = descend_lower(key);
+  return normalize(leaf, leaf_lower(leaf, key));
+}
+
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+upper_bound_aux(const key_type& key) const
+{
+  if (root_ == nullptr)
+    return iterator();
+  leaf_ptr leaf = descend_upper(key);
+  return normalize(leaf, leaf_upper(leaf, key));
+}
+
+// 插入不重复的元素，已有相同键值的元素时返回它的位置与 false
+template <class T, class Compare>
+template <class V>
+mystl::pair<typename bplus_tree<T, Compare>::iterator, bool>
+bplus_tree<T, Compare>::
+insert_unique_value(V&& value)
+{
+  const key_type& key = value_traits::get_key(value);
+  if (root_ == nullptr)
+    return mystl::make_pair(insert_at(nullptr, 0, mystl::forward<V>(value)), true);
+  // 比所有元素都大时直接追加到末尾，按顺序插入时不需要从根节点下降
+  if (key_comp_(key_of(rightmost_, rightmost_->count - 1), key))
+    return mystl::make_pair(insert_at(rightmost_, rightmost_->count, mystl::forward<V>(value)), true);
+  leaf_ptr leaf = descend_lower(key);
+  const size_type n = leaf_lower(leaf, key);
+  if (n < leaf->count)
+  {
+    if (!key_comp_(key, key_of(leaf, n)))
+      return mystl::make_pair(iterator(leaf, n), false);
+  }
+  else if (leaf->next != nullptr && !key_comp_(key, key_of(leaf->next, 0)))
+  {
+    return mystl::make_pair(iterator(leaf->next, 0), false);
+  }
+  return mystl::make_pair(insert_at(leaf, n, mystl::forward<V>(value)), true);
+}
+
+// 插入可重复的元素，插入到所有相同键值的元素之后
+template <class T, class Compare>
+template <class V>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+insert_multi_value(V&& value)
+{
+  const key_type& key = value_traits::get_key(value);
+  if (root_ == nullptr)
+    return insert_at(nullptr, 0, mystl::forward<V>(value));
+  if (!key_comp_(key, key_of(rightmost_, rightmost_->count - 1)))
+    return insert_at(rightmost_, rightmost_->count, mystl::forward<V>(value));
+  leaf_ptr leaf = descend_upper(key);
+  return insert_at(leaf, leaf_upper(leaf, key), mystl::forward<V>(value));
+}
+
+// 使用 hint 插入不重复的元素
+// hint 为 end() 且 value 大于所有元素，或 hint 与它的前一个元素在同一叶节点且 value 介于两者之间时，
+// 直接插入到 hint 的位置，否则从根节点查找
+template <class T, class Compare>
+template <class V>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+insert_unique_use_hint(const_iterator hint, V&& value)
+{
+  const key_type& key = value_traits::get_key(value);
+  if (root_ != nullptr && hint.index != 0)
+  {
+    leaf_ptr leaf = hint.leaf;
+    const size_type n = hint.index;
+    if (key_comp_(key_of(leaf, n - 1), key) &&
+        (n == leaf->count ? leaf == rightmost_ : key_comp_(key, key_of(leaf, n))))
+      return insert_at(leaf, n, mystl::forward<V>(value));
+  }
+  return insert_unique_value(mystl::forward<V>(value)).first;
+}
+
+// 使用 hint 插入可重复的元素
+template <class T, class Compare>
+template <class V>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+insert_multi_use_hint(const_iterator hint, V&& value)
+{
+  const key_type& key = value_traits::get_key(value);
+  if (root_ != nullptr && hint.index != 0)
+  {
+    leaf_ptr leaf = hint.leaf;
+    const size_type n = hint.index;
+    if (!key_comp_(key, key_of(leaf, n - 1)) &&
+        (n == leaf->count ? leaf == rightmost_ : !key_comp_(key_of(leaf, n), key)))
+      return insert_at(leaf, n, mystl::forward<V>(value));
+  }
+  return insert_multi_value(mystl::forward<V>(value));
+}
+
+// 在叶节点 leaf 的第 n 个位置插入元素，leaf 为 nullptr 时树为空
+// 叶节点已满时先分裂为两个节点，把右节点的第一个键作为分隔键插入父节点
+// 可能抛出异常的步骤（构造新元素、复制分隔键、分配节点）都在修改树的结构之前完成，
+// 构造新元素失败时把已经移动的元素移回原处，树保持不变
+template <class T, class Compare>
+template <class V>
+typename bplus_tree<T, Compare>::iterator
+bplus_tree<T, Compare>::
+insert_at(leaf_ptr leaf, size_type n, V&& value)
+{
+  if (leaf == nullptr)
+  {
+    leaf = create_leaf();
+    try
+    {
+      mystl::construct(leaf->value(0), mystl::forward<V>(value));
+    }
+    catch (...)
+    {
+      leaf_allocator::deallocate(leaf);
+      throw;
+    }
+    leaf->count = 1;
+    root_ = leftmost_ = rightmost_ = leaf;
+    ++node_count_;
+    return iterator(leaf, 0);
+  }
+  if (leaf->count < leaf_type::capacity)
+  {
+    mystl::bplus_tree_relocate(leaf->value(n), leaf->count - n, leaf->value(n + 1));
+    try
+    {
+      mystl::construct(leaf->value(n), mystl::forward<V>(value));
+    }
+    catch (...)
+    {
+      mystl::bplus_tree_relocate(leaf->value(n + 1), leaf->count - n, leaf->value(n));
+      throw;
+    }
+    ++leaf->count;
+    ++node_count_;
+    return iterator(leaf, n);
+  }
+  // 在末尾追加时原节点保持满载，新元素单独放入右节点；否则平分节点，右节点的第一个键不会因为插入而改变
+  const bool append = leaf == rightmost_ && n == leaf->count;
+  const size_type split = leaf->count / 2;
+  key_type key(append ? value_traits::get_key(value) : key_of(leaf, split));
+  inner_ptr spare = create_spare_inners(leaf);
+  leaf_ptr right = nullptr;
+  try
+  {
+    right = create_leaf();
+  }
+  catch (...)
+  {
+    destroy_spare_inners(spare);
+    throw;
+  }
+  leaf_ptr target = leaf;
+  if (append)
+  {
+    target = right;
+    n = 0;
+  }
+  else
+  {
+    mystl::bplus_tree_relocate(leaf->value(split), leaf->count - split, right->value(0));
+    right->count = leaf->count - split;
+    leaf->count = split;
+    if (n > split)
+    {
+      target = right;
+      n -= split;
+    }
+    mystl::bplus_tree_relocate(target->value(n), target->count - n, target->value(n + 1));
+  }
+  try
+  {
+    mystl::construct(target->value(n), mystl::forward<V>(value));
+  }
+  catch (...)
+  {
+    if (!append)
+    {
+      mystl::bplus_tree_relocate(target->value(n + 1), target->count - n, target->value(n));
+      mystl::bplus_tree_relocate(right->value(0), right->count, leaf->value(split));
+      leaf->count += right->count;
+    }
+    leaf_allocator::deallocate(right);
+    destroy_spare_inners(spare);
+    throw;
+  }
+  ++target->count;
+  ++node_count_;
+  // 以下步骤不会抛出异常
+  right->prev = leaf;
+  right->next = leaf->next;
+  if (leaf->next != nullptr)
+    leaf->next->prev = right;
+  else
+    rightmost_ = right;
+  leaf->next = right;
+  insert_into_parent(leaf, mystl::move(key), right, append, spare);
+  MYSTL_DEBUG(spare == nullptr);
+  return iterator(target, n);
+}
+
+// 把分隔键 key 与它右侧的子节点 right 插入到 left 的父节点中，父节点已满时继续分裂
+// append 为 true 表示 right 是所在层最右侧的节点，此时分裂让左节点尽量满载
+// 新的内部节点从 create_spare_inners 预先分配的 spare 中取用
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+insert_into_parent(base_ptr left, key_type&& key, base_ptr right, bool append,
+                   inner_ptr& spare)
+{
+  if (left == root_)
+  { // 树长高一层
+    inner_ptr root = spare;
+    spare = static_cast<inner_ptr>(spare->parent);
+    root->parent = nullptr;
+    mystl::construct(root->key(0), mystl::move(key));
+    root->children[0] = left;
+    root->children[1] = right;
+    root->count = 1;
+    left->parent = root;
+    right->parent = root;
+    root_ = root;
+    return;
+  }
+  inner_ptr parent = static_cast<inner_ptr>(left->parent);
+  const size_type pos = child_index(parent, left);
+  if (parent->count < inner_type::capacity)
+  {
+    inner_insert(parent, pos, mystl::move(key), right);
+    return;
+  }
+  // 父节点已满，分裂为 parent 与 sibling，中间的键上移
+  append = append && pos == parent->count;
+  const size_type mid = append ? parent->count - 1 : parent->count / 2;
+  inner_ptr sibling = spare;
+  spare = static_cast<inner_ptr>(spare->parent);
+  sibling->parent = nullptr;
+  const size_type moved = parent->count - mid - 1;
+  mystl::bplus_tree_relocate(parent->key(mid + 1), moved, sibling->key(0));
+  for (size_type i = 0; i <= moved; ++i)
+  {
+    sibling->children[i] = parent->children[mid + 1 + i];
+    sibling->children[i]->parent = sibling;
+  }
+  sibling->count = moved;
+  key_type up(mystl::move(*parent->key(mid)));
+  mystl::destroy(parent->key(mid));
+  parent->count = mid;
+  if (pos <= mid)
+    inner_insert(parent, pos, mystl::move(key), right);
+  else
+    inner_insert(sibling, pos - mid - 1, mystl::move(key), right);
+  insert_into_parent(parent, mystl::move(up), sibling, append, spare);
+}
+
+// 在未满的内部节点中，把分隔键 key 插入到第 pos 个位置，child 插入到第 pos + 1 个子节点的位置
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+inner_insert(inner_ptr inner, size_type pos, key_type&& key, base_ptr child)
+{
+  mystl::bplus_tree_relocate(inner->key(pos), inner->count - pos, inner->key(pos + 1));
+  mystl::construct(inner->key(pos), mystl::move(key));
+  for (size_type i = inner->count + 1; i > pos + 1; --i)
+    inner->children[i] = inner->children[i - 1];
+  inner->children[pos + 1] = child;
+  child->parent = inner;
+  ++inner->count;
+}
+
+// 子节点在父节点中的位置
+template <class T, class Compare>
+typename bplus_tree<T, Compare>::size_type
+bplus_tree<T, Compare>::
+child_index(inner_ptr parent, base_ptr child)
+{
+  size_type i = 0;
+  while (parent->children[i] != child)
+    ++i;
+  return i;
+}
+
+// 叶节点的元素过少时，先尝试从兄弟节点借一个元素，兄弟节点也不够时与它合并
+// leaf 与 n 随之更新，使它们仍指向被删除元素的下一个元素
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+rebalance_leaf(leaf_ptr& leaf, size_type& n)
+{
+  inner_ptr parent = static_cast<inner_ptr>(leaf->parent);
+  const size_type pos = child_index(parent, leaf);
+  leaf_ptr left = pos > 0 ? static_cast<leaf_ptr>(parent->children[pos - 1]) : nullptr;
+  leaf_ptr right = pos < parent->count ? static_cast<leaf_ptr>(parent->children[pos + 1]) : nullptr;
+  if (left != nullptr && left->count > leaf_type::min_count)
+  { // 借左兄弟的最后一个元素
+    mystl::bplus_tree_relocate(leaf->value(0), leaf->count, leaf->value(1));
+    mystl::bplus_tree_relocate(left->value(left->count - 1), 1, leaf->value(0));
+    --left->count;
+    ++leaf->count;
+    *parent->key(pos - 1) = key_of(leaf, 0);
+    ++n;
+  }
+  else if (right != nullptr && right->count > leaf_type::min_count)
+  { // 借右兄弟的第一个元素
+    mystl::bplus_tree_relocate(right->value(0), 1, leaf->value(leaf->count));
+    mystl::bplus_tree_relocate(right->value(1), right->count - 1, right->value(0));
+    --right->count;
+    ++leaf->count;
+    *parent->key(pos) = key_of(right, 0);
+  }
+  else
+  { // 与兄弟合并，总是把右侧的节点并入左侧的节点
+    leaf_ptr dst = left != nullptr ? left : leaf;
+    leaf_ptr src = left != nullptr ? leaf : right;
+    if (left != nullptr)
+      n += left->count;
+    mystl::bplus_tree_relocate(src->value(0), src->count, dst->value(dst->count));
+    dst->count += src->count;
+    dst->next = src->next;
+    if (src->next != nullptr)
+      src->next->prev = dst;
+    else
+      rightmost_ = dst;
+    leaf_allocator::deallocate(src);
+    leaf = dst;
+    inner_erase(parent, left != nullptr ? pos - 1 : pos);
+  }
+}
+
+// 删除内部节点的第 pos 个分隔键与第 pos + 1 个子节点，之后节点过少时重新平衡
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+inner_erase(inner_ptr inner, size_type pos)
+{
+  mystl::destroy(inner->key(pos));
+  mystl::bplus_tree_relocate(inner->key(pos + 1), inner->count - pos - 1, inner->key(pos));
+  for (size_type i = pos + 1; i < inner->count; ++i)
+    inner->children[i] = inner->children[i + 1];
+  --inner->count;
+  if (inner == root_)
+  {
+    if (inner->count == 0)
+    { // 树降低一层
+      root_ = inner->children[0];
+      root_->parent = nullptr;
+      inner_allocator::deallocate(inner);
+    }
+  }
+  else if (inner->count < inner_type::min_count)
+  {
+    rebalance_inner(inner);
+  }
+}
+
+// 内部节点的分隔键过少时，经由父节点从兄弟节点旋转一个分隔键，兄弟节点也不够时与它合并
+template <class T, class Compare>
+void bplus_tree<T, Compare>::
+rebalance_inner(inner_ptr inner)
+{
+  inner_ptr parent = static_cast<inner_ptr>(inner->parent);
+  const size_type pos = child_index(parent, inner);
+  inner_ptr left = pos > 0 ? static_cast<inner_ptr>(parent->children[pos - 1]) : nullptr;
+  inner_ptr right = pos < parent->count ? static_cast<inner_ptr>(parent->children[pos + 1]) : nullptr;
+  if (left != nullptr && left->count > inner_type::min_count)
+  { // 父节点的分隔键下移到本节点最前，左兄弟的最后一个分隔键上移
+    mystl::bplus_tree_relocate(inner->key(0), inner->count, inner->key(1));
+    for (size_type i = inner->count + 1; i > 0; --i)
+      inner->children[i] = inner->children[i - 1];
+    mystl::bplus_tree_relocate(parent->key(pos - 1), 1, inner->key(0));
+    mystl::bplus_tree_relocate(left->key(left->count - 1), 1, parent->key(pos - 1));
+    inner->children[0] = left->children[left->count];
+    inner->children[0]->parent = inner;
+    --left->count;
+    ++inner->count;
+  }
+  else if (right != nullptr && right->count > inner_type::min_count)
+  { // 父节点的分隔键下移到本节点最后，右兄弟的第一个分隔键上移
+    mystl::bplus_tree_relocate(parent->key(pos), 1, inner->key(inner->count));
+    mystl::bplus_tree_relocate(right->key(0), 1, parent->key(pos));
+    inner->children[inner->count + 1] = right->children[0];
+    inner->children[inner->count + 1]->parent = inner;
+    mystl::bplus_tree_relocate(right->key(1), right->count - 1, right->key(0));
+    for (size_type i = 0; i < right->count; ++i)
+      right->children[i] = right->children[i + 1];
+    --right->count;
+    ++inner->count;
+  }
+  else
+  { // 与兄弟合并，父节点的分隔键下移到两者之间
+    inner_ptr dst = left != nullptr ? left : inner;
+    inner_ptr src = left != nullptr ? inner : right;
+    const size_type key_pos = left != nullptr ? pos - 1 : pos;
+    mystl::construct(dst->key(dst->count), *parent->key(key_pos));
+    mystl::bplus_tree_relocate(src->key(0), src->count, dst->key(dst->count + 1));
+    for (size_type i = 0; i <= src->count; ++i)
+    {
+      dst->children[dst->count + 1 + i] = src->children[i];
+      src->children[i]->parent = dst;
+    }
+    dst->count += src->count + 1;
+    inner_allocator::deallocate(src);
+    inner_erase(parent, key_pos);
+  }
+}
+
+// 重载比较操作符
+template <class T, class Compare>
+bool operator==(const bplus_tree<T, Compare>& lhs, const bplus_tree<T, Compare>& rhs)
+{
+  return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Compare>
+bool operator<(const bplus_tree<T, Compare>& lhs, const bplus_tree<T, Compare>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Compare>
+bool operator!=(const bplus_tree<T, Compare>& lhs, const bplus_tree<T, Compare>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Compare>
+bool operator>(const bplus_tree<T, Compare>& lhs, const bplus_tree<T, Compare>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Compare>
+bool operator<=(const bplus_tree<T, Compare>& lhs, const bplus_tree<T, Compare>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Compare>
+bool operator>=(const bplus_tree<T, Compare>& lhs, const bplus_tree<T, Compare>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare>
+void swap(bplus_tree<T, Compare>& lhs, bplus_tree<T, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_BPLUS_TREE_H_
+
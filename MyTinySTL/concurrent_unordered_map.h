@@ -0,0 +1,470 @@
+﻿#ifndef MYTINYSTL_CONCURRENT_UNORDERED_MAP_H_
+#define MYTINYSTL_CONCURRENT_UNORDERED_MAP_H_
+
+// 这个头文件包含一个读写自旋锁 rw_spinlock 与一个模板类 concurrent_unordered_map
+// rw_spinlock              : 读写自旋锁，写者优先，自旋若干次后让出时间片
+// concurrent_unordered_map : 分片的并发哈希表，键值按哈希值分到若干个 hashtable 中，每个分片由自己的读写锁保护
+
+// notes:
+//
+// 1. 分片数为 2 的幂，用哈希值乘以黄金分割常数后的高位选择分片，与分片内部按质数取模选择桶的方式相互独立
+// 2. 每个分片按缓存行对齐（见 memory.h 中的 kCacheLineSize），相邻分片的锁不在同一个缓存行中
+// 3. 不提供迭代器，访问元素的操作都在持有分片锁的期间完成：
+//    find_and_apply 在读锁内对元素调用函数，insert_or_assign / erase_if 持有写锁，
+//    for_each 依次或者并行地在各个分片的读锁内遍历元素
+// 4. size 分别读取每个分片的大小，并发修改时只是一个近似值
+// 5. 当 Hash 与 KeyEqual 都声明了 is_transparent 时，查找与删除可以接受任意键值类型
+//
+// 异常保证：
+// mystl::concurrent_unordered_map<Key, T> 满足基本异常保证，insert / insert_or_assign 做强异常安全保证
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "execution.h"
+#include "hashtable.h"
+#include "memory.h"
+
+namespace mystl
+{
+
+// 读写自旋锁
+// state_ 的最低位表示写者持有锁，次低位表示有写者在等待，其余位为读者计数
+// 有写者等待时新的读者不再进入，避免读多写少时写者饥饿
+class rw_spinlock
+{
+private:
+  static constexpr uint32_t kWriter  = 1u;
+  static constexpr uint32_t kPending = 2u;
+  static constexpr uint32_t kReader  = 4u;
+
+  std::atomic<uint32_t> state_;
+
+public:
+  rw_spinlock() noexcept :state_(0) {}
+
+  rw_spinlock(const rw_spinlock&) = delete;
+  rw_spinlock& operator=(const rw_spinlock&) = delete;
+
+  void lock() noexcept
+  {
+    for (unsigned spins = 0; ; ++spins)
+    {
+      uint32_t s = state_.load(std::memory_order_relaxed);
+      if ((s & ~kPending) == 0)
+      { // 没有读者与写者，抢占锁的同时清除等待标记
+        if (state_.compare_exchange_weak(s, kWriter, std::memory_order_acquire,
+                                         std::memory_order_relaxed))
+          return;
+      }
+      else if ((s & kPending) == 0)
+      {
+        state_.fetch_or(kPending, std::memory_order_relaxed);
+      }
+      backoff(spins);
+    }
+  }
+
+  void unlock() noexcept
+  { // 保留其它写者设置的等待标记
+    state_.fetch_and(~kWriter, std::memory_order_release);
+  }
+
+  void lock_shared() noexcept
+  {
+    for (unsigned spins = 0; ; ++spins)
+    {
+      uint32_t s = state_.load(std::memory_order_relaxed);
+      if ((s & (kWriter | kPending)) == 0 &&
+          state_.compare_exchange_weak(s, s + kReader, std::memory_order_acquire,
+                                       std::memory_order_relaxed))
+        return;
+      backoff(spins);
+    }
+  }
+
+  void unlock_shared() noexcept
+  {
+    state_.fetch_sub(kReader, std::memory_order_release);
+  }
+
+private:
+  // 短暂自旋后让出时间片，线程数多于核数时持有锁的线程才能得到运行
+  static void backoff(unsigned spins) noexcept
+  {
+    if (spins >= 16)
+      std::this_thread::yield();
+  }
+};
+
+// 读锁与写锁的 RAII 守卫
+class rw_shared_guard
+{
+private:
+  rw_spinlock& lock_;
+
+public:
+  explicit rw_shared_guard(rw_spinlock& lock) noexcept :lock_(lock) { lock_.lock_shared(); }
+  ~rw_shared_guard() { lock_.unlock_shared(); }
+
+  rw_shared_guard(const rw_shared_guard&) = delete;
+  rw_shared_guard& operator=(const rw_shared_guard&) = delete;
+};
+
+class rw_unique_guard
+{
+private:
+  rw_spinlock& lock_;
+
+public:
+  explicit rw_unique_guard(rw_spinlock& lock) noexcept :lock_(lock) { lock_.lock(); }
+  ~rw_unique_guard() { lock_.unlock(); }
+
+  rw_unique_guard(const rw_unique_guard&) = delete;
+  rw_unique_guard& operator=(const rw_unique_guard&) = delete;
+};
+
+// 模板类 concurrent_unordered_map，键值不允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash
+// 参数四代表键值比较方式，缺省使用 mystl::equal_to
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+class concurrent_unordered_map
+{
+public:
+  typedef Key                               key_type;
+  typedef T                                 mapped_type;
+  typedef mystl::pair<const Key, T>         value_type;
+  typedef Hash                              hasher;
+  typedef KeyEqual                          key_equal;
+  typedef size_t                            size_type;
+
+private:
+  typedef hashtable<value_type, Hash, KeyEqual> table_type;
+
+  // 分片：一把读写锁与一个 hashtable
+  struct alignas(kCacheLineSize) shard
+  {
+    mutable rw_spinlock lock;
+    table_type          table;
+
+    shard(size_type bucket_count, const Hash& hash, const KeyEqual& equal)
+      :table(bucket_count, hash, equal)
+    {
+    }
+  };
+
+  shard*    shards_;
+  size_type shard_count_;
+  size_type shard_shift_;  // shard_count_ == 1 << shard_shift_
+  hasher    hash_;
+
+public:
+  // 构造、析构函数
+  // shard_count 为分片数，向上取为 2 的幂，为 0 时取硬件并发数的 4 倍；bucket_count 为每个分片初始的桶数
+  explicit concurrent_unordered_map(size_type shard_count = 0,
+                                    size_type bucket_count = 16,
+                                    const Hash& hash = Hash(),
+                                    const KeyEqual& equal = KeyEqual());
+  ~concurrent_unordered_map();
+
+  concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+  concurrent_unordered_map& operator=(const concurrent_unordered_map&) = delete;
+
+public:
+  // 容量相关操作
+  bool      empty() const noexcept { return size() == 0; }
+  size_type size()  const noexcept;
+
+  size_type shard_count() const noexcept { return shard_count_; }
+
+  // 插入元素，键值已存在时不做任何操作并返回 false
+  template <class M>
+  bool insert(const key_type& key, M&& obj)
+  { return insert_key(key, mystl::forward<M>(obj), false); }
+  template <class M>
+  bool insert(key_type&& key, M&& obj)
+  { return insert_key(mystl::move(key), mystl::forward<M>(obj), false); }
+
+  // 插入元素，键值已存在时把实值赋为 obj；插入了新元素时返回 true
+  template <class M>
+  bool insert_or_assign(const key_type& key, M&& obj)
+  { return insert_key(key, mystl::forward<M>(obj), true); }
+  template <class M>
+  bool insert_or_assign(key_type&& key, M&& obj)
+  { return insert_key(mystl::move(key), mystl::forward<M>(obj), true); }
+
+  // 删除键值为 key 的元素，返回删除的个数
+  size_type erase(const key_type& key)
+  { return erase_key(key); }
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  size_type erase(const K& key)
+  { return erase_key(key); }
+
+  // 删除所有满足 pred(const value_type&) 的元素，返回删除的个数
+  template <class Predicate>
+  size_type erase_if(Predicate pred);
+
+  void      clear();
+
+  // 查找键值为 key 的元素，找到时把实值复制到 result 并返回 true
+  bool find(const key_type& key, mapped_type& result) const
+  { return find_key(key, result); }
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  bool find(const K& key, mapped_type& result) const
+  { return find_key(key, result); }
+
+  bool contains(const key_type& key) const
+  { return contains_key(key); }
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  bool contains(const K& key) const
+  { return contains_key(key); }
+
+  // 查找键值为 key 的元素，找到时在持有读锁的期间调用 f(const value_type&) 并返回 true
+  template <class Function>
+  bool find_and_apply(const key_type& key, Function f) const
+  { return apply_key(key, f); }
+  template <class K, class Function, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  bool find_and_apply(const K& key, Function f) const
+  { return apply_key(key, f); }
+
+  // 对每个元素调用 f(const value_type&)，逐个分片持有读锁
+  template <class Function>
+  void for_each(Function f) const;
+
+  // 以执行策略并行地对每个元素调用 f(const value_type&)，不同的分片可能在不同的线程中遍历
+  template <class ExecutionPolicy, class Function>
+  enable_if_execution_policy<ExecutionPolicy>
+  for_each(ExecutionPolicy&& policy, Function f) const;
+
+  hasher    hash_function() const { return hash_; }
+
+private:
+  template <class K>
+  shard&    shard_of(const K& key) const;
+
+  template <class K, class M>
+  bool      insert_key(K&& key, M&& obj, bool assign);
+  template <class K>
+  size_type erase_key(const K& key);
+  template <class K>
+  bool      find_key(const K& key, mapped_type& result) const;
+  template <class K>
+  bool      contains_key(const K& key) const;
+  template <class K, class Function>
+  bool      apply_key(const K& key, Function& f) const;
+};
+
+/*****************************************************************************************/
+
+template <class Key, class T, class Hash, class KeyEqual>
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+concurrent_unordered_map(size_type shard_count, size_type bucket_count,
+                         const Hash& hash, const KeyEqual& equal)
+  :shards_(nullptr), shard_count_(1), shard_shift_(0), hash_(hash)
+{
+  if (shard_count == 0)
+  {
+    const size_type hc = std::thread::hardware_concurrency();
+    shard_count = (hc == 0 ? 1 : hc) * 4;
+  }
+  while (shard_count_ < shard_count)
+  {
+    shard_count_ <<= 1;
+    ++shard_shift_;
+  }
+  shards_ = mystl::aligned_allocate<shard>(shard_count_);
+  size_type n = 0;
+  try
+  {
+    for (; n < shard_count_; ++n)
+      mystl::construct(shards_ + n, bucket_count, hash, equal);
+  }
+  catch (...)
+  {
+    mystl::destroy(shards_, shards_ + n);
+    mystl::aligned_deallocate(shards_);
+    throw;
+  }
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+~concurrent_unordered_map()
+{
+  mystl::destroy(shards_, shards_ + shard_count_);
+  mystl::aligned_deallocate(shards_);
+}
+
+// 各个分片大小之和
+template <class Key, class T, class Hash, class KeyEqual>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::size_type
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+size() const noexcept
+{
+  size_type result = 0;
+  for (size_type i = 0; i < shard_count_; ++i)
+  {
+    rw_shared_guard guard(shards_[i].lock);
+    result += shards_[i].table.size();
+  }
+  return result;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+template <class Predicate>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::size_type
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+erase_if(Predicate pred)
+{
+  size_type result = 0;
+  for (size_type i = 0; i < shard_count_; ++i)
+  {
+    table_type& table = shards_[i].table;
+    rw_unique_guard guard(shards_[i].lock);
+    for (auto it = table.begin(); it != table.end(); )
+    { // 删除一个节点只会使指向它的迭代器失效
+      auto cur = it;
+      ++it;
+      if (pred(*cur))
+      {
+        table.erase(cur);
+        ++result;
+      }
+    }
+  }
+  return result;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+clear()
+{
+  for (size_type i = 0; i < shard_count_; ++i)
+  {
+    rw_unique_guard guard(shards_[i].lock);
+    shards_[i].table.clear();
+  }
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+template <class Function>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+for_each(Function f) const
+{
+  for (size_type i = 0; i < shard_count_; ++i)
+  {
+    rw_shared_guard guard(shards_[i].lock);
+    const table_type& table = shards_[i].table;
+    for (auto it = table.begin(); it != table.end(); ++it)
+      f(*it);
+  }
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+template <class ExecutionPolicy, class Function>
+enable_if_execution_policy<ExecutionPolicy>
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+for_each(ExecutionPolicy&& policy, Function f) const
+{
+  const size_type concurrency = policy.concurrency();
+  const size_type chunks = concurrency < shard_count_ ? concurrency : shard_count_;
+  mystl::parallel_run(policy, shard_count_, chunks, [&](size_t b, size_t e, size_t)
+  {
+    for (size_t i = b; i < e; ++i)
+    {
+      rw_shared_guard guard(shards_[i].lock);
+      const table_type& table = shards_[i].table;
+      for (auto it = table.begin(); it != table.end(); ++it)
+        f(*it);
+    }
+  });
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 用哈希值乘以黄金分割常数后的高 shard_shift_ 位选择分片
+template <class Key, class T, class Hash, class KeyEqual>
+template <class K>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::shard&
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+shard_of(const K& key) const
+{
+  if (shard_shift_ == 0)
+    return shards_[0];
+  const uint64_t h = static_cast<uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+  return shards_[static_cast<size_type>(h >> (64 - shard_shift_))];
+}
+
+// 插入或赋值，先在写锁内查找，键值已存在时根据 assign 决定是否赋值
+template <class Key, class T, class Hash, class KeyEqual>
+template <class K, class M>
+bool concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+insert_key(K&& key, M&& obj, bool assign)
+{
+  shard& s = shard_of(key);
+  rw_unique_guard guard(s.lock);
+  auto it = s.table.find(key);
+  if (it.node != nullptr)
+  {
+    if (assign)
+      it->second = mystl::forward<M>(obj);
+    return false;
+  }
+  s.table.emplace_unique(mystl::forward<K>(key), mystl::forward<M>(obj));
+  return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+template <class K>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::size_type
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+erase_key(const K& key)
+{
+  shard& s = shard_of(key);
+  rw_unique_guard guard(s.lock);
+  return s.table.erase_unique(key);
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+template <class K>
+bool concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+find_key(const K& key, mapped_type& result) const
+{
+  const shard& s = shard_of(key);
+  rw_shared_guard guard(s.lock);
+  auto it = s.table.find(key);
+  if (it.node == nullptr)
+    return false;
+  result = it->second;
+  return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+template <class K>
+bool concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+contains_key(const K& key) const
+{
+  const shard& s = shard_of(key);
+  rw_shared_guard guard(s.lock);
+  return s.table.find(key).node != nullptr;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+template <class K, class Function>
+bool concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+apply_key(const K& key, Function& f) const
+{
+  const shard& s = shard_of(key);
+  rw_shared_guard guard(s.lock);
+  auto it = s.table.find(key);
+  if (it.node == nullptr)
+    return false;
+  f(*it);
+  return true;
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_CONCURRENT_UNORDERED_MAP_H_
+
@@ -0,0 +1,726 @@
+﻿#ifndef MYTINYSTL_CUCKOO_MAP_H_
+#define MYTINYSTL_CUCKOO_MAP_H_
+
+// 这个头文件包含一个模板类 cuckoo_map
+// cuckoo_map : 分桶布谷鸟哈希表，每个桶有 4 个槽位，每个键值只可能位于两个候选桶中，键值不允许重复
+
+// notes:
+//
+// 1. 对 mystl::hash 的结果再做一次混合，低位决定第一个候选桶，高 8 位作为标签（0 表示空槽），
+//    第二个候选桶为第一个候选桶异或标签的哈希值，因此由任意一个候选桶与标签就能算出另一个
+// 2. 查找只检查两个候选桶，先比较标签，标签相同才比较键值，最坏情况下也只比较 8 个槽位。
+//    桶按缓存行对齐，4 * sizeof(value_type) + 4 不超过 64 字节时，一次查找最多访问两个缓存行
+// 3. 两个候选桶都满时，从这两个桶开始广度优先搜索一条最多 5 步的挪动路径，
+//    沿路径把元素逐个挪到它的另一个候选桶，腾出空位。找不到路径时把桶数加倍并重新插入所有元素。
+//    两个候选桶的 8 个槽位已被哈希值完全相同的键值占满时，扩容也无济于事，插入抛出 length_error；
+//    单次插入最多连续扩容 kMaxGrow 次，仍找不到空位时同样抛出 length_error
+// 4. 桶数总是 2 的幂，通常装载率达到 90% 以上才需要扩容
+// 5. 插入可能挪动其它元素，会使所有迭代器、指针与引用失效；删除只使指向被删除元素的失效
+//
+// 异常保证：
+// mystl::cuckoo_map<Key, T> 在 value_type 的移动构造函数不抛出异常时满足基本异常保证
+
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 一个桶：4 个标签与 4 个未初始化的槽位，按缓存行对齐，大小为 64 字节的整数倍
+template <class Value>
+struct alignas(64) cuckoo_bucket
+{
+  typedef typename std::aligned_storage<sizeof(Value), alignof(Value)>::type storage_type;
+
+  unsigned char tags[4];
+  storage_type  slots[4];
+
+  Value&       value(size_t i)       { return *reinterpret_cast<Value*>(&slots[i]); }
+  const Value& value(size_t i) const { return *reinterpret_cast<const Value*>(&slots[i]); }
+};
+
+// cuckoo_map 的迭代器，pos 为 桶号 * 4 + 槽号
+template <class Value, bool IsConst>
+struct cuckoo_map_iterator
+{
+  typedef cuckoo_bucket<Value>                                        bucket_type;
+  typedef typename std::conditional<IsConst, const bucket_type*, bucket_type*>::type
+                                                                      bucket_ptr;
+
+  typedef mystl::forward_iterator_tag                                 iterator_category;
+  typedef Value                                                       value_type;
+  typedef typename std::conditional<IsConst, const Value*, Value*>::type pointer;
+  typedef typename std::conditional<IsConst, const Value&, Value&>::type reference;
+  typedef ptrdiff_t                                                   difference_type;
+
+  typedef cuckoo_map_iterator<Value, IsConst>                         self;
+
+  bucket_ptr buckets;
+  size_t     end_pos;  // 桶数 * 4
+  size_t     pos;
+
+  cuckoo_map_iterator() :buckets(nullptr), end_pos(0), pos(0) {}
+  cuckoo_map_iterator(bucket_ptr b, size_t e, size_t p) :buckets(b), end_pos(e), pos(p) {}
+
+  // iterator 可以转换为 const_iterator
+  template <bool C, typename std::enable_if<IsConst && !C, int>::type = 0>
+  cuckoo_map_iterator(const cuckoo_map_iterator<Value, C>& rhs)
+    :buckets(rhs.buckets), end_pos(rhs.end_pos), pos(rhs.pos)
+  {
+  }
+
+  reference operator*()  const { return buckets[pos >> 2].value(pos & 3); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    MYSTL_DEBUG(pos < end_pos);
+    while (++pos < end_pos && buckets[pos >> 2].tags[pos & 3] == 0) {}
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+};
+
+template <class Value, bool C1, bool C2>
+bool operator==(const cuckoo_map_iterator<Value, C1>& lhs, const cuckoo_map_iterator<Value, C2>& rhs)
+{
+  return lhs.pos == rhs.pos;
+}
+
+template <class Value, bool C1, bool C2>
+bool operator!=(const cuckoo_map_iterator<Value, C1>& lhs, const cuckoo_map_iterator<Value, C2>& rhs)
+{
+  return lhs.pos != rhs.pos;
+}
+
+// 模板类 cuckoo_map
+// 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash
+// 参数四代表键值比较方式，缺省使用 mystl::equal_to
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+class cuckoo_map
+{
+public:
+  typedef Key                                       key_type;
+  typedef T                                         mapped_type;
+  typedef mystl::pair<const Key, T>                 value_type;
+  typedef Hash                                      hasher;
+  typedef KeyEqual                                  key_equal;
+
+  typedef size_t                                    size_type;
+  typedef ptrdiff_t                                 difference_type;
+  typedef value_type&                               reference;
+  typedef const value_type&                         const_reference;
+
+  typedef mystl::cuckoo_map_iterator<value_type, false> iterator;
+  typedef mystl::cuckoo_map_iterator<value_type, true>  const_iterator;
+
+private:
+  typedef mystl::cuckoo_bucket<value_type>          bucket_type;
+  typedef mystl::allocator<char>                    byte_allocator;
+
+  static constexpr size_type kSlots      = 4;    // 每个桶的槽位数
+  static constexpr size_type kCacheLine  = 64;
+  static constexpr size_type kMinBuckets = 2;
+  static constexpr int       kMaxDepth   = 5;    // 挪动路径的最大长度
+  static constexpr int       kMaxQueue   = 256;  // 广度优先搜索最多访问的桶数
+  static constexpr int       kMaxGrow    = 4;    // 单次插入最多连续扩容的次数
+  static constexpr size_type npos        = static_cast<size_type>(-1);
+
+  // 广度优先搜索的节点：parent 为上一个节点在队列中的位置，slot 为上一个桶中被挪到本桶的槽位
+  struct bfs_entry
+  {
+    size_type bucket;
+    int       parent;
+    int       slot;
+    int       depth;
+  };
+
+  char*        raw_;           // 分配得到的内存，buckets_ 在其中按缓存行对齐
+  bucket_type* buckets_;
+  size_type    bucket_count_;  // 2 的幂，为 0 表示还没有分配
+  size_type    mask_;
+  size_type    size_;
+  hasher       hash_;
+  key_equal    equal_;
+
+public:
+  // 构造、复制、移动、析构函数
+  explicit cuckoo_map(size_type n = 0,
+                      const Hash& hash = Hash(),
+                      const KeyEqual& equal = KeyEqual())
+    :raw_(nullptr), buckets_(nullptr), bucket_count_(0), mask_(0), size_(0),
+    hash_(hash), equal_(equal)
+  {
+    init(buckets_for(n));
+  }
+
+  template <class InputIter, typename std::enable_if<
+    mystl::is_input_iterator<InputIter>::value, int>::type = 0>
+  cuckoo_map(InputIter first, InputIter last, size_type n = 0,
+             const Hash& hash = Hash(),
+             const KeyEqual& equal = KeyEqual())
+    :raw_(nullptr), buckets_(nullptr), bucket_count_(0), mask_(0), size_(0),
+    hash_(hash), equal_(equal)
+  {
+    init(buckets_for(mystl::max(n, static_cast<size_type>(mystl::distance(first, last)))));
+    insert(first, last);
+  }
+
+  cuckoo_map(std::initializer_list<value_type> ilist, size_type n = 0,
+             const Hash& hash = Hash(),
+             const KeyEqual& equal = KeyEqual())
+    :raw_(nullptr), buckets_(nullptr), bucket_count_(0), mask_(0), size_(0),
+    hash_(hash), equal_(equal)
+  {
+    init(buckets_for(mystl::max(n, static_cast<size_type>(ilist.size()))));
+    insert(ilist.begin(), ilist.end());
+  }
+
+  cuckoo_map(const cuckoo_map& rhs);
+  cuckoo_map(cuckoo_map&& rhs) noexcept
+    :raw_(rhs.raw_), buckets_(rhs.buckets_), bucket_count_(rhs.bucket_count_),
+    mask_(rhs.mask_), size_(rhs.size_), hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    rhs.raw_ = nullptr;
+    rhs.buckets_ = nullptr;
+    rhs.bucket_count_ = 0;
+    rhs.mask_ = 0;
+    rhs.size_ = 0;
+  }
+
+  cuckoo_map& operator=(const cuckoo_map& rhs)
+  {
+    if (this != &rhs)
+    {
+      cuckoo_map tmp(rhs);
+      swap(tmp);
+    }
+    return *this;
+  }
+  cuckoo_map& operator=(cuckoo_map&& rhs) noexcept
+  {
+    cuckoo_map tmp(mystl::move(rhs));
+    swap(tmp);
+    return *this;
+  }
+
+  ~cuckoo_map()
+  {
+    clear();
+    deallocate();
+  }
+
+  // 迭代器相关操作
+  iterator       begin()        noexcept
+  { return iterator(buckets_, end_pos(), first_pos()); }
+  const_iterator begin()  const noexcept
+  { return const_iterator(buckets_, end_pos(), first_pos()); }
+  iterator       end()          noexcept
+  { return iterator(buckets_, end_pos(), end_pos()); }
+  const_iterator end()    const noexcept
+  { return const_iterator(buckets_, end_pos(), end_pos()); }
+
+  const_iterator cbegin() const noexcept
+  { return begin(); }
+  const_iterator cend()   const noexcept
+  { return end(); }
+
+  // 容量相关操作
+  bool      empty()        const noexcept { return size_ == 0; }
+  size_type size()         const noexcept { return size_; }
+  size_type max_size()     const noexcept { return static_cast<size_type>(-1) / sizeof(bucket_type); }
+  size_type bucket_count() const noexcept { return bucket_count_; }
+  size_type capacity()     const noexcept { return bucket_count_ * kSlots; }
+  float     load_factor()  const noexcept
+  { return bucket_count_ != 0 ? (float)size_ / (float)capacity() : 0.0f; }
+
+  // 修改容器相关操作
+
+  pair<iterator, bool> insert(const value_type& value)
+  { return insert_value(value); }
+  pair<iterator, bool> insert(value_type&& value)
+  { return insert_value(mystl::move(value)); }
+
+  template <class InputIter>
+  void insert(InputIter first, InputIter last)
+  {
+    for (; first != last; ++first)
+      insert_value(*first);
+  }
+
+  template <class ...Args>
+  pair<iterator, bool> emplace(Args&& ...args)
+  { return insert_value(value_type(mystl::forward<Args>(args)...)); }
+
+  template <class M>
+  pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+  { return insert_value(value_type(key, mystl::forward<M>(obj)), true); }
+
+  void      erase(const_iterator position);
+  size_type erase(const key_type& key);
+  void      clear();
+
+  void      swap(cuckoo_map& rhs) noexcept;
+
+  // 查找相关操作
+  mapped_type& at(const key_type& key)
+  {
+    const size_type pos = locate(key);
+    THROW_OUT_OF_RANGE_IF(pos == npos, "cuckoo_map<Key, T> no such element exists");
+    return slot(pos).second;
+  }
+  const mapped_type& at(const key_type& key) const
+  {
+    const size_type pos = locate(key);
+    THROW_OUT_OF_RANGE_IF(pos == npos, "cuckoo_map<Key, T> no such element exists");
+    return slot(pos).second;
+  }
+
+  mapped_type& operator[](const key_type& key)
+  {
+    const size_type pos = locate(key);
+    if (pos != npos)
+      return slot(pos).second;
+    return insert_value(value_type(key, T{})).first->second;
+  }
+
+  iterator       find(const key_type& key)
+  {
+    const size_type pos = locate(key);
+    return iterator(buckets_, end_pos(), pos == npos ? end_pos() : pos);
+  }
+  const_iterator find(const key_type& key) const
+  {
+    const size_type pos = locate(key);
+    return const_iterator(buckets_, end_pos(), pos == npos ? end_pos() : pos);
+  }
+
+  size_type count(const key_type& key)    const
+  { return locate(key) != npos ? 1 : 0; }
+  bool      contains(const key_type& key) const
+  { return locate(key) != npos; }
+
+  // hash policy
+  void rehash(size_type count);
+  void reserve(size_type count)
+  { rehash(buckets_for(count)); }
+
+  hasher    hash_function() const { return hash_; }
+  key_equal key_eq()        const { return equal_; }
+
+private:
+  // helper functions
+
+  // 对用户的哈希值再做一次混合（MurmurHash3 的 fmix64），避免恒等哈希让低位与高位相关
+  static uint64_t mix(uint64_t h) noexcept
+  {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+  }
+
+  static unsigned char tag_of(uint64_t h) noexcept
+  {
+    const unsigned char tag = static_cast<unsigned char>(h >> 56);
+    return tag == 0 ? 1 : tag;
+  }
+
+  // 另一个候选桶，对同一个标签做两次得到原来的桶
+  size_type alt_index(size_type index, unsigned char tag) const noexcept
+  {
+    return (index ^ (static_cast<size_type>(tag) * 0x5bd1e995u)) & mask_;
+  }
+
+  // 能容纳 n 个元素且装载率不超过 90% 的桶数
+  static size_type buckets_for(size_type n) noexcept
+  {
+    return static_cast<size_type>(n / (kSlots * 0.9)) + 1;
+  }
+
+  size_type end_pos() const noexcept { return bucket_count_ * kSlots; }
+  size_type first_pos() const noexcept
+  {
+    size_type pos = 0;
+    while (pos < end_pos() && buckets_[pos >> 2].tags[pos & 3] == 0)
+      ++pos;
+    return pos;
+  }
+
+  value_type&       slot(size_type pos)       { return buckets_[pos >> 2].value(pos & 3); }
+  const value_type& slot(size_type pos) const { return buckets_[pos >> 2].value(pos & 3); }
+
+  size_type locate(const key_type& key) const;
+  size_type find_free(uint64_t h);
+  size_type bfs_free(size_type i1, size_type i2);
+  bool      same_hash_full(uint64_t h) const;
+
+  template <class V>
+  pair<iterator, bool> insert_value(V&& value, bool assign = false);
+
+  void init(size_type n);
+  void deallocate() noexcept;
+};
+
+/*****************************************************************************************/
+
+// 复制构造函数，元素复制到相同的槽位
+template <class Key, class T, class Hash, class KeyEqual>
+cuckoo_map<Key, T, Hash, KeyEqual>::
+cuckoo_map(const cuckoo_map& rhs)
+  :raw_(nullptr), buckets_(nullptr), bucket_count_(0), mask_(0), size_(0),
+  hash_(rhs.hash_), equal_(rhs.equal_)
+{
+  if (rhs.bucket_count_ == 0)
+    return;
+  init(rhs.bucket_count_);
+  try
+  {
+    for (size_type pos = 0; pos < end_pos(); ++pos)
+    {
+      const unsigned char tag = rhs.buckets_[pos >> 2].tags[pos & 3];
+      if (tag != 0)
+      {
+        mystl::construct(&slot(pos), rhs.slot(pos));
+        buckets_[pos >> 2].tags[pos & 3] = tag;
+        ++size_;
+      }
+    }
+  }
+  catch (...)
+  {
+    clear();
+    deallocate();
+    throw;
+  }
+}
+
+// 删除迭代器所指的元素
+template <class Key, class T, class Hash, class KeyEqual>
+void cuckoo_map<Key, T, Hash, KeyEqual>::
+erase(const_iterator position)
+{
+  const size_type pos = position.pos;
+  MYSTL_DEBUG(pos < end_pos() && buckets_[pos >> 2].tags[pos & 3] != 0);
+  mystl::destroy(&slot(pos));
+  buckets_[pos >> 2].tags[pos & 3] = 0;
+  --size_;
+}
+
+// 删除键值为 key 的元素，返回删除的个数
+template <class Key, class T, class Hash, class KeyEqual>
+typename cuckoo_map<Key, T, Hash, KeyEqual>::size_type
+cuckoo_map<Key, T, Hash, KeyEqual>::
+erase(const key_type& key)
+{
+  const size_type pos = locate(key);
+  if (pos == npos)
+    return 0;
+  mystl::destroy(&slot(pos));
+  buckets_[pos >> 2].tags[pos & 3] = 0;
+  --size_;
+  return 1;
+}
+
+// 清空容器，保留桶数组
+template <class Key, class T, class Hash, class KeyEqual>
+void cuckoo_map<Key, T, Hash, KeyEqual>::
+clear()
+{
+  for (size_type pos = 0; size_ != 0 && pos < end_pos(); ++pos)
+  {
+    if (buckets_[pos >> 2].tags[pos & 3] != 0)
+    {
+      mystl::destroy(&slot(pos));
+      buckets_[pos >> 2].tags[pos & 3] = 0;
+      --size_;
+    }
+  }
+}
+
+// 交换 cuckoo_map
+template <class Key, class T, class Hash, class KeyEqual>
+void cuckoo_map<Key, T, Hash, KeyEqual>::
+swap(cuckoo_map& rhs) noexcept
+{
+  if (this != &rhs)
+  {
+    mystl::swap(raw_, rhs.raw_);
+    mystl::swap(buckets_, rhs.buckets_);
+    mystl::swap(bucket_count_, rhs.bucket_count_);
+    mystl::swap(mask_, rhs.mask_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(hash_, rhs.hash_);
+    mystl::swap(equal_, rhs.equal_);
+  }
+}
+
+// 把桶数调整为不小于 count 且能容纳现有元素的 2 的幂，重新插入所有元素
+// 新表中插入失败时由新表自己继续扩容
+template <class Key, class T, class Hash, class KeyEqual>
+void cuckoo_map<Key, T, Hash, KeyEqual>::
+rehash(size_type count)
+{
+  count = mystl::max(count, (size_ + kSlots - 1) / kSlots);
+  size_type n = kMinBuckets;
+  while (n < count)
+    n <<= 1;
+  if (n == bucket_count_)
+    return;
+  cuckoo_map tmp(0, hash_, equal_);
+  tmp.deallocate();  // 换成 n 个桶
+  tmp.init(n);
+  for (size_type pos = 0; size_ != 0 && pos < end_pos(); ++pos)
+  {
+    if (buckets_[pos >> 2].tags[pos & 3] != 0)
+    {
+      tmp.insert_value(mystl::move(slot(pos)));
+      mystl::destroy(&slot(pos));
+      buckets_[pos >> 2].tags[pos & 3] = 0;
+      --size_;
+    }
+  }
+  swap(tmp);
+}
+
+// 查找键值所在的槽位，找不到时返回 npos
+template <class Key, class T, class Hash, class KeyEqual>
+typename cuckoo_map<Key, T, Hash, KeyEqual>::size_type
+cuckoo_map<Key, T, Hash, KeyEqual>::
+locate(const key_type& key) const
+{
+  if (bucket_count_ == 0)
+    return npos;
+  const uint64_t h = mix(static_cast<uint64_t>(hash_(key)));
+  const unsigned char tag = tag_of(h);
+  const size_type i1 = static_cast<size_type>(h) & mask_;
+  const size_type i2 = alt_index(i1, tag);
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(&buckets_[i2]);
+#endif
+  const bucket_type& b1 = buckets_[i1];
+  for (size_type s = 0; s < kSlots; ++s)
+  {
+    if (b1.tags[s] == tag && equal_(b1.value(s).first, key))
+      return i1 * kSlots + s;
+  }
+  const bucket_type& b2 = buckets_[i2];
+  for (size_type s = 0; s < kSlots; ++s)
+  {
+    if (b2.tags[s] == tag && equal_(b2.value(s).first, key))
+      return i2 * kSlots + s;
+  }
+  return npos;
+}
+
+// 为哈希值为 h 的新元素找一个空槽位，必要时挪动其它元素，找不到时返回 npos
+template <class Key, class T, class Hash, class KeyEqual>
+typename cuckoo_map<Key, T, Hash, KeyEqual>::size_type
+cuckoo_map<Key, T, Hash, KeyEqual>::
+find_free(uint64_t h)
+{
+  const size_type i1 = static_cast<size_type>(h) & mask_;
+  const size_type i2 = alt_index(i1, tag_of(h));
+  for (size_type s = 0; s < kSlots; ++s)
+  {
+    if (buckets_[i1].tags[s] == 0)
+      return i1 * kSlots + s;
+  }
+  for (size_type s = 0; s < kSlots; ++s)
+  {
+    if (buckets_[i2].tags[s] == 0)
+      return i2 * kSlots + s;
+  }
+  return bfs_free(i1, i2);
+}
+
+// 从两个候选桶开始广度优先搜索一个有空槽位的桶，再沿路径从后往前挪动元素，
+// 最终在 i1 或 i2 中腾出一个空槽位，返回它的位置
+template <class Key, class T, class Hash, class KeyEqual>
+typename cuckoo_map<Key, T, Hash, KeyEqual>::size_type
+cuckoo_map<Key, T, Hash, KeyEqual>::
+bfs_free(size_type i1, size_type i2)
+{
+  bfs_entry queue[kMaxQueue];
+  int head = 0;
+  int tail = 0;
+  queue[tail++] = bfs_entry{ i1, -1, -1, 0 };
+  if (i2 != i1)
+    queue[tail++] = bfs_entry{ i2, -1, -1, 0 };
+  int found = -1;
+  int free_slot = -1;
+  for (; head < tail && found < 0; ++head)
+  {
+    const bfs_entry cur = queue[head];
+    const bucket_type& b = buckets_[cur.bucket];
+    for (int s = 0; s < static_cast<int>(kSlots); ++s)
+    {
+      if (b.tags[s] == 0)
+      {
+        found = head;
+        free_slot = s;
+        break;
+      }
+    }
+    if (found >= 0 || cur.depth >= kMaxDepth)
+      continue;
+    for (int s = 0; s < static_cast<int>(kSlots) && tail < kMaxQueue; ++s)
+    {
+      const size_type next = alt_index(cur.bucket, b.tags[s]);
+      bool on_path = false;
+      for (int p = head; p >= 0 && !on_path; p = queue[p].parent)
+        on_path = queue[p].bucket == next;
+      if (!on_path)  // 路径上重复出现的桶会让挪动互相覆盖
+        queue[tail++] = bfs_entry{ next, head, s, cur.depth + 1 };
+    }
+  }
+  if (found < 0)
+    return npos;
+  // 从路径末端开始，把上一个桶中的元素挪到本桶的空槽位，空槽位随之前移
+  for (int e = found; queue[e].parent >= 0; e = queue[e].parent)
+  {
+    bucket_type& from = buckets_[queue[queue[e].parent].bucket];
+    bucket_type& to = buckets_[queue[e].bucket];
+    const int s = queue[e].slot;
+    mystl::construct(&to.value(free_slot), mystl::move(from.value(s)));
+    to.tags[free_slot] = from.tags[s];
+    mystl::destroy(&from.value(s));
+    from.tags[s] = 0;
+    free_slot = s;
+    found = queue[e].parent;
+  }
+  return queue[found].bucket * kSlots + free_slot;
+}
+
+// 哈希值为 h 的两个候选桶是否不同，且其中的槽位全被哈希值也为 h 的元素占满
+// 此时无论桶数多大，这些元素都只能落在同样的两个桶中
+template <class Key, class T, class Hash, class KeyEqual>
+bool cuckoo_map<Key, T, Hash, KeyEqual>::
+same_hash_full(uint64_t h) const
+{
+  const size_type i1 = static_cast<size_type>(h) & mask_;
+  const size_type i2 = alt_index(i1, tag_of(h));
+  if (i1 == i2)
+    return false;
+  for (size_type s = 0; s < kSlots; ++s)
+  {
+    if (buckets_[i1].tags[s] == 0 || buckets_[i2].tags[s] == 0 ||
+        mix(static_cast<uint64_t>(hash_(buckets_[i1].value(s).first))) != h ||
+        mix(static_cast<uint64_t>(hash_(buckets_[i2].value(s).first))) != h)
+      return false;
+  }
+  return true;
+}
+
+// 插入一个元素，键值已经存在时根据 assign 决定是否覆盖实值
+template <class Key, class T, class Hash, class KeyEqual>
+template <class V>
+pair<typename cuckoo_map<Key, T, Hash, KeyEqual>::iterator, bool>
+cuckoo_map<Key, T, Hash, KeyEqual>::
+insert_value(V&& value, bool assign)
+{
+  if (bucket_count_ == 0)
+    init(kMinBuckets);
+  size_type pos = locate(value.first);
+  if (pos != npos)
+  {
+    if (assign)
+      slot(pos).second = mystl::forward<V>(value).second;
+    return mystl::make_pair(iterator(buckets_, end_pos(), pos), false);
+  }
+  const uint64_t h = mix(static_cast<uint64_t>(hash_(value.first)));
+  for (int grow = 0; (pos = find_free(h)) == npos; ++grow)
+  {
+    THROW_LENGTH_ERROR_IF(grow == kMaxGrow || same_hash_full(h),
+                          "cuckoo_map<Key, T> too many keys with the same hash");
+    rehash(bucket_count_ * 2);
+  }
+  mystl::construct(&slot(pos), mystl::forward<V>(value));
+  buckets_[pos >> 2].tags[pos & 3] = tag_of(h);
+  ++size_;
+  return mystl::make_pair(iterator(buckets_, end_pos(), pos), true);
+}
+
+// 分配 n 个桶（n 调整为 2 的幂），桶数组的起始地址按缓存行对齐
+template <class Key, class T, class Hash, class KeyEqual>
+void cuckoo_map<Key, T, Hash, KeyEqual>::
+init(size_type n)
+{
+  size_type count = kMinBuckets;
+  while (count < n)
+    count <<= 1;
+  raw_ = byte_allocator::allocate(count * sizeof(bucket_type) + kCacheLine);
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(raw_);
+  buckets_ = reinterpret_cast<bucket_type*>((addr + kCacheLine - 1) & ~(uintptr_t)(kCacheLine - 1));
+  for (size_type i = 0; i < count; ++i)
+  {
+    for (size_type s = 0; s < kSlots; ++s)
+      buckets_[i].tags[s] = 0;
+  }
+  bucket_count_ = count;
+  mask_ = count - 1;
+}
+
+// 释放桶数组，元素必须已经析构
+template <class Key, class T, class Hash, class KeyEqual>
+void cuckoo_map<Key, T, Hash, KeyEqual>::
+deallocate() noexcept
+{
+  if (raw_ != nullptr)
+  {
+    byte_allocator::deallocate(raw_);
+    raw_ = nullptr;
+  }
+  buckets_ = nullptr;
+  bucket_count_ = 0;
+  mask_ = 0;
+}
+
+// 重载比较操作符
+template <class Key, class T, class Hash, class KeyEqual>
+bool operator==(const cuckoo_map<Key, T, Hash, KeyEqual>& lhs,
+                const cuckoo_map<Key, T, Hash, KeyEqual>& rhs)
+{
+  if (lhs.size() != rhs.size())
+    return false;
+  for (auto it = lhs.begin(); it != lhs.end(); ++it)
+  {
+    auto res = rhs.find(it->first);
+    if (res == rhs.end() || !(res->second == it->second))
+      return false;
+  }
+  return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+bool operator!=(const cuckoo_map<Key, T, Hash, KeyEqual>& lhs,
+                const cuckoo_map<Key, T, Hash, KeyEqual>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Hash, class KeyEqual>
+void swap(cuckoo_map<Key, T, Hash, KeyEqual>& lhs,
+          cuckoo_map<Key, T, Hash, KeyEqual>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_CUCKOO_MAP_H_
+
@@ -0,0 +1,339 @@
+﻿#ifndef MYTINYSTL_EBR_H_
+#define MYTINYSTL_EBR_H_
+
+// 这个头文件包含基于纪元的内存回收（epoch-based reclamation）：类 ebr 与 ebr_guard
+// ebr       : 线程登记、延迟回收与统计，所有无锁容器共用一个全局纪元
+// ebr_guard : 在作用域内钉住当前纪元，期间读到的节点不会被释放
+
+// notes:
+//
+// 1. 每个线程第一次使用时登记一个线程记录，线程退出或调用 unregister_thread 时归还，
+//    归还的记录连同其中还未释放的对象由之后登记的线程接手，或由其它线程调用 flush 时回收，
+//    记录本身在进程结束前不释放
+// 2. 线程被钉住时在记录中声明它读到的全局纪元。只有所有被钉住的线程都处于当前纪元时，全局纪元才能加一，
+//    因此在纪元 e 摘除的对象，等到全局纪元不小于 e + 2 时已经没有线程能访问它
+// 3. 每个线程有三个待回收列表，按摘除时的纪元模 3 存放，一个列表中的对象总是整批释放
+// 4. retire(T*) 释放对象时调用 mystl::destroy 再用 mystl::allocator<T> 归还内存，
+//    对象必须是用 mystl::allocator<T> 分配的
+// 5. 一个被钉住而长期不离开的线程会阻止纪元推进，期间所有线程摘除的对象都无法释放
+//
+// 异常保证：
+// retire 在登记对象时可能因为内存不足抛出异常，此时对象尚未登记，由调用者处理
+
+#include <atomic>
+#include <cstdint>
+
+#include "exceptdef.h"
+#include "memory.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+class ebr
+{
+  friend class ebr_guard;
+
+public:
+  typedef void (*deleter_type)(void*);
+
+private:
+  struct retired
+  {
+    void*        ptr;
+    deleter_type deleter;
+  };
+
+  // 线程记录，state 为 0 表示未被钉住，否则为 (纪元 << 1) | 1
+  // 除 state、in_use 与 pending 外，其余成员只由持有记录的线程访问，每个记录独占缓存行
+  struct alignas(kCacheLineSize) record
+  {
+    std::atomic<uint64_t>  state;
+    std::atomic<bool>      in_use;
+    std::atomic<size_t>    pending;        // 三个列表中对象的总数，供统计使用
+    record*                next;
+    unsigned               depth;          // 嵌套钉住的层数
+    size_t                 since_reclaim;  // 上次尝试回收之后登记的对象数
+    uint64_t               limbo_epoch[3];
+    mystl::vector<retired> limbo[3];
+
+    record() :state(0), in_use(true), pending(0), next(nullptr), depth(0), since_reclaim(0)
+    {
+      limbo_epoch[0] = limbo_epoch[1] = limbo_epoch[2] = 0;
+    }
+  };
+
+  // 线程退出时归还线程记录
+  struct holder
+  {
+    record* rec;
+
+    holder() :rec(nullptr) {}
+    ~holder() { release(*this); }
+  };
+
+  static constexpr size_t kReclaimThreshold = 64;  // 每登记这么多对象尝试推进纪元并回收一次
+
+public:
+  // 显式登记与注销当前线程，登记是可选的，第一次使用时会自动登记
+  static void register_thread()   { local(); }
+  static void unregister_thread()
+  {
+    MYSTL_DEBUG(tls().rec == nullptr || tls().rec->depth == 0);
+    release(tls());
+  }
+
+  // 当前线程是否被钉住
+  static bool is_pinned()
+  {
+    record* r = tls().rec;
+    return r != nullptr && r->depth != 0;
+  }
+
+  // 登记一个已经从数据结构中摘除、用 mystl::allocator<T> 分配的对象，在安全时析构并释放它
+  // 必须在 ebr_guard 的作用域内调用
+  template <class T>
+  static void retire(T* ptr)
+  {
+    retire(static_cast<void*>(ptr), &delete_object<T>);
+  }
+
+  // 登记一个对象，在安全时调用 deleter(ptr)
+  static void retire(void* ptr, deleter_type deleter);
+
+  // 尝试推进纪元，并释放当前线程与已注销线程留下的所有已经安全的对象
+  static void flush();
+
+  // 全局纪元
+  static uint64_t epoch()
+  { return global_epoch().load(std::memory_order_acquire); }
+
+  // 所有线程登记之后还未释放的对象数
+  static size_t pending();
+
+  // 正在使用的线程记录数
+  static size_t thread_count();
+
+private:
+  template <class T>
+  static void delete_object(void* p)
+  {
+    T* ptr = static_cast<T*>(p);
+    mystl::destroy(ptr);
+    mystl::allocator<T>::deallocate(ptr);
+  }
+
+  static std::atomic<uint64_t>& global_epoch()
+  {
+    static std::atomic<uint64_t> epoch(0);
+    return epoch;
+  }
+
+  static std::atomic<record*>& records()
+  {
+    static std::atomic<record*> head(nullptr);
+    return head;
+  }
+
+  static holder& tls()
+  {
+    static thread_local holder h;
+    return h;
+  }
+
+  static record& local();
+  static void    release(holder& h);
+
+  static record* pin();
+  static void    unpin(record* r);
+
+  static bool    try_advance();
+  static void    reclaim(record& r, uint64_t e);
+  static void    free_list(record& r, size_t i);
+};
+
+// 在作用域内钉住当前线程，可以嵌套
+class ebr_guard
+{
+private:
+  ebr::record* rec_;
+
+public:
+  ebr_guard()  :rec_(ebr::pin()) {}
+  ~ebr_guard() { ebr::unpin(rec_); }
+
+  ebr_guard(const ebr_guard&) = delete;
+  ebr_guard& operator=(const ebr_guard&) = delete;
+};
+
+/*****************************************************************************************/
+
+inline void ebr::retire(void* ptr, deleter_type deleter)
+{
+  record& r = local();
+  MYSTL_DEBUG(r.depth != 0);
+  // 对象在摘除之后才登记，此时读到的全局纪元不早于摘除时的纪元
+  const uint64_t e = global_epoch().load(std::memory_order_seq_cst);
+  const size_t i = static_cast<size_t>(e % 3);
+  if (r.limbo_epoch[i] != e)
+  { // 列表中是至少三个纪元之前的对象，已经可以释放
+    free_list(r, i);
+    r.limbo_epoch[i] = e;
+  }
+  r.limbo[i].push_back(retired{ ptr, deleter });
+  r.pending.store(r.pending.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  if (++r.since_reclaim >= kReclaimThreshold)
+  {
+    r.since_reclaim = 0;
+    try_advance();
+    reclaim(r, global_epoch().load(std::memory_order_seq_cst));
+  }
+}
+
+inline void ebr::flush()
+{
+  record& r = local();
+  // 当前线程没有被钉住时，最多推进两次就能释放所有已登记的对象
+  for (int i = 0; i < 2 && try_advance(); ++i) {}
+  const uint64_t e = global_epoch().load(std::memory_order_seq_cst);
+  reclaim(r, e);
+  r.since_reclaim = 0;
+  // 暂时接手已注销线程的记录，回收其中的对象后再归还
+  for (record* p = records().load(std::memory_order_acquire); p; p = p->next)
+  {
+    bool expected = false;
+    if (p->pending.load(std::memory_order_relaxed) != 0 &&
+        !p->in_use.load(std::memory_order_relaxed) &&
+        p->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+    {
+      reclaim(*p, e);
+      p->in_use.store(false, std::memory_order_release);
+    }
+  }
+}
+
+inline size_t ebr::pending()
+{
+  size_t result = 0;
+  for (record* p = records().load(std::memory_order_acquire); p; p = p->next)
+    result += p->pending.load(std::memory_order_relaxed);
+  return result;
+}
+
+inline size_t ebr::thread_count()
+{
+  size_t result = 0;
+  for (record* p = records().load(std::memory_order_acquire); p; p = p->next)
+    result += p->in_use.load(std::memory_order_relaxed) ? 1 : 0;
+  return result;
+}
+
+// 当前线程的记录，先尝试接手已注销线程归还的记录，否则新建一个并加入链表
+inline ebr::record& ebr::local()
+{
+  holder& h = tls();
+  if (h.rec == nullptr)
+  {
+    for (record* p = records().load(std::memory_order_acquire); p; p = p->next)
+    {
+      bool expected = false;
+      if (!p->in_use.load(std::memory_order_relaxed) &&
+          p->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+      {
+        h.rec = p;
+        return *p;
+      }
+    }
+    record* p = mystl::aligned_allocate<record>(1);
+    try
+    {
+      mystl::construct(p);
+    }
+    catch (...)
+    {
+      mystl::aligned_deallocate(p);
+      throw;
+    }
+    p->next = records().load(std::memory_order_relaxed);
+    while (!records().compare_exchange_weak(p->next, p, std::memory_order_release,
+                                            std::memory_order_relaxed)) {}
+    h.rec = p;
+  }
+  return *h.rec;
+}
+
+// 回收能回收的对象后归还记录
+inline void ebr::release(holder& h)
+{
+  if (h.rec == nullptr)
+    return;
+  try_advance();
+  reclaim(*h.rec, global_epoch().load(std::memory_order_seq_cst));
+  h.rec->state.store(0, std::memory_order_release);
+  h.rec->depth = 0;
+  h.rec->in_use.store(false, std::memory_order_release);
+  h.rec = nullptr;
+}
+
+inline ebr::record* ebr::pin()
+{
+  record& r = local();
+  if (r.depth++ == 0)
+  {
+    uint64_t e = global_epoch().load(std::memory_order_seq_cst);
+    for (;;)
+    { // 声明之后再确认全局纪元没有变化，否则重新声明
+      r.state.store((e << 1) | 1, std::memory_order_seq_cst);
+      const uint64_t now = global_epoch().load(std::memory_order_seq_cst);
+      if (now == e)
+        break;
+      e = now;
+    }
+  }
+  return &r;
+}
+
+inline void ebr::unpin(record* r)
+{
+  if (--r->depth == 0)
+    r->state.store(0, std::memory_order_release);
+}
+
+// 所有被钉住的线程都已处于当前纪元时，把全局纪元加一，有线程落后时返回 false
+inline bool ebr::try_advance()
+{
+  uint64_t e = global_epoch().load(std::memory_order_seq_cst);
+  for (record* p = records().load(std::memory_order_acquire); p; p = p->next)
+  {
+    const uint64_t s = p->state.load(std::memory_order_seq_cst);
+    if ((s & 1) && (s >> 1) != e)
+      return false;
+  }
+  // 失败说明其它线程已经推进了纪元，结果相同
+  global_epoch().compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+  return true;
+}
+
+// 整批释放纪元不晚于 e - 2 的列表
+inline void ebr::reclaim(record& r, uint64_t e)
+{
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (!r.limbo[i].empty() && r.limbo_epoch[i] + 2 <= e)
+      free_list(r, i);
+  }
+}
+
+inline void ebr::free_list(record& r, size_t i)
+{
+  mystl::vector<retired>& list = r.limbo[i];
+  for (size_t k = 0; k < list.size(); ++k)
+    list[k].deleter(list[k].ptr);
+  r.pending.store(r.pending.load(std::memory_order_relaxed) - list.size(),
+                  std::memory_order_relaxed);
+  list.clear();
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_EBR_H_
+
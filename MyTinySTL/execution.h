@@ -0,0 +1,817 @@
+﻿#ifndef MYTINYSTL_EXECUTION_H_
+#define MYTINYSTL_EXECUTION_H_
+
+// 这个头文件包含执行策略 seq / par / par_unseq，以及一组接受执行策略的并行算法
+// 并行算法把区间划分为若干块，交给线程池执行，调用线程也参与执行
+// 并行版本只针对随机访问迭代器，其它迭代器退化为顺序执行
+
+#include <atomic>
+
+#include "algobase.h"
+#include "algo.h"
+#include "numeric.h"
+#include "memory.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+namespace execution
+{
+
+// 顺序执行
+class sequenced_policy
+{
+public:
+  constexpr sequenced_policy() {}
+
+  size_t       concurrency() const noexcept { return 1; }
+  thread_pool& pool()        const { return thread_pool::default_pool(); }
+};
+
+// 并行执行
+// par(n) 把并发数限制为 n，par.on(pool) 在指定的线程池上执行
+class parallel_policy
+{
+private:
+  thread_pool* pool_;
+  size_t       concurrency_;
+
+public:
+  constexpr parallel_policy() :pool_(nullptr), concurrency_(0) {}
+  constexpr parallel_policy(thread_pool* p, size_t n) :pool_(p), concurrency_(n) {}
+
+  parallel_policy operator()(size_t n)  const { return parallel_policy(pool_, n); }
+  parallel_policy on(thread_pool& p)    const { return parallel_policy(&p, concurrency_); }
+
+  thread_pool& pool()        const { return pool_ ? *pool_ : thread_pool::default_pool(); }
+  size_t       concurrency() const { return concurrency_ ? concurrency_ : pool().size(); }
+};
+
+// 并行且允许向量化执行，在 mystl 中与 parallel_policy 的执行方式相同
+class parallel_unsequenced_policy
+{
+private:
+  thread_pool* pool_;
+  size_t       concurrency_;
+
+public:
+  constexpr parallel_unsequenced_policy() :pool_(nullptr), concurrency_(0) {}
+  constexpr parallel_unsequenced_policy(thread_pool* p, size_t n) :pool_(p), concurrency_(n) {}
+
+  parallel_unsequenced_policy operator()(size_t n) const
+  { return parallel_unsequenced_policy(pool_, n); }
+  parallel_unsequenced_policy on(thread_pool& p)   const
+  { return parallel_unsequenced_policy(&p, concurrency_); }
+
+  thread_pool& pool()        const { return pool_ ? *pool_ : thread_pool::default_pool(); }
+  size_t       concurrency() const { return concurrency_ ? concurrency_ : pool().size(); }
+};
+
+constexpr sequenced_policy            seq{};
+constexpr parallel_policy             par{};
+constexpr parallel_unsequenced_policy par_unseq{};
+
+} // namespace execution
+
+// is_execution_policy : 判断一个类型是否为执行策略
+template <class T>
+struct is_execution_policy :public std::false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> :public std::true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> :public std::true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy> :public std::true_type {};
+
+// 只有第一个参数为执行策略时，才启用接受执行策略的重载版本
+template <class ExecutionPolicy, class T = void>
+using enable_if_execution_policy = typename std::enable_if<
+  is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value, T>::type;
+
+/*****************************************************************************************/
+// parallel_run
+// 把 [0, n) 均分为 chunks 块，对每一块执行 f(begin, end, index)
+// 除第一块由调用线程执行外，其余的块作为 task_group 的任务派生到线程池中
+/*****************************************************************************************/
+constexpr static size_t kParallelGrainSize = 4096;  // 每一块至少处理的元素个数
+
+// 根据执行策略与区间长度计算划分的块数
+template <class ExecutionPolicy>
+size_t parallel_chunk_count(const ExecutionPolicy& policy, size_t n)
+{
+  const size_t max_chunks = n / kParallelGrainSize;
+  const size_t concurrency = policy.concurrency();
+  if (max_chunks <= 1 || concurrency <= 1)
+    return 1;
+  return concurrency < max_chunks ? concurrency : max_chunks;
+}
+
+template <class ExecutionPolicy, class Function>
+void parallel_run(const ExecutionPolicy& policy, size_t n, size_t chunks, Function f)
+{
+  if (chunks <= 1)
+  {
+    f(static_cast<size_t>(0), n, static_cast<size_t>(0));
+    return;
+  }
+  task_group group(policy.pool());
+  for (size_t i = 1; i < chunks; ++i)
+  {
+    const size_t b = n / chunks * i + (i < n % chunks ? i : n % chunks);
+    const size_t e = b + n / chunks + (i < n % chunks ? 1 : 0);
+    group.spawn([&f, b, e, i]() { f(b, e, i); });
+  }
+  f(static_cast<size_t>(0), n / chunks + (0 < n % chunks ? 1 : 0), static_cast<size_t>(0));
+  group.sync();  // 传播任务中抛出的异常
+}
+
+/*****************************************************************************************/
+// for_each
+// 对[first, last)区间内的每个元素并行地执行 f
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class Function>
+void par_for_each_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                           Function f, input_iterator_tag)
+{
+  mystl::for_each(first, last, f);
+}
+
+template <class ExecutionPolicy, class RandomIter, class Function>
+void par_for_each_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                           Function f, random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  mystl::parallel_run(policy, n, mystl::parallel_chunk_count(policy, n),
+                      [&](size_t b, size_t e, size_t)
+                      { mystl::for_each(first + b, first + e, f); });
+}
+
+template <class ExecutionPolicy, class InputIter, class Function>
+enable_if_execution_policy<ExecutionPolicy>
+for_each(ExecutionPolicy&& policy, InputIter first, InputIter last, Function f)
+{
+  mystl::par_for_each_dispatch(policy, first, last, f, iterator_category(first));
+}
+
+/*****************************************************************************************/
+// count_if
+// 并行地统计[first, last)区间内满足一元操作 unary_pred 的元素个数
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+size_t par_count_if_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                             UnaryPredicate unary_pred, input_iterator_tag)
+{
+  return mystl::count_if(first, last, unary_pred);
+}
+
+template <class ExecutionPolicy, class RandomIter, class UnaryPredicate>
+size_t par_count_if_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                             UnaryPredicate unary_pred, random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = mystl::parallel_chunk_count(policy, n);
+  mystl::vector<size_t> counts(chunks, 0);
+  mystl::parallel_run(policy, n, chunks,
+                      [&](size_t b, size_t e, size_t i)
+                      { counts[i] = mystl::count_if(first + b, first + e, unary_pred); });
+  return mystl::accumulate(counts.begin(), counts.end(), static_cast<size_t>(0));
+}
+
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, size_t>
+count_if(ExecutionPolicy&& policy, InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+  return mystl::par_count_if_dispatch(policy, first, last, unary_pred, iterator_category(first));
+}
+
+/*****************************************************************************************/
+// find_if
+// 并行地查找[first, last)区间内第一个满足一元操作 unary_pred 的元素，返回指向它的迭代器
+// 一旦更靠前的块找到了元素，靠后的块便提前结束
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+InputIter par_find_if_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                               UnaryPredicate unary_pred, input_iterator_tag)
+{
+  return mystl::find_if(first, last, unary_pred);
+}
+
+template <class ExecutionPolicy, class RandomIter, class UnaryPredicate>
+RandomIter par_find_if_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                                UnaryPredicate unary_pred, random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  std::atomic<size_t> found(n);  // 已找到的最靠前的位置
+  mystl::parallel_run(policy, n, mystl::parallel_chunk_count(policy, n),
+                      [&](size_t b, size_t e, size_t)
+  {
+    for (size_t i = b; i < e; ++i)
+    {
+      if ((i - b) % kParallelGrainSize == 0 && found.load(std::memory_order_relaxed) < b)
+        return;
+      if (unary_pred(*(first + i)))
+      {
+        size_t cur = found.load();
+        while (i < cur && !found.compare_exchange_weak(cur, i))
+          ;
+        return;
+      }
+    }
+  });
+  return first + found.load();
+}
+
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, InputIter>
+find_if(ExecutionPolicy&& policy, InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+  return mystl::par_find_if_dispatch(policy, first, last, unary_pred, iterator_category(first));
+}
+
+/*****************************************************************************************/
+// copy
+// 并行地把 [first, last)区间内的元素拷贝到 [result, result + (last - first))内
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class OutputIter, class Tag1, class Tag2>
+OutputIter par_copy_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                             OutputIter result, Tag1, Tag2)
+{
+  return mystl::copy(first, last, result);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2>
+RandomIter2 par_copy_dispatch(ExecutionPolicy& policy, RandomIter1 first, RandomIter1 last,
+                              RandomIter2 result, random_access_iterator_tag,
+                              random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  mystl::parallel_run(policy, n, mystl::parallel_chunk_count(policy, n),
+                      [&](size_t b, size_t e, size_t)
+                      { mystl::copy(first + b, first + e, result + b); });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+copy(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result)
+{
+  return mystl::par_copy_dispatch(policy, first, last, result,
+                                  iterator_category(first), iterator_category(result));
+}
+
+/*****************************************************************************************/
+// fill
+// 并行地为 [first, last)区间内的所有元素填充新值
+/*****************************************************************************************/
+template <class ExecutionPolicy, class ForwardIter, class T>
+void par_fill_dispatch(ExecutionPolicy&, ForwardIter first, ForwardIter last,
+                       const T& value, forward_iterator_tag)
+{
+  mystl::fill(first, last, value);
+}
+
+template <class ExecutionPolicy, class RandomIter, class T>
+void par_fill_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                       const T& value, random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  mystl::parallel_run(policy, n, mystl::parallel_chunk_count(policy, n),
+                      [&](size_t b, size_t e, size_t)
+                      { mystl::fill(first + b, first + e, value); });
+}
+
+template <class ExecutionPolicy, class ForwardIter, class T>
+enable_if_execution_policy<ExecutionPolicy>
+fill(ExecutionPolicy&& policy, ForwardIter first, ForwardIter last, const T& value)
+{
+  mystl::par_fill_dispatch(policy, first, last, value, iterator_category(first));
+}
+
+/*****************************************************************************************/
+// transform
+// 版本1：并行地以函数对象 unary_op 作用于[first, last)中的每个元素并将结果保存至 result 中
+// 版本2：并行地以函数对象 binary_op 作用于两个序列[first1, last1)、[first2, first2 + (last1 - first1))
+//        的每一对元素，并将结果保存至 result 中
+/*****************************************************************************************/
+// 版本1
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryOperation,
+          class Tag1, class Tag2>
+OutputIter par_transform_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                                  OutputIter result, UnaryOperation unary_op, Tag1, Tag2)
+{
+  return mystl::transform(first, last, result, unary_op);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2, class UnaryOperation>
+RandomIter2 par_transform_dispatch(ExecutionPolicy& policy, RandomIter1 first, RandomIter1 last,
+                                   RandomIter2 result, UnaryOperation unary_op,
+                                   random_access_iterator_tag, random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  mystl::parallel_run(policy, n, mystl::parallel_chunk_count(policy, n),
+                      [&](size_t b, size_t e, size_t)
+                      { mystl::transform(first + b, first + e, result + b, unary_op); });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryOperation>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+transform(ExecutionPolicy&& policy, InputIter first, InputIter last,
+          OutputIter result, UnaryOperation unary_op)
+{
+  return mystl::par_transform_dispatch(policy, first, last, result, unary_op,
+                                       iterator_category(first), iterator_category(result));
+}
+
+// 版本2
+template <class ExecutionPolicy, class InputIter1, class InputIter2,
+          class OutputIter, class BinaryOperation, class Tag1, class Tag2, class Tag3>
+OutputIter par_transform_dispatch(ExecutionPolicy&, InputIter1 first1, InputIter1 last1,
+                                  InputIter2 first2, OutputIter result, BinaryOperation binary_op,
+                                  Tag1, Tag2, Tag3)
+{
+  return mystl::transform(first1, last1, first2, result, binary_op);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2,
+          class RandomIter3, class BinaryOperation>
+RandomIter3 par_transform_dispatch(ExecutionPolicy& policy, RandomIter1 first1, RandomIter1 last1,
+                                   RandomIter2 first2, RandomIter3 result, BinaryOperation binary_op,
+                                   random_access_iterator_tag, random_access_iterator_tag,
+                                   random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last1 - first1);
+  mystl::parallel_run(policy, n, mystl::parallel_chunk_count(policy, n),
+                      [&](size_t b, size_t e, size_t)
+  {
+    mystl::transform(first1 + b, first1 + e, first2 + b, result + b, binary_op);
+  });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2,
+          class OutputIter, class BinaryOperation>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+transform(ExecutionPolicy&& policy, InputIter1 first1, InputIter1 last1,
+          InputIter2 first2, OutputIter result, BinaryOperation binary_op)
+{
+  return mystl::par_transform_dispatch(policy, first1, last1, first2, result, binary_op,
+                                       iterator_category(first1), iterator_category(first2),
+                                       iterator_category(result));
+}
+
+/*****************************************************************************************/
+// par_block_reduce
+// 块内的归约：算术类型的加法满足交换律，使用 reduce（连续内存中可以向量化），
+// 其它类型的加法（如字符串的拼接）与其它二元操作只要求满足结合律，按顺序累加
+/*****************************************************************************************/
+template <class RandomIter, class T, class BinaryOp>
+T par_block_reduce(RandomIter first, RandomIter last, T init, BinaryOp binary_op)
+{
+  return mystl::accumulate(first, last, init, binary_op);
+}
+
+template <class RandomIter, class T>
+T par_block_reduce_plus(RandomIter first, RandomIter last, T init, m_true_type)
+{
+  return mystl::reduce(first, last, init, mystl::plus<T>());
+}
+
+template <class RandomIter, class T>
+T par_block_reduce_plus(RandomIter first, RandomIter last, T init, m_false_type)
+{
+  return mystl::accumulate(first, last, init, mystl::plus<T>());
+}
+
+template <class RandomIter, class T>
+T par_block_reduce(RandomIter first, RandomIter last, T init, mystl::plus<T>)
+{
+  return mystl::par_block_reduce_plus(first, last, init,
+                                      m_bool_constant<std::is_arithmetic<T>::value>());
+}
+
+/*****************************************************************************************/
+// reduce
+// 版本1：并行地以初值 init 对每个元素进行累加
+// 版本2：并行地以初值 init 对每个元素进行二元操作 binary_op，binary_op 须满足结合律
+// 每一块先在块内按顺序求值，再按块的顺序把各块的结果合并到 init 上
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class T, class BinaryOp>
+T par_reduce_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                      T init, BinaryOp binary_op, input_iterator_tag)
+{
+  return mystl::accumulate(first, last, init, binary_op);
+}
+
+template <class ExecutionPolicy, class RandomIter, class T, class BinaryOp>
+T par_reduce_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                      T init, BinaryOp binary_op, random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = mystl::parallel_chunk_count(policy, n);
+  mystl::vector<T> partial(chunks, init);
+  mystl::parallel_run(policy, n, chunks,
+                      [&](size_t b, size_t e, size_t i)
+  {
+    if (i == 0)
+    {
+      partial[0] = mystl::par_block_reduce(first + b, first + e, init, binary_op);
+    }
+    else
+    {
+      T value = *(first + b);
+      partial[i] = mystl::par_block_reduce(first + b + 1, first + e, value, binary_op);
+    }
+  });
+  T result = partial[0];
+  for (size_t i = 1; i < chunks; ++i)
+    result = binary_op(result, partial[i]);
+  return result;
+}
+
+// 版本1
+template <class ExecutionPolicy, class InputIter, class T>
+enable_if_execution_policy<ExecutionPolicy, T>
+reduce(ExecutionPolicy&& policy, InputIter first, InputIter last, T init)
+{
+  return mystl::par_reduce_dispatch(policy, first, last, init, mystl::plus<T>(),
+                                    iterator_category(first));
+}
+
+// 版本2
+template <class ExecutionPolicy, class InputIter, class T, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, T>
+reduce(ExecutionPolicy&& policy, InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+  return mystl::par_reduce_dispatch(policy, first, last, init, binary_op,
+                                    iterator_category(first));
+}
+
+/*****************************************************************************************/
+// accumulate
+// 接受执行策略的 accumulate 以 reduce 的方式执行，二元操作须满足结合律
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class T>
+enable_if_execution_policy<ExecutionPolicy, T>
+accumulate(ExecutionPolicy&& policy, InputIter first, InputIter last, T init)
+{
+  return mystl::reduce(policy, first, last, init);
+}
+
+template <class ExecutionPolicy, class InputIter, class T, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, T>
+accumulate(ExecutionPolicy&& policy, InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+  return mystl::reduce(policy, first, last, init, binary_op);
+}
+
+/*****************************************************************************************/
+// inclusive_scan / exclusive_scan / partial_sum
+// 并行地计算局部累计求和（或二元操作），结果保存到以 result 为起始的区间上，binary_op 须满足结合律
+// 两遍的分块扫描：第一遍并行地求出每一块的归约结果，再顺序地求出每一块的初值，
+// 第二遍各块以自己的初值并行地扫描，块内使用 numeric.h 中的顺序版本，result 可以等于 first
+/*****************************************************************************************/
+// carries[i] 为第 i 块的初值，即 init 与第 i 块之前所有元素的归约结果
+// 没有初值（has_init 为 false）时 carries[0] 无意义，第 0 块按 partial_sum 的方式扫描
+template <class ExecutionPolicy, class RandomIter, class T, class BinaryOp>
+mystl::vector<T> par_scan_carries(ExecutionPolicy& policy, RandomIter first, size_t n, size_t chunks,
+                                  T init, bool has_init, BinaryOp binary_op)
+{
+  mystl::vector<T> carries(chunks, init);
+  mystl::parallel_run(policy, n, chunks,
+                      [&](size_t b, size_t e, size_t i)
+  {
+    if (i + 1 == chunks)
+      return;  // 最后一块的归约结果不需要
+    T value = *(first + b);
+    carries[i + 1] = mystl::par_block_reduce(first + b + 1, first + e, value, binary_op);
+  });
+  for (size_t i = has_init ? 1 : 2; i < chunks; ++i)
+    carries[i] = binary_op(carries[i - 1], carries[i]);
+  return carries;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class BinaryOp, class T,
+          class Tag1, class Tag2>
+OutputIter par_inclusive_scan_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                                       OutputIter result, BinaryOp binary_op, T init, bool has_init,
+                                       Tag1, Tag2)
+{
+  return has_init
+    ? mystl::inclusive_scan(first, last, result, binary_op, init)
+    : mystl::inclusive_scan(first, last, result, binary_op);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2, class BinaryOp, class T>
+RandomIter2 par_inclusive_scan_dispatch(ExecutionPolicy& policy, RandomIter1 first, RandomIter1 last,
+                                        RandomIter2 result, BinaryOp binary_op, T init, bool has_init,
+                                        random_access_iterator_tag, random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = mystl::parallel_chunk_count(policy, n);
+  if (chunks <= 1)
+  {
+    return has_init
+      ? mystl::inclusive_scan(first, last, result, binary_op, init)
+      : mystl::inclusive_scan(first, last, result, binary_op);
+  }
+  mystl::vector<T> carries = mystl::par_scan_carries(policy, first, n, chunks, init, has_init, binary_op);
+  mystl::parallel_run(policy, n, chunks,
+                      [&](size_t b, size_t e, size_t i)
+  {
+    if (i == 0 && !has_init)
+      mystl::inclusive_scan(first + b, first + e, result + b, binary_op);
+    else
+      mystl::inclusive_scan(first + b, first + e, result + b, binary_op, carries[i]);
+  });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class T, class BinaryOp,
+          class Tag1, class Tag2>
+OutputIter par_exclusive_scan_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                                       OutputIter result, T init, BinaryOp binary_op, Tag1, Tag2)
+{
+  return mystl::exclusive_scan(first, last, result, init, binary_op);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2, class T, class BinaryOp>
+RandomIter2 par_exclusive_scan_dispatch(ExecutionPolicy& policy, RandomIter1 first, RandomIter1 last,
+                                        RandomIter2 result, T init, BinaryOp binary_op,
+                                        random_access_iterator_tag, random_access_iterator_tag)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = mystl::parallel_chunk_count(policy, n);
+  if (chunks <= 1)
+    return mystl::exclusive_scan(first, last, result, init, binary_op);
+  mystl::vector<T> carries = mystl::par_scan_carries(policy, first, n, chunks, init, true, binary_op);
+  mystl::parallel_run(policy, n, chunks,
+                      [&](size_t b, size_t e, size_t i)
+  {
+    mystl::exclusive_scan(first + b, first + e, result + b, carries[i], binary_op);
+  });
+  return result + n;
+}
+
+// inclusive_scan 版本1：以加法计算局部累计求和
+template <class ExecutionPolicy, class InputIter, class OutputIter>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+inclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  if (first == last)
+    return result;
+  return mystl::par_inclusive_scan_dispatch(policy, first, last, result, mystl::plus<value_type>(),
+                                            static_cast<value_type>(*first), false,
+                                            iterator_category(first), iterator_category(result));
+}
+
+// inclusive_scan 版本2：以二元操作 binary_op 代替加法
+template <class ExecutionPolicy, class InputIter, class OutputIter, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+inclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result,
+               BinaryOp binary_op)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  if (first == last)
+    return result;
+  return mystl::par_inclusive_scan_dispatch(policy, first, last, result, binary_op,
+                                            static_cast<value_type>(*first), false,
+                                            iterator_category(first), iterator_category(result));
+}
+
+// inclusive_scan 版本3：以 init 为初值
+template <class ExecutionPolicy, class InputIter, class OutputIter, class BinaryOp, class T>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+inclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result,
+               BinaryOp binary_op, T init)
+{
+  return mystl::par_inclusive_scan_dispatch(policy, first, last, result, binary_op, init, true,
+                                            iterator_category(first), iterator_category(result));
+}
+
+// exclusive_scan 版本1：以 init 为初值，第 i 个结果不包含第 i 个元素
+template <class ExecutionPolicy, class InputIter, class OutputIter, class T>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+exclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result, T init)
+{
+  return mystl::par_exclusive_scan_dispatch(policy, first, last, result, init, mystl::plus<T>(),
+                                            iterator_category(first), iterator_category(result));
+}
+
+// exclusive_scan 版本2：以二元操作 binary_op 代替加法
+template <class ExecutionPolicy, class InputIter, class OutputIter, class T, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+exclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result,
+               T init, BinaryOp binary_op)
+{
+  return mystl::par_exclusive_scan_dispatch(policy, first, last, result, init, binary_op,
+                                            iterator_category(first), iterator_category(result));
+}
+
+// 接受执行策略的 partial_sum 与 inclusive_scan 相同
+template <class ExecutionPolicy, class InputIter, class OutputIter>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+partial_sum(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result)
+{
+  return mystl::inclusive_scan(policy, first, last, result);
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+partial_sum(ExecutionPolicy&& policy, InputIter first, InputIter last,
+            OutputIter result, BinaryOp binary_op)
+{
+  return mystl::inclusive_scan(policy, first, last, result, binary_op);
+}
+
+/*****************************************************************************************/
+// sort / stable_sort
+// 并行地将[first, last)内的元素以递增的方式排序，stable_sort 保持相等元素的相对次序
+// 先把区间分为若干块并行排序，再借助临时缓冲区逐轮两两归并
+// 每一轮按输出位置把每对有序段的归并划分为若干片（co-ranking），使最后几轮仍能并行
+/*****************************************************************************************/
+// 求稳定归并 [first1, first1 + len1) 与 [first2, first2 + len2) 时，
+// 输出的前 k 个元素中来自第一个区间的元素个数
+template <class RandomIter1, class RandomIter2, class Compared>
+size_t par_co_rank(size_t k, RandomIter1 first1, size_t len1,
+                   RandomIter2 first2, size_t len2, Compared comp)
+{
+  size_t lo = k > len2 ? k - len2 : 0;
+  size_t hi = k < len1 ? k : len1;
+  while (lo < hi)
+  {
+    const size_t i = lo + (hi - lo) / 2;
+    if (comp(*(first2 + (k - i - 1)), *(first1 + i)))
+      hi = i;
+    else
+      lo = i + 1;
+  }
+  return lo;
+}
+
+// 一片归并任务：把 src 的 [first1, last1) 与 [first2, last2) 归并到 dst + out 开始的位置
+struct par_merge_piece
+{
+  size_t first1, last1;
+  size_t first2, last2;
+  size_t out;
+};
+
+// 对 [src, src + n) 中以 bounds 分隔的有序段两两归并到 dst 中，bounds 随之更新
+template <class ExecutionPolicy, class Iter1, class Iter2, class Compared>
+void par_merge_round(ExecutionPolicy& policy, Iter1 src, Iter2 dst,
+                     mystl::vector<size_t>& bounds, Compared comp)
+{
+  const size_t n = bounds.back();
+  const size_t chunks = mystl::parallel_chunk_count(policy, n);
+  const size_t piece_len = chunks > 1 ? (n + chunks - 1) / chunks : n;
+
+  // 划分点在调用线程中全部算好，归并开始后 src 中的元素会被移走
+  mystl::vector<par_merge_piece> pieces;
+  for (size_t p = 0; p + 1 < bounds.size(); p += 2)
+  {
+    const size_t lo = bounds[p];
+    const size_t mid = bounds[p + 1];
+    const size_t hi = p + 2 < bounds.size() ? bounds[p + 2] : mid;
+    const size_t len1 = mid - lo;
+    const size_t len2 = hi - mid;
+    size_t i = 0;
+    for (size_t k = 0; k < len1 + len2; )
+    {
+      const size_t next_k = len1 + len2 - k > piece_len ? k + piece_len : len1 + len2;
+      const size_t next_i = next_k == len1 + len2 ? len1
+        : mystl::par_co_rank(next_k, src + lo, len1, src + mid, len2, comp);
+      pieces.push_back(par_merge_piece{ lo + i, lo + next_i,
+                                        mid + (k - i), mid + (next_k - next_i), lo + k });
+      k = next_k;
+      i = next_i;
+    }
+  }
+  mystl::parallel_run(policy, pieces.size(), pieces.size(),
+                      [&](size_t b, size_t e, size_t)
+  {
+    for (size_t p = b; p < e; ++p)
+    {
+      const par_merge_piece& m = pieces[p];
+      mystl::move_merge(src + m.first1, src + m.last1, src + m.first2, src + m.last2,
+                        dst + m.out, comp);
+    }
+  });
+  mystl::vector<size_t> next;
+  for (size_t i = 0; i < bounds.size(); i += 2)
+    next.push_back(bounds[i]);
+  if (next.back() != bounds.back())
+    next.push_back(bounds.back());
+  bounds.swap(next);
+}
+
+// chunk_sort 用于对每一块排序，决定了整体是否稳定
+template <class ExecutionPolicy, class RandomIter, class Compared, class ChunkSort>
+void par_merge_sort(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                    Compared comp, ChunkSort chunk_sort)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  const size_t n = static_cast<size_t>(last - first);
+  const size_t chunks = mystl::parallel_chunk_count(policy, n);
+  if (chunks <= 1)
+  {
+    chunk_sort(first, last);
+    return;
+  }
+  temporary_buffer<RandomIter, value_type> buf(first, last);
+  if (static_cast<size_t>(buf.size()) != n)
+  {
+    chunk_sort(first, last);
+    return;
+  }
+
+  mystl::vector<size_t> bounds(chunks + 1, 0);
+  mystl::parallel_run(policy, n, chunks,
+                      [&](size_t b, size_t e, size_t i)
+  {
+    bounds[i + 1] = e;
+    chunk_sort(first + b, first + e);
+  });
+
+  bool in_buffer = false;  // 当前数据是否位于缓冲区中
+  while (bounds.size() > 2)
+  {
+    if (in_buffer)
+      mystl::par_merge_round(policy, buf.begin(), first, bounds, comp);
+    else
+      mystl::par_merge_round(policy, first, buf.begin(), bounds, comp);
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer)
+  {
+    mystl::parallel_run(policy, n, chunks,
+                        [&](size_t b, size_t e, size_t)
+                        { mystl::move(buf.begin() + b, buf.begin() + e, first + b); });
+  }
+}
+
+template <class ExecutionPolicy, class RandomIter, class Compared>
+void par_sort_aux(ExecutionPolicy& policy, RandomIter first, RandomIter last, Compared comp)
+{
+  mystl::par_merge_sort(policy, first, last, comp,
+                        [comp](RandomIter b, RandomIter e) { mystl::sort(b, e, comp); });
+}
+
+template <class ExecutionPolicy, class RandomIter>
+enable_if_execution_policy<ExecutionPolicy>
+sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::par_sort_aux(policy, first, last, mystl::less<value_type>());
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class ExecutionPolicy, class RandomIter, class Compared>
+enable_if_execution_policy<ExecutionPolicy>
+sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last, Compared comp)
+{
+  mystl::par_sort_aux(policy, first, last, comp);
+}
+
+template <class ExecutionPolicy, class BidirectionalIter, class Compared>
+void par_stable_sort_dispatch(ExecutionPolicy&, BidirectionalIter first, BidirectionalIter last,
+                              Compared comp, bidirectional_iterator_tag)
+{
+  mystl::stable_sort(first, last, comp);
+}
+
+template <class ExecutionPolicy, class RandomIter, class Compared>
+void par_stable_sort_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                              Compared comp, random_access_iterator_tag)
+{
+  mystl::par_merge_sort(policy, first, last, comp,
+                        [comp](RandomIter b, RandomIter e) { mystl::stable_sort(b, e, comp); });
+}
+
+template <class ExecutionPolicy, class BidirectionalIter>
+enable_if_execution_policy<ExecutionPolicy>
+stable_sort(ExecutionPolicy&& policy, BidirectionalIter first, BidirectionalIter last)
+{
+  typedef typename iterator_traits<BidirectionalIter>::value_type value_type;
+  mystl::par_stable_sort_dispatch(policy, first, last, mystl::less<value_type>(),
+                                  iterator_category(first));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class ExecutionPolicy, class BidirectionalIter, class Compared>
+enable_if_execution_policy<ExecutionPolicy>
+stable_sort(ExecutionPolicy&& policy, BidirectionalIter first, BidirectionalIter last,
+            Compared comp)
+{
+  mystl::par_stable_sort_dispatch(policy, first, last, comp, iterator_category(first));
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_EXECUTION_H_
+
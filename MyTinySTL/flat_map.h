@@ -0,0 +1,604 @@
+﻿#ifndef MYTINYSTL_FLAT_MAP_H_
+#define MYTINYSTL_FLAT_MAP_H_
+
+// 这个头文件包含一个模板类 flat_map
+// flat_map : 有序映射，键值与实值分别按键值顺序储存在两个 vector 中，键值不允许重复
+
+// notes:
+//
+// 1. 查找只在连续的键值数组上做 lower_bound，不经过实值，适合读多写少的场合
+// 2. 单个元素的插入与删除需要移动其后的所有元素，复杂度为 O(n)，批量插入请使用 insert_range
+// 3. 批量构造对所有元素只排序、去重一次；insert_range 把新元素追加到末尾，只对新追加的部分排序，
+//    再与原有的部分 inplace_merge，复杂度为 O(n + m log m)
+// 4. 由于键值与实值分开储存，迭代器解引用得到的是 pair<const Key&, T&>，而不是 value_type 的引用
+// 5. 插入与删除会使所有迭代器失效
+
+// 异常保证：
+// mystl::flat_map<Key, T> 满足基本异常保证，单个元素的插入与 insert_range 满足强异常安全保证：
+// 追加、排序或重排时抛出异常，会把两个数组截断回插入前的长度再重新抛出，
+// 重排时键值与实值的移动构造函数可能抛出异常则复制，原有的元素保持不变
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algo.h"
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// flat_map 的迭代器，同时指向键值数组与实值数组中的同一个位置
+template <class Key, class T, bool IsConst>
+struct flat_map_iterator
+{
+  typedef typename std::conditional<IsConst, const T, T>::type mapped_type;
+
+  typedef mystl::random_access_iterator_tag       iterator_category;
+  typedef mystl::pair<Key, T>                     value_type;
+  typedef mystl::pair<const Key&, mapped_type&>   reference;
+  typedef ptrdiff_t                               difference_type;
+
+  // operator-> 返回的代理对象，保存一个 reference
+  struct pointer
+  {
+    reference ref;
+    reference* operator->() { return &ref; }
+  };
+
+  typedef flat_map_iterator<Key, T, IsConst>      self;
+
+  const Key*   key;    // 指向键值
+  mapped_type* value;  // 指向实值
+
+  // 构造函数
+  flat_map_iterator() :key(nullptr), value(nullptr) {}
+  flat_map_iterator(const Key* k, mapped_type* v) :key(k), value(v) {}
+
+  // iterator 可以转换为 const_iterator
+  template <bool C, typename std::enable_if<IsConst && !C, int>::type = 0>
+  flat_map_iterator(const flat_map_iterator<Key, T, C>& rhs)
+    :key(rhs.key), value(rhs.value)
+  {
+  }
+
+  // 重载操作符
+  reference operator*()  const { return reference(*key, *value); }
+  pointer   operator->() const { return pointer{ operator*() }; }
+  reference operator[](difference_type n) const { return reference(key[n], value[n]); }
+
+  self& operator++()
+  {
+    ++key;
+    ++value;
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  self& operator--()
+  {
+    --key;
+    --value;
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  self& operator+=(difference_type n)
+  {
+    key += n;
+    value += n;
+    return *this;
+  }
+  self operator+(difference_type n) const
+  {
+    self tmp = *this;
+    return tmp += n;
+  }
+  self& operator-=(difference_type n)
+  {
+    return *this += -n;
+  }
+  self operator-(difference_type n) const
+  {
+    self tmp = *this;
+    return tmp -= n;
+  }
+  difference_type operator-(const self& rhs) const
+  {
+    return key - rhs.key;
+  }
+};
+
+// 重载比较操作符，iterator 与 const_iterator 之间也可以比较
+template <class Key, class T, bool C1, bool C2>
+bool operator==(const flat_map_iterator<Key, T, C1>& lhs, const flat_map_iterator<Key, T, C2>& rhs)
+{
+  return lhs.key == rhs.key;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator!=(const flat_map_iterator<Key, T, C1>& lhs, const flat_map_iterator<Key, T, C2>& rhs)
+{
+  return lhs.key != rhs.key;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator<(const flat_map_iterator<Key, T, C1>& lhs, const flat_map_iterator<Key, T, C2>& rhs)
+{
+  return lhs.key < rhs.key;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator>(const flat_map_iterator<Key, T, C1>& lhs, const flat_map_iterator<Key, T, C2>& rhs)
+{
+  return rhs.key < lhs.key;
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator<=(const flat_map_iterator<Key, T, C1>& lhs, const flat_map_iterator<Key, T, C2>& rhs)
+{
+  return !(rhs.key < lhs.key);
+}
+
+template <class Key, class T, bool C1, bool C2>
+bool operator>=(const flat_map_iterator<Key, T, C1>& lhs, const flat_map_iterator<Key, T, C2>& rhs)
+{
+  return !(lhs.key < rhs.key);
+}
+
+// 模板类 flat_map，键值不允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
+template <class Key, class T, class Compare = mystl::less<Key>>
+class flat_map
+{
+public:
+  // flat_map 的嵌套型别定义
+  typedef Key                                          key_type;
+  typedef T                                            mapped_type;
+  typedef mystl::pair<Key, T>                          value_type;
+  typedef Compare                                      key_compare;
+  typedef mystl::vector<Key>                           key_container_type;
+  typedef mystl::vector<T>                             mapped_container_type;
+
+  typedef mystl::flat_map_iterator<Key, T, false>      iterator;
+  typedef mystl::flat_map_iterator<Key, T, true>       const_iterator;
+  typedef mystl::reverse_iterator<iterator>            reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>      const_reverse_iterator;
+
+  typedef typename iterator::reference                 reference;
+  typedef typename const_iterator::reference           const_reference;
+  typedef size_t                                       size_type;
+  typedef ptrdiff_t                                    difference_type;
+
+private:
+  key_container_type    keys_;    // 按顺序储存的键值
+  mapped_container_type values_;  // 与键值一一对应的实值
+  key_compare           comp_;    // 键值比较的准则
+
+public:
+  // 构造、复制、移动函数
+
+  flat_map() = default;
+
+  explicit flat_map(const Compare& comp)
+    :comp_(comp)
+  {
+  }
+
+  // 批量构造，所有元素追加之后只排序、去重一次，重复的键值保留第一个
+  template <class InputIterator, typename std::enable_if<
+    mystl::is_input_iterator<InputIterator>::value, int>::type = 0>
+  flat_map(InputIterator first, InputIterator last, const Compare& comp = Compare())
+    :comp_(comp)
+  {
+    insert_range(first, last);
+  }
+
+  flat_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+    :comp_(comp)
+  {
+    insert_range(ilist.begin(), ilist.end());
+  }
+
+  // 由两个等长的容器构造，键值不需要有序
+  flat_map(key_container_type keys, mapped_container_type values,
+           const Compare& comp = Compare())
+    :keys_(mystl::move(keys)), values_(mystl::move(values)), comp_(comp)
+  {
+    THROW_LENGTH_ERROR_IF(keys_.size() != values_.size(),
+                          "flat_map<Key, T> keys and values have different sizes");
+    merge_tail(0);
+  }
+
+  flat_map(const flat_map& rhs) = default;
+  flat_map(flat_map&& rhs) noexcept
+    :keys_(mystl::move(rhs.keys_)), values_(mystl::move(rhs.values_)), comp_(rhs.comp_)
+  {
+  }
+
+  flat_map& operator=(const flat_map& rhs) = default;
+  flat_map& operator=(flat_map&& rhs)
+  {
+    keys_ = mystl::move(rhs.keys_);
+    values_ = mystl::move(rhs.values_);
+    comp_ = rhs.comp_;
+    return *this;
+  }
+
+  flat_map& operator=(std::initializer_list<value_type> ilist)
+  {
+    clear();
+    insert_range(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~flat_map() = default;
+
+  // 相关接口
+  key_compare                  key_comp() const { return comp_; }
+  const key_container_type&    keys()     const noexcept { return keys_; }
+  const mapped_container_type& values()   const noexcept { return values_; }
+
+  // 迭代器相关
+
+  iterator               begin()         noexcept
+  { return iterator(keys_.data(), values_.data()); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(keys_.data(), values_.data()); }
+  iterator               end()           noexcept
+  { return begin() + size(); }
+  const_iterator         end()     const noexcept
+  { return begin() + size(); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关
+  bool      empty()    const noexcept { return keys_.empty(); }
+  size_type size()     const noexcept { return keys_.size(); }
+  size_type max_size() const noexcept { return keys_.max_size(); }
+  size_type capacity() const noexcept { return keys_.capacity(); }
+
+  void      reserve(size_type n)
+  {
+    keys_.reserve(n);
+    values_.reserve(n);
+  }
+  void      shrink_to_fit()
+  {
+    keys_.shrink_to_fit();
+    values_.shrink_to_fit();
+  }
+
+  // 访问元素相关
+
+  // 若键值不存在，at 会抛出一个异常
+  mapped_type& at(const key_type& key)
+  {
+    const size_type n = find_index(key);
+    THROW_OUT_OF_RANGE_IF(n == size(), "flat_map<Key, T> no such element exists");
+    return values_[n];
+  }
+  const mapped_type& at(const key_type& key) const
+  {
+    const size_type n = find_index(key);
+    THROW_OUT_OF_RANGE_IF(n == size(), "flat_map<Key, T> no such element exists");
+    return values_[n];
+  }
+
+  mapped_type& operator[](const key_type& key)
+  {
+    const size_type n = lower_index(key);
+    if (n == size() || comp_(key, keys_[n]))
+      insert_at(n, key, T{});
+    return values_[n];
+  }
+  mapped_type& operator[](key_type&& key)
+  {
+    const size_type n = lower_index(key);
+    if (n == size() || comp_(key, keys_[n]))
+      insert_at(n, mystl::move(key), T{});
+    return values_[n];
+  }
+
+  // 插入删除相关
+
+  template <class ...Args>
+  pair<iterator, bool> emplace(Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return insert(mystl::move(tmp));
+  }
+
+  template <class ...Args>
+  iterator emplace_hint(const_iterator hint, Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return insert(hint, mystl::move(tmp));
+  }
+
+  pair<iterator, bool> insert(const value_type& value)
+  {
+    return insert_unique(value.first, value.second);
+  }
+  pair<iterator, bool> insert(value_type&& value)
+  {
+    return insert_unique(mystl::move(value.first), mystl::move(value.second));
+  }
+
+  // hint 恰好是 value 应在的位置时不需要查找
+  iterator insert(const_iterator hint, const value_type& value)
+  {
+    const size_type n = hint_index(hint, value.first);
+    return n != size() + 1 ? insert_at(n, value.first, value.second)
+                           : insert_unique(value.first, value.second).first;
+  }
+  iterator insert(const_iterator hint, value_type&& value)
+  {
+    const size_type n = hint_index(hint, value.first);
+    return n != size() + 1 ? insert_at(n, mystl::move(value.first), mystl::move(value.second))
+                           : insert_unique(mystl::move(value.first), mystl::move(value.second)).first;
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  {
+    insert_range(first, last);
+  }
+
+  // 批量插入[first, last)，已有的键值或区间内重复的键值保留先出现的一个
+  template <class InputIterator>
+  void insert_range(InputIterator first, InputIterator last)
+  {
+    const size_type old_size = size();
+    try
+    {
+      for (; first != last; ++first)
+      {
+        const value_type& value = *first;
+        keys_.push_back(value.first);
+        values_.push_back(value.second);
+      }
+      merge_tail(old_size);
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + old_size, keys_.end());
+      values_.erase(values_.begin() + old_size, values_.end());
+      throw;
+    }
+  }
+
+  iterator  erase(const_iterator position)
+  {
+    const size_type n = static_cast<size_type>(position.key - keys_.data());
+    keys_.erase(keys_.begin() + n);
+    values_.erase(values_.begin() + n);
+    return begin() + n;
+  }
+  iterator  erase(const_iterator first, const_iterator last)
+  {
+    const size_type n = static_cast<size_type>(first.key - keys_.data());
+    const size_type m = static_cast<size_type>(last.key - keys_.data());
+    keys_.erase(keys_.begin() + n, keys_.begin() + m);
+    values_.erase(values_.begin() + n, values_.begin() + m);
+    return begin() + n;
+  }
+  size_type erase(const key_type& key)
+  {
+    const size_type n = find_index(key);
+    if (n == size())
+      return 0;
+    erase(begin() + n);
+    return 1;
+  }
+
+  void      clear()
+  {
+    keys_.clear();
+    values_.clear();
+  }
+
+  // flat_map 相关操作
+
+  iterator       find(const key_type& key)
+  { return begin() + find_index(key); }
+  const_iterator find(const key_type& key) const
+  { return begin() + find_index(key); }
+
+  size_type      count(const key_type& key) const
+  { return find_index(key) != size() ? 1 : 0; }
+
+  bool           contains(const key_type& key) const
+  { return find_index(key) != size(); }
+
+  iterator       lower_bound(const key_type& key)
+  { return begin() + lower_index(key); }
+  const_iterator lower_bound(const key_type& key) const
+  { return begin() + lower_index(key); }
+
+  iterator       upper_bound(const key_type& key)
+  { return begin() + upper_index(key); }
+  const_iterator upper_bound(const key_type& key) const
+  { return begin() + upper_index(key); }
+
+  pair<iterator, iterator>
+    equal_range(const key_type& key)
+  {
+    const size_type n = find_index(key);
+    return n == size() ? pair<iterator, iterator>(end(), end())
+                       : pair<iterator, iterator>(begin() + n, begin() + n + 1);
+  }
+  pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const
+  {
+    const size_type n = find_index(key);
+    return n == size() ? pair<const_iterator, const_iterator>(end(), end())
+                       : pair<const_iterator, const_iterator>(begin() + n, begin() + n + 1);
+  }
+
+  void swap(flat_map& rhs) noexcept
+  {
+    keys_.swap(rhs.keys_);
+    values_.swap(rhs.values_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+private:
+  // helper functions
+
+  size_type lower_index(const key_type& key) const
+  {
+    return static_cast<size_type>(
+      mystl::lower_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin());
+  }
+  size_type upper_index(const key_type& key) const
+  {
+    return static_cast<size_type>(
+      mystl::upper_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin());
+  }
+  // 键值不存在时返回 size()
+  size_type find_index(const key_type& key) const
+  {
+    const size_type n = lower_index(key);
+    return (n == size() || comp_(key, keys_[n])) ? size() : n;
+  }
+
+  // hint 是 key 应在的位置时返回它的下标，否则返回 size() + 1
+  size_type hint_index(const_iterator hint, const key_type& key) const
+  {
+    const size_type n = static_cast<size_type>(hint.key - keys_.data());
+    if ((n == 0 || comp_(keys_[n - 1], key)) && (n == size() || comp_(key, keys_[n])))
+      return n;
+    return size() + 1;
+  }
+
+  template <class K, class V>
+  pair<iterator, bool> insert_unique(K&& key, V&& value)
+  {
+    const size_type n = lower_index(key);
+    if (n != size() && !comp_(key, keys_[n]))
+      return pair<iterator, bool>(begin() + n, false);
+    return pair<iterator, bool>(insert_at(n, mystl::forward<K>(key), mystl::forward<V>(value)), true);
+  }
+
+  template <class K, class V>
+  iterator insert_at(size_type n, K&& key, V&& value)
+  {
+    keys_.emplace(keys_.begin() + n, mystl::forward<K>(key));
+    try
+    {
+      values_.emplace(values_.begin() + n, mystl::forward<V>(value));
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + n);
+      throw;
+    }
+    return begin() + n;
+  }
+
+  void merge_tail(size_type old_size);
+};
+
+/*****************************************************************************************/
+
+// [0, old_size) 已经有序且不重复，把 [old_size, size()) 并入其中
+// 键值与实值分开储存，因此在下标数组上完成排序与合并，最后按下标一次性重排两个数组
+// 排序与合并都在下标数组上进行，抛出异常时两个数组都没有被改动，由调用者截断新追加的部分
+template <class Key, class T, class Compare>
+void flat_map<Key, T, Compare>::
+merge_tail(size_type old_size)
+{
+  const size_type n = size();
+  if (old_size == n)
+    return;
+  mystl::vector<size_type> order(n);
+  for (size_type i = 0; i < n; ++i)
+    order[i] = i;
+  const key_type* keys = keys_.data();
+  auto comp = [keys, this](size_type a, size_type b) { return comp_(keys[a], keys[b]); };
+  // 只对新追加的部分排序，稳定排序使重复的键值中先出现的排在前面
+  mystl::stable_sort(order.begin() + old_size, order.end(), comp);
+  if (old_size != 0 && !comp(order[old_size - 1], order[old_size]))
+    mystl::inplace_merge(order.begin(), order.begin() + old_size, order.end(), comp);
+  // 去重，保留每组相同键值中的第一个
+  size_type len = 0;
+  bool identity = true;
+  for (size_type i = 0; i < n; ++i)
+  {
+    if (len != 0 && !comp(order[len - 1], order[i]))
+      continue;
+    order[len] = order[i];
+    identity = identity && order[len] == len;
+    ++len;
+  }
+  if (identity)
+  { // 新元素都追加在末尾且没有重复，不需要重排
+    keys_.erase(keys_.begin() + len, keys_.end());
+    values_.erase(values_.begin() + len, values_.end());
+    return;
+  }
+  key_container_type    new_keys;
+  mapped_container_type new_values;
+  new_keys.reserve(len);
+  new_values.reserve(len);
+  for (size_type i = 0; i < len; ++i)
+  {
+    new_keys.push_back(mystl::move_if_noexcept(keys_[order[i]]));
+    new_values.push_back(mystl::move_if_noexcept(values_[order[i]]));
+  }
+  keys_.swap(new_keys);
+  values_.swap(new_values);
+}
+
+// 重载比较操作符
+template <class Key, class T, class Compare>
+bool operator==(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+{
+  return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+}
+
+template <class Key, class T, class Compare>
+bool operator!=(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare>
+void swap(flat_map<Key, T, Compare>& lhs, flat_map<Key, T, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_MAP_H_
+
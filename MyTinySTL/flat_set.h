@@ -0,0 +1,353 @@
+﻿#ifndef MYTINYSTL_FLAT_SET_H_
+#define MYTINYSTL_FLAT_SET_H_
+
+// 这个头文件包含一个模板类 flat_set
+// flat_set : 有序集合，元素按顺序储存在一个 vector 中，元素不允许重复
+
+// notes:
+//
+// 1. 查找在连续的数组上做 lower_bound，缓存友好，适合读多写少的场合
+// 2. 单个元素的插入与删除需要移动其后的所有元素，复杂度为 O(n)，批量插入请使用 insert_range
+// 3. 批量构造对所有元素只排序、去重一次；insert_range 把新元素追加到末尾，只对新追加的部分排序，
+//    再与原有的部分 inplace_merge，最后 unique 去重
+// 4. 插入与删除会使所有迭代器失效
+
+// 异常保证：
+// mystl::flat_set<Key> 满足基本异常保证，单个元素的插入满足强异常安全保证，
+// insert_range 在追加或对新追加的部分排序时抛出异常，会截断回插入前的长度再重新抛出，满足强异常安全保证；
+// 与原有的元素合并、去重时抛出异常，原有的元素可能已被移动，此时清空 flat_set 再重新抛出
+
+#include <initializer_list>
+
+#include "algo.h"
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+// 模板类 flat_set，元素不允许重复
+// 参数一代表元素类型，参数二代表比较方式，缺省使用 mystl::less
+template <class Key, class Compare = mystl::less<Key>>
+class flat_set
+{
+public:
+  // flat_set 的嵌套型别定义
+  typedef Key                                          key_type;
+  typedef Key                                          value_type;
+  typedef Compare                                      key_compare;
+  typedef Compare                                      value_compare;
+  typedef mystl::vector<Key>                           container_type;
+
+  typedef typename container_type::const_pointer       pointer;
+  typedef typename container_type::const_pointer       const_pointer;
+  typedef typename container_type::const_reference     reference;
+  typedef typename container_type::const_reference     const_reference;
+  typedef typename container_type::const_iterator      iterator;
+  typedef typename container_type::const_iterator      const_iterator;
+  typedef mystl::reverse_iterator<iterator>            reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>      const_reverse_iterator;
+  typedef typename container_type::size_type           size_type;
+  typedef typename container_type::difference_type     difference_type;
+
+private:
+  container_type keys_;  // 按顺序储存的元素
+  key_compare    comp_;  // 元素比较的准则
+
+public:
+  // 构造、复制、移动函数
+
+  flat_set() = default;
+
+  explicit flat_set(const Compare& comp)
+    :comp_(comp)
+  {
+  }
+
+  // 批量构造，所有元素追加之后只排序、去重一次，重复的元素保留第一个
+  template <class InputIterator, typename std::enable_if<
+    mystl::is_input_iterator<InputIterator>::value, int>::type = 0>
+  flat_set(InputIterator first, InputIterator last, const Compare& comp = Compare())
+    :comp_(comp)
+  {
+    insert_range(first, last);
+  }
+
+  flat_set(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+    :comp_(comp)
+  {
+    insert_range(ilist.begin(), ilist.end());
+  }
+
+  // 接管一个 vector，元素不需要有序
+  explicit flat_set(container_type keys, const Compare& comp = Compare())
+    :keys_(mystl::move(keys)), comp_(comp)
+  {
+    merge_tail(0);
+  }
+
+  flat_set(const flat_set& rhs) = default;
+  flat_set(flat_set&& rhs) noexcept
+    :keys_(mystl::move(rhs.keys_)), comp_(rhs.comp_)
+  {
+  }
+
+  flat_set& operator=(const flat_set& rhs) = default;
+  flat_set& operator=(flat_set&& rhs)
+  {
+    keys_ = mystl::move(rhs.keys_);
+    comp_ = rhs.comp_;
+    return *this;
+  }
+
+  flat_set& operator=(std::initializer_list<value_type> ilist)
+  {
+    keys_.clear();
+    insert_range(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~flat_set() = default;
+
+  // 相关接口
+  key_compare           key_comp()   const { return comp_; }
+  value_compare         value_comp() const { return comp_; }
+  const container_type& keys()       const noexcept { return keys_; }
+
+  // 迭代器相关
+
+  iterator               begin()   const noexcept
+  { return keys_.begin(); }
+  iterator               end()     const noexcept
+  { return keys_.end(); }
+  reverse_iterator       rbegin()  const noexcept
+  { return reverse_iterator(end()); }
+  reverse_iterator       rend()    const noexcept
+  { return reverse_iterator(begin()); }
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关
+  bool      empty()    const noexcept { return keys_.empty(); }
+  size_type size()     const noexcept { return keys_.size(); }
+  size_type max_size() const noexcept { return keys_.max_size(); }
+  size_type capacity() const noexcept { return keys_.capacity(); }
+
+  void      reserve(size_type n) { keys_.reserve(n); }
+  void      shrink_to_fit()      { keys_.shrink_to_fit(); }
+
+  // 插入删除相关
+
+  template <class ...Args>
+  pair<iterator, bool> emplace(Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return insert(mystl::move(tmp));
+  }
+
+  template <class ...Args>
+  iterator emplace_hint(const_iterator hint, Args&& ...args)
+  {
+    value_type tmp(mystl::forward<Args>(args)...);
+    return insert(hint, mystl::move(tmp));
+  }
+
+  pair<iterator, bool> insert(const value_type& value)
+  {
+    return insert_unique(value);
+  }
+  pair<iterator, bool> insert(value_type&& value)
+  {
+    return insert_unique(mystl::move(value));
+  }
+
+  // hint 恰好是 value 应在的位置时不需要查找
+  iterator insert(const_iterator hint, const value_type& value)
+  {
+    return hint_ok(hint, value) ? keys_.insert(hint, value) : insert_unique(value).first;
+  }
+  iterator insert(const_iterator hint, value_type&& value)
+  {
+    return hint_ok(hint, value) ? keys_.emplace(hint, mystl::move(value))
+                                : insert_unique(mystl::move(value)).first;
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last)
+  {
+    insert_range(first, last);
+  }
+
+  // 批量插入[first, last)，已有的元素或区间内重复的元素保留先出现的一个
+  template <class InputIterator>
+  void insert_range(InputIterator first, InputIterator last)
+  {
+    const size_type old_size = size();
+    try
+    {
+      for (; first != last; ++first)
+        keys_.push_back(*first);
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + old_size, keys_.end());
+      throw;
+    }
+    merge_tail(old_size);
+  }
+
+  iterator  erase(const_iterator position)
+  { return keys_.erase(position); }
+  iterator  erase(const_iterator first, const_iterator last)
+  { return keys_.erase(first, last); }
+  size_type erase(const key_type& key)
+  {
+    const_iterator it = find(key);
+    if (it == end())
+      return 0;
+    keys_.erase(it);
+    return 1;
+  }
+
+  void      clear() { keys_.clear(); }
+
+  // flat_set 相关操作
+
+  iterator       find(const key_type& key) const
+  {
+    const_iterator it = lower_bound(key);
+    return (it == end() || comp_(key, *it)) ? end() : it;
+  }
+
+  size_type      count(const key_type& key) const
+  { return find(key) != end() ? 1 : 0; }
+
+  bool           contains(const key_type& key) const
+  { return find(key) != end(); }
+
+  iterator       lower_bound(const key_type& key) const
+  { return mystl::lower_bound(keys_.begin(), keys_.end(), key, comp_); }
+
+  iterator       upper_bound(const key_type& key) const
+  { return mystl::upper_bound(keys_.begin(), keys_.end(), key, comp_); }
+
+  pair<iterator, iterator>
+    equal_range(const key_type& key) const
+  {
+    const_iterator it = find(key);
+    return it == end() ? pair<iterator, iterator>(it, it)
+                       : pair<iterator, iterator>(it, it + 1);
+  }
+
+  void swap(flat_set& rhs) noexcept
+  {
+    keys_.swap(rhs.keys_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+private:
+  // helper functions
+
+  bool hint_ok(const_iterator hint, const value_type& value) const
+  {
+    return (hint == begin() || comp_(*(hint - 1), value)) &&
+           (hint == end() || comp_(value, *hint));
+  }
+
+  template <class V>
+  pair<iterator, bool> insert_unique(V&& value)
+  {
+    const_iterator it = lower_bound(value);
+    if (it != end() && !comp_(value, *it))
+      return pair<iterator, bool>(it, false);
+    return pair<iterator, bool>(keys_.emplace(it, mystl::forward<V>(value)), true);
+  }
+
+  // [0, old_size) 已经有序且不重复，把 [old_size, size()) 并入其中
+  // 与原有的元素合并之前抛出异常时截断新追加的部分，合并之后抛出异常时清空
+  void merge_tail(size_type old_size)
+  {
+    if (old_size == size())
+      return;
+    auto middle = keys_.begin() + old_size;
+    bool merged = false;
+    try
+    {
+      // 稳定排序使重复的元素中先出现的排在前面，原有的元素总在新追加的元素之前
+      mystl::stable_sort(middle, keys_.end(), comp_);
+      if (old_size != 0 && !comp_(*(middle - 1), *middle))
+      {
+        merged = true;
+        mystl::inplace_merge(keys_.begin(), middle, keys_.end(), comp_);
+      }
+      // 没有合并时新元素都大于原有的元素，只需要对新追加的部分去重
+      Compare comp = comp_;
+      auto equiv = [comp](const value_type& a, const value_type& b) { return !comp(a, b); };
+      keys_.erase(mystl::unique(merged ? keys_.begin() : middle, keys_.end(), equiv), keys_.end());
+    }
+    catch (...)
+    {
+      if (merged)
+        keys_.clear();
+      else
+        keys_.erase(middle, keys_.end());
+      throw;
+    }
+  }
+};
+
+// 重载比较操作符
+template <class Key, class Compare>
+bool operator==(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return lhs.keys() == rhs.keys();
+}
+
+template <class Key, class Compare>
+bool operator<(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return lhs.keys() < rhs.keys();
+}
+
+template <class Key, class Compare>
+bool operator!=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class Compare>
+bool operator>(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class Compare>
+bool operator<=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class Compare>
+bool operator>=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class Compare>
+void swap(flat_set<Key, Compare>& lhs, flat_set<Key, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_SET_H_
+
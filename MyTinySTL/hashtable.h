@@ -4,6 +4,16 @@
 // 这个头文件包含了一个模板类 hashtable
 // hashtable : 哈希表，使用开链法处理冲突
 
+// notes:
+//
+// 1. 重建表格时只重新链接节点，不复制元素，指向元素的指针与引用保持有效
+// 2. 打开 incremental_rehash 后，插入导致的扩容改为渐进式进行：新旧两个 bucket 数组同时存在，
+//    之后每次插入与按键值删除时迁移旧表中的几个桶，全部迁移完才释放旧表。迁移期间一个键值
+//    在其所在的旧桶被迁移之前仍留在旧桶中，查找时根据迁移进度只检查一条链表，查找本身不迁移。
+//    单次插入不再需要一次移动所有元素，代价是迁移期间插入与删除会改变遍历顺序。
+//    显式调用 rehash / reserve 时仍一次完成
+// 3. 迁移期间 bucket 接口只反映新表
+
 #include <initializer_list>
 
 #include "algo.h"
@@ -206,9 +216,7 @@ struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual>
     node = node->next;
     if (node == nullptr)
     { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-      auto index = ht->hash(value_traits::get_key(old->value));
-      while (!node && ++index < ht->bucket_size_)
-        node = ht->buckets_[index];
+      node = ht->M_next_head(value_traits::get_key(old->value));
     }
     return *this;
   }
@@ -284,11 +292,7 @@ struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual>
     node = node->next;
     if (node == nullptr)
     { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-      auto index = ht->hash(value_traits::get_key(old->value));
-      while (!node && ++index < ht->bucket_size_)
-      {
-        node = ht->buckets_[index];
-      }
+      node = ht->M_next_head(value_traits::get_key(old->value));
     }
     return *this;
   }
@@ -467,6 +471,27 @@ inline size_t ht_next_prime(size_t n)
   return pos == last ? *(last - 1) : *pos;
 }
 
+// 判断哈希函数与键值比较函数是否都声明了 is_transparent
+// 参数 K 只用来让判断依赖于查找时传入的键值类型，使 enable_if 能够在重载决议中起作用
+template <class ...Types>
+struct ht_void
+{
+  typedef void type;
+};
+
+template <class Hash, class KeyEqual, class K, class = void>
+struct ht_is_transparent :public mystl::m_false_type {};
+
+template <class Hash, class KeyEqual, class K>
+struct ht_is_transparent<Hash, KeyEqual, K,
+  typename ht_void<typename Hash::is_transparent, typename KeyEqual::is_transparent>::type>
+  :public mystl::m_true_type {};
+
+// 只有 Hash 与 KeyEqual 都是透明的，才启用接受任意键值类型 K 的查找重载
+template <class Hash, class KeyEqual, class K, class R = void>
+using ht_enable_if_transparent = typename std::enable_if<
+  ht_is_transparent<Hash, KeyEqual, K>::value, R>::type;
+
 // 模板类 hashtable
 // 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
 template <class T, class Hash, class KeyEqual>
@@ -516,40 +541,93 @@ private:
   hasher      hash_;
   key_equal   equal_;
 
+  // 渐进式重建使用的旧表，old_bucket_size_ 为 0 表示不在迁移中
+  // 旧表中 [0, rehash_index_) 的桶已经迁移到新表
+  bucket_type old_buckets_;
+  size_type   old_bucket_size_;
+  size_type   rehash_index_;
+  bool        incremental_;
+
+  static constexpr size_type kRehashStep = 4;  // 每次操作迁移的非空桶数
+
 private:
-  bool is_equal(const key_type& key1, const key_type& key2)
+  template <class K>
+  bool is_equal(const key_type& key1, const K& key2) const
   {
     return equal_(key1, key2);
   }
 
-  bool is_equal(const key_type& key1, const key_type& key2) const
+  const_iterator M_cit(node_ptr node) const noexcept
   {
-    return equal_(key1, key2);
+    return const_iterator(node, const_cast<hashtable*>(this));
   }
 
-  const_iterator M_cit(node_ptr node) const noexcept
+  // 键值所在的桶，迁移期间旧表中还未迁移的桶里的键值仍留在旧表
+  template <class K>
+  node_ptr& M_bucket(const K& key)
   {
-    return const_iterator(node, const_cast<hashtable*>(this));
+    const size_type h = hash_(key);
+    if (old_bucket_size_ != 0 && h % old_bucket_size_ >= rehash_index_)
+      return old_buckets_[h % old_bucket_size_];
+    return buckets_[h % bucket_size_];
   }
 
-  iterator M_begin() noexcept
+  template <class K>
+  node_ptr M_bucket(const K& key) const
   {
-    for (size_type n = 0; n < bucket_size_; ++n)
+    const size_type h = hash_(key);
+    if (old_bucket_size_ != 0 && h % old_bucket_size_ >= rehash_index_)
+      return old_buckets_[h % old_bucket_size_];
+    return buckets_[h % bucket_size_];
+  }
+
+  // 遍历顺序中位于 key 所在的桶之后的第一个节点
+  // 迁移期间先遍历旧表中还未迁移的桶，再遍历新表
+  template <class K>
+  node_ptr M_next_head(const K& key) const
+  {
+    const size_type h = hash_(key);
+    size_type index = h % bucket_size_;
+    if (old_bucket_size_ != 0 && h % old_bucket_size_ >= rehash_index_)
     {
-      if (buckets_[n])  // 找到第一个有节点的位置就返回
-        return iterator(buckets_[n], this);
+      for (index = h % old_bucket_size_ + 1; index < old_bucket_size_; ++index)
+      {
+        if (old_buckets_[index])
+          return old_buckets_[index];
+      }
+      index = static_cast<size_type>(-1);  // 从新表的第一个桶开始
     }
-    return iterator(nullptr, this);
+    while (++index < bucket_size_)
+    {
+      if (buckets_[index])
+        return buckets_[index];
+    }
+    return nullptr;
   }
 
-  const_iterator M_begin() const noexcept
+  node_ptr M_first_head() const noexcept
   {
+    for (size_type n = rehash_index_; n < old_bucket_size_; ++n)
+    {
+      if (old_buckets_[n])
+        return old_buckets_[n];
+    }
     for (size_type n = 0; n < bucket_size_; ++n)
     {
       if (buckets_[n])  // 找到第一个有节点的位置就返回
-        return M_cit(buckets_[n]);
+        return buckets_[n];
     }
-    return M_cit(nullptr);
+    return nullptr;
+  }
+
+  iterator M_begin() noexcept
+  {
+    return iterator(M_first_head(), this);
+  }
+
+  const_iterator M_begin() const noexcept
+  {
+    return M_cit(M_first_head());
   }
 
 public:
@@ -557,7 +635,8 @@ public:
   explicit hashtable(size_type bucket_count,
                      const Hash& hash = Hash(),
                      const KeyEqual& equal = KeyEqual())
-    :size_(0), mlf_(1.0f), hash_(hash), equal_(equal)
+    :size_(0), mlf_(1.0f), hash_(hash), equal_(equal),
+    old_bucket_size_(0), rehash_index_(0), incremental_(false)
   {
     init(bucket_count);
   }
@@ -568,7 +647,8 @@ public:
               size_type bucket_count,
               const Hash& hash = Hash(),
               const KeyEqual& equal = KeyEqual())
-    :size_(mystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal)
+    :size_(mystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal),
+    old_bucket_size_(0), rehash_index_(0), incremental_(false)
   {
     init(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))));
   }
@@ -583,12 +663,18 @@ public:
     size_(rhs.size_),
     mlf_(rhs.mlf_),
     hash_(rhs.hash_),
-    equal_(rhs.equal_)
+    equal_(rhs.equal_),
+    old_bucket_size_(rhs.old_bucket_size_),
+    rehash_index_(rhs.rehash_index_),
+    incremental_(rhs.incremental_)
   {
     buckets_ = mystl::move(rhs.buckets_);
+    old_buckets_ = mystl::move(rhs.old_buckets_);
     rhs.bucket_size_ = 0;
     rhs.size_ = 0;
     rhs.mlf_ = 0.0f;
+    rhs.old_bucket_size_ = 0;
+    rhs.rehash_index_ = 0;
   }
 
   hashtable& operator=(const hashtable& rhs);
@@ -682,25 +768,40 @@ public:
   void      erase(const_iterator position);
   void      erase(const_iterator first, const_iterator last);
 
-  size_type erase_multi(const key_type& key);
-  size_type erase_unique(const key_type& key);
+  template <class K>
+  size_type erase_multi(const K& key);
+  template <class K>
+  size_type erase_unique(const K& key);
 
   void      clear();
 
   void      swap(hashtable& rhs) noexcept;
 
   // 查找相关操作
+  // 以下函数接受任意键值类型 K，只要 Hash 与 KeyEqual 能够直接作用于 K
+  // 是否允许异构查找由上层容器通过 ht_enable_if_transparent 决定
 
-  size_type                            count(const key_type& key) const;
+  template <class K>
+  size_type                            count(const K& key) const;
 
-  iterator                             find(const key_type& key);
-  const_iterator                       find(const key_type& key) const;
+  template <class K>
+  iterator                             find(const K& key);
+  template <class K>
+  const_iterator                       find(const K& key) const;
 
-  pair<iterator, iterator>             equal_range_multi(const key_type& key);
-  pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const;
+  template <class K>
+  pair<iterator, iterator>             equal_range_multi(const K& key);
+  template <class K>
+  pair<const_iterator, const_iterator> equal_range_multi(const K& key) const;
 
-  pair<iterator, iterator>             equal_range_unique(const key_type& key);
-  pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const;
+  template <class K>
+  pair<iterator, iterator>             equal_range_unique(const K& key);
+  template <class K>
+  pair<const_iterator, const_iterator> equal_range_unique(const K& key) const;
+
+  // 比较两个容器的元素是否相同，与元素的顺序无关
+  bool equal_to_multi(const hashtable& other) const;
+  bool equal_to_unique(const hashtable& other) const;
 
   // bucket interface
 
@@ -763,6 +864,20 @@ public:
   void reserve(size_type count)
   { rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f)); }
 
+  // 渐进式重建，关闭时完成正在进行的迁移
+  bool incremental_rehash() const noexcept
+  { return incremental_; }
+  void incremental_rehash(bool enable)
+  {
+    if (!enable)
+      finish_rehash();
+    incremental_ = enable;
+  }
+
+  // 是否正处于迁移之中
+  bool rehashing()          const noexcept
+  { return old_bucket_size_ != 0; }
+
   hasher    hash_fcn() const { return hash_; }
   key_equal key_eq()   const { return equal_; }
 
@@ -780,9 +895,14 @@ private:
 
   // hash
   size_type next_size(size_type n) const;
-  size_type hash(const key_type& key, size_type n) const;
-  size_type hash(const key_type& key) const;
+  template <class K>
+  size_type hash(const K& key, size_type n) const;
+  template <class K>
+  size_type hash(const K& key) const;
   void      rehash_if_need(size_type n);
+  void      start_rehash(size_type count);
+  void      rehash_step(size_type n);
+  void      finish_rehash();
 
   // insert
   template <class InputIter>
@@ -799,13 +919,12 @@ private:
   iterator             insert_node_multi(node_ptr np);
 
   // bucket operator
+  void copy_bucket(bucket_type& bucket, const bucket_type& other,
+                   size_type first, size_type last);
+  void move_chain(node_ptr first);
   void replace_bucket(size_type bucket_count);
   void erase_bucket(size_type n, node_ptr first, node_ptr last);
   void erase_bucket(size_type n, node_ptr last);
-
-  // comparision
-  bool equal_to_multi(const hashtable& other);
-  bool equal_to_unique(const hashtable& other);
 };
 
 /*****************************************************************************************/
@@ -846,8 +965,7 @@ emplace_multi(Args&& ...args)
   auto np = create_node(mystl::forward<Args>(args)...);
   try
   {
-    if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-      rehash(size_ + 1);
+    rehash_if_need(1);
   }
   catch (...)
   {
@@ -868,8 +986,7 @@ emplace_unique(Args&& ...args)
   auto np = create_node(mystl::forward<Args>(args)...);
   try
   {
-    if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-      rehash(size_ + 1);
+    rehash_if_need(1);
   }
   catch (...)
   {
@@ -885,8 +1002,8 @@ pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
 hashtable<T, Hash, KeyEqual>::
 insert_unique_noresize(const value_type& value)
 {
-  const auto n = hash(value_traits::get_key(value));
-  auto first = buckets_[n];
+  node_ptr& head = M_bucket(value_traits::get_key(value));
+  auto first = head;
   for (auto cur = first; cur; cur = cur->next)
   {
     if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value)))
@@ -895,7 +1012,7 @@ insert_unique_noresize(const value_type& value)
   // 让新节点成为链表的第一个节点
   auto tmp = create_node(value);  
   tmp->next = first;
-  buckets_[n] = tmp;
+  head = tmp;
   ++size_;
   return mystl::make_pair(iterator(tmp, this), true);
 }
@@ -906,8 +1023,8 @@ typename hashtable<T, Hash, KeyEqual>::iterator
 hashtable<T, Hash, KeyEqual>::
 insert_multi_noresize(const value_type& value)
 {
-  const auto n = hash(value_traits::get_key(value));
-  auto first = buckets_[n];
+  node_ptr& head = M_bucket(value_traits::get_key(value));
+  auto first = head;
   auto tmp = create_node(value);
   for (auto cur = first; cur; cur = cur->next)
   {
@@ -921,7 +1038,7 @@ insert_multi_noresize(const value_type& value)
   }
   // 否则插入在链表头部
   tmp->next = first;
-  buckets_[n] = tmp;
+  head = tmp;
   ++size_;
   return iterator(tmp, this);
 }
@@ -934,11 +1051,11 @@ erase(const_iterator position)
   auto p = position.node;
   if (p)
   {
-    const auto n = hash(value_traits::get_key(p->value));
-    auto cur = buckets_[n];
+    node_ptr& head = M_bucket(value_traits::get_key(p->value));
+    auto cur = head;
     if (cur == p)
     { // p 位于链表头部
-      buckets_[n] = cur->next;
+      head = cur->next;
       destroy_node(cur);
       --size_;
     }
@@ -971,6 +1088,12 @@ erase(const_iterator first, const_iterator last)
 {
   if (first.node == last.node)
     return;
+  if (old_bucket_size_ != 0)
+  { // 迁移期间区间可能跨越两个数组，逐个删除
+    while (first != last)
+      erase(first++);
+    return;
+  }
   auto first_bucket = first.node 
     ? hash(value_traits::get_key(first.node->value)) 
     : bucket_size_;
@@ -998,31 +1121,38 @@ erase(const_iterator first, const_iterator last)
 
 // 删除键值为 key 的节点
 template <class T, class Hash, class KeyEqual>
+template <class K>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
-erase_multi(const key_type& key)
+erase_multi(const K& key)
 {
+  if (old_bucket_size_ != 0)
+    rehash_step(kRehashStep);
   auto p = equal_range_multi(key);
   if (p.first.node != nullptr)
-  {
+  { // 先计算区间长度，删除之后迭代器已经失效
+    const size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
     erase(p.first, p.second);
-    return mystl::distance(p.first, p.second);
+    return n;
   }
   return 0;
 }
 
 template <class T, class Hash, class KeyEqual>
+template <class K>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
-erase_unique(const key_type& key)
+erase_unique(const K& key)
 {
-  const auto n = hash(key);
-  auto first = buckets_[n];
+  if (old_bucket_size_ != 0)
+    rehash_step(kRehashStep);
+  node_ptr& head = M_bucket(key);
+  auto first = head;
   if (first)
   {
     if (is_equal(value_traits::get_key(first->value), key))
     {
-      buckets_[n] = first->next;
+      head = first->next;
       destroy_node(first);
       --size_;
       return 1;
@@ -1065,8 +1195,24 @@ clear()
       }
       buckets_[i] = nullptr;
     }
+    for (size_type i = rehash_index_; i < old_bucket_size_; ++i)
+    {
+      node_ptr cur = old_buckets_[i];
+      while (cur != nullptr)
+      {
+        node_ptr next = cur->next;
+        destroy_node(cur);
+        cur = next;
+      }
+    }
     size_ = 0;
   }
+  if (old_bucket_size_ != 0)
+  { // 直接丢弃旧表
+    bucket_type().swap(old_buckets_);
+    old_bucket_size_ = 0;
+    rehash_index_ = 0;
+  }
 }
 
 // 在某个 bucket 节点的个数
@@ -1088,6 +1234,7 @@ template <class T, class Hash, class KeyEqual>
 void hashtable<T, Hash, KeyEqual>::
 rehash(size_type count)
 {
+  finish_rehash();
   auto n = ht_next_prime(count);
   if (n > bucket_size_)
   {
@@ -1105,36 +1252,36 @@ rehash(size_type count)
 
 // 查找键值为 key 的节点，返回其迭代器
 template <class T, class Hash, class KeyEqual>
+template <class K>
 typename hashtable<T, Hash, KeyEqual>::iterator
 hashtable<T, Hash, KeyEqual>::
-find(const key_type& key)
+find(const K& key)
 {
-  const auto n = hash(key);
-  node_ptr first = buckets_[n];
+  node_ptr first = M_bucket(key);
   for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
   return iterator(first, this);
 }
 
 template <class T, class Hash, class KeyEqual>
+template <class K>
 typename hashtable<T, Hash, KeyEqual>::const_iterator
 hashtable<T, Hash, KeyEqual>::
-find(const key_type& key) const
+find(const K& key) const
 {
-  const auto n = hash(key);
-  node_ptr first = buckets_[n];
+  node_ptr first = M_bucket(key);
   for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
   return M_cit(first);
 }
 
 // 查找键值为 key 出现的次数
 template <class T, class Hash, class KeyEqual>
+template <class K>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
-count(const key_type& key) const
+count(const K& key) const
 {
-  const auto n = hash(key);
   size_type result = 0;
-  for (node_ptr cur = buckets_[n]; cur; cur = cur->next)
+  for (node_ptr cur = M_bucket(key); cur; cur = cur->next)
   {
     if (is_equal(value_traits::get_key(cur->value), key))
       ++result;
@@ -1144,13 +1291,13 @@ count(const key_type& key) const
 
 // 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
 template <class T, class Hash, class KeyEqual>
+template <class K>
 pair<typename hashtable<T, Hash, KeyEqual>::iterator,
   typename hashtable<T, Hash, KeyEqual>::iterator>
 hashtable<T, Hash, KeyEqual>::
-equal_range_multi(const key_type& key)
+equal_range_multi(const K& key)
 {
-  const auto n = hash(key);
-  for (node_ptr first = buckets_[n]; first; first = first->next)
+  for (node_ptr first = M_bucket(key); first; first = first->next)
   {
     if (is_equal(value_traits::get_key(first->value), key))
     { // 如果出现相等的键值
@@ -1159,25 +1306,21 @@ equal_range_multi(const key_type& key)
         if (!is_equal(value_traits::get_key(second->value), key))
           return mystl::make_pair(iterator(first, this), iterator(second, this));
       }
-      for (auto m = n + 1; m < bucket_size_; ++m)
-      { // 整个链表都相等，查找下一个链表出现的位置
-        if (buckets_[m])
-          return mystl::make_pair(iterator(first, this), iterator(buckets_[m], this));
-      }
-      return mystl::make_pair(iterator(first, this), end());
+      // 整个链表都相等，查找下一个链表出现的位置
+      return mystl::make_pair(iterator(first, this), iterator(M_next_head(key), this));
     }
   }
   return mystl::make_pair(end(), end());
 }
 
 template <class T, class Hash, class KeyEqual>
+template <class K>
 pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
   typename hashtable<T, Hash, KeyEqual>::const_iterator>
 hashtable<T, Hash, KeyEqual>::
-equal_range_multi(const key_type& key) const
+equal_range_multi(const K& key) const
 {
-  const auto n = hash(key);
-  for (node_ptr first = buckets_[n]; first; first = first->next)
+  for (node_ptr first = M_bucket(key); first; first = first->next)
   {
     if (is_equal(value_traits::get_key(first->value), key))
     {
@@ -1186,60 +1329,48 @@ equal_range_multi(const key_type& key) const
         if (!is_equal(value_traits::get_key(second->value), key))
           return mystl::make_pair(M_cit(first), M_cit(second));
       }
-      for (auto m = n + 1; m < bucket_size_; ++m)
-      { // 整个链表都相等，查找下一个链表出现的位置
-        if (buckets_[m])
-          return mystl::make_pair(M_cit(first), M_cit(buckets_[m]));
-      }
-      return mystl::make_pair(M_cit(first), cend());
+      // 整个链表都相等，查找下一个链表出现的位置
+      return mystl::make_pair(M_cit(first), M_cit(M_next_head(key)));
     }
   }
   return mystl::make_pair(cend(), cend());
 }
 
 template <class T, class Hash, class KeyEqual>
+template <class K>
 pair<typename hashtable<T, Hash, KeyEqual>::iterator,
   typename hashtable<T, Hash, KeyEqual>::iterator>
 hashtable<T, Hash, KeyEqual>::
-equal_range_unique(const key_type& key)
+equal_range_unique(const K& key)
 {
-  const auto n = hash(key);
-  for (node_ptr first = buckets_[n]; first; first = first->next)
+  for (node_ptr first = M_bucket(key); first; first = first->next)
   {
     if (is_equal(value_traits::get_key(first->value), key))
     {
       if (first->next)
         return mystl::make_pair(iterator(first, this), iterator(first->next, this));
-      for (auto m = n + 1; m < bucket_size_; ++m)
-      { // 整个链表都相等，查找下一个链表出现的位置
-        if (buckets_[m])
-          return mystl::make_pair(iterator(first, this), iterator(buckets_[m], this));
-      }
-      return mystl::make_pair(iterator(first, this), end());
+      // 整个链表都相等，查找下一个链表出现的位置
+      return mystl::make_pair(iterator(first, this), iterator(M_next_head(key), this));
     }
   }
   return mystl::make_pair(end(), end());
 }
 
 template <class T, class Hash, class KeyEqual>
+template <class K>
 pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
   typename hashtable<T, Hash, KeyEqual>::const_iterator>
 hashtable<T, Hash, KeyEqual>::
-equal_range_unique(const key_type& key) const
+equal_range_unique(const K& key) const
 {
-  const auto n = hash(key);
-  for (node_ptr first = buckets_[n]; first; first = first->next)
+  for (node_ptr first = M_bucket(key); first; first = first->next)
   {
     if (is_equal(value_traits::get_key(first->value), key))
     {
       if (first->next)
         return mystl::make_pair(M_cit(first), M_cit(first->next));
-      for (auto m = n + 1; m < bucket_size_; ++m)
-      { // 整个链表都相等，查找下一个链表出现的位置
-        if (buckets_[m])
-          return mystl::make_pair(M_cit(first), M_cit(buckets_[m]));
-      }
-      return mystl::make_pair(M_cit(first), cend());
+      // 整个链表都相等，查找下一个链表出现的位置
+      return mystl::make_pair(M_cit(first), M_cit(M_next_head(key)));
     }
   }
   return mystl::make_pair(cend(), cend());
@@ -1258,6 +1389,10 @@ swap(hashtable& rhs) noexcept
     mystl::swap(mlf_, rhs.mlf_);
     mystl::swap(hash_, rhs.hash_);
     mystl::swap(equal_, rhs.equal_);
+    old_buckets_.swap(rhs.old_buckets_);
+    mystl::swap(old_bucket_size_, rhs.old_bucket_size_);
+    mystl::swap(rehash_index_, rhs.rehash_index_);
+    mystl::swap(incremental_, rhs.incremental_);
   }
 }
 
@@ -1290,24 +1425,20 @@ void hashtable<T, Hash, KeyEqual>::
 copy_init(const hashtable& ht)
 {
   bucket_size_ = 0;
+  old_bucket_size_ = 0;
+  rehash_index_ = 0;
+  incremental_ = ht.incremental_;
   buckets_.reserve(ht.bucket_size_);
   buckets_.assign(ht.bucket_size_, nullptr);
   try
   {
-    for (size_type i = 0; i < ht.bucket_size_; ++i)
-    {
-      node_ptr cur = ht.buckets_[i];
-      if (cur)
-      { // 如果某 bucket 存在链表
-        auto copy = create_node(cur->value);
-        buckets_[i] = copy;
-        for (auto next = cur->next; next; cur = next, next = cur->next)
-        {  //复制链表
-          copy->next = create_node(next->value);
-          copy = copy->next;
-        }
-        copy->next = nullptr;
-      }
+    copy_bucket(buckets_, ht.buckets_, 0, ht.bucket_size_);
+    if (ht.old_bucket_size_ != 0)
+    { // 迁移中的表连同旧表一起复制
+      old_buckets_.assign(ht.old_bucket_size_, nullptr);
+      old_bucket_size_ = ht.old_bucket_size_;
+      rehash_index_ = ht.rehash_index_;
+      copy_bucket(old_buckets_, ht.old_buckets_, ht.rehash_index_, ht.old_bucket_size_);
     }
     bucket_size_ = ht.bucket_size_;
     mlf_ = ht.mlf_;
@@ -1360,17 +1491,19 @@ hashtable<T, Hash, KeyEqual>::next_size(size_type n) const
 
 // hash 函数
 template <class T, class Hash, class KeyEqual>
+template <class K>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
-hash(const key_type& key, size_type n) const
+hash(const K& key, size_type n) const
 {
   return hash_(key) % n;
 }
 
 template <class T, class Hash, class KeyEqual>
+template <class K>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
-hash(const key_type& key) const
+hash(const K& key) const
 {
   return hash_(key) % bucket_size_;
 }
@@ -1380,8 +1513,76 @@ template <class T, class Hash, class KeyEqual>
 void hashtable<T, Hash, KeyEqual>::
 rehash_if_need(size_type n)
 {
+  if (old_bucket_size_ != 0)
+    rehash_step(kRehashStep);
   if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
-    rehash(size_ + n);
+  { // 批量插入时一次完成重建
+    if (incremental_ && n == 1)
+      start_rehash(size_ + n);
+    else
+      rehash(size_ + n);
+  }
+}
+
+// start_rehash 函数
+// 分配新表并把当前表作为旧表，之后由 rehash_step 逐步迁移
+template <class T, class Hash, class KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+start_rehash(size_type count)
+{
+  const auto n = ht_next_prime(count);
+  if (n <= bucket_size_)
+  {
+    rehash(count);
+    return;
+  }
+  // 上一次迁移还未完成时先完成它，正常情况下迁移总是先于下一次扩容完成
+  finish_rehash();
+  bucket_type bucket(n);
+  old_buckets_.swap(buckets_);
+  buckets_.swap(bucket);
+  old_bucket_size_ = bucket_size_;
+  bucket_size_ = n;
+  rehash_index_ = 0;
+  rehash_step(kRehashStep);
+}
+
+// rehash_step 函数
+// 把旧表中最多 n 个非空的桶迁移到新表，最多访问 10 * n 个空桶，全部迁移后释放旧表
+template <class T, class Hash, class KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+rehash_step(size_type n)
+{
+  size_type empty_visits = n * 10;
+  while (n > 0 && rehash_index_ < old_bucket_size_)
+  {
+    node_ptr first = old_buckets_[rehash_index_];
+    if (first == nullptr)
+    {
+      ++rehash_index_;
+      if (--empty_visits == 0)
+        break;
+      continue;
+    }
+    old_buckets_[rehash_index_++] = nullptr;
+    move_chain(first);
+    --n;
+  }
+  if (rehash_index_ == old_bucket_size_)
+  {
+    bucket_type().swap(old_buckets_);
+    old_bucket_size_ = 0;
+    rehash_index_ = 0;
+  }
+}
+
+// finish_rehash 函数
+template <class T, class Hash, class KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+finish_rehash()
+{
+  if (old_bucket_size_ != 0)
+    rehash_step(old_bucket_size_);
 }
 
 // copy_insert
@@ -1433,11 +1634,11 @@ typename hashtable<T, Hash, KeyEqual>::iterator
 hashtable<T, Hash, KeyEqual>::
 insert_node_multi(node_ptr np)
 {
-  const auto n = hash(value_traits::get_key(np->value));
-  auto cur = buckets_[n];
+  node_ptr& head = M_bucket(value_traits::get_key(np->value));
+  auto cur = head;
   if (cur == nullptr)
   {
-    buckets_[n] = np;
+    head = np;
     ++size_;
     return iterator(np, this);
   }
@@ -1451,8 +1652,8 @@ insert_node_multi(node_ptr np)
       return iterator(np, this);
     }
   }
-  np->next = buckets_[n];
-  buckets_[n] = np;
+  np->next = head;
+  head = np;
   ++size_;
   return iterator(np, this);
 }
@@ -1463,63 +1664,81 @@ pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
 hashtable<T, Hash, KeyEqual>::
 insert_node_unique(node_ptr np)
 {
-  const auto n = hash(value_traits::get_key(np->value));
-  auto cur = buckets_[n];
+  node_ptr& head = M_bucket(value_traits::get_key(np->value));
+  auto cur = head;
   if (cur == nullptr)
   {
-    buckets_[n] = np;
+    head = np;
     ++size_;
     return mystl::make_pair(iterator(np, this), true);
   }
   for (; cur; cur = cur->next)
   {
     if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(np->value)))
-    {
+    { // 键值已经存在，释放新节点
+      destroy_node(np);
       return mystl::make_pair(iterator(cur, this), false);
     }
   }
-  np->next = buckets_[n];
-  buckets_[n] = np;
+  np->next = head;
+  head = np;
   ++size_;
   return mystl::make_pair(iterator(np, this), true);
 }
 
-// replace_bucket 函数
+// copy_bucket 函数
+// 复制 other 中 [first, last) 的桶到 bucket 的相同位置
 template <class T, class Hash, class KeyEqual>
 void hashtable<T, Hash, KeyEqual>::
-replace_bucket(size_type bucket_count)
+copy_bucket(bucket_type& bucket, const bucket_type& other, size_type first, size_type last)
 {
-  bucket_type bucket(bucket_count);
-  if (size_ != 0)
-  {
-    for (size_type i = 0; i < bucket_size_; ++i)
-    {
-      for (auto first = buckets_[i]; first; first = first->next)
-      {
-        auto tmp = create_node(first->value);
-        const auto n = hash(value_traits::get_key(first->value), bucket_count);
-        auto f = bucket[n];
-        bool is_inserted = false;
-        for (auto cur = f; cur; cur = cur->next)
-        {
-          if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(first->value)))
-          {
-            tmp->next = cur->next;
-            cur->next = tmp;
-            is_inserted = true;
-            break;
-          }
-        }
-        if (!is_inserted)
-        {
-          tmp->next = f;
-          bucket[n] = tmp;
-        }
+  for (size_type i = first; i < last; ++i)
+  {
+    node_ptr cur = other[i];
+    if (cur)
+    { // 如果某 bucket 存在链表
+      auto copy = create_node(cur->value);
+      bucket[i] = copy;
+      for (auto next = cur->next; next; cur = next, next = cur->next)
+      {  //复制链表
+        copy->next = create_node(next->value);
+        copy = copy->next;
       }
+      copy->next = nullptr;
     }
   }
+}
+
+// move_chain 函数
+// 把以 first 开头的链表中的节点逐个链接到当前表中
+// 键值相等的节点在原链表中相邻，且会进入同一个桶，逐个插入到链表头部后仍然相邻
+template <class T, class Hash, class KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+move_chain(node_ptr first)
+{
+  while (first)
+  {
+    node_ptr next = first->next;
+    const auto n = hash(value_traits::get_key(first->value));
+    first->next = buckets_[n];
+    buckets_[n] = first;
+    first = next;
+  }
+}
+
+// replace_bucket 函数
+template <class T, class Hash, class KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+replace_bucket(size_type bucket_count)
+{
+  bucket_type bucket(bucket_count);
   buckets_.swap(bucket);
+  const size_type old_count = bucket_size_;
   bucket_size_ = buckets_.size();
+  for (size_type i = 0; i < old_count; ++i)
+  {
+    move_chain(bucket[i]);
+  }
 }
 
 // erase_bucket 函数
@@ -1566,7 +1785,7 @@ erase_bucket(size_type n, node_ptr last)
 
 // equal_to 函数
 template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other)
+bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other) const
 {
   if (size_ != other.size_)
     return false;
@@ -1574,16 +1793,16 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other)
   {
     auto p1 = equal_range_multi(value_traits::get_key(*f));
     auto p2 = other.equal_range_multi(value_traits::get_key(*f));
-    if (mystl::distance(p1.first, p1.last) != mystl::distance(p2.first, p2.last) ||
-        !mystl::is_permutation(p1.first, p2.last, p2.first, p2.last))
+    if (mystl::distance(p1.first, p1.second) != mystl::distance(p2.first, p2.second) ||
+        !mystl::is_permutation(p1.first, p1.second, p2.first, p2.second))
       return false;
-    f = p1.last;
+    f = p1.second;
   }
   return true;
 }
 
 template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
+bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other) const
 {
   if (size_ != other.size_)
     return false;
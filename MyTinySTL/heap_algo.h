@@ -2,8 +2,14 @@
 #define MYTINYSTL_HEAP_ALGO_H_
 
 // 这个头文件包含 heap 的四个算法 : push_heap, pop_heap, sort_heap, make_heap
+// 以及它们以子节点个数 D 为模板参数的 D 叉 heap 版本 : dary_push_heap, dary_pop_heap,
+// dary_sort_heap, dary_make_heap, dary_is_heap
 
+#include <cstddef>
+
+#include "functional.h"
 #include "iterator.h"
+#include "util.h"
 
 namespace mystl
 {
@@ -222,6 +228,170 @@ void make_heap(RandomIter first, RandomIter last, Compared comp)
   mystl::make_heap_aux(first, last, distance_type(first), comp);
 }
 
+/*****************************************************************************************/
+// dary_push_heap / dary_pop_heap / dary_make_heap / dary_sort_heap / dary_is_heap
+// 每个节点有 D 个子节点的 heap，下标为 i 的节点的子节点为 D * i + 1 ... D * i + D，父节点为 (i - 1) / D
+// D 越大树越矮，push 的比较次数越少，一组兄弟节点位于连续的内存中，下溯时缓存缺失更少
+// 默认使用 operator<，与 push_heap 等相同为 max-heap，重载版本使用函数对象 comp 代替比较操作
+/*****************************************************************************************/
+// 从 holeIndex 开始上溯，把 value 放到合适的位置，不超过 topIndex
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T value,
+                        Compared comp)
+{
+  const Distance d = static_cast<Distance>(D);
+  while (holeIndex > topIndex)
+  {
+    const Distance parent = (holeIndex - 1) / d;
+    if (!comp(*(first + parent), value))
+      break;
+    *(first + holeIndex) = mystl::move(*(first + parent));
+    holeIndex = parent;
+  }
+  *(first + holeIndex) = mystl::move(value);
+}
+
+// Floyd 的自底向上调整：空洞沿着最大的子节点一直下溯到叶子，不与 value 比较，
+// 再从叶子把 value 上溯到合适的位置，value 通常来自 heap 的末尾，上溯的距离很短
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value, Compared comp)
+{
+  const Distance d = static_cast<Distance>(D);
+  const Distance topIndex = holeIndex;
+  Distance child = d * holeIndex + 1;
+  while (child + d <= len)
+  { // D 个子节点都存在
+    Distance best = child;
+    for (Distance k = 1; k < d; ++k)
+    {
+      if (comp(*(first + best), *(first + (child + k))))
+        best = child + k;
+    }
+    *(first + holeIndex) = mystl::move(*(first + best));
+    holeIndex = best;
+    child = d * holeIndex + 1;
+  }
+  if (child < len)
+  { // 最后一组不完整的子节点
+    Distance best = child;
+    for (Distance k = child + 1; k < len; ++k)
+    {
+      if (comp(*(first + best), *(first + k)))
+        best = k;
+    }
+    *(first + holeIndex) = mystl::move(*(first + best));
+    holeIndex = best;
+  }
+  mystl::dary_push_heap_aux<D>(first, holeIndex, topIndex, mystl::move(value), comp);
+}
+
+// 新元素应该已置于底部容器的最尾端
+template <size_t D, class RandomIter, class Compared>
+void dary_push_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  static_assert(D >= 2, "the arity of a heap should be at least 2");
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  typedef typename iterator_traits<RandomIter>::value_type      value_type;
+  if (last - first < 2)
+    return;
+  value_type value = mystl::move(*(last - 1));
+  mystl::dary_push_heap_aux<D>(first, static_cast<Distance>((last - first) - 1),
+                               static_cast<Distance>(0), mystl::move(value), comp);
+}
+
+template <size_t D, class RandomIter>
+void dary_push_heap(RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::dary_push_heap<D>(first, last, mystl::less<value_type>());
+}
+
+// 将根节点取出放到容器尾部，调整[first, last - 1)使之重新成为一个 heap
+template <size_t D, class RandomIter, class Compared>
+void dary_pop_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  static_assert(D >= 2, "the arity of a heap should be at least 2");
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  typedef typename iterator_traits<RandomIter>::value_type      value_type;
+  if (last - first < 2)
+    return;
+  --last;
+  value_type value = mystl::move(*last);
+  *last = mystl::move(*first);
+  mystl::dary_adjust_heap<D>(first, static_cast<Distance>(0), static_cast<Distance>(last - first),
+                             mystl::move(value), comp);
+}
+
+template <size_t D, class RandomIter>
+void dary_pop_heap(RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::dary_pop_heap<D>(first, last, mystl::less<value_type>());
+}
+
+// 从最后一个有子节点的节点开始，依次调整以每个节点为根的子树，O(n)
+template <size_t D, class RandomIter, class Compared>
+void dary_make_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  static_assert(D >= 2, "the arity of a heap should be at least 2");
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  typedef typename iterator_traits<RandomIter>::value_type      value_type;
+  const Distance len = last - first;
+  if (len < 2)
+    return;
+  for (Distance holeIndex = (len - 2) / static_cast<Distance>(D); ; --holeIndex)
+  {
+    value_type value = mystl::move(*(first + holeIndex));
+    mystl::dary_adjust_heap<D>(first, holeIndex, len, mystl::move(value), comp);
+    if (holeIndex == 0)
+      return;
+  }
+}
+
+template <size_t D, class RandomIter>
+void dary_make_heap(RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::dary_make_heap<D>(first, last, mystl::less<value_type>());
+}
+
+template <size_t D, class RandomIter, class Compared>
+void dary_sort_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  while (last - first > 1)
+  {
+    mystl::dary_pop_heap<D>(first, last--, comp);
+  }
+}
+
+template <size_t D, class RandomIter>
+void dary_sort_heap(RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::dary_sort_heap<D>(first, last, mystl::less<value_type>());
+}
+
+// 检查[first, last)是否为一个 D 叉 heap
+template <size_t D, class RandomIter, class Compared>
+bool dary_is_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const Distance len = last - first;
+  for (Distance i = 1; i < len; ++i)
+  {
+    if (comp(*(first + (i - 1) / static_cast<Distance>(D)), *(first + i)))
+      return false;
+  }
+  return true;
+}
+
+template <size_t D, class RandomIter>
+bool dary_is_heap(RandomIter first, RandomIter last)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  return mystl::dary_is_heap<D>(first, last, mystl::less<value_type>());
+}
+
 } // namespace mystl
 #endif // !MYTINYSTL_HEAP_ALGO_H_
 
@@ -114,6 +114,7 @@ struct list_iterator : public mystl::iterator<mystl::bidirectional_iterator_tag,
     :node_(x->as_base()) {}
   list_iterator(const list_iterator& rhs)
     :node_(rhs.node_) {}
+  list_iterator& operator=(const list_iterator& rhs) = default;
 
   // 重载操作符
   reference operator*()  const { return node_->as_node()->value; }
@@ -170,6 +171,7 @@ struct list_const_iterator : public iterator<bidirectional_iterator_tag, T>
     :node_(rhs.node_) {}
   list_const_iterator(const list_const_iterator& rhs)
     :node_(rhs.node_) {}
+  list_const_iterator& operator=(const list_const_iterator& rhs) = default;
 
   reference operator*()  const { return node_->as_node()->value; }
   pointer   operator->() const { return &(operator*()); }
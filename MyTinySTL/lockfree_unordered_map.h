@@ -0,0 +1,458 @@
+﻿#ifndef MYTINYSTL_LOCKFREE_UNORDERED_MAP_H_
+#define MYTINYSTL_LOCKFREE_UNORDERED_MAP_H_
+
+// 这个头文件包含一个模板类 lockfree_unordered_map
+// lockfree_unordered_map : 无锁哈希表，使用 Shalev 与 Shavit 的 split-ordered list 实现，键值不允许重复
+
+// notes:
+//
+// 1. 所有元素按照哈希值按位反转后的顺序（split order）链接在一条 Harris-Michael 无锁有序链表中，
+//    桶只是指向链表中哨兵节点的指针。桶数加倍时元素不需要移动，新的桶在第一次被访问时
+//    从它的父桶开始插入哨兵节点，扩容因此是增量、无锁的
+// 2. 桶数组分段存放，第 0 段有 kSegmentBase 个桶，之后每段的桶数是前面所有段之和，段在需要时用 CAS 安装
+// 3. 删除节点时先标记它的 next 指针，再把它从链表中摘除，只有摘除成功的线程回收它
+// 4. 每个操作都处于 ebr_guard 的作用域内，摘除的节点交给 ebr 延迟回收
+// 5. find 把实值复制出来，因为离开操作之后节点随时可能被回收
+//
+// 异常保证：
+// mystl::lockfree_unordered_map<Key, T> 的 insert 做强异常安全保证，其它操作不抛出异常（内存分配除外）
+
+#include <atomic>
+#include <cstdint>
+
+#include "ebr.h"
+#include "functional.h"
+#include "memory.h"
+#include "util.h"
+
+namespace mystl
+{
+
+/*****************************************************************************************/
+// split-ordered list 的节点
+// next 的最低位为删除标记；so_key 为哈希值按位反转后的键，哨兵节点最低位为 0，元素节点最低位为 1
+/*****************************************************************************************/
+struct lf_node_base
+{
+  std::atomic<uintptr_t> next;
+  uint64_t               so_key;
+
+  explicit lf_node_base(uint64_t key) :next(0), so_key(key) {}
+};
+
+template <class T>
+struct lf_node :public lf_node_base
+{
+  T value;
+
+  template <class ...Args>
+  explicit lf_node(uint64_t key, Args&& ...args)
+    :lf_node_base(key), value(mystl::forward<Args>(args)...)
+  {
+  }
+};
+
+// 按位反转一个 64 位整数
+inline uint64_t lf_reverse_bits(uint64_t x) noexcept
+{
+  x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+  x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+  x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+  x = ((x >> 8) & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+  x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+  return (x >> 32) | (x << 32);
+}
+
+// 最高位的 1 的位置，x 不为 0
+inline size_t lf_floor_log2(size_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return sizeof(unsigned long long) * 8 - 1 -
+    static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(x)));
+#else
+  size_t n = 0;
+  while (x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+// 模板类 lockfree_unordered_map，键值不允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash
+// 参数四代表键值比较方式，缺省使用 mystl::equal_to
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+class lockfree_unordered_map
+{
+public:
+  typedef Key                               key_type;
+  typedef T                                 mapped_type;
+  typedef mystl::pair<const Key, T>         value_type;
+  typedef Hash                              hasher;
+  typedef KeyEqual                          key_equal;
+  typedef size_t                            size_type;
+
+private:
+  typedef lf_node_base                         base_type;
+  typedef lf_node<value_type>                  node_type;
+  typedef std::atomic<base_type*>              bucket_type;
+
+  typedef mystl::allocator<base_type>          dummy_allocator;
+  typedef mystl::allocator<node_type>          node_allocator;
+  typedef mystl::allocator<bucket_type>        bucket_allocator;
+
+  static constexpr size_type kSegmentBase  = 64;  // 第 0 段的桶数
+  static constexpr size_type kSegmentShift = 6;   // log2(kSegmentBase)
+  static constexpr size_type kSegmentCount = 64 - kSegmentShift + 1;
+  static constexpr size_type kMaxLoad      = 2;   // 平均每个桶的元素数超过它时桶数加倍
+
+  mutable std::atomic<bucket_type*> segments_[kSegmentCount];
+  std::atomic<size_type> bucket_count_;
+  std::atomic<size_type> size_;
+  hasher                 hash_;
+  key_equal              equal_;
+
+public:
+  // 构造、析构函数，bucket_count 向上取为 2 的幂
+  explicit lockfree_unordered_map(size_type bucket_count = 16,
+                                  const Hash& hash = Hash(),
+                                  const KeyEqual& equal = KeyEqual());
+  ~lockfree_unordered_map();
+
+  lockfree_unordered_map(const lockfree_unordered_map&) = delete;
+  lockfree_unordered_map& operator=(const lockfree_unordered_map&) = delete;
+
+public:
+  // 容量相关操作，并发修改时只是一个近似值
+  bool      empty()        const noexcept { return size() == 0; }
+  size_type size()         const noexcept { return size_.load(std::memory_order_relaxed); }
+  size_type bucket_count() const noexcept { return bucket_count_.load(std::memory_order_relaxed); }
+
+  // 插入元素，键值已存在时不做任何操作并返回 false
+  bool insert(const key_type& key, const mapped_type& obj);
+
+  // 删除键值为 key 的元素，返回是否删除了元素
+  bool erase(const key_type& key);
+
+  // 查找键值为 key 的元素，找到时把实值复制到 result 并返回 true
+  bool find(const key_type& key, mapped_type& result) const;
+  bool contains(const key_type& key) const;
+
+  hasher    hash_function() const { return hash_; }
+  key_equal key_eq()        const { return equal_; }
+
+private:
+  // 指针与删除标记
+  static base_type* ptr_of(uintptr_t p) noexcept
+  { return reinterpret_cast<base_type*>(p & ~static_cast<uintptr_t>(1)); }
+  static bool       is_marked(uintptr_t p) noexcept
+  { return (p & 1) != 0; }
+  static uintptr_t  to_word(base_type* p) noexcept
+  { return reinterpret_cast<uintptr_t>(p); }
+
+  static uint64_t   regular_key(size_type h) noexcept
+  { return lf_reverse_bits(static_cast<uint64_t>(h)) | 1; }
+  static uint64_t   dummy_key(size_type bucket) noexcept
+  { return lf_reverse_bits(static_cast<uint64_t>(bucket)); }
+
+  static void       delete_node(node_type* node);
+
+  bucket_type& bucket_at(size_type bucket) const;
+  base_type*   get_bucket(size_type bucket) const;
+  void         initialize_bucket(size_type bucket) const;
+
+  bool list_find(base_type* head, uint64_t so_key, const key_type* key,
+                 std::atomic<uintptr_t>*& prev, base_type*& cur) const;
+};
+
+/*****************************************************************************************/
+
+template <class Key, class T, class Hash, class KeyEqual>
+lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+lockfree_unordered_map(size_type bucket_count, const Hash& hash, const KeyEqual& equal)
+  :bucket_count_(2), size_(0), hash_(hash), equal_(equal)
+{
+  for (size_type i = 0; i < kSegmentCount; ++i)
+    segments_[i].store(nullptr, std::memory_order_relaxed);
+  size_type n = 2;
+  while (n < bucket_count)
+    n <<= 1;
+  bucket_count_.store(n, std::memory_order_relaxed);
+  // 0 号桶的哨兵节点是整条链表的头
+  base_type* head = dummy_allocator::allocate();
+  mystl::construct(head, static_cast<uint64_t>(0));
+  try
+  {
+    bucket_at(0).store(head, std::memory_order_relaxed);
+  }
+  catch (...)
+  {
+    mystl::destroy(head);
+    dummy_allocator::deallocate(head);
+    throw;
+  }
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+~lockfree_unordered_map()
+{
+  base_type* cur = segments_[0].load(std::memory_order_relaxed)[0].load(std::memory_order_relaxed);
+  while (cur)
+  {
+    base_type* next = ptr_of(cur->next.load(std::memory_order_relaxed));
+    if (cur->so_key & 1)
+    {
+      delete_node(static_cast<node_type*>(cur));
+    }
+    else
+    {
+      mystl::destroy(cur);
+      dummy_allocator::deallocate(cur);
+    }
+    cur = next;
+  }
+  for (size_type i = 0; i < kSegmentCount; ++i)
+  {
+    bucket_type* segment = segments_[i].load(std::memory_order_relaxed);
+    if (segment)
+    {
+      const size_type n = i == 0 ? kSegmentBase : kSegmentBase << (i - 1);
+      mystl::destroy(segment, segment + n);
+      bucket_allocator::deallocate(segment, n);
+    }
+  }
+}
+
+// 插入元素
+template <class Key, class T, class Hash, class KeyEqual>
+bool lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+insert(const key_type& key, const mapped_type& obj)
+{
+  const size_type h = hash_(key);
+  node_type* node = node_allocator::allocate();
+  try
+  {
+    mystl::construct(node, regular_key(h), key, obj);
+  }
+  catch (...)
+  {
+    node_allocator::deallocate(node);
+    throw;
+  }
+  ebr_guard guard;
+  const size_type count = bucket_count_.load(std::memory_order_acquire);
+  base_type* head = get_bucket(h & (count - 1));
+  std::atomic<uintptr_t>* prev;
+  base_type* cur;
+  for (;;)
+  {
+    if (list_find(head, node->so_key, &key, prev, cur))
+    { // 节点还未发布，可以直接释放
+      delete_node(node);
+      return false;
+    }
+    node->next.store(to_word(cur), std::memory_order_relaxed);
+    uintptr_t expected = to_word(cur);
+    if (prev->compare_exchange_strong(expected, to_word(node), std::memory_order_release,
+                                      std::memory_order_relaxed))
+      break;
+  }
+  // 平均每个桶的元素数超过 kMaxLoad 时把桶数加倍，新桶在第一次访问时初始化
+  const size_type n = size_.fetch_add(1, std::memory_order_relaxed) + 1;
+  size_type c = bucket_count_.load(std::memory_order_relaxed);
+  if (n > c * kMaxLoad && c < (kSegmentBase << (kSegmentCount - 2)))
+    bucket_count_.compare_exchange_strong(c, c * 2, std::memory_order_release,
+                                          std::memory_order_relaxed);
+  return true;
+}
+
+// 删除元素：先标记，再摘除
+template <class Key, class T, class Hash, class KeyEqual>
+bool lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+erase(const key_type& key)
+{
+  const size_type h = hash_(key);
+  const uint64_t so_key = regular_key(h);
+  ebr_guard guard;
+  const size_type count = bucket_count_.load(std::memory_order_acquire);
+  base_type* head = get_bucket(h & (count - 1));
+  std::atomic<uintptr_t>* prev;
+  base_type* cur;
+  for (;;)
+  {
+    if (!list_find(head, so_key, &key, prev, cur))
+      return false;
+    uintptr_t next = cur->next.load(std::memory_order_acquire);
+    if (is_marked(next))
+      continue;
+    if (!cur->next.compare_exchange_strong(next, next | 1, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed))
+      continue;
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    uintptr_t expected = to_word(cur);
+    if (prev->compare_exchange_strong(expected, next, std::memory_order_acq_rel,
+                                      std::memory_order_relaxed))
+      ebr::retire(static_cast<node_type*>(cur));
+    else  // 摘除失败时由 list_find 摘除并回收
+      list_find(head, so_key, &key, prev, cur);
+    return true;
+  }
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+bool lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+find(const key_type& key, mapped_type& result) const
+{
+  const size_type h = hash_(key);
+  ebr_guard guard;
+  const size_type count = bucket_count_.load(std::memory_order_acquire);
+  std::atomic<uintptr_t>* prev;
+  base_type* cur;
+  if (!list_find(get_bucket(h & (count - 1)), regular_key(h), &key, prev, cur))
+    return false;
+  result = static_cast<node_type*>(cur)->value.second;
+  return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+bool lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+contains(const key_type& key) const
+{
+  const size_type h = hash_(key);
+  ebr_guard guard;
+  const size_type count = bucket_count_.load(std::memory_order_acquire);
+  std::atomic<uintptr_t>* prev;
+  base_type* cur;
+  return list_find(get_bucket(h & (count - 1)), regular_key(h), &key, prev, cur);
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class Key, class T, class Hash, class KeyEqual>
+void lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+delete_node(node_type* node)
+{
+  mystl::destroy(node);
+  node_allocator::deallocate(node);
+}
+
+// 找到桶所在的段，段不存在时分配并用 CAS 安装
+template <class Key, class T, class Hash, class KeyEqual>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual>::bucket_type&
+lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+bucket_at(size_type bucket) const
+{
+  size_type seg = 0, offset = bucket, n = kSegmentBase;
+  if (bucket >= kSegmentBase)
+  {
+    const size_type log = lf_floor_log2(bucket);
+    seg = log - kSegmentShift + 1;
+    offset = bucket - (static_cast<size_type>(1) << log);
+    n = static_cast<size_type>(1) << log;
+  }
+  std::atomic<bucket_type*>& slot = segments_[seg];
+  bucket_type* segment = slot.load(std::memory_order_acquire);
+  if (segment == nullptr)
+  {
+    bucket_type* fresh = bucket_allocator::allocate(n);
+    for (size_type i = 0; i < n; ++i)
+      mystl::construct(fresh + i, nullptr);
+    if (slot.compare_exchange_strong(segment, fresh, std::memory_order_acq_rel,
+                                     std::memory_order_acquire))
+    {
+      segment = fresh;
+    }
+    else
+    {
+      mystl::destroy(fresh, fresh + n);
+      bucket_allocator::deallocate(fresh, n);
+    }
+  }
+  return segment[offset];
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+typename lockfree_unordered_map<Key, T, Hash, KeyEqual>::base_type*
+lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+get_bucket(size_type bucket) const
+{
+  bucket_type& b = bucket_at(bucket);
+  base_type* head = b.load(std::memory_order_acquire);
+  if (head == nullptr)
+  {
+    initialize_bucket(bucket);
+    head = b.load(std::memory_order_acquire);
+  }
+  return head;
+}
+
+// 从父桶开始把哨兵节点插入链表，父桶是去掉最高位的 1 之后的桶
+template <class Key, class T, class Hash, class KeyEqual>
+void lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+initialize_bucket(size_type bucket) const
+{
+  const size_type parent = bucket & ~(static_cast<size_type>(1) << lf_floor_log2(bucket));
+  base_type* head = get_bucket(parent);
+  base_type* dummy = dummy_allocator::allocate();
+  mystl::construct(dummy, dummy_key(bucket));
+  std::atomic<uintptr_t>* prev;
+  base_type* cur;
+  for (;;)
+  {
+    if (list_find(head, dummy->so_key, nullptr, prev, cur))
+    { // 其它线程已经插入了这个哨兵
+      mystl::destroy(dummy);
+      dummy_allocator::deallocate(dummy);
+      dummy = cur;
+      break;
+    }
+    dummy->next.store(to_word(cur), std::memory_order_relaxed);
+    uintptr_t expected = to_word(cur);
+    if (prev->compare_exchange_strong(expected, to_word(dummy), std::memory_order_release,
+                                      std::memory_order_relaxed))
+      break;
+  }
+  base_type* expected = nullptr;
+  bucket_at(bucket).compare_exchange_strong(expected, dummy, std::memory_order_release,
+                                            std::memory_order_relaxed);
+}
+
+// 从 head 开始查找 so_key 与键值都相等的节点，key 为空指针时查找哨兵节点
+// 返回时 prev 指向 cur 的前驱的 next 字段，cur 为第一个不小于目标的节点
+// 途中遇到被标记的节点就把它摘除并回收
+template <class Key, class T, class Hash, class KeyEqual>
+bool lockfree_unordered_map<Key, T, Hash, KeyEqual>::
+list_find(base_type* head, uint64_t so_key, const key_type* key,
+          std::atomic<uintptr_t>*& prev, base_type*& cur) const
+{
+retry:
+  prev = &head->next;
+  cur = ptr_of(prev->load(std::memory_order_acquire));
+  while (cur)
+  {
+    const uintptr_t next = cur->next.load(std::memory_order_acquire);
+    if (is_marked(next))
+    {
+      uintptr_t expected = to_word(cur);
+      if (!prev->compare_exchange_strong(expected, next & ~static_cast<uintptr_t>(1),
+                                         std::memory_order_acq_rel, std::memory_order_relaxed))
+        goto retry;
+      ebr::retire(static_cast<node_type*>(cur));
+      cur = ptr_of(next);
+      continue;
+    }
+    if (cur->so_key > so_key)
+      return false;
+    if (cur->so_key == so_key &&
+        (key == nullptr || equal_(static_cast<node_type*>(cur)->value.first, *key)))
+      return true;
+    prev = &cur->next;
+    cur = ptr_of(next);
+  }
+  return false;
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_LOCKFREE_UNORDERED_MAP_H_
+
@@ -5,8 +5,10 @@
 // 包含一些基本函数、空间配置器、未初始化的储存空间管理，以及一个模板类 auto_ptr
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <climits>
+#include <new>
 
 #include "algobase.h"
 #include "allocator.h"
@@ -58,6 +60,32 @@ void release_temporary_buffer(T* ptr)
   free(ptr);
 }
 
+// 按缓存行对齐的空间
+// 不同线程频繁写入的对象（每个线程的记录、每个分片的锁等）若落在同一个缓存行中，
+// 一个线程的写入会使其它线程缓存的这一行失效，即伪共享。这类对象的类型用 alignas(kCacheLineSize)
+// 声明，使每个对象独占整数个缓存行。C++11 的 operator new 只保证基本对齐，
+// 因此它们的空间要用 aligned_allocate 分配
+constexpr static size_t kCacheLineSize = 64;
+
+// 分配能容纳 n 个 T 的未初始化空间，起始地址按 alignof(T) 对齐，只能用 aligned_deallocate 释放
+template <class T>
+T* aligned_allocate(size_t n)
+{
+  const size_t align = alignof(T) > alignof(void*) ? alignof(T) : alignof(void*);
+  char* raw = static_cast<char*>(::operator new(n * sizeof(T) + align + sizeof(void*)));
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(raw + sizeof(void*));
+  char* p = reinterpret_cast<char*>((addr + align - 1) & ~static_cast<uintptr_t>(align - 1));
+  reinterpret_cast<void**>(p)[-1] = raw;  // 在对齐后的地址之前保存原始地址
+  return reinterpret_cast<T*>(p);
+}
+
+template <class T>
+void aligned_deallocate(T* ptr) noexcept
+{
+  if (ptr != nullptr)
+    ::operator delete(reinterpret_cast<void**>(ptr)[-1]);
+}
+
 // --------------------------------------------------------------------------------------
 // 类模板 : temporary_buffer
 // 进行临时缓冲区的申请与释放
@@ -124,6 +152,7 @@ template <class ForwardIterator, class T>
 void temporary_buffer<ForwardIterator, T>::allocate_buffer()
 {
   original_len = len;
+  buffer = nullptr;
   if (len > static_cast<ptrdiff_t>(INT_MAX / sizeof(T)))
     len = INT_MAX / sizeof(T);
   while (len > 0)
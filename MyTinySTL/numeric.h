@@ -3,19 +3,44 @@
 
 // 这个头文件包含了 mystl 的数值算法
 
+// notes:
+//
+// 1. reduce, transform_reduce, inclusive_scan, exclusive_scan 允许以任意顺序结合二元操作，
+//    随机访问迭代器使用多路累加，连续内存中的算术类型使用 simd.h 中的向量化内核，
+//    浮点数的结果可能与 accumulate, inner_product, partial_sum 有舍入误差
+// 2. accumulate, inner_product, partial_sum 只对整数使用向量化的内核，结果与逐个计算完全相同，
+//    adjacent_difference 逐个元素独立计算，对整数与浮点数都使用向量化的内核
+
+#include "functional.h"
 #include "iterator.h"
+#include "simd.h"
 
 namespace mystl
 {
 
+// 连续内存中的元素类型 Tp 去掉 const 之后与结果类型 T 相同，并且可以使用 simd 中的算术内核
+template <class Tp, class T>
+struct is_simd_numeric :public m_bool_constant<
+  !std::is_volatile<Tp>::value &&
+  std::is_same<typename std::remove_cv<Tp>::type, T>::value &&
+  mystl::simd::is_summable<T>::value>
+{
+};
+
+// 整数的加法与乘法在按模回绕时满足结合律与交换律，改变求值顺序不影响结果
+template <class Tp, class T>
+struct is_simd_integral :public m_bool_constant<
+  is_simd_numeric<Tp, T>::value && std::is_integral<T>::value>
+{
+};
+
 /*****************************************************************************************/
 // accumulate
 // 版本1：以初值 init 对每个元素进行累加
 // 版本2：以初值 init 对每个元素进行二元操作
 /*****************************************************************************************/
-// 版本1
 template <class InputIter, class T>
-T accumulate(InputIter first, InputIter last, T init)
+T unchecked_accumulate(InputIter first, InputIter last, T init)
 {
   for (; first != last; ++first)
   {
@@ -24,6 +49,21 @@ T accumulate(InputIter first, InputIter last, T init)
   return init;
 }
 
+// 连续内存中的整数使用向量化的多路累加
+template <class Tp, class T>
+typename std::enable_if<is_simd_integral<Tp, T>::value, T>::type
+unchecked_accumulate(Tp* first, Tp* last, T init)
+{
+  return mystl::simd::sum<T>(first, last, init);
+}
+
+// 版本1
+template <class InputIter, class T>
+T accumulate(InputIter first, InputIter last, T init)
+{
+  return mystl::unchecked_accumulate(first, last, init);
+}
+
 // 版本2
 template <class InputIter, class T, class BinaryOp>
 T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
@@ -40,9 +80,8 @@ T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
 // 版本1：计算相邻元素的差值，结果保存到以 result 为起始的区间上
 // 版本2：自定义相邻元素的二元操作
 /*****************************************************************************************/
-// 版本1
 template <class InputIter, class OutputIter>
-OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter result)
+OutputIter unchecked_adjacent_difference(InputIter first, InputIter last, OutputIter result)
 {
   if (first == last)  return result;
   *result = *first;  // 记录第一个元素
@@ -56,6 +95,21 @@ OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter resul
   return ++result;
 }
 
+// 连续内存中的算术类型使用向量化的版本
+template <class Tp, class T>
+typename std::enable_if<is_simd_numeric<Tp, T>::value, T*>::type
+unchecked_adjacent_difference(Tp* first, Tp* last, T* result)
+{
+  return mystl::simd::adjacent_difference<T>(first, last, result);
+}
+
+// 版本1
+template <class InputIter, class OutputIter>
+OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter result)
+{
+  return mystl::unchecked_adjacent_difference(first, last, result);
+}
+
 // 版本2
 template <class InputIter, class OutputIter, class BinaryOp>
 OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter result,
@@ -78,9 +132,8 @@ OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter resul
 // 版本1：以 init 为初值，计算两个区间的内积   
 // 版本2：自定义 operator+ 和 operator*
 /*****************************************************************************************/
-// 版本1
 template <class InputIter1, class InputIter2, class T>
-T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+T unchecked_inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
 {
   for (; first1 != last1; ++first1, ++first2)
   {
@@ -89,6 +142,21 @@ T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
   return init;
 }
 
+// 连续内存中的整数使用向量化的多路累加
+template <class Tp, class Up, class T>
+typename std::enable_if<is_simd_integral<Tp, T>::value && is_simd_integral<Up, T>::value, T>::type
+unchecked_inner_product(Tp* first1, Tp* last1, Up* first2, T init)
+{
+  return mystl::simd::dot<T>(first1, last1, first2, init);
+}
+
+// 版本1
+template <class InputIter1, class InputIter2, class T>
+T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+  return mystl::unchecked_inner_product(first1, last1, first2, init);
+}
+
 // 版本2
 template <class InputIter1, class InputIter2, class T, class BinaryOp1, class BinaryOp2>
 T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
@@ -121,7 +189,7 @@ void iota(ForwardIter first, ForwardIter last, T value)
 // 版本2：进行局部进行自定义二元操作
 /*****************************************************************************************/
 template <class InputIter, class OutputIter>
-OutputIter partial_sum(InputIter first, InputIter last, OutputIter result)
+OutputIter unchecked_partial_sum(InputIter first, InputIter last, OutputIter result)
 {
   if (first == last)  return result;
   *result = *first;  // 记录第一个元素
@@ -134,6 +202,23 @@ OutputIter partial_sum(InputIter first, InputIter last, OutputIter result)
   return ++result;
 }
 
+// 连续内存中的整数使用向量化的版本
+template <class Tp, class T>
+typename std::enable_if<is_simd_integral<Tp, T>::value, T*>::type
+unchecked_partial_sum(Tp* first, Tp* last, T* result)
+{
+  if (first == last)  return result;
+  *result = *first;
+  return mystl::simd::inclusive_scan<T>(first + 1, last, result + 1, *first);
+}
+
+// 版本1
+template <class InputIter, class OutputIter>
+OutputIter partial_sum(InputIter first, InputIter last, OutputIter result)
+{
+  return mystl::unchecked_partial_sum(first, last, result);
+}
+
 // 版本2
 template <class InputIter, class OutputIter, class BinaryOp>
 OutputIter partial_sum(InputIter first, InputIter last, OutputIter result,
@@ -150,6 +235,293 @@ OutputIter partial_sum(InputIter first, InputIter last, OutputIter result,
   return ++result;
 }
 
+/*****************************************************************************************/
+// reduce
+// 版本1：以元素类型的默认值为初值，对每个元素进行累加
+// 版本2：以初值 init 对每个元素进行累加
+// 版本3：以初值 init 对每个元素进行二元操作 binary_op，binary_op 须满足结合律与交换律
+// 与 accumulate 不同，reduce 不保证求值的顺序
+/*****************************************************************************************/
+template <class InputIter, class T, class BinaryOp>
+T reduce_dispatch(InputIter first, InputIter last, T init, BinaryOp binary_op,
+                  input_iterator_tag)
+{
+  return mystl::accumulate(first, last, init, binary_op);
+}
+
+// 以前 4 个元素为 4 个累加器的初值，4 条依赖链可以同时执行
+template <class RandomIter, class T, class BinaryOp>
+T reduce_dispatch(RandomIter first, RandomIter last, T init, BinaryOp binary_op,
+                  random_access_iterator_tag)
+{
+  if (last - first < 8)
+    return mystl::accumulate(first, last, init, binary_op);
+  T s0 = first[0], s1 = first[1], s2 = first[2], s3 = first[3];
+  for (first += 4; last - first >= 4; first += 4)
+  {
+    s0 = binary_op(s0, first[0]);
+    s1 = binary_op(s1, first[1]);
+    s2 = binary_op(s2, first[2]);
+    s3 = binary_op(s3, first[3]);
+  }
+  for (; first != last; ++first)
+    s0 = binary_op(s0, *first);
+  return binary_op(init, binary_op(binary_op(s0, s1), binary_op(s2, s3)));
+}
+
+template <class InputIter, class T, class BinaryOp>
+T unchecked_reduce(InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+  return mystl::reduce_dispatch(first, last, init, binary_op, iterator_category(first));
+}
+
+// 连续内存中的算术类型求和使用向量化的内核
+template <class Tp, class T>
+typename std::enable_if<is_simd_numeric<Tp, T>::value, T>::type
+unchecked_reduce(Tp* first, Tp* last, T init, mystl::plus<T>)
+{
+  return mystl::simd::sum<T>(first, last, init);
+}
+
+// 版本1
+template <class InputIter>
+typename iterator_traits<InputIter>::value_type
+reduce(InputIter first, InputIter last)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  return mystl::unchecked_reduce(first, last, value_type(), mystl::plus<value_type>());
+}
+
+// 版本2
+template <class InputIter, class T>
+T reduce(InputIter first, InputIter last, T init)
+{
+  return mystl::unchecked_reduce(first, last, init, mystl::plus<T>());
+}
+
+// 版本3
+template <class InputIter, class T, class BinaryOp>
+T reduce(InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+  return mystl::unchecked_reduce(first, last, init, binary_op);
+}
+
+/*****************************************************************************************/
+// transform_reduce
+// 版本1：以 init 为初值，计算两个区间的内积，不保证求值的顺序
+// 版本2：以 transform_op 作用于两个区间的对应元素，再以 reduce_op 与 init 归约
+// 版本3：以 unary_op 作用于每个元素，再以 reduce_op 与 init 归约
+// reduce_op 须满足结合律与交换律
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class T, class ReduceOp, class TransformOp,
+          class Tag1, class Tag2>
+T transform_reduce_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                            ReduceOp reduce_op, TransformOp transform_op, Tag1, Tag2)
+{
+  return mystl::inner_product(first1, last1, first2, init, reduce_op, transform_op);
+}
+
+template <class RandomIter1, class RandomIter2, class T, class ReduceOp, class TransformOp>
+T transform_reduce_dispatch(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, T init,
+                            ReduceOp reduce_op, TransformOp transform_op,
+                            random_access_iterator_tag, random_access_iterator_tag)
+{
+  if (last1 - first1 < 8)
+    return mystl::inner_product(first1, last1, first2, init, reduce_op, transform_op);
+  T s0 = transform_op(first1[0], first2[0]), s1 = transform_op(first1[1], first2[1]);
+  T s2 = transform_op(first1[2], first2[2]), s3 = transform_op(first1[3], first2[3]);
+  for (first1 += 4, first2 += 4; last1 - first1 >= 4; first1 += 4, first2 += 4)
+  {
+    s0 = reduce_op(s0, transform_op(first1[0], first2[0]));
+    s1 = reduce_op(s1, transform_op(first1[1], first2[1]));
+    s2 = reduce_op(s2, transform_op(first1[2], first2[2]));
+    s3 = reduce_op(s3, transform_op(first1[3], first2[3]));
+  }
+  for (; first1 != last1; ++first1, ++first2)
+    s0 = reduce_op(s0, transform_op(*first1, *first2));
+  return reduce_op(init, reduce_op(reduce_op(s0, s1), reduce_op(s2, s3)));
+}
+
+template <class InputIter1, class InputIter2, class T>
+T unchecked_transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+  return mystl::transform_reduce_dispatch(first1, last1, first2, init,
+                                          mystl::plus<T>(), mystl::multiplies<T>(),
+                                          iterator_category(first1), iterator_category(first2));
+}
+
+// 连续内存中的算术类型使用向量化的内核
+template <class Tp, class Up, class T>
+typename std::enable_if<is_simd_numeric<Tp, T>::value && is_simd_numeric<Up, T>::value, T>::type
+unchecked_transform_reduce(Tp* first1, Tp* last1, Up* first2, T init)
+{
+  return mystl::simd::dot<T>(first1, last1, first2, init);
+}
+
+template <class InputIter, class T, class ReduceOp, class UnaryOp>
+T transform_reduce_dispatch(InputIter first, InputIter last, T init,
+                            ReduceOp reduce_op, UnaryOp unary_op, input_iterator_tag)
+{
+  for (; first != last; ++first)
+    init = reduce_op(init, unary_op(*first));
+  return init;
+}
+
+template <class RandomIter, class T, class ReduceOp, class UnaryOp>
+T transform_reduce_dispatch(RandomIter first, RandomIter last, T init,
+                            ReduceOp reduce_op, UnaryOp unary_op, random_access_iterator_tag)
+{
+  if (last - first < 8)
+    return mystl::transform_reduce_dispatch(first, last, init, reduce_op, unary_op,
+                                            input_iterator_tag());
+  T s0 = unary_op(first[0]), s1 = unary_op(first[1]);
+  T s2 = unary_op(first[2]), s3 = unary_op(first[3]);
+  for (first += 4; last - first >= 4; first += 4)
+  {
+    s0 = reduce_op(s0, unary_op(first[0]));
+    s1 = reduce_op(s1, unary_op(first[1]));
+    s2 = reduce_op(s2, unary_op(first[2]));
+    s3 = reduce_op(s3, unary_op(first[3]));
+  }
+  for (; first != last; ++first)
+    s0 = reduce_op(s0, unary_op(*first));
+  return reduce_op(init, reduce_op(reduce_op(s0, s1), reduce_op(s2, s3)));
+}
+
+// 版本1
+template <class InputIter1, class InputIter2, class T>
+T transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+  return mystl::unchecked_transform_reduce(first1, last1, first2, init);
+}
+
+// 版本2
+template <class InputIter1, class InputIter2, class T, class ReduceOp, class TransformOp>
+T transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                   ReduceOp reduce_op, TransformOp transform_op)
+{
+  return mystl::transform_reduce_dispatch(first1, last1, first2, init, reduce_op, transform_op,
+                                          iterator_category(first1), iterator_category(first2));
+}
+
+// 版本3
+template <class InputIter, class T, class ReduceOp, class UnaryOp>
+T transform_reduce(InputIter first, InputIter last, T init, ReduceOp reduce_op, UnaryOp unary_op)
+{
+  return mystl::transform_reduce_dispatch(first, last, init, reduce_op, unary_op,
+                                          iterator_category(first));
+}
+
+/*****************************************************************************************/
+// inclusive_scan
+// 版本1：计算局部累计求和，结果保存到以 result 为起始的区间上，第 i 个结果包含第 i 个元素
+// 版本2：以二元操作 binary_op 代替加法
+// 版本3：以 init 为初值，第一个结果为 binary_op(init, *first)
+// 与 partial_sum 不同，inclusive_scan 不保证求值的顺序，binary_op 须满足结合律
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter unchecked_inclusive_scan(InputIter first, InputIter last, OutputIter result,
+                                    BinaryOp binary_op)
+{
+  return mystl::partial_sum(first, last, result, binary_op);
+}
+
+// 连续内存中的算术类型求和使用向量化的内核
+template <class Tp, class T>
+typename std::enable_if<is_simd_numeric<Tp, T>::value, T*>::type
+unchecked_inclusive_scan(Tp* first, Tp* last, T* result, mystl::plus<T>)
+{
+  if (first == last)  return result;
+  *result = *first;
+  return mystl::simd::inclusive_scan<T>(first + 1, last, result + 1, *first);
+}
+
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter unchecked_inclusive_scan(InputIter first, InputIter last, OutputIter result,
+                                    BinaryOp binary_op, T init)
+{
+  for (; first != last; ++first, ++result)
+  {
+    init = binary_op(init, *first);
+    *result = init;
+  }
+  return result;
+}
+
+template <class Tp, class T>
+typename std::enable_if<is_simd_numeric<Tp, T>::value, T*>::type
+unchecked_inclusive_scan(Tp* first, Tp* last, T* result, mystl::plus<T>, T init)
+{
+  return mystl::simd::inclusive_scan<T>(first, last, result, init);
+}
+
+// 版本1
+template <class InputIter, class OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result)
+{
+  typedef typename iterator_traits<InputIter>::value_type value_type;
+  return mystl::unchecked_inclusive_scan(first, last, result, mystl::plus<value_type>());
+}
+
+// 版本2
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          BinaryOp binary_op)
+{
+  return mystl::unchecked_inclusive_scan(first, last, result, binary_op);
+}
+
+// 版本3
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          BinaryOp binary_op, T init)
+{
+  return mystl::unchecked_inclusive_scan(first, last, result, binary_op, init);
+}
+
+/*****************************************************************************************/
+// exclusive_scan
+// 版本1：以 init 为初值计算局部累计求和，结果保存到以 result 为起始的区间上，
+//        第 i 个结果不包含第 i 个元素，第一个结果为 init
+// 版本2：以二元操作 binary_op 代替加法
+// 不保证求值的顺序，binary_op 须满足结合律，result 可以等于 first
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class T, class BinaryOp>
+OutputIter unchecked_exclusive_scan(InputIter first, InputIter last, OutputIter result,
+                                    T init, BinaryOp binary_op)
+{
+  for (; first != last; ++first, ++result)
+  {
+    auto value = *first;  // 先读出元素，result 等于 first 时不会被覆盖
+    *result = init;
+    init = binary_op(init, value);
+  }
+  return result;
+}
+
+// 连续内存中的算术类型求和使用向量化的内核
+template <class Tp, class T>
+typename std::enable_if<is_simd_numeric<Tp, T>::value, T*>::type
+unchecked_exclusive_scan(Tp* first, Tp* last, T* result, T init, mystl::plus<T>)
+{
+  return mystl::simd::exclusive_scan<T>(first, last, result, init);
+}
+
+// 版本1
+template <class InputIter, class OutputIter, class T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter result, T init)
+{
+  return mystl::unchecked_exclusive_scan(first, last, result, init, mystl::plus<T>());
+}
+
+// 版本2
+template <class InputIter, class OutputIter, class T, class BinaryOp>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          T init, BinaryOp binary_op)
+{
+  return mystl::unchecked_exclusive_scan(first, last, result, init, binary_op);
+}
+
 } // namespace mystl
 #endif // !MYTINYSTL_NUMERIC_H_
 
@@ -0,0 +1,991 @@
+﻿#ifndef MYTINYSTL_ORDER_STATISTIC_TREE_H_
+#define MYTINYSTL_ORDER_STATISTIC_TREE_H_
+
+// 这个头文件包含一个模板类 order_statistic_tree
+// order_statistic_tree : 顺序统计树，在有序集合上以 O(log n) 回答第 k 小元素、元素排名与区间计数
+
+// notes:
+//
+// 1. 底层是 AVL 树，每个节点额外记录以它为根的子树的节点个数（size），
+//    插入、删除与旋转时沿路径向上维护 size 与高度，复杂度均为 O(log n)
+// 2. nth(k) 返回第 k 小（从 0 开始）的元素，rank(key) 返回小于 key 的元素个数，
+//    count_range(lo, hi) 返回落在 [lo, hi) 中的元素个数，index(it) 返回 it 之前的元素个数
+// 3. 提供 _unique 与 _multi 两组插入删除接口，分别对应键值不允许重复与允许重复的集合
+// 4. 元素不允许修改，iterator 与 const_iterator 相同；插入与删除不会使其它元素的迭代器失效
+// 5. 使用一个头节点：头节点的 parent 指向根节点，left 与 right 分别指向最小与最大的节点，
+//    头节点的高度为 0，以此与普通节点区分，end() 即头节点
+//
+// 异常保证：
+// mystl::order_statistic_tree<T> 满足基本异常保证，对插入操作做强异常安全保证
+
+#include "algobase.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// 节点设计
+
+struct ost_node_base
+{
+  typedef ost_node_base* base_ptr;
+
+  base_ptr parent;
+  base_ptr left;
+  base_ptr right;
+  size_t   size;    // 以该节点为根的子树中的节点个数
+  int      height;  // 以该节点为根的子树高度，叶节点为 1，头节点为 0
+};
+
+template <class T>
+struct ost_node :public ost_node_base
+{
+  T value;
+};
+
+/*****************************************************************************************/
+// 树的算法
+
+inline size_t ost_size(const ost_node_base* x) noexcept
+{
+  return x ? x->size : 0;
+}
+
+inline int ost_height(const ost_node_base* x) noexcept
+{
+  return x ? x->height : 0;
+}
+
+// 由左右子树重新计算 x 的 size 与高度
+inline void ost_update(ost_node_base* x) noexcept
+{
+  const int lh = ost_height(x->left);
+  const int rh = ost_height(x->right);
+  x->height = (lh > rh ? lh : rh) + 1;
+  x->size = ost_size(x->left) + ost_size(x->right) + 1;
+}
+
+inline ost_node_base* ost_minimum(ost_node_base* x) noexcept
+{
+  while (x->left != nullptr)
+    x = x->left;
+  return x;
+}
+
+inline ost_node_base* ost_maximum(ost_node_base* x) noexcept
+{
+  while (x->right != nullptr)
+    x = x->right;
+  return x;
+}
+
+// 中序遍历的下一个节点，最大节点的下一个节点是头节点
+inline ost_node_base* ost_next(ost_node_base* x) noexcept
+{
+  if (x->right != nullptr)
+    return ost_minimum(x->right);
+  ost_node_base* y = x->parent;
+  while (x == y->right)
+  {
+    x = y;
+    y = y->parent;
+  }
+  // 从最大节点（且为根节点）出发时，x 停在头节点，此时 x 就是结果
+  return x->right != y ? y : x;
+}
+
+// 中序遍历的上一个节点，头节点的上一个节点是最大节点
+inline ost_node_base* ost_prev(ost_node_base* x) noexcept
+{
+  if (x->height == 0)
+    return x->right;
+  if (x->left != nullptr)
+    return ost_maximum(x->left);
+  ost_node_base* y = x->parent;
+  while (x == y->left)
+  {
+    x = y;
+    y = y->parent;
+  }
+  return y;
+}
+
+// 左旋，x 的右子节点成为子树的新根
+inline void ost_rotate_left(ost_node_base* x, ost_node_base* header) noexcept
+{
+  ost_node_base* y = x->right;
+  x->right = y->left;
+  if (y->left != nullptr)
+    y->left->parent = x;
+  y->parent = x->parent;
+  if (x->parent == header)
+    header->parent = y;
+  else if (x == x->parent->left)
+    x->parent->left = y;
+  else
+    x->parent->right = y;
+  y->left = x;
+  x->parent = y;
+  ost_update(x);
+  ost_update(y);
+}
+
+// 右旋，x 的左子节点成为子树的新根
+inline void ost_rotate_right(ost_node_base* x, ost_node_base* header) noexcept
+{
+  ost_node_base* y = x->left;
+  x->left = y->right;
+  if (y->right != nullptr)
+    y->right->parent = x;
+  y->parent = x->parent;
+  if (x->parent == header)
+    header->parent = y;
+  else if (x == x->parent->right)
+    x->parent->right = y;
+  else
+    x->parent->left = y;
+  y->right = x;
+  x->parent = y;
+  ost_update(x);
+  ost_update(y);
+}
+
+// 从 x 开始沿父节点向上，更新 size 与高度，并在失衡处旋转
+// size 在每一层都会改变，因此总是走到根节点
+inline void ost_rebalance(ost_node_base* x, ost_node_base* header) noexcept
+{
+  while (x != header)
+  {
+    ost_update(x);
+    const int balance = ost_height(x->left) - ost_height(x->right);
+    if (balance > 1)
+    {
+      if (ost_height(x->left->left) < ost_height(x->left->right))
+        ost_rotate_left(x->left, header);
+      ost_rotate_right(x, header);
+      x = x->parent;
+    }
+    else if (balance < -1)
+    {
+      if (ost_height(x->right->right) < ost_height(x->right->left))
+        ost_rotate_right(x->right, header);
+      ost_rotate_left(x, header);
+      x = x->parent;
+    }
+    x = x->parent;
+  }
+}
+
+// 把新节点 x 挂到 parent 的左侧或右侧，然后重新平衡
+inline void ost_insert_and_rebalance(bool insert_left, ost_node_base* x,
+                                     ost_node_base* parent, ost_node_base* header) noexcept
+{
+  x->parent = parent;
+  x->left = nullptr;
+  x->right = nullptr;
+  x->size = 1;
+  x->height = 1;
+  if (parent == header)
+  {
+    header->parent = x;
+    header->left = x;
+    header->right = x;
+  }
+  else if (insert_left)
+  {
+    parent->left = x;
+    if (parent == header->left)
+      header->left = x;
+  }
+  else
+  {
+    parent->right = x;
+    if (parent == header->right)
+      header->right = x;
+  }
+  ost_rebalance(parent, header);
+}
+
+// 用以 v 为根的子树替换以 u 为根的子树
+inline void ost_transplant(ost_node_base* u, ost_node_base* v, ost_node_base* header) noexcept
+{
+  if (u->parent == header)
+    header->parent = v;
+  else if (u == u->parent->left)
+    u->parent->left = v;
+  else
+    u->parent->right = v;
+  if (v != nullptr)
+    v->parent = u->parent;
+}
+
+// 把节点 z 从树中摘下并重新平衡，不释放 z
+inline void ost_erase_and_rebalance(ost_node_base* z, ost_node_base* header) noexcept
+{
+  if (header->left == z)
+    header->left = z->right != nullptr ? ost_minimum(z->right) : z->parent;
+  if (header->right == z)
+    header->right = z->left != nullptr ? ost_maximum(z->left) : z->parent;
+
+  ost_node_base* start = nullptr;  // 重新平衡的起点
+  if (z->left == nullptr || z->right == nullptr)
+  {
+    start = z->parent;
+    ost_transplant(z, z->left != nullptr ? z->left : z->right, header);
+  }
+  else
+  { // 用 z 的后继 y 接替 z 的位置，其它节点保持不动
+    ost_node_base* y = ost_minimum(z->right);
+    if (y->parent == z)
+    {
+      start = y;
+    }
+    else
+    {
+      start = y->parent;
+      ost_transplant(y, y->right, header);
+      y->right = z->right;
+      y->right->parent = y;
+    }
+    ost_transplant(z, y, header);
+    y->left = z->left;
+    y->left->parent = y;
+  }
+  ost_rebalance(start, header);
+}
+
+/*****************************************************************************************/
+// 迭代器设计
+
+template <class T>
+struct ost_const_iterator :public mystl::iterator<mystl::bidirectional_iterator_tag, T>
+{
+  typedef T                      value_type;
+  typedef const T*               pointer;
+  typedef const T&               reference;
+  typedef ost_node_base*         base_ptr;
+  typedef ost_node<T>*           node_ptr;
+  typedef ost_const_iterator<T>  self;
+
+  base_ptr node;  // 指向节点本身
+
+  // 构造函数
+  ost_const_iterator() :node(nullptr) {}
+  explicit ost_const_iterator(base_ptr x) :node(x) {}
+
+  // 重载操作符
+  reference operator*()  const { return static_cast<node_ptr>(node)->value; }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    node = mystl::ost_next(node);
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp(*this);
+    node = mystl::ost_next(node);
+    return tmp;
+  }
+
+  self& operator--()
+  {
+    node = mystl::ost_prev(node);
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp(*this);
+    node = mystl::ost_prev(node);
+    return tmp;
+  }
+
+  bool operator==(const self& rhs) const { return node == rhs.node; }
+  bool operator!=(const self& rhs) const { return node != rhs.node; }
+};
+
+// 模板类 order_statistic_tree
+// 参数一代表数据类型，参数二代表比较方式，缺省使用 mystl::less
+template <class T, class Compare = mystl::less<T>>
+class order_statistic_tree
+{
+public:
+  // order_statistic_tree 的嵌套型别定义
+
+  typedef T                                         key_type;
+  typedef T                                         value_type;
+  typedef Compare                                   key_compare;
+
+  typedef ost_node_base*                            base_ptr;
+  typedef ost_node<T>                               node_type;
+  typedef ost_node<T>*                              node_ptr;
+
+  typedef mystl::allocator<T>                       allocator_type;
+  typedef mystl::allocator<T>                       data_allocator;
+  typedef mystl::allocator<node_type>               node_allocator;
+
+  typedef typename allocator_type::const_pointer    pointer;
+  typedef typename allocator_type::const_pointer    const_pointer;
+  typedef typename allocator_type::const_reference  reference;
+  typedef typename allocator_type::const_reference  const_reference;
+  typedef typename allocator_type::size_type        size_type;
+  typedef typename allocator_type::difference_type  difference_type;
+
+  typedef ost_const_iterator<T>                     iterator;
+  typedef ost_const_iterator<T>                     const_iterator;
+  typedef mystl::reverse_iterator<iterator>         reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+  allocator_type get_allocator() const { return allocator_type(); }
+  key_compare    key_comp()      const { return key_comp_; }
+
+private:
+  // 用以下两个数据表现 order_statistic_tree
+  ost_node_base header_;    // 头节点
+  key_compare   key_comp_;  // 键值比较的准则
+
+public:
+  // 构造、复制、析构函数
+  order_statistic_tree() { reset(); }
+
+  explicit order_statistic_tree(const Compare& comp)
+    :key_comp_(comp)
+  {
+    reset();
+  }
+
+  order_statistic_tree(const order_statistic_tree& rhs)
+    :key_comp_(rhs.key_comp_)
+  {
+    reset();
+    copy_from(rhs);
+  }
+  order_statistic_tree(order_statistic_tree&& rhs) noexcept
+    :key_comp_(rhs.key_comp_)
+  {
+    reset();
+    take(rhs);
+  }
+
+  order_statistic_tree& operator=(const order_statistic_tree& rhs)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      key_comp_ = rhs.key_comp_;
+      copy_from(rhs);
+    }
+    return *this;
+  }
+  order_statistic_tree& operator=(order_statistic_tree&& rhs)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      key_comp_ = mystl::move(rhs.key_comp_);
+      take(rhs);
+    }
+    return *this;
+  }
+
+  ~order_statistic_tree() { clear(); }
+
+public:
+  // 迭代器相关操作
+
+  iterator               begin()   const noexcept
+  { return iterator(header_.left); }
+  iterator               end()     const noexcept
+  { return iterator(header()); }
+
+  reverse_iterator       rbegin()  const noexcept
+  { return reverse_iterator(end()); }
+  reverse_iterator       rend()    const noexcept
+  { return reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+
+  bool      empty()    const noexcept { return header_.parent == nullptr; }
+  size_type size()     const noexcept { return ost_size(header_.parent); }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+  // 插入删除相关操作
+
+  template <class ...Args>
+  iterator  emplace_multi(Args&& ...args);
+
+  template <class ...Args>
+  mystl::pair<iterator, bool> emplace_unique(Args&& ...args);
+
+  iterator  insert_multi(const value_type& value)
+  { return emplace_multi(value); }
+  iterator  insert_multi(value_type&& value)
+  { return emplace_multi(mystl::move(value)); }
+
+  template <class InputIterator>
+  void      insert_multi(InputIterator first, InputIterator last)
+  {
+    for (; first != last; ++first)
+      emplace_multi(*first);
+  }
+
+  mystl::pair<iterator, bool> insert_unique(const value_type& value)
+  { return emplace_unique(value); }
+  mystl::pair<iterator, bool> insert_unique(value_type&& value)
+  { return emplace_unique(mystl::move(value)); }
+
+  template <class InputIterator>
+  void      insert_unique(InputIterator first, InputIterator last)
+  {
+    for (; first != last; ++first)
+      emplace_unique(*first);
+  }
+
+  iterator  erase(const_iterator position);
+  iterator  erase(const_iterator first, const_iterator last);
+
+  size_type erase_multi(const key_type& key);
+  size_type erase_unique(const key_type& key);
+
+  void      clear();
+
+  // 查找相关操作
+
+  iterator  find(const key_type& key) const;
+
+  size_type count_multi(const key_type& key) const
+  { return count_range(key, key, true); }
+  size_type count_unique(const key_type& key) const
+  { return find(key) != end() ? 1 : 0; }
+
+  iterator  lower_bound(const key_type& key) const;
+  iterator  upper_bound(const key_type& key) const;
+
+  mystl::pair<iterator, iterator>
+    equal_range_multi(const key_type& key) const
+  {
+    return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+  }
+  mystl::pair<iterator, iterator>
+    equal_range_unique(const key_type& key) const
+  {
+    iterator it = find(key);
+    iterator next = it;
+    if (it != end())
+      ++next;
+    return mystl::pair<iterator, iterator>(it, next);
+  }
+
+  // 顺序统计相关操作
+
+  // 第 k 小（从 0 开始）的元素，k >= size() 时返回 end()
+  iterator  nth(size_type k) const;
+
+  // 小于 key 的元素个数，即 lower_bound(key) 之前的元素个数
+  size_type rank(const key_type& key) const;
+
+  // 不大于 key 的元素个数，即 upper_bound(key) 之前的元素个数
+  size_type rank_upper(const key_type& key) const;
+
+  // it 之前的元素个数，index(end()) == size()
+  size_type index(const_iterator it) const;
+
+  // 落在 [lo, hi) 中的元素个数，closed 为 true 时统计 [lo, hi]
+  size_type count_range(const key_type& lo, const key_type& hi, bool closed = false) const
+  {
+    if (key_comp_(hi, lo))
+      return 0;
+    return (closed ? rank_upper(hi) : rank(hi)) - rank(lo);
+  }
+
+  void swap(order_statistic_tree& rhs) noexcept;
+
+private:
+  // helper functions
+
+  base_ptr  header() const noexcept
+  { return const_cast<base_ptr>(&header_); }
+  base_ptr  root()   const noexcept
+  { return header_.parent; }
+  static const key_type& key_of(base_ptr x)
+  { return static_cast<node_ptr>(x)->value; }
+
+  template <class ...Args>
+  node_ptr  create_node(Args&& ...args);
+  void      destroy_node(base_ptr x);
+  void      destroy_subtree(base_ptr x);
+  base_ptr  copy_subtree(base_ptr x, base_ptr parent);
+  void      copy_from(const order_statistic_tree& rhs);
+  void      take(order_statistic_tree& rhs) noexcept;
+  void      reset() noexcept;
+};
+
+/*****************************************************************************************/
+
+// 就地构造元素，键值允许重复，相同键值插入到最后
+template <class T, class Compare>
+template <class ...Args>
+typename order_statistic_tree<T, Compare>::iterator
+order_statistic_tree<T, Compare>::
+emplace_multi(Args&& ...args)
+{
+  node_ptr np = create_node(mystl::forward<Args>(args)...);
+  base_ptr y = header();
+  base_ptr x = root();
+  bool insert_left = true;
+  while (x != nullptr)
+  {
+    y = x;
+    insert_left = key_comp_(np->value, key_of(x));
+    x = insert_left ? x->left : x->right;
+  }
+  mystl::ost_insert_and_rebalance(insert_left, np, y, header());
+  return iterator(np);
+}
+
+// 就地构造元素，键值不允许重复
+template <class T, class Compare>
+template <class ...Args>
+mystl::pair<typename order_statistic_tree<T, Compare>::iterator, bool>
+order_statistic_tree<T, Compare>::
+emplace_unique(Args&& ...args)
+{
+  node_ptr np = create_node(mystl::forward<Args>(args)...);
+  base_ptr y = header();
+  base_ptr x = root();
+  base_ptr candidate = nullptr;  // 最后一个不小于新元素的节点
+  bool insert_left = true;
+  try
+  {
+    while (x != nullptr)
+    {
+      y = x;
+      insert_left = !key_comp_(key_of(x), np->value);
+      if (insert_left)
+        candidate = x;
+      x = insert_left ? x->left : x->right;
+    }
+    if (candidate != nullptr && !key_comp_(np->value, key_of(candidate)))
+    {
+      destroy_node(np);
+      return mystl::pair<iterator, bool>(iterator(candidate), false);
+    }
+  }
+  catch (...)
+  {
+    destroy_node(np);
+    throw;
+  }
+  mystl::ost_insert_and_rebalance(insert_left, np, y, header());
+  return mystl::pair<iterator, bool>(iterator(np), true);
+}
+
+// 删除 position 位置的元素，返回下一个位置
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::iterator
+order_statistic_tree<T, Compare>::
+erase(const_iterator position)
+{
+  MYSTL_DEBUG(position != end());
+  iterator next = position;
+  ++next;
+  mystl::ost_erase_and_rebalance(position.node, header());
+  destroy_node(position.node);
+  return next;
+}
+
+// 删除[first, last)区间内的元素
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::iterator
+order_statistic_tree<T, Compare>::
+erase(const_iterator first, const_iterator last)
+{
+  if (first == begin() && last == end())
+  {
+    clear();
+    return end();
+  }
+  while (first != last)
+    first = erase(first);
+  return last;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::size_type
+order_statistic_tree<T, Compare>::
+erase_multi(const key_type& key)
+{
+  auto p = equal_range_multi(key);
+  const size_type n = index(p.second) - index(p.first);
+  erase(p.first, p.second);
+  return n;
+}
+
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::size_type
+order_statistic_tree<T, Compare>::
+erase_unique(const key_type& key)
+{
+  iterator it = find(key);
+  if (it == end())
+    return 0;
+  erase(it);
+  return 1;
+}
+
+// 清空 order_statistic_tree
+template <class T, class Compare>
+void order_statistic_tree<T, Compare>::
+clear()
+{
+  if (root() != nullptr)
+  {
+    destroy_subtree(root());
+    reset();
+  }
+}
+
+// 查找键值为 key 的节点，返回指向它的迭代器
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::iterator
+order_statistic_tree<T, Compare>::
+find(const key_type& key) const
+{
+  iterator it = lower_bound(key);
+  return (it == end() || key_comp_(key, *it)) ? end() : it;
+}
+
+// 键值不小于 key 的第一个位置
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::iterator
+order_statistic_tree<T, Compare>::
+lower_bound(const key_type& key) const
+{
+  base_ptr y = header();
+  base_ptr x = root();
+  while (x != nullptr)
+  {
+    if (!key_comp_(key_of(x), key))
+    {
+      y = x;
+      x = x->left;
+    }
+    else
+    {
+      x = x->right;
+    }
+  }
+  return iterator(y);
+}
+
+// 键值大于 key 的第一个位置
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::iterator
+order_statistic_tree<T, Compare>::
+upper_bound(const key_type& key) const
+{
+  base_ptr y = header();
+  base_ptr x = root();
+  while (x != nullptr)
+  {
+    if (key_comp_(key, key_of(x)))
+    {
+      y = x;
+      x = x->left;
+    }
+    else
+    {
+      x = x->right;
+    }
+  }
+  return iterator(y);
+}
+
+// 沿左子树的 size 下降，找到第 k 小的元素
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::iterator
+order_statistic_tree<T, Compare>::
+nth(size_type k) const
+{
+  base_ptr x = root();
+  while (x != nullptr)
+  {
+    const size_type left = ost_size(x->left);
+    if (k < left)
+    {
+      x = x->left;
+    }
+    else if (k == left)
+    {
+      return iterator(x);
+    }
+    else
+    {
+      k -= left + 1;
+      x = x->right;
+    }
+  }
+  return end();
+}
+
+// 下降时每向右走一步，就累加左子树与当前节点
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::size_type
+order_statistic_tree<T, Compare>::
+rank(const key_type& key) const
+{
+  size_type r = 0;
+  base_ptr x = root();
+  while (x != nullptr)
+  {
+    if (!key_comp_(key_of(x), key))
+    {
+      x = x->left;
+    }
+    else
+    {
+      r += ost_size(x->left) + 1;
+      x = x->right;
+    }
+  }
+  return r;
+}
+
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::size_type
+order_statistic_tree<T, Compare>::
+rank_upper(const key_type& key) const
+{
+  size_type r = 0;
+  base_ptr x = root();
+  while (x != nullptr)
+  {
+    if (key_comp_(key, key_of(x)))
+    {
+      x = x->left;
+    }
+    else
+    {
+      r += ost_size(x->left) + 1;
+      x = x->right;
+    }
+  }
+  return r;
+}
+
+// 从节点向上走到根，每从右侧上来一次，就累加父节点与它的左子树
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::size_type
+order_statistic_tree<T, Compare>::
+index(const_iterator it) const
+{
+  base_ptr x = it.node;
+  if (x == header())
+    return size();
+  size_type r = ost_size(x->left);
+  while (x->parent != header())
+  {
+    if (x == x->parent->right)
+      r += ost_size(x->parent->left) + 1;
+    x = x->parent;
+  }
+  return r;
+}
+
+// 交换 order_statistic_tree
+template <class T, class Compare>
+void order_statistic_tree<T, Compare>::
+swap(order_statistic_tree& rhs) noexcept
+{
+  if (this != &rhs)
+  {
+    order_statistic_tree tmp(mystl::move(rhs));
+    rhs.take(*this);
+    take(tmp);
+    mystl::swap(key_comp_, rhs.key_comp_);
+  }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 创建一个节点并构造元素
+template <class T, class Compare>
+template <class ...Args>
+typename order_statistic_tree<T, Compare>::node_ptr
+order_statistic_tree<T, Compare>::
+create_node(Args&& ...args)
+{
+  node_ptr np = node_allocator::allocate(1);
+  try
+  {
+    data_allocator::construct(mystl::address_of(np->value), mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    node_allocator::deallocate(np);
+    throw;
+  }
+  return np;
+}
+
+// 析构元素并释放节点
+template <class T, class Compare>
+void order_statistic_tree<T, Compare>::
+destroy_node(base_ptr x)
+{
+  node_ptr np = static_cast<node_ptr>(x);
+  data_allocator::destroy(mystl::address_of(np->value));
+  node_allocator::deallocate(np);
+}
+
+// 销毁以 x 为根的子树，AVL 树的高度为 O(log n)，递归深度有限
+template <class T, class Compare>
+void order_statistic_tree<T, Compare>::
+destroy_subtree(base_ptr x)
+{
+  while (x != nullptr)
+  {
+    destroy_subtree(x->right);
+    base_ptr left = x->left;
+    destroy_node(x);
+    x = left;
+  }
+}
+
+// 复制以 x 为根的子树，保持原来的形状，新节点在复制子树之前就已挂到 parent 上，
+// 出现异常时整棵树仍然是连通的
+template <class T, class Compare>
+typename order_statistic_tree<T, Compare>::base_ptr
+order_statistic_tree<T, Compare>::
+copy_subtree(base_ptr x, base_ptr parent)
+{
+  node_ptr top = create_node(key_of(x));
+  top->parent = parent;
+  top->left = nullptr;
+  top->right = nullptr;
+  top->size = x->size;
+  top->height = x->height;
+  if (parent == header())
+    header_.parent = top;
+  if (x->left != nullptr)
+    top->left = copy_subtree(x->left, top);
+  if (x->right != nullptr)
+    top->right = copy_subtree(x->right, top);
+  return top;
+}
+
+template <class T, class Compare>
+void order_statistic_tree<T, Compare>::
+copy_from(const order_statistic_tree& rhs)
+{
+  if (rhs.root() == nullptr)
+    return;
+  try
+  {
+    copy_subtree(rhs.root(), header());
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+  header_.left = ost_minimum(root());
+  header_.right = ost_maximum(root());
+}
+
+// 接管 rhs 的节点，rhs 置为空树，调用前 *this 必须为空
+template <class T, class Compare>
+void order_statistic_tree<T, Compare>::
+take(order_statistic_tree& rhs) noexcept
+{
+  if (rhs.root() == nullptr)
+    return;
+  header_.parent = rhs.header_.parent;
+  header_.left = rhs.header_.left;
+  header_.right = rhs.header_.right;
+  header_.parent->parent = header();
+  rhs.reset();
+}
+
+// 将 order_statistic_tree 置为空树，不释放节点
+template <class T, class Compare>
+void order_statistic_tree<T, Compare>::
+reset() noexcept
+{
+  header_.parent = nullptr;
+  header_.left = header();
+  header_.right = header();
+  header_.size = 0;
+  header_.height = 0;
+}
+
+// 重载比较操作符
+template <class T, class Compare>
+bool operator==(const order_statistic_tree<T, Compare>& lhs,
+                const order_statistic_tree<T, Compare>& rhs)
+{
+  return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Compare>
+bool operator<(const order_statistic_tree<T, Compare>& lhs,
+               const order_statistic_tree<T, Compare>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Compare>
+bool operator!=(const order_statistic_tree<T, Compare>& lhs,
+                const order_statistic_tree<T, Compare>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Compare>
+bool operator>(const order_statistic_tree<T, Compare>& lhs,
+               const order_statistic_tree<T, Compare>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Compare>
+bool operator<=(const order_statistic_tree<T, Compare>& lhs,
+                const order_statistic_tree<T, Compare>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Compare>
+bool operator>=(const order_statistic_tree<T, Compare>& lhs,
+                const order_statistic_tree<T, Compare>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare>
+void swap(order_statistic_tree<T, Compare>& lhs, order_statistic_tree<T, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_ORDER_STATISTIC_TREE_H_
+
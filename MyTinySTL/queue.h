@@ -0,0 +1,213 @@
+﻿#ifndef MYTINYSTL_QUEUE_H_
+#define MYTINYSTL_QUEUE_H_
+
+// 这个头文件包含了一个模板类 priority_queue
+// priority_queue : 优先队列
+
+// notes:
+//
+// 1. 底层为一个 Arity 叉的 heap，默认为 4 叉，比二叉 heap 矮一半，push 与 pop 的缓存缺失更少
+// 2. pop 使用 Floyd 的自底向上调整，每一层只在兄弟节点之间比较
+// 3. push_range 批量插入较多元素时，先追加到尾部再以 make_heap 重建，复杂度为 O(n)
+
+#include <initializer_list>
+
+#include "vector.h"
+#include "functional.h"
+#include "heap_algo.h"
+
+namespace mystl
+{
+
+// 模板类 priority_queue
+// 参数一代表数据类型，参数二代表容器类型，缺省使用 mystl::vector 作为底层容器
+// 参数三代表比较权值的方式，缺省使用 mystl::less 作为比较方式，参数四代表 heap 的叉数
+template <class T, class Container = mystl::vector<T>,
+  class Compare = mystl::less<typename Container::value_type>, size_t Arity = 4>
+class priority_queue
+{
+  static_assert(Arity >= 2, "the arity of priority_queue should be at least 2");
+
+public:
+  typedef Container                           container_type;
+  typedef Compare                             value_compare;
+  // 使用底层容器的型别
+  typedef typename Container::value_type      value_type;
+  typedef typename Container::size_type       size_type;
+  typedef typename Container::reference       reference;
+  typedef typename Container::const_reference const_reference;
+
+  static_assert(std::is_same<T, value_type>::value,
+                "the value_type of Container should be same with T");
+
+private:
+  container_type c_;     // 用底层容器来表现 priority_queue
+  value_compare  comp_;  // 权值比较的标准
+
+public:
+  // 构造、复制、移动函数
+  priority_queue() = default;
+
+  explicit priority_queue(const Compare& c)
+    :c_(), comp_(c)
+  {
+  }
+
+  explicit priority_queue(size_type n)
+    :c_(n)
+  {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(size_type n, const value_type& value)
+    :c_(n, value)
+  {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  template <class IIter>
+  priority_queue(IIter first, IIter last)
+    :c_(first, last)
+  {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(std::initializer_list<T> ilist)
+    :c_(ilist)
+  {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(const Container& s)
+    :c_(s)
+  {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(Container&& s)
+    :c_(mystl::move(s))
+  {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(const priority_queue& rhs)
+    :c_(rhs.c_), comp_(rhs.comp_)
+  {
+  }
+
+  priority_queue(priority_queue&& rhs)
+    :c_(mystl::move(rhs.c_)), comp_(rhs.comp_)
+  {
+  }
+
+  priority_queue& operator=(const priority_queue& rhs)
+  {
+    c_ = rhs.c_;
+    comp_ = rhs.comp_;
+    return *this;
+  }
+
+  priority_queue& operator=(priority_queue&& rhs)
+  {
+    c_ = mystl::move(rhs.c_);
+    comp_ = rhs.comp_;
+    return *this;
+  }
+
+  priority_queue& operator=(std::initializer_list<T> ilist)
+  {
+    c_ = ilist;
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+    return *this;
+  }
+
+  ~priority_queue() = default;
+
+public:
+
+  // 访问元素相关操作
+  const_reference top() const { return c_.front(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return c_.empty(); }
+  size_type size()     const noexcept { return c_.size(); }
+  size_type capacity() const noexcept { return c_.capacity(); }
+
+  // 预先分配 n 个元素的空间，之后的 push 不会引起重新分配
+  void reserve(size_type n) { c_.reserve(n); }
+
+  // 修改容器相关操作
+
+  template <class... Args>
+  void emplace(Args&& ...args)
+  {
+    c_.emplace_back(mystl::forward<Args>(args)...);
+    mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  void push(const value_type& value)
+  {
+    c_.push_back(value);
+    mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+  void push(value_type&& value)
+  {
+    c_.push_back(mystl::move(value));
+    mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  // 批量插入[first, last)
+  // 插入的元素不少于原有的元素时，追加之后以 make_heap 重建，否则逐个上溯
+  template <class IIter>
+  void push_range(IIter first, IIter last)
+  {
+    const size_type old_size = c_.size();
+    c_.insert(c_.end(), first, last);
+    const size_type n = c_.size() - old_size;
+    if (n >= old_size)
+    {
+      mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+    }
+    else
+    {
+      for (size_type i = old_size + 1; i <= c_.size(); ++i)
+        mystl::dary_push_heap<Arity>(c_.begin(), c_.begin() + i, comp_);
+    }
+  }
+
+  void pop()
+  {
+    mystl::dary_pop_heap<Arity>(c_.begin(), c_.end(), comp_);
+    c_.pop_back();
+  }
+
+  void clear() { c_.clear(); }
+
+  void swap(priority_queue& rhs) noexcept(noexcept(mystl::swap(c_, rhs.c_)) &&
+                                          noexcept(mystl::swap(comp_, rhs.comp_)))
+  {
+    mystl::swap(c_, rhs.c_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+public:
+  friend bool operator==(const priority_queue& lhs, const priority_queue& rhs)
+  {
+    return lhs.c_ == rhs.c_;
+  }
+  friend bool operator!=(const priority_queue& lhs, const priority_queue& rhs)
+  {
+    return lhs.c_ != rhs.c_;
+  }
+};
+
+// 重载 mystl 的 swap
+template <class T, class Container, class Compare, size_t Arity>
+void swap(priority_queue<T, Container, Compare, Arity>& lhs,
+          priority_queue<T, Container, Compare, Arity>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_QUEUE_H_
@@ -0,0 +1,328 @@
+﻿#ifndef MYTINYSTL_RANDOM_H_
+#define MYTINYSTL_RANDOM_H_
+
+// 这个头文件包含三个伪随机数引擎，以及生成有界随机整数与每个线程独立的随机数流的函数
+// splitmix64    : 64 位状态，每次加上一个常数后混合输出，常用于为其它引擎生成种子
+// xoshiro256ss  : xoshiro256**，256 位状态，周期为 2^256 - 1，jump() 可以跳过 2^128 个数
+// pcg32         : 64 位线性同余状态加置换输出，构造时可以指定 2^63 条互不重叠的流之一
+
+// notes:
+//
+// 1. 引擎满足 UniformRandomBitGenerator 的要求，也可以用于 std::uniform_int_distribution 等
+// 2. uniform_int(g, range) 使用 Lemire 的乘法取高位的方法生成 [0, range) 中的整数，
+//    没有偏差，并且绝大多数情况下不需要除法
+// 3. thread_engine() 返回当前线程独立的引擎，不同线程的种子不同，不需要加锁
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace mystl
+{
+
+/*****************************************************************************************/
+// splitmix64
+/*****************************************************************************************/
+class splitmix64
+{
+public:
+  typedef uint64_t result_type;
+
+private:
+  uint64_t state_;
+
+public:
+  explicit splitmix64(uint64_t seed = 0) noexcept :state_(seed) {}
+
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return UINT64_MAX; }
+
+  void seed(uint64_t s) noexcept { state_ = s; }
+
+  result_type operator()() noexcept
+  {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  friend bool operator==(const splitmix64& lhs, const splitmix64& rhs) noexcept
+  {
+    return lhs.state_ == rhs.state_;
+  }
+  friend bool operator!=(const splitmix64& lhs, const splitmix64& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+};
+
+/*****************************************************************************************/
+// xoshiro256ss
+// 种子经过 splitmix64 扩展为 256 位的状态，保证状态不全为 0
+/*****************************************************************************************/
+class xoshiro256ss
+{
+public:
+  typedef uint64_t result_type;
+
+private:
+  uint64_t s_[4];
+
+public:
+  explicit xoshiro256ss(uint64_t seed = 0) noexcept { this->seed(seed); }
+
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return UINT64_MAX; }
+
+  void seed(uint64_t s) noexcept
+  {
+    splitmix64 sm(s);
+    for (auto& x : s_)
+      x = sm();
+  }
+
+  result_type operator()() noexcept
+  {
+    const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+  // 相当于调用 2^128 次 operator()，对同一个种子依次 jump，可以得到 2^128 条互不重叠的子序列
+  void jump() noexcept
+  {
+    static const uint64_t kJump[4] = { 0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+                                       0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+    uint64_t t[4] = { 0, 0, 0, 0 };
+    for (auto j : kJump)
+    {
+      for (int b = 0; b < 64; ++b)
+      {
+        if (j & (static_cast<uint64_t>(1) << b))
+        {
+          t[0] ^= s_[0];
+          t[1] ^= s_[1];
+          t[2] ^= s_[2];
+          t[3] ^= s_[3];
+        }
+        (*this)();
+      }
+    }
+    for (int i = 0; i < 4; ++i)
+      s_[i] = t[i];
+  }
+
+  friend bool operator==(const xoshiro256ss& lhs, const xoshiro256ss& rhs) noexcept
+  {
+    return lhs.s_[0] == rhs.s_[0] && lhs.s_[1] == rhs.s_[1] &&
+           lhs.s_[2] == rhs.s_[2] && lhs.s_[3] == rhs.s_[3];
+  }
+  friend bool operator!=(const xoshiro256ss& lhs, const xoshiro256ss& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+private:
+  static uint64_t rotl(uint64_t x, int k) noexcept
+  {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+
+/*****************************************************************************************/
+// pcg32
+// PCG-XSH-RR，与参考实现 pcg32_srandom_r(seed, stream) 的输出相同
+/*****************************************************************************************/
+class pcg32
+{
+public:
+  typedef uint32_t result_type;
+
+private:
+  uint64_t state_;
+  uint64_t inc_;    // 增量，必须为奇数，决定了使用哪一条流
+
+public:
+  explicit pcg32(uint64_t seed = 0x853c49e6748fea9bull, uint64_t stream = 0xda3e39cb94b95bdbull) noexcept
+  {
+    this->seed(seed, stream);
+  }
+
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return UINT32_MAX; }
+
+  void seed(uint64_t s, uint64_t stream = 0xda3e39cb94b95bdbull) noexcept
+  {
+    state_ = 0;
+    inc_ = (stream << 1) | 1;
+    (*this)();
+    state_ += s;
+    (*this)();
+  }
+
+  result_type operator()() noexcept
+  {
+    const uint64_t old = state_;
+    state_ = old * 6364136223846793005ull + inc_;
+    const uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+    const uint32_t rot = static_cast<uint32_t>(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+  }
+
+  // 跳过 n 个数，O(log n)
+  void discard(uint64_t n) noexcept
+  {
+    uint64_t mult = 6364136223846793005ull, plus = inc_;
+    uint64_t acc_mult = 1, acc_plus = 0;
+    for (; n > 0; n >>= 1)
+    {
+      if (n & 1)
+      {
+        acc_mult *= mult;
+        acc_plus = acc_plus * mult + plus;
+      }
+      plus = (mult + 1) * plus;
+      mult *= mult;
+    }
+    state_ = acc_mult * state_ + acc_plus;
+  }
+
+  friend bool operator==(const pcg32& lhs, const pcg32& rhs) noexcept
+  {
+    return lhs.state_ == rhs.state_ && lhs.inc_ == rhs.inc_;
+  }
+  friend bool operator!=(const pcg32& lhs, const pcg32& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+};
+
+/*****************************************************************************************/
+// uniform_int
+// 生成 [0, range) 中均匀分布的整数，range 必须大于 0
+// 引擎的值域必须恰好为 32 位或 64 位
+/*****************************************************************************************/
+template <class URBG>
+struct random_engine_bits
+{
+  typedef typename std::remove_reference<URBG>::type engine_type;
+  static constexpr uint64_t span = static_cast<uint64_t>(engine_type::max() - engine_type::min());
+  static constexpr int value = span == UINT64_MAX ? 64 : span == UINT32_MAX ? 32 : 0;
+  static_assert(value != 0, "the random engine should produce exactly 32 or 64 random bits");
+};
+
+template <class URBG>
+uint32_t random_bits32(URBG& g)
+{
+  typedef typename std::remove_reference<URBG>::type engine_type;
+  return random_engine_bits<URBG>::value == 64
+    ? static_cast<uint32_t>((g() - engine_type::min()) >> 32)
+    : static_cast<uint32_t>(g() - engine_type::min());
+}
+
+template <class URBG>
+uint64_t random_bits64(URBG& g)
+{
+  typedef typename std::remove_reference<URBG>::type engine_type;
+  if (random_engine_bits<URBG>::value == 64)
+    return static_cast<uint64_t>(g() - engine_type::min());
+  const uint64_t hi = static_cast<uint64_t>(g() - engine_type::min());
+  return (hi << 32) | static_cast<uint64_t>(g() - engine_type::min());
+}
+
+// 64 位乘法，hi 为结果的高 64 位，返回低 64 位
+inline uint64_t mul_64x64(uint64_t a, uint64_t b, uint64_t& hi) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+  hi = static_cast<uint64_t>(p >> 64);
+  return static_cast<uint64_t>(p);
+#else
+  const uint64_t a_lo = a & 0xffffffffull, a_hi = a >> 32;
+  const uint64_t b_lo = b & 0xffffffffull, b_hi = b >> 32;
+  const uint64_t lo_lo = a_lo * b_lo;
+  const uint64_t hi_lo = a_hi * b_lo;
+  const uint64_t lo_hi = a_lo * b_hi;
+  const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffull) + lo_hi;
+  hi = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+  return (cross << 32) | (lo_lo & 0xffffffffull);
+#endif
+}
+
+// x * range 的高位均匀落在 [0, range) 中，低位小于 2^32 % range 的少数情况需要重新生成
+template <class URBG>
+uint32_t uniform_int32(URBG& g, uint32_t range)
+{
+  uint64_t m = static_cast<uint64_t>(random_bits32(g)) * range;
+  uint32_t low = static_cast<uint32_t>(m);
+  if (low < range)
+  {
+    const uint32_t threshold = static_cast<uint32_t>(0u - range) % range;
+    while (low < threshold)
+    {
+      m = static_cast<uint64_t>(random_bits32(g)) * range;
+      low = static_cast<uint32_t>(m);
+    }
+  }
+  return static_cast<uint32_t>(m >> 32);
+}
+
+template <class URBG>
+uint64_t uniform_int64(URBG& g, uint64_t range)
+{
+  uint64_t hi;
+  uint64_t low = mystl::mul_64x64(random_bits64(g), range, hi);
+  if (low < range)
+  {
+    const uint64_t threshold = (0ull - range) % range;
+    while (low < threshold)
+      low = mystl::mul_64x64(random_bits64(g), range, hi);
+  }
+  return hi;
+}
+
+template <class URBG>
+uint64_t uniform_int(URBG& g, uint64_t range)
+{
+  return range <= UINT32_MAX
+    ? static_cast<uint64_t>(mystl::uniform_int32(g, static_cast<uint32_t>(range)))
+    : mystl::uniform_int64(g, range);
+}
+
+/*****************************************************************************************/
+// thread_engine
+// 每个线程第一次调用时，用时间与全局计数器生成种子
+/*****************************************************************************************/
+inline uint64_t next_stream_seed() noexcept
+{
+  static std::atomic<uint64_t> counter(0);
+  splitmix64 sm(static_cast<uint64_t>(
+    std::chrono::high_resolution_clock::now().time_since_epoch().count()) ^
+    (counter.fetch_add(1, std::memory_order_relaxed) * 0x9e3779b97f4a7c15ull));
+  return sm();
+}
+
+inline xoshiro256ss& thread_engine() noexcept
+{
+  static thread_local xoshiro256ss engine(next_stream_seed());
+  return engine;
+}
+
+// 为第 index 个线程（或任务）生成可重现的独立引擎，相同的 seed 与 index 得到相同的序列
+inline pcg32 make_stream(uint64_t seed, uint64_t index) noexcept
+{
+  return pcg32(seed, index);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_RANDOM_H_
+
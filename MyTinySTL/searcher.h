@@ -0,0 +1,284 @@
+﻿#ifndef MYTINYSTL_SEARCHER_H_
+#define MYTINYSTL_SEARCHER_H_
+
+// 这个头文件包含用于子串查找的三个查找器，配合 mystl::search(first, last, searcher) 使用
+// boyer_moore_horspool_searcher : 从模式串末尾向前比较，失配时按窗口最后一个元素跳跃，
+//                                 模式串较长、字符集较大时平均只需比较约 n / m 次
+// two_way_searcher              : 双向查找（Crochemore-Perrin），最坏情况下为 O(n + m)，只需常数的额外空间
+// simd_searcher                 : 针对单字节整数的连续区间，用 SIMD 同时比较首尾字符筛选候选位置
+
+// notes:
+//
+// 1. 查找器只保存模式串的迭代器，模式串必须比查找器存活得更久
+// 2. searcher(first, last) 返回 pair，为找到的子串所在的区间，找不到时返回 (last, last)
+// 3. 模式串为空时返回 (first, first)
+
+#include <cstddef>
+#include <cstring>
+
+#include "algo.h"
+#include "functional.h"
+#include "iterator.h"
+#include "simd.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+/*****************************************************************************************/
+// boyer_moore_horspool_searcher
+// 跳跃表记录每个元素在模式串前 m - 1 个位置中最后一次出现处到末尾的距离，未出现的元素跳跃 m
+/*****************************************************************************************/
+
+// 元素为单字节整数且以 == 比较时，跳跃表为 256 个元素的数组，否则为开放定址的哈希表
+template <class RandomIter, class Hash, class BinaryPred>
+struct use_byte_skip_table :public m_bool_constant<
+  mystl::is_byte_range<typename iterator_traits<RandomIter>::value_type,
+                       typename iterator_traits<RandomIter>::value_type>::value &&
+  std::is_same<BinaryPred,
+               mystl::equal_to<typename iterator_traits<RandomIter>::value_type>>::value>
+{
+};
+
+template <class RandomIter, class Hash, class BinaryPred, bool IsByte>
+class bmh_skip_table;
+
+// 单字节版本
+template <class RandomIter, class Hash, class BinaryPred>
+class bmh_skip_table<RandomIter, Hash, BinaryPred, true>
+{
+public:
+  typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+
+private:
+  difference_type table_[256];
+
+public:
+  bmh_skip_table(RandomIter, difference_type m, const Hash&, const BinaryPred&)
+  {
+    for (size_t i = 0; i < 256; ++i)
+      table_[i] = m;
+  }
+
+  // 模式串的第 i 个元素的跳跃距离为 skip
+  void set(RandomIter pattern, difference_type i, difference_type skip)
+  {
+    table_[static_cast<unsigned char>(pattern[i])] = skip;
+  }
+
+  template <class T>
+  difference_type get(const T& value) const
+  {
+    return table_[static_cast<unsigned char>(value)];
+  }
+};
+
+// 一般版本，槽中保存元素在模式串中的位置，-1 表示空槽
+template <class RandomIter, class Hash, class BinaryPred>
+class bmh_skip_table<RandomIter, Hash, BinaryPred, false>
+{
+public:
+  typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+
+private:
+  RandomIter                      pattern_;
+  difference_type                 m_;
+  size_t                          mask_;
+  mystl::vector<difference_type>  pos_;
+  mystl::vector<difference_type>  skip_;
+  Hash                            hash_;
+  BinaryPred                      pred_;
+
+public:
+  bmh_skip_table(RandomIter pattern, difference_type m, const Hash& hf, const BinaryPred& pred)
+    :pattern_(pattern), m_(m), hash_(hf), pred_(pred)
+  {
+    size_t cap = 8;
+    while (cap < static_cast<size_t>(m) * 2)
+      cap <<= 1;
+    mask_ = cap - 1;
+    pos_.assign(cap, -1);
+    skip_.assign(cap, m);
+  }
+
+  void set(RandomIter pattern, difference_type i, difference_type skip)
+  {
+    const size_t h = slot(pattern[i]);
+    pos_[h] = i;
+    skip_[h] = skip;
+  }
+
+  template <class T>
+  difference_type get(const T& value) const
+  {
+    return skip_[slot(value)];
+  }
+
+private:
+  // value 所在的槽，不存在时为它应该插入的空槽
+  template <class T>
+  size_t slot(const T& value) const
+  {
+    size_t h = hash_(value) & mask_;
+    while (pos_[h] != -1 && !pred_(pattern_[pos_[h]], value))
+      h = (h + 1) & mask_;
+    return h;
+  }
+};
+
+template <class RandomIter,
+          class Hash = mystl::hash<typename iterator_traits<RandomIter>::value_type>,
+          class BinaryPred = mystl::equal_to<typename iterator_traits<RandomIter>::value_type>>
+class boyer_moore_horspool_searcher
+{
+public:
+  typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+
+private:
+  typedef bmh_skip_table<RandomIter, Hash, BinaryPred,
+                         use_byte_skip_table<RandomIter, Hash, BinaryPred>::value> table_type;
+
+  RandomIter  first_;
+  RandomIter  last_;
+  BinaryPred  pred_;
+  table_type  table_;
+
+public:
+  boyer_moore_horspool_searcher(RandomIter first, RandomIter last,
+                                Hash hf = Hash(), BinaryPred pred = BinaryPred())
+    :first_(first), last_(last), pred_(pred), table_(first, last - first, hf, pred)
+  {
+    const difference_type m = last - first;
+    for (difference_type i = 0; i + 1 < m; ++i)
+      table_.set(first, i, m - 1 - i);
+  }
+
+  template <class RandomIter2>
+  mystl::pair<RandomIter2, RandomIter2>
+  operator()(RandomIter2 first, RandomIter2 last) const
+  {
+    const difference_type m = last_ - first_;
+    if (m == 0)
+      return mystl::make_pair(first, first);
+    const difference_type n = static_cast<difference_type>(last - first);
+    for (difference_type pos = 0; n - pos >= m; pos += table_.get(first[pos + m - 1]))
+    {
+      difference_type j = m - 1;
+      while (pred_(first[pos + j], first_[j]))
+      {
+        if (j == 0)
+          return mystl::make_pair(first + pos, first + pos + m);
+        --j;
+      }
+    }
+    return mystl::make_pair(last, last);
+  }
+};
+
+/*****************************************************************************************/
+// two_way_searcher
+// 构造时求出模式串的临界分解，查找时先从左向右比较右半部分，再从右向左比较左半部分
+// 元素需要支持 operator< 与 operator==
+/*****************************************************************************************/
+template <class RandomIter>
+class two_way_searcher
+{
+public:
+  typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+
+private:
+  RandomIter      first_;
+  difference_type m_;
+  difference_type ell_;       // 左半部分的最后一个位置
+  difference_type period_;    // 右半部分匹配而左半部分失配时的跳跃距离
+  bool            periodic_;  // 左半部分是否为右半部分的后缀
+
+public:
+  two_way_searcher(RandomIter first, RandomIter last)
+    :first_(first), m_(last - first), ell_(0), period_(1), periodic_(false)
+  {
+    if (m_ > 0)
+      mystl::two_way_factorize(first_, m_, ell_, period_, periodic_);
+  }
+
+  template <class RandomIter2>
+  mystl::pair<RandomIter2, RandomIter2>
+  operator()(RandomIter2 first, RandomIter2 last) const
+  {
+    if (m_ == 0)
+      return mystl::make_pair(first, first);
+    typedef typename iterator_traits<RandomIter2>::value_type value_type;
+    auto pos = mystl::two_way_search(first, last, first_, m_, ell_, period_, periodic_,
+                                     [](const value_type&) { return 0; });
+    return pos == last ? mystl::make_pair(last, last) : mystl::make_pair(pos, pos + m_);
+  }
+};
+
+/*****************************************************************************************/
+// simd_searcher
+// 模式串与被查找的区间都是 CharT 类型的连续区间，CharT 为单字节整数
+/*****************************************************************************************/
+template <class CharT>
+class simd_searcher
+{
+  static_assert(mystl::is_byte_range<CharT, CharT>::value,
+                "simd_searcher requires a single-byte integral element type");
+
+private:
+  const CharT* first_;
+  size_t       m_;
+
+public:
+  simd_searcher(const CharT* first, const CharT* last)
+    :first_(first), m_(static_cast<size_t>(last - first))
+  {
+  }
+
+  template <class Ptr>
+  mystl::pair<Ptr, Ptr> operator()(Ptr first, Ptr last) const
+  {
+    const CharT* f = first;
+    const CharT* l = last;
+    const size_t n = static_cast<size_t>(l - f);
+    const CharT* p = l;
+    if (m_ == 0)
+      p = f;
+    else if (m_ == 1)
+      p = mystl::simd::find(f, l, *first_);
+    else if (m_ <= n)
+      p = mystl::simd::search(f, l, first_, m_);
+    if (p == l)
+      return mystl::make_pair(last, last);
+    return mystl::make_pair(first + (p - f), first + (p - f) + m_);
+  }
+};
+
+/*****************************************************************************************/
+// make_xxx_searcher
+// 便于推导模板参数
+/*****************************************************************************************/
+template <class RandomIter>
+boyer_moore_horspool_searcher<RandomIter>
+make_boyer_moore_horspool_searcher(RandomIter first, RandomIter last)
+{
+  return boyer_moore_horspool_searcher<RandomIter>(first, last);
+}
+
+template <class RandomIter>
+two_way_searcher<RandomIter>
+make_two_way_searcher(RandomIter first, RandomIter last)
+{
+  return two_way_searcher<RandomIter>(first, last);
+}
+
+template <class CharT>
+simd_searcher<CharT>
+make_simd_searcher(const CharT* first, const CharT* last)
+{
+  return simd_searcher<CharT>(first, last);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_SEARCHER_H_
+
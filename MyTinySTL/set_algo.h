@@ -0,0 +1,327 @@
+﻿#ifndef MYTINYSTL_SET_ALGO_H_
+#define MYTINYSTL_SET_ALGO_H_
+
+// 这个头文件包含 set 的四种算法: union, intersection, difference, symmetric_difference
+// 以及两个针对交集的加速版本: set_intersection_adaptive, set_intersection_simd
+// 所有函数都要求序列有序
+
+#include <cstdint>
+
+#include "algobase.h"
+#include "algo.h"
+#include "iterator.h"
+#include "simd.h"
+
+namespace mystl
+{
+
+/*****************************************************************************************/
+// set_union
+// 计算 S1∪S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                     InputIter2 first2, InputIter2 last2,
+                     OutputIter result)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (*first1 < *first2)
+    {
+      *result = *first1;
+      ++first1;
+    }
+    else if (*first2 < *first1)
+    {
+      *result = *first2;
+      ++first2;
+    }
+    else
+    {
+      *result = *first1;
+      ++first1;
+      ++first2;
+    }
+    ++result;
+  }
+  // 将剩余元素拷贝到 result
+  return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                     InputIter2 first2, InputIter2 last2,
+                     OutputIter result, Compared comp)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      *result = *first1;
+      ++first1;
+    }
+    else if (comp(*first2, *first1))
+    {
+      *result = *first2;
+      ++first2;
+    }
+    else
+    {
+      *result = *first1;
+      ++first1;
+      ++first2;
+    }
+    ++result;
+  }
+  // 将剩余元素拷贝到 result
+  return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+}
+
+/*****************************************************************************************/
+// set_intersection
+// 计算 S1∩S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                            InputIter2 first2, InputIter2 last2,
+                            OutputIter result)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (*first1 < *first2)
+    {
+      ++first1;
+    }
+    else if (*first2 < *first1)
+    {
+      ++first2;
+    }
+    else
+    {
+      *result = *first1;
+      ++first1;
+      ++first2;
+      ++result;
+    }
+  }
+  return result;
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                            InputIter2 first2, InputIter2 last2,
+                            OutputIter result, Compared comp)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      ++first1;
+    }
+    else if (comp(*first2, *first1))
+    {
+      ++first2;
+    }
+    else
+    {
+      *result = *first1;
+      ++first1;
+      ++first2;
+      ++result;
+    }
+  }
+  return result;
+}
+
+/*****************************************************************************************/
+// set_difference
+// 计算 S1-S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, InputIter2 last2,
+                          OutputIter result)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (*first1 < *first2)
+    {
+      *result = *first1;
+      ++first1;
+      ++result;
+    }
+    else if (*first2 < *first1)
+    {
+      ++first2;
+    }
+    else
+    {
+      ++first1;
+      ++first2;
+    }
+  }
+  return mystl::copy(first1, last1, result);
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, InputIter2 last2,
+                          OutputIter result, Compared comp)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      *result = *first1;
+      ++first1;
+      ++result;
+    }
+    else if (comp(*first2, *first1))
+    {
+      ++first2;
+    }
+    else
+    {
+      ++first1;
+      ++first2;
+    }
+  }
+  return mystl::copy(first1, last1, result);
+}
+
+/*****************************************************************************************/
+// set_symmetric_difference
+// 计算 (S1-S2)∪(S2-S1) 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter result)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (*first1 < *first2)
+    {
+      *result = *first1;
+      ++first1;
+      ++result;
+    }
+    else if (*first2 < *first1)
+    {
+      *result = *first2;
+      ++first2;
+      ++result;
+    }
+    else
+    {
+      ++first1;
+      ++first2;
+    }
+  }
+  return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter result, Compared comp)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      *result = *first1;
+      ++first1;
+      ++result;
+    }
+    else if (comp(*first2, *first1))
+    {
+      *result = *first2;
+      ++first2;
+      ++result;
+    }
+    else
+    {
+      ++first1;
+      ++first2;
+    }
+  }
+  return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+}
+
+/*****************************************************************************************/
+// set_intersection_adaptive
+// 两个序列的长度相差悬殊时，对较短序列的每个元素在较长序列中做指数搜索（galloping），
+// 复杂度为 O(m log(n / m))，否则与 set_intersection 相同，逐个归并
+// 输出的元素取自较短的序列，两个序列都必须是随机访问迭代器
+/*****************************************************************************************/
+constexpr static size_t kGallopRatio = 32;  // 长度之比不小于该值时使用指数搜索
+
+// 对 [first1, last1) 的每个元素，从 first2 开始以 1, 2, 4, ... 的步长向后探测，
+// 再在最后一个步长内二分查找，之后的查找从上一次的结果开始
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_intersection_gallop(RandomIter1 first1, RandomIter1 last1,
+                                   RandomIter2 first2, RandomIter2 last2,
+                                   OutputIter result, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter2>::difference_type diff_t;
+  for (; first1 != last1 && first2 != last2; ++first1)
+  {
+    const diff_t len = last2 - first2;
+    diff_t bound = 1;
+    while (bound < len && comp(first2[bound - 1], *first1))
+      bound <<= 1;
+    first2 = mystl::lower_bound(first2 + (bound >> 1), first2 + (bound < len ? bound : len),
+                                *first1, comp);
+    if (first2 != last2 && !comp(*first1, *first2))
+    {
+      *result = *first1;
+      ++result;
+      ++first2;
+    }
+  }
+  return result;
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compared>
+OutputIter set_intersection_adaptive(RandomIter1 first1, RandomIter1 last1,
+                                     RandomIter2 first2, RandomIter2 last2,
+                                     OutputIter result, Compared comp)
+{
+  const size_t len1 = static_cast<size_t>(last1 - first1);
+  const size_t len2 = static_cast<size_t>(last2 - first2);
+  if (len1 / kGallopRatio >= len2)
+    return mystl::set_intersection_gallop(first2, last2, first1, last1, result, comp);
+  if (len2 / kGallopRatio >= len1)
+    return mystl::set_intersection_gallop(first1, last1, first2, last2, result, comp);
+  return mystl::set_intersection(first1, last1, first2, last2, result, comp);
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter>
+OutputIter set_intersection_adaptive(RandomIter1 first1, RandomIter1 last1,
+                                     RandomIter2 first2, RandomIter2 last2,
+                                     OutputIter result)
+{
+  typedef typename iterator_traits<RandomIter1>::value_type value_type;
+  return mystl::set_intersection_adaptive(first1, last1, first2, last2, result,
+                                          mystl::less<value_type>());
+}
+
+/*****************************************************************************************/
+// set_intersection_simd
+// 两个严格递增（没有重复元素）的 uint32_t 序列的交集，例如倒排表，每次用 SIMD 比较 4×4 个元素
+/*****************************************************************************************/
+inline uint32_t* set_intersection_simd(const uint32_t* first1, const uint32_t* last1,
+                                       const uint32_t* first2, const uint32_t* last2,
+                                       uint32_t* result)
+{
+  return mystl::simd::intersect(first1, last1, first2, last2, result);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_SET_ALGO_H_
+
@@ -0,0 +1,1104 @@
+﻿#ifndef MYTINYSTL_SIMD_H_
+#define MYTINYSTL_SIMD_H_
+
+// 这个头文件包含一组针对连续内存中算术类型元素的向量化内核，供 find, count, mismatch, equal, search,
+// set_intersection_simd，以及 numeric.h 中的 reduce, transform_reduce, inclusive_scan 等数值算法使用
+// 以及预取缓存行的 prefetch
+// x86 平台上使用 SSE2，运行时通过 cpuid 检测到 AVX2 时改用 AVX2，其它平台退化为逐元素比较
+
+// notes:
+//
+// 1. 定义 MYSTL_NO_SIMD 可以关闭向量化
+// 2. AVX2 版本的函数通过 target 属性单独编译，不需要以 -mavx2 编译整个程序
+// 3. 浮点数使用浮点比较指令，与 operator== 的语义一致（0.0 == -0.0，NaN 与任何值都不相等）
+// 4. 算术内核把有符号整数当作对应的无符号整数计算，溢出时按模回绕
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "type_traits.h"
+
+#if !defined(MYSTL_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MYSTL_SIMD_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MYSTL_AVX2_TARGET
+#else
+#include <cpuid.h>
+#define MYSTL_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace mystl
+{
+namespace simd
+{
+
+// 元素类型 Tp 与查找的值的类型 Up 能否使用向量化比较
+// 整数之间要求 Up 的值转换为 Tp 后仍与原值相等（见 value_fits），浮点数要求类型相同
+template <class Tp, class Up>
+struct is_comparable :public m_bool_constant<
+  !std::is_volatile<Tp>::value &&
+  (sizeof(Tp) == 1 || sizeof(Tp) == 2 || sizeof(Tp) == 4 || sizeof(Tp) == 8) &&
+  ((std::is_integral<Tp>::value && !std::is_same<typename std::remove_cv<Tp>::type, bool>::value &&
+    std::is_integral<Up>::value && !std::is_same<typename std::remove_cv<Up>::type, bool>::value) ||
+   (std::is_floating_point<Tp>::value &&
+    std::is_same<typename std::remove_cv<Tp>::type, typename std::remove_cv<Up>::type>::value))>
+{
+};
+
+// 两个区间的元素能否逐字节比较
+template <class Tp, class Up>
+struct is_bitwise_comparable :public m_bool_constant<
+  std::is_same<typename std::remove_cv<Tp>::type, typename std::remove_cv<Up>::type>::value &&
+  (std::is_integral<Tp>::value || std::is_pointer<Tp>::value)>
+{
+};
+
+// 能否使用 sum, dot, inclusive_scan, exclusive_scan, adjacent_difference 等算术内核
+// 要求为 4 或 8 字节的整数，或者 float, double
+template <class T>
+struct is_summable :public m_bool_constant<
+  !std::is_volatile<T>::value && !std::is_same<typename std::remove_cv<T>::type, bool>::value &&
+  ((std::is_integral<T>::value && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+   std::is_same<typename std::remove_cv<T>::type, float>::value ||
+   std::is_same<typename std::remove_cv<T>::type, double>::value)>
+{
+};
+
+// 算术内核内部使用的类型，有符号整数转为对应的无符号整数，使溢出时按模回绕而不是未定义行为
+template <class T, bool = std::is_integral<T>::value>
+struct wrap_type
+{
+  typedef typename std::make_unsigned<T>::type type;
+};
+
+template <class T>
+struct wrap_type<T, false>
+{
+  typedef T type;
+};
+
+// value 转换为 T 之后，x == value 与 x == T(value) 对任意 T 类型的 x 等价
+template <class T, class U>
+bool value_fits(const U& value)
+{
+  return static_cast<T>(value) == value;
+}
+
+// 预取 p 所在的缓存行，p 可以是任意地址，不会产生访存错误
+inline void prefetch(const void* p)
+{
+#if defined(MYSTL_SIMD_X86) && defined(_MSC_VER)
+  _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+
+#ifdef MYSTL_SIMD_X86
+
+/*****************************************************************************************/
+// cpu 特性检测
+
+inline bool detect_avx2()
+{
+  unsigned int a = 0, b = 0, c = 0, d = 0;
+#if defined(_MSC_VER)
+  int regs[4];
+  __cpuid(regs, 0);
+  if (regs[0] < 7)
+    return false;
+  __cpuid(regs, 1);
+  c = static_cast<unsigned int>(regs[2]);
+#else
+  if (__get_cpuid_max(0, nullptr) < 7)
+    return false;
+  __cpuid(1, a, b, c, d);
+#endif
+  // 需要 OSXSAVE 与 AVX，并且操作系统保存了 ymm 寄存器的状态
+  if ((c & (1u << 27)) == 0 || (c & (1u << 28)) == 0)
+    return false;
+#if defined(_MSC_VER)
+  const unsigned long long xcr0 = _xgetbv(0);
+#else
+  unsigned int xcr0_lo = 0, xcr0_hi = 0;
+  __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  const unsigned long long xcr0 = xcr0_lo | (static_cast<unsigned long long>(xcr0_hi) << 32);
+#endif
+  if ((xcr0 & 0x6) != 0x6)
+    return false;
+#if defined(_MSC_VER)
+  __cpuidex(regs, 7, 0);
+  b = static_cast<unsigned int>(regs[1]);
+#else
+  __cpuid_count(7, 0, a, b, c, d);
+#endif
+  return (b & (1u << 5)) != 0;
+}
+
+inline bool has_avx2()
+{
+  static const bool result = detect_avx2();
+  return result;
+}
+
+// 最低位的 1 的位置，mask 不为 0
+inline unsigned ctz(unsigned mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned popcount(unsigned mask)
+{
+#if defined(_MSC_VER)
+  mask = mask - ((mask >> 1) & 0x55555555u);
+  mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+  return (((mask + (mask >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+#else
+  return static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+}
+
+/*****************************************************************************************/
+// sse2_ops / avx2_ops
+// 按元素大小与是否为浮点数选择广播与相等比较指令，比较结果每个相等元素的所有字节全为 1
+
+template <size_t Size, bool IsFloat>
+struct sse2_ops;
+
+template <>
+struct sse2_ops<1, false>
+{
+  template <class T>
+  static __m128i splat(T v) { return _mm_set1_epi8(static_cast<char>(v)); }
+  static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+};
+
+template <>
+struct sse2_ops<2, false>
+{
+  template <class T>
+  static __m128i splat(T v) { return _mm_set1_epi16(static_cast<short>(v)); }
+  static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+};
+
+template <>
+struct sse2_ops<4, false>
+{
+  template <class T>
+  static __m128i splat(T v) { return _mm_set1_epi32(static_cast<int>(v)); }
+  static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+};
+
+template <>
+struct sse2_ops<8, false>
+{
+  template <class T>
+  static __m128i splat(T v) { return _mm_set1_epi64x(static_cast<long long>(v)); }
+  // SSE2 没有 64 位整数的比较，高低两个 32 位都相等时才相等
+  static __m128i eq(__m128i a, __m128i b)
+  {
+    const __m128i c = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+  }
+};
+
+template <>
+struct sse2_ops<4, true>
+{
+  static __m128i splat(float v) { return _mm_castps_si128(_mm_set1_ps(v)); }
+  static __m128i eq(__m128i a, __m128i b)
+  { return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b))); }
+};
+
+template <>
+struct sse2_ops<8, true>
+{
+  static __m128i splat(double v) { return _mm_castpd_si128(_mm_set1_pd(v)); }
+  static __m128i eq(__m128i a, __m128i b)
+  { return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b))); }
+};
+
+template <size_t Size, bool IsFloat>
+struct avx2_ops;
+
+template <>
+struct avx2_ops<1, false>
+{
+  template <class T>
+  MYSTL_AVX2_TARGET static __m256i splat(T v) { return _mm256_set1_epi8(static_cast<char>(v)); }
+  MYSTL_AVX2_TARGET static __m256i eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi8(a, b); }
+};
+
+template <>
+struct avx2_ops<2, false>
+{
+  template <class T>
+  MYSTL_AVX2_TARGET static __m256i splat(T v) { return _mm256_set1_epi16(static_cast<short>(v)); }
+  MYSTL_AVX2_TARGET static __m256i eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi16(a, b); }
+};
+
+template <>
+struct avx2_ops<4, false>
+{
+  template <class T>
+  MYSTL_AVX2_TARGET static __m256i splat(T v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+  MYSTL_AVX2_TARGET static __m256i eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi32(a, b); }
+};
+
+template <>
+struct avx2_ops<8, false>
+{
+  template <class T>
+  MYSTL_AVX2_TARGET static __m256i splat(T v)
+  { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+  MYSTL_AVX2_TARGET static __m256i eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi64(a, b); }
+};
+
+template <>
+struct avx2_ops<4, true>
+{
+  MYSTL_AVX2_TARGET static __m256i splat(float v)
+  { return _mm256_castps_si256(_mm256_set1_ps(v)); }
+  MYSTL_AVX2_TARGET static __m256i eq(__m256i a, __m256i b)
+  {
+    return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a),
+                                             _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+  }
+};
+
+template <>
+struct avx2_ops<8, true>
+{
+  MYSTL_AVX2_TARGET static __m256i splat(double v)
+  { return _mm256_castpd_si256(_mm256_set1_pd(v)); }
+  MYSTL_AVX2_TARGET static __m256i eq(__m256i a, __m256i b)
+  {
+    return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a),
+                                             _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+  }
+};
+
+/*****************************************************************************************/
+// sse2_arith / avx2_arith
+// 按元素大小与是否为浮点数选择加、减、乘指令，整数为无符号类型
+// prefix 求出向量内的前缀和，broadcast_last 把最后一个元素广播到所有位置，
+// shift_in 把 x 的元素整体后移一位，空出的第一个位置放入 prev 的最后一个元素
+
+template <size_t Size, bool IsFloat>
+struct sse2_arith;
+
+template <>
+struct sse2_arith<4, false>
+{
+  typedef __m128i reg;
+  static reg zero() { return _mm_setzero_si128(); }
+  static reg splat(uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+  template <class T>
+  static reg load(const T* p) { return _mm_loadu_si128(reinterpret_cast<const reg*>(p)); }
+  template <class T>
+  static void store(T* p, reg x) { _mm_storeu_si128(reinterpret_cast<reg*>(p), x); }
+  static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+  static reg sub(reg a, reg b) { return _mm_sub_epi32(a, b); }
+  // SSE2 没有 32 位的低位乘法，分别计算偶数位置与奇数位置的 64 位乘积，再取出低 32 位
+  static reg mul(reg a, reg b)
+  {
+    const reg even = _mm_mul_epu32(a, b);
+    const reg odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+  }
+  static reg prefix(reg x)
+  {
+    x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+    return _mm_add_epi32(x, _mm_slli_si128(x, 8));
+  }
+  static reg broadcast_last(reg x) { return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3)); }
+  static reg shift_in(reg x, reg prev)
+  { return _mm_or_si128(_mm_slli_si128(x, 4), _mm_srli_si128(prev, 12)); }
+};
+
+template <>
+struct sse2_arith<8, false>
+{
+  typedef __m128i reg;
+  static reg zero() { return _mm_setzero_si128(); }
+  static reg splat(uint64_t v) { return _mm_set1_epi64x(static_cast<long long>(v)); }
+  template <class T>
+  static reg load(const T* p) { return _mm_loadu_si128(reinterpret_cast<const reg*>(p)); }
+  template <class T>
+  static void store(T* p, reg x) { _mm_storeu_si128(reinterpret_cast<reg*>(p), x); }
+  static reg add(reg a, reg b) { return _mm_add_epi64(a, b); }
+  static reg sub(reg a, reg b) { return _mm_sub_epi64(a, b); }
+  // 没有 64 位整数的乘法，dot 对 8 字节整数使用标量的多路累加
+  static reg prefix(reg x) { return _mm_add_epi64(x, _mm_slli_si128(x, 8)); }
+  static reg broadcast_last(reg x) { return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 2, 3, 2)); }
+  static reg shift_in(reg x, reg prev)
+  { return _mm_or_si128(_mm_slli_si128(x, 8), _mm_srli_si128(prev, 8)); }
+};
+
+template <>
+struct sse2_arith<4, true>
+{
+  typedef __m128 reg;
+  static reg zero() { return _mm_setzero_ps(); }
+  static reg splat(float v) { return _mm_set1_ps(v); }
+  static reg load(const float* p) { return _mm_loadu_ps(p); }
+  static void store(float* p, reg x) { _mm_storeu_ps(p, x); }
+  static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+  static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+  static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+  static reg prefix(reg x)
+  {
+    x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+    return _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+  }
+  static reg broadcast_last(reg x) { return _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3)); }
+  static reg shift_in(reg x, reg prev)
+  {
+    return _mm_castsi128_ps(_mm_or_si128(_mm_slli_si128(_mm_castps_si128(x), 4),
+                                         _mm_srli_si128(_mm_castps_si128(prev), 12)));
+  }
+};
+
+template <>
+struct sse2_arith<8, true>
+{
+  typedef __m128d reg;
+  static reg zero() { return _mm_setzero_pd(); }
+  static reg splat(double v) { return _mm_set1_pd(v); }
+  static reg load(const double* p) { return _mm_loadu_pd(p); }
+  static void store(double* p, reg x) { _mm_storeu_pd(p, x); }
+  static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+  static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+  static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+  static reg prefix(reg x) { return _mm_add_pd(x, _mm_unpacklo_pd(_mm_setzero_pd(), x)); }
+  static reg broadcast_last(reg x) { return _mm_unpackhi_pd(x, x); }
+  static reg shift_in(reg x, reg prev) { return _mm_shuffle_pd(prev, x, 1); }
+};
+
+template <size_t Size, bool IsFloat>
+struct avx2_arith;
+
+template <>
+struct avx2_arith<4, false>
+{
+  typedef __m256i reg;
+  MYSTL_AVX2_TARGET static reg zero() { return _mm256_setzero_si256(); }
+  template <class T>
+  MYSTL_AVX2_TARGET static reg load(const T* p)
+  { return _mm256_loadu_si256(reinterpret_cast<const reg*>(p)); }
+  template <class T>
+  MYSTL_AVX2_TARGET static void store(T* p, reg x)
+  { _mm256_storeu_si256(reinterpret_cast<reg*>(p), x); }
+  MYSTL_AVX2_TARGET static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+  MYSTL_AVX2_TARGET static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+};
+
+template <>
+struct avx2_arith<8, false>
+{
+  typedef __m256i reg;
+  MYSTL_AVX2_TARGET static reg zero() { return _mm256_setzero_si256(); }
+  template <class T>
+  MYSTL_AVX2_TARGET static reg load(const T* p)
+  { return _mm256_loadu_si256(reinterpret_cast<const reg*>(p)); }
+  template <class T>
+  MYSTL_AVX2_TARGET static void store(T* p, reg x)
+  { _mm256_storeu_si256(reinterpret_cast<reg*>(p), x); }
+  MYSTL_AVX2_TARGET static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+};
+
+template <>
+struct avx2_arith<4, true>
+{
+  typedef __m256 reg;
+  MYSTL_AVX2_TARGET static reg zero() { return _mm256_setzero_ps(); }
+  MYSTL_AVX2_TARGET static reg load(const float* p) { return _mm256_loadu_ps(p); }
+  MYSTL_AVX2_TARGET static void store(float* p, reg x) { _mm256_storeu_ps(p, x); }
+  MYSTL_AVX2_TARGET static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+  MYSTL_AVX2_TARGET static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+};
+
+template <>
+struct avx2_arith<8, true>
+{
+  typedef __m256d reg;
+  MYSTL_AVX2_TARGET static reg zero() { return _mm256_setzero_pd(); }
+  MYSTL_AVX2_TARGET static reg load(const double* p) { return _mm256_loadu_pd(p); }
+  MYSTL_AVX2_TARGET static void store(double* p, reg x) { _mm256_storeu_pd(p, x); }
+  MYSTL_AVX2_TARGET static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+  MYSTL_AVX2_TARGET static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+};
+
+/*****************************************************************************************/
+// 各个内核的 SSE2 与 AVX2 版本，尾部不足一个向量的元素逐个比较
+
+template <class T>
+const T* find_sse2(const T* first, const T* last, T value)
+{
+  typedef sse2_ops<sizeof(T), std::is_floating_point<T>::value> ops;
+  const size_t lanes = 16 / sizeof(T);
+  const __m128i v = ops::splat(value);
+  for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(ops::eq(x, v)));
+    if (mask != 0)
+      return first + mystl::simd::ctz(mask) / sizeof(T);
+  }
+  while (first != last && !(*first == value))
+    ++first;
+  return first;
+}
+
+template <class T>
+MYSTL_AVX2_TARGET const T* find_avx2(const T* first, const T* last, T value)
+{
+  typedef avx2_ops<sizeof(T), std::is_floating_point<T>::value> ops;
+  const size_t lanes = 32 / sizeof(T);
+  const __m256i v = ops::splat(value);
+  for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+  {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(ops::eq(x, v)));
+    if (mask != 0)
+      return first + mystl::simd::ctz(mask) / sizeof(T);
+  }
+  while (first != last && !(*first == value))
+    ++first;
+  return first;
+}
+
+template <class T>
+size_t count_sse2(const T* first, const T* last, T value)
+{
+  typedef sse2_ops<sizeof(T), std::is_floating_point<T>::value> ops;
+  const size_t lanes = 16 / sizeof(T);
+  const __m128i v = ops::splat(value);
+  size_t n = 0;
+  for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    n += mystl::simd::popcount(static_cast<unsigned>(_mm_movemask_epi8(ops::eq(x, v))));
+  }
+  n /= sizeof(T);  // 每个相等的元素贡献 sizeof(T) 个 1
+  for (; first != last; ++first)
+    n += *first == value;
+  return n;
+}
+
+template <class T>
+MYSTL_AVX2_TARGET size_t count_avx2(const T* first, const T* last, T value)
+{
+  typedef avx2_ops<sizeof(T), std::is_floating_point<T>::value> ops;
+  const size_t lanes = 32 / sizeof(T);
+  const __m256i v = ops::splat(value);
+  size_t n = 0;
+  for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+  {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    n += mystl::simd::popcount(static_cast<unsigned>(_mm256_movemask_epi8(ops::eq(x, v))));
+  }
+  n /= sizeof(T);
+  for (; first != last; ++first)
+    n += *first == value;
+  return n;
+}
+
+template <class T>
+const T* mismatch_sse2(const T* first1, const T* last1, const T* first2)
+{
+  typedef sse2_ops<sizeof(T), std::is_floating_point<T>::value> ops;
+  const size_t lanes = 16 / sizeof(T);
+  for (; static_cast<size_t>(last1 - first1) >= lanes; first1 += lanes, first2 += lanes)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first1));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first2));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(ops::eq(x, y))) ^ 0xffffu;
+    if (mask != 0)
+      return first1 + mystl::simd::ctz(mask) / sizeof(T);
+  }
+  while (first1 != last1 && *first1 == *first2)
+  {
+    ++first1;
+    ++first2;
+  }
+  return first1;
+}
+
+template <class T>
+MYSTL_AVX2_TARGET const T* mismatch_avx2(const T* first1, const T* last1, const T* first2)
+{
+  typedef avx2_ops<sizeof(T), std::is_floating_point<T>::value> ops;
+  const size_t lanes = 32 / sizeof(T);
+  for (; static_cast<size_t>(last1 - first1) >= lanes; first1 += lanes, first2 += lanes)
+  {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first1));
+    const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first2));
+    const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(ops::eq(x, y)));
+    if (mask != 0)
+      return first1 + mystl::simd::ctz(mask) / sizeof(T);
+  }
+  while (first1 != last1 && *first1 == *first2)
+  {
+    ++first1;
+    ++first2;
+  }
+  return first1;
+}
+
+// 单字节元素的子串查找：同时比较每个候选起点处的首字符与对应的尾字符，
+// 两者都相等的位置才比较中间的 m - 2 个字符，m 不小于 2
+template <class T>
+const T* search_sse2(const T* first, const T* last, const T* pattern, size_t m)
+{
+  typedef sse2_ops<1, false> ops;
+  const __m128i head = ops::splat(pattern[0]);
+  const __m128i tail = ops::splat(pattern[m - 1]);
+  const T* stop = last - (m - 1);  // 候选起点的上界
+  for (; stop - first >= 16; first += 16)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + m - 1));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(ops::eq(x, head),
+                                                                          ops::eq(y, tail))));
+    for (; mask != 0; mask &= mask - 1)
+    {
+      const T* p = first + mystl::simd::ctz(mask);
+      if (std::memcmp(p + 1, pattern + 1, m - 2) == 0)
+        return p;
+    }
+  }
+  for (; first != stop; ++first)
+  {
+    if (first[0] == pattern[0] && first[m - 1] == pattern[m - 1] &&
+        std::memcmp(first + 1, pattern + 1, m - 2) == 0)
+      return first;
+  }
+  return last;
+}
+
+template <class T>
+MYSTL_AVX2_TARGET const T* search_avx2(const T* first, const T* last, const T* pattern, size_t m)
+{
+  typedef avx2_ops<1, false> ops;
+  const __m256i head = ops::splat(pattern[0]);
+  const __m256i tail = ops::splat(pattern[m - 1]);
+  const T* stop = last - (m - 1);
+  for (; stop - first >= 32; first += 32)
+  {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + m - 1));
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(ops::eq(x, head),
+                                                                                ops::eq(y, tail))));
+    for (; mask != 0; mask &= mask - 1)
+    {
+      const T* p = first + mystl::simd::ctz(mask);
+      if (std::memcmp(p + 1, pattern + 1, m - 2) == 0)
+        return p;
+    }
+  }
+  for (; first != stop; ++first)
+  {
+    if (first[0] == pattern[0] && first[m - 1] == pattern[m - 1] &&
+        std::memcmp(first + 1, pattern + 1, m - 2) == 0)
+      return first;
+  }
+  return last;
+}
+
+// 两个严格递增的 uint32_t 序列的交集：每次取两边各 4 个元素，把第二组循环移位 3 次，
+// 与第一组比较 4 次即可得到第一组中哪些元素出现在第二组中，然后丢弃最大值较小的一组
+inline uint32_t* intersect_sse2(const uint32_t* first1, const uint32_t* last1,
+                                const uint32_t* first2, const uint32_t* last2, uint32_t* result)
+{
+  while (last1 - first1 >= 4 && last2 - first2 >= 4)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first1));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first2));
+    __m128i m = _mm_cmpeq_epi32(a, b);
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, 0x39)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, 0x4e)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, 0x93)));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m)));
+    for (; mask != 0; mask &= mask - 1)
+      *result++ = first1[mystl::simd::ctz(mask)];
+    const uint32_t max1 = first1[3];
+    const uint32_t max2 = first2[3];
+    if (max1 <= max2)
+      first1 += 4;
+    if (max2 <= max1)
+      first2 += 4;
+  }
+  while (first1 != last1 && first2 != last2)
+  {
+    if (*first1 < *first2)
+    {
+      ++first1;
+    }
+    else if (*first2 < *first1)
+    {
+      ++first2;
+    }
+    else
+    {
+      *result++ = *first1;
+      ++first1;
+      ++first2;
+    }
+  }
+  return result;
+}
+
+// 算术内核：T 为无符号整数或 float, double，使用 4 个向量累加器隐藏加法的延迟
+// 浮点数的求和顺序与逐个累加不同，结果可能有舍入误差
+template <class T>
+T sum_sse2(const T* first, const T* last, T init)
+{
+  typedef sse2_arith<sizeof(T), std::is_floating_point<T>::value> ops;
+  typedef typename ops::reg reg;
+  const size_t lanes = 16 / sizeof(T);
+  reg s0 = ops::zero(), s1 = ops::zero(), s2 = ops::zero(), s3 = ops::zero();
+  for (; static_cast<size_t>(last - first) >= 4 * lanes; first += 4 * lanes)
+  {
+    s0 = ops::add(s0, ops::load(first));
+    s1 = ops::add(s1, ops::load(first + lanes));
+    s2 = ops::add(s2, ops::load(first + 2 * lanes));
+    s3 = ops::add(s3, ops::load(first + 3 * lanes));
+  }
+  for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+    s0 = ops::add(s0, ops::load(first));
+  T lane[16 / sizeof(T)];
+  ops::store(lane, ops::add(ops::add(s0, s1), ops::add(s2, s3)));
+  for (size_t i = 0; i < lanes; ++i)
+    init += lane[i];
+  for (; first != last; ++first)
+    init += *first;
+  return init;
+}
+
+template <class T>
+MYSTL_AVX2_TARGET T sum_avx2(const T* first, const T* last, T init)
+{
+  typedef avx2_arith<sizeof(T), std::is_floating_point<T>::value> ops;
+  typedef typename ops::reg reg;
+  const size_t lanes = 32 / sizeof(T);
+  reg s0 = ops::zero(), s1 = ops::zero(), s2 = ops::zero(), s3 = ops::zero();
+  for (; static_cast<size_t>(last - first) >= 4 * lanes; first += 4 * lanes)
+  {
+    s0 = ops::add(s0, ops::load(first));
+    s1 = ops::add(s1, ops::load(first + lanes));
+    s2 = ops::add(s2, ops::load(first + 2 * lanes));
+    s3 = ops::add(s3, ops::load(first + 3 * lanes));
+  }
+  for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+    s0 = ops::add(s0, ops::load(first));
+  T lane[32 / sizeof(T)];
+  ops::store(lane, ops::add(ops::add(s0, s1), ops::add(s2, s3)));
+  for (size_t i = 0; i < lanes; ++i)
+    init += lane[i];
+  for (; first != last; ++first)
+    init += *first;
+  return init;
+}
+
+template <class T>
+T dot_sse2(const T* first1, const T* last1, const T* first2, T init)
+{
+  typedef sse2_arith<sizeof(T), std::is_floating_point<T>::value> ops;
+  typedef typename ops::reg reg;
+  const size_t lanes = 16 / sizeof(T);
+  reg s0 = ops::zero(), s1 = ops::zero(), s2 = ops::zero(), s3 = ops::zero();
+  for (; static_cast<size_t>(last1 - first1) >= 4 * lanes; first1 += 4 * lanes, first2 += 4 * lanes)
+  {
+    s0 = ops::add(s0, ops::mul(ops::load(first1), ops::load(first2)));
+    s1 = ops::add(s1, ops::mul(ops::load(first1 + lanes), ops::load(first2 + lanes)));
+    s2 = ops::add(s2, ops::mul(ops::load(first1 + 2 * lanes), ops::load(first2 + 2 * lanes)));
+    s3 = ops::add(s3, ops::mul(ops::load(first1 + 3 * lanes), ops::load(first2 + 3 * lanes)));
+  }
+  for (; static_cast<size_t>(last1 - first1) >= lanes; first1 += lanes, first2 += lanes)
+    s0 = ops::add(s0, ops::mul(ops::load(first1), ops::load(first2)));
+  T lane[16 / sizeof(T)];
+  ops::store(lane, ops::add(ops::add(s0, s1), ops::add(s2, s3)));
+  for (size_t i = 0; i < lanes; ++i)
+    init += lane[i];
+  for (; first1 != last1; ++first1, ++first2)
+    init += *first1 * *first2;
+  return init;
+}
+
+template <class T>
+MYSTL_AVX2_TARGET T dot_avx2(const T* first1, const T* last1, const T* first2, T init)
+{
+  typedef avx2_arith<sizeof(T), std::is_floating_point<T>::value> ops;
+  typedef typename ops::reg reg;
+  const size_t lanes = 32 / sizeof(T);
+  reg s0 = ops::zero(), s1 = ops::zero(), s2 = ops::zero(), s3 = ops::zero();
+  for (; static_cast<size_t>(last1 - first1) >= 4 * lanes; first1 += 4 * lanes, first2 += 4 * lanes)
+  {
+    s0 = ops::add(s0, ops::mul(ops::load(first1), ops::load(first2)));
+    s1 = ops::add(s1, ops::mul(ops::load(first1 + lanes), ops::load(first2 + lanes)));
+    s2 = ops::add(s2, ops::mul(ops::load(first1 + 2 * lanes), ops::load(first2 + 2 * lanes)));
+    s3 = ops::add(s3, ops::mul(ops::load(first1 + 3 * lanes), ops::load(first2 + 3 * lanes)));
+  }
+  for (; static_cast<size_t>(last1 - first1) >= lanes; first1 += lanes, first2 += lanes)
+    s0 = ops::add(s0, ops::mul(ops::load(first1), ops::load(first2)));
+  T lane[32 / sizeof(T)];
+  ops::store(lane, ops::add(ops::add(s0, s1), ops::add(s2, s3)));
+  for (size_t i = 0; i < lanes; ++i)
+    init += lane[i];
+  for (; first1 != last1; ++first1, ++first2)
+    init += *first1 * *first2;
+  return init;
+}
+
+// 前缀和：每个向量先在寄存器内求前缀和，再加上之前所有元素的和 carry
+// Exclusive 为 true 时第 i 个结果不包含第 i 个元素
+// 每个向量先读后写，result 可以等于 first
+template <bool Exclusive, class T>
+T* scan_sse2(const T* first, const T* last, T* result, T init)
+{
+  typedef sse2_arith<sizeof(T), std::is_floating_point<T>::value> ops;
+  typedef typename ops::reg reg;
+  const size_t lanes = 16 / sizeof(T);
+  reg carry = ops::splat(init);
+  for (; static_cast<size_t>(last - first) >= lanes; first += lanes, result += lanes)
+  {
+    const reg x = ops::prefix(ops::load(first));
+    ops::store(result, ops::add(Exclusive ? ops::shift_in(x, ops::zero()) : x, carry));
+    carry = ops::add(carry, ops::broadcast_last(x));
+  }
+  T lane[16 / sizeof(T)];
+  ops::store(lane, carry);
+  init = lane[0];
+  for (; first != last; ++first, ++result)
+  {
+    const T x = *first;
+    if (Exclusive)
+    {
+      *result = init;
+      init += x;
+    }
+    else
+    {
+      init += x;
+      *result = init;
+    }
+  }
+  return result;
+}
+
+// 相邻元素的差：用上一个向量的最后一个元素与当前向量拼出前一个位置的元素，result 可以等于 first
+template <class T>
+T* adjacent_difference_sse2(const T* first, const T* last, T* result)
+{
+  typedef sse2_arith<sizeof(T), std::is_floating_point<T>::value> ops;
+  typedef typename ops::reg reg;
+  const size_t lanes = 16 / sizeof(T);
+  if (first == last)
+    return result;
+  reg prev = ops::splat(*first);
+  *result++ = *first++;
+  for (; static_cast<size_t>(last - first) >= lanes; first += lanes, result += lanes)
+  {
+    const reg x = ops::load(first);
+    ops::store(result, ops::sub(x, ops::shift_in(x, prev)));
+    prev = x;
+  }
+  T lane[16 / sizeof(T)];
+  ops::store(lane, prev);
+  T value = lane[lanes - 1];
+  for (; first != last; ++first, ++result)
+  {
+    const T x = *first;
+    *result = x - value;
+    value = x;
+  }
+  return result;
+}
+
+#endif // MYSTL_SIMD_X86
+
+/*****************************************************************************************/
+// find / count / mismatch / search / intersect
+// 对外的接口，T 为去掉 const 之后的元素类型
+
+template <class T>
+const T* find(const T* first, const T* last, T value)
+{
+  if (sizeof(T) == 1 && !std::is_floating_point<T>::value)
+  { // 单字节类型直接使用 memchr
+    const void* p = std::memchr(first, static_cast<unsigned char>(value),
+                                static_cast<size_t>(last - first));
+    return p ? static_cast<const T*>(p) : last;
+  }
+#ifdef MYSTL_SIMD_X86
+  if (mystl::simd::has_avx2())
+    return mystl::simd::find_avx2(first, last, value);
+  return mystl::simd::find_sse2(first, last, value);
+#else
+  while (first != last && !(*first == value))
+    ++first;
+  return first;
+#endif
+}
+
+template <class T>
+size_t count(const T* first, const T* last, T value)
+{
+#ifdef MYSTL_SIMD_X86
+  if (mystl::simd::has_avx2())
+    return mystl::simd::count_avx2(first, last, value);
+  return mystl::simd::count_sse2(first, last, value);
+#else
+  size_t n = 0;
+  for (; first != last; ++first)
+    n += *first == value;
+  return n;
+#endif
+}
+
+// 返回第一个区间中失配的位置
+template <class T>
+const T* mismatch(const T* first1, const T* last1, const T* first2)
+{
+#ifdef MYSTL_SIMD_X86
+  if (mystl::simd::has_avx2())
+    return mystl::simd::mismatch_avx2(first1, last1, first2);
+  return mystl::simd::mismatch_sse2(first1, last1, first2);
+#else
+  while (first1 != last1 && *first1 == *first2)
+  {
+    ++first1;
+    ++first2;
+  }
+  return first1;
+#endif
+}
+
+// 在单字节元素的区间 [first, last) 中查找长度为 m 的模式串，要求 2 <= m <= last - first，找不到返回 last
+template <class T>
+const T* search(const T* first, const T* last, const T* pattern, size_t m)
+{
+#ifdef MYSTL_SIMD_X86
+  if (mystl::simd::has_avx2())
+    return mystl::simd::search_avx2(first, last, pattern, m);
+  return mystl::simd::search_sse2(first, last, pattern, m);
+#else
+  const T* stop = last - (m - 1);
+  for (; first != stop; ++first)
+  { // 用 memchr 找到首字符，再比较尾字符与中间的字符
+    const void* p = std::memchr(first, static_cast<unsigned char>(pattern[0]),
+                                static_cast<size_t>(stop - first));
+    if (p == nullptr)
+      return last;
+    first = static_cast<const T*>(p);
+    if (first[m - 1] == pattern[m - 1] && std::memcmp(first + 1, pattern + 1, m - 2) == 0)
+      return first;
+  }
+  return last;
+#endif
+}
+
+// 两个严格递增的 uint32_t 序列的交集，写入 result，返回写入结束的位置
+inline uint32_t* intersect(const uint32_t* first1, const uint32_t* last1,
+                           const uint32_t* first2, const uint32_t* last2, uint32_t* result)
+{
+#ifdef MYSTL_SIMD_X86
+  return mystl::simd::intersect_sse2(first1, last1, first2, last2, result);
+#else
+  while (first1 != last1 && first2 != last2)
+  {
+    if (*first1 < *first2)
+    {
+      ++first1;
+    }
+    else if (*first2 < *first1)
+    {
+      ++first2;
+    }
+    else
+    {
+      *result++ = *first1;
+      ++first1;
+      ++first2;
+    }
+  }
+  return result;
+#endif
+}
+
+/*****************************************************************************************/
+// sum / dot / inclusive_scan / exclusive_scan / adjacent_difference
+// 算术内核的对外接口，T 须满足 is_summable
+// sum 与 dot 使用多路累加，改变了求和的顺序：整数的结果与逐个累加相同，浮点数可能有舍入误差
+
+// 标量的多路累加，用于没有 SIMD 的平台，以及没有向量乘法的 8 字节整数的 dot
+template <class T>
+T sum_scalar(const T* first, const T* last, T init)
+{
+  T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+  for (; last - first >= 4; first += 4)
+  {
+    s0 += first[0];
+    s1 += first[1];
+    s2 += first[2];
+    s3 += first[3];
+  }
+  init += (s0 + s1) + (s2 + s3);
+  for (; first != last; ++first)
+    init += *first;
+  return init;
+}
+
+template <class T>
+T dot_scalar(const T* first1, const T* last1, const T* first2, T init)
+{
+  T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+  for (; last1 - first1 >= 4; first1 += 4, first2 += 4)
+  {
+    s0 += first1[0] * first2[0];
+    s1 += first1[1] * first2[1];
+    s2 += first1[2] * first2[2];
+    s3 += first1[3] * first2[3];
+  }
+  init += (s0 + s1) + (s2 + s3);
+  for (; first1 != last1; ++first1, ++first2)
+    init += *first1 * *first2;
+  return init;
+}
+
+template <class T>
+T dot_dispatch(const T* first1, const T* last1, const T* first2, T init, m_true_type)
+{ // 有向量乘法的类型
+#ifdef MYSTL_SIMD_X86
+  if (mystl::simd::has_avx2())
+    return mystl::simd::dot_avx2(first1, last1, first2, init);
+  return mystl::simd::dot_sse2(first1, last1, first2, init);
+#else
+  return mystl::simd::dot_scalar(first1, last1, first2, init);
+#endif
+}
+
+template <class T>
+T dot_dispatch(const T* first1, const T* last1, const T* first2, T init, m_false_type)
+{
+  return mystl::simd::dot_scalar(first1, last1, first2, init);
+}
+
+template <bool Exclusive, class T>
+T* scan(const T* first, const T* last, T* result, T init)
+{
+#ifdef MYSTL_SIMD_X86
+  return mystl::simd::scan_sse2<Exclusive>(first, last, result, init);
+#else
+  for (; first != last; ++first, ++result)
+  {
+    const T x = *first;
+    if (Exclusive)
+    {
+      *result = init;
+      init += x;
+    }
+    else
+    {
+      init += x;
+      *result = init;
+    }
+  }
+  return result;
+#endif
+}
+
+// 返回 init 与 [first, last) 中所有元素的和
+template <class T>
+T sum(const T* first, const T* last, T init)
+{
+  typedef typename wrap_type<T>::type U;
+  const U* f = reinterpret_cast<const U*>(first);
+  const U* l = reinterpret_cast<const U*>(last);
+#ifdef MYSTL_SIMD_X86
+  if (mystl::simd::has_avx2())
+    return static_cast<T>(mystl::simd::sum_avx2(f, l, static_cast<U>(init)));
+  return static_cast<T>(mystl::simd::sum_sse2(f, l, static_cast<U>(init)));
+#else
+  return static_cast<T>(mystl::simd::sum_scalar(f, l, static_cast<U>(init)));
+#endif
+}
+
+// 返回 init 与两个区间对应元素乘积的和
+template <class T>
+T dot(const T* first1, const T* last1, const T* first2, T init)
+{
+  typedef typename wrap_type<T>::type U;
+  return static_cast<T>(mystl::simd::dot_dispatch(
+    reinterpret_cast<const U*>(first1), reinterpret_cast<const U*>(last1),
+    reinterpret_cast<const U*>(first2), static_cast<U>(init),
+    m_bool_constant<std::is_floating_point<T>::value || sizeof(T) == 4>()));
+}
+
+// result[i] = init + first[0] + ... + first[i]，返回写入结束的位置
+template <class T>
+T* inclusive_scan(const T* first, const T* last, T* result, T init)
+{
+  typedef typename wrap_type<T>::type U;
+  return reinterpret_cast<T*>(mystl::simd::scan<false>(
+    reinterpret_cast<const U*>(first), reinterpret_cast<const U*>(last),
+    reinterpret_cast<U*>(result), static_cast<U>(init)));
+}
+
+// result[i] = init + first[0] + ... + first[i - 1]，返回写入结束的位置
+template <class T>
+T* exclusive_scan(const T* first, const T* last, T* result, T init)
+{
+  typedef typename wrap_type<T>::type U;
+  return reinterpret_cast<T*>(mystl::simd::scan<true>(
+    reinterpret_cast<const U*>(first), reinterpret_cast<const U*>(last),
+    reinterpret_cast<U*>(result), static_cast<U>(init)));
+}
+
+// result[0] = first[0]，result[i] = first[i] - first[i - 1]，每个元素的结果与逐个计算相同
+template <class T>
+T* adjacent_difference(const T* first, const T* last, T* result)
+{
+  typedef typename wrap_type<T>::type U;
+#ifdef MYSTL_SIMD_X86
+  return reinterpret_cast<T*>(mystl::simd::adjacent_difference_sse2(
+    reinterpret_cast<const U*>(first), reinterpret_cast<const U*>(last),
+    reinterpret_cast<U*>(result)));
+#else
+  if (first == last)
+    return result;
+  const U* f = reinterpret_cast<const U*>(first);
+  const U* l = reinterpret_cast<const U*>(last);
+  U* r = reinterpret_cast<U*>(result);
+  U value = *f;
+  *r++ = *f++;
+  for (; f != l; ++f, ++r)
+  {
+    const U x = *f;
+    *r = x - value;
+    value = x;
+  }
+  return reinterpret_cast<T*>(r);
+#endif
+}
+
+} // namespace simd
+} // namespace mystl
+#endif // !MYTINYSTL_SIMD_H_
+
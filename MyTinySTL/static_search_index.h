@@ -0,0 +1,323 @@
+﻿#ifndef MYTINYSTL_STATIC_SEARCH_INDEX_H_
+#define MYTINYSTL_STATIC_SEARCH_INDEX_H_
+
+// 这个头文件包含一个模板类 static_search_index
+// static_search_index : 只读的有序查找索引，把一个有序序列重排为对缓存友好的布局，
+//                       支持无分支的 lower_bound, upper_bound, equal_range，结果为元素在原有序序列中的位置
+
+// notes:
+//
+// 1. search_layout::eytzinger : 按完全二叉树的层序（BFS）存放，结点 k 的孩子为 2k 与 2k+1，
+//    前几层集中在少数缓存行中，查找时预取 4 层之后的后代所在的缓存行
+// 2. search_layout::btree : 静态 B+ 树（S+ 树），每个结点的键值恰好占满一个缓存行，
+//    叶子层就是补齐后的有序序列，内部结点保存每个孩子子树的最小值，查找只访问 log(B+1, n) 个缓存行
+// 3. 两种布局都把元素个数补齐，空位填充最大的元素，因此查找时的循环次数固定，不需要边界判断
+// 4. 构造时输入的序列必须已经按 comp 有序
+
+#include <cstddef>
+#include <cstdint>
+
+#include "functional.h"
+#include "memory.h"
+#include "simd.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+// 索引的存储布局
+enum class search_layout
+{
+  eytzinger,
+  btree
+};
+
+template <class T, class Compare = mystl::less<T>>
+class static_search_index
+{
+public:
+  typedef T                               value_type;
+  typedef Compare                         value_compare;
+  typedef size_t                          size_type;
+  typedef mystl::pair<size_type, size_type> range_type;
+
+  // B+ 树结点的键值个数，使一个结点占满一个缓存行
+  static constexpr size_type kNodeSize =
+    kCacheLineSize / sizeof(T) >= 2 ? kCacheLineSize / sizeof(T) : 2;
+  // eytzinger 布局中结点 k 的第 log2(kPrefetchStride) 层后代从 k * kPrefetchStride 开始连续存放
+  static constexpr size_type kPrefetchStride =
+    kCacheLineSize / sizeof(T) >= 1 ? kCacheLineSize / sizeof(T) : 1;
+
+private:
+  search_layout             layout_;
+  size_type                 size_;          // 元素个数
+  size_type                 height_;        // 树的层数
+  size_type                 offset_;        // data_ 中对齐到缓存行的起始位置
+  mystl::vector<T>          data_;
+  mystl::vector<size_type>  layer_offset_;  // btree 每一层的起始位置，第 0 层为叶子
+  Compare                   comp_;
+
+public:
+  // 构造函数
+  static_search_index()
+    :layout_(search_layout::eytzinger), size_(0), height_(0), offset_(0)
+  {
+  }
+
+  template <class RandomIter>
+  static_search_index(RandomIter first, RandomIter last,
+                      search_layout layout = search_layout::eytzinger,
+                      const Compare& comp = Compare())
+    :layout_(layout), size_(static_cast<size_type>(last - first)),
+     height_(0), offset_(0), comp_(comp)
+  {
+    if (size_ == 0)
+      return;
+    if (layout_ == search_layout::eytzinger)
+      build_eytzinger(first);
+    else
+      build_btree(first);
+  }
+
+public:
+  size_type     size()   const noexcept { return size_; }
+  bool          empty()  const noexcept { return size_ == 0; }
+  search_layout layout() const noexcept { return layout_; }
+
+  // 第一个不小于 value 的元素在原序列中的位置，没有则返回 size()
+  size_type lower_bound(const value_type& value) const
+  {
+    if (size_ == 0)
+      return 0;
+    const Compare& comp = comp_;
+    auto go_right = [&comp, &value](const value_type& x) { return comp(x, value); };
+    if (layout_ == search_layout::eytzinger)
+      return eytzinger_search(go_right);
+    if (comp(max_value(), value))
+      return size_;
+    return btree_search(go_right);
+  }
+
+  // 第一个大于 value 的元素在原序列中的位置，没有则返回 size()
+  size_type upper_bound(const value_type& value) const
+  {
+    if (size_ == 0)
+      return 0;
+    const Compare& comp = comp_;
+    auto go_right = [&comp, &value](const value_type& x) { return !comp(value, x); };
+    if (layout_ == search_layout::eytzinger)
+      return eytzinger_search(go_right);
+    if (!comp(value, max_value()))
+      return size_;
+    return btree_search(go_right);
+  }
+
+  range_type equal_range(const value_type& value) const
+  {
+    return range_type(lower_bound(value), upper_bound(value));
+  }
+
+  bool contains(const value_type& value) const
+  {
+    return lower_bound(value) != upper_bound(value);
+  }
+
+private:
+  const T* base() const noexcept { return data_.data() + offset_; }
+
+  // btree 布局中最大的元素
+  const T& max_value() const { return base()[layer_offset_[0] + size_ - 1]; }
+
+  T* allocate(size_type n, const T& filler);
+
+  template <class RandomIter>
+  void build_eytzinger(RandomIter first);
+  template <class RandomIter>
+  void eytzinger_fill(T* t, RandomIter first, size_type k, size_type cap, size_type& i);
+  template <class RandomIter>
+  void build_btree(RandomIter first);
+
+  template <class GoRight>
+  size_type eytzinger_search(GoRight go_right) const;
+  template <class GoRight>
+  size_type btree_search(GoRight go_right) const;
+
+  static size_type trailing_ones(size_type x) noexcept;
+  static size_type floor_log2(size_type x) noexcept;
+};
+
+template <class T, class Compare>
+constexpr typename static_search_index<T, Compare>::size_type
+static_search_index<T, Compare>::kNodeSize;
+
+template <class T, class Compare>
+constexpr typename static_search_index<T, Compare>::size_type
+static_search_index<T, Compare>::kPrefetchStride;
+
+/*****************************************************************************************/
+// helper function
+
+// 申请 n 个元素的空间并使起始位置对齐到缓存行，所有位置先填充 filler
+template <class T, class Compare>
+T* static_search_index<T, Compare>::allocate(size_type n, const T& filler)
+{
+  data_.assign(n + kCacheLineSize / sizeof(T) + 1, filler);
+  const auto addr = reinterpret_cast<uintptr_t>(data_.data());
+  const size_type miss = (kCacheLineSize - addr % kCacheLineSize) % kCacheLineSize;
+  offset_ = miss % sizeof(T) == 0 ? miss / sizeof(T) : 0;
+  return data_.data() + offset_;
+}
+
+// 补齐为 2^h - 1 个结点的完全二叉树，下标从 1 开始，中序遍历依次填入有序序列
+template <class T, class Compare>
+template <class RandomIter>
+void static_search_index<T, Compare>::build_eytzinger(RandomIter first)
+{
+  height_ = 1;
+  while ((static_cast<size_type>(1) << height_) - 1 < size_)
+    ++height_;
+  const size_type cap = static_cast<size_type>(1) << height_;
+  T* t = allocate(cap, first[size_ - 1]);
+  size_type i = 0;
+  eytzinger_fill(t, first, 1, cap, i);
+}
+
+template <class T, class Compare>
+template <class RandomIter>
+void static_search_index<T, Compare>::eytzinger_fill(T* t, RandomIter first, size_type k,
+                                                     size_type cap, size_type& i)
+{
+  if (k >= cap)
+    return;
+  eytzinger_fill(t, first, 2 * k, cap, i);
+  if (i < size_)
+    t[k] = first[i];
+  ++i;
+  eytzinger_fill(t, first, 2 * k + 1, cap, i);
+}
+
+// 叶子层为补齐到 kNodeSize 整数倍的有序序列，每个内部结点有 kNodeSize + 1 个孩子，
+// 第 j 个键值为第 j + 1 个孩子子树的最小值，不存在的孩子对应的键值填充最大的元素
+template <class T, class Compare>
+template <class RandomIter>
+void static_search_index<T, Compare>::build_btree(RandomIter first)
+{
+  const size_type B = kNodeSize;
+  mystl::vector<size_type> nodes;  // 每一层的结点数
+  nodes.push_back((size_ + B - 1) / B);
+  while (nodes.back() > 1)
+    nodes.push_back((nodes.back() + B) / (B + 1));
+  height_ = nodes.size();
+
+  // 根结点在最前面，叶子层在最后
+  layer_offset_.assign(height_, 0);
+  size_type total = 0;
+  for (size_type h = height_; h-- > 0; )
+  {
+    layer_offset_[h] = total;
+    total += nodes[h] * B;
+  }
+  T* t = allocate(total, first[size_ - 1]);
+  for (size_type i = 0; i < size_; ++i)
+    t[layer_offset_[0] + i] = first[i];
+
+  size_type span = B;  // 第 h - 1 层的一个结点覆盖的叶子元素个数
+  for (size_type h = 1; h < height_; ++h)
+  {
+    for (size_type k = 0; k < nodes[h]; ++k)
+    {
+      for (size_type j = 0; j < B; ++j)
+      {
+        const size_type start = (k * (B + 1) + j + 1) * span;
+        if (start < size_)
+          t[layer_offset_[h] + k * B + j] = first[start];
+      }
+    }
+    span *= B + 1;
+  }
+}
+
+/*****************************************************************************************/
+// 查找
+// go_right(x) 为 true 表示答案在 x 之后，循环中只有与比较结果相关的算术运算，没有分支
+
+template <class T, class Compare>
+template <class GoRight>
+typename static_search_index<T, Compare>::size_type
+static_search_index<T, Compare>::eytzinger_search(GoRight go_right) const
+{
+  const T* t = base();
+  const size_type cap = static_cast<size_type>(1) << height_;
+  size_type k = 1;
+  for (size_type level = 0; level < height_; ++level)
+  {
+    const size_type ahead = k * kPrefetchStride;
+    mystl::simd::prefetch(t + (ahead < cap ? ahead : 0));
+    k = 2 * k + static_cast<size_type>(go_right(t[k]));
+  }
+  // 最后一次向左走的结点即为答案，去掉末尾连续向右走的部分
+  k >>= trailing_ones(k) + 1;
+  if (k == 0)
+    return size_;
+  const size_type depth = floor_log2(k);
+  const size_type rank = ((2 * (k - (static_cast<size_type>(1) << depth)) + 1)
+                          << (height_ - 1 - depth)) - 1;
+  return rank < size_ ? rank : size_;
+}
+
+template <class T, class Compare>
+template <class GoRight>
+typename static_search_index<T, Compare>::size_type
+static_search_index<T, Compare>::btree_search(GoRight go_right) const
+{
+  const size_type B = kNodeSize;
+  const T* t = base();
+  size_type k = 0;
+  for (size_type h = height_ - 1; h > 0; --h)
+  {
+    const T* node = t + layer_offset_[h] + k * B;
+    size_type i = 0;
+    for (size_type j = 0; j < B; ++j)
+      i += static_cast<size_type>(go_right(node[j]));
+    k = k * (B + 1) + i;
+  }
+  const T* leaf = t + layer_offset_[0] + k * B;
+  size_type i = 0;
+  for (size_type j = 0; j < B; ++j)
+    i += static_cast<size_type>(go_right(leaf[j]));
+  const size_type rank = k * B + i;
+  return rank < size_ ? rank : size_;
+}
+
+template <class T, class Compare>
+typename static_search_index<T, Compare>::size_type
+static_search_index<T, Compare>::trailing_ones(size_type x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return ~x == 0 ? sizeof(size_type) * 8 : static_cast<size_type>(__builtin_ctzll(~x));
+#else
+  size_type n = 0;
+  for (; x & 1; x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+template <class T, class Compare>
+typename static_search_index<T, Compare>::size_type
+static_search_index<T, Compare>::floor_log2(size_type x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return sizeof(unsigned long long) * 8 - 1 - static_cast<size_type>(__builtin_clzll(x));
+#else
+  size_type n = 0;
+  while (x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_STATIC_SEARCH_INDEX_H_
+
@@ -0,0 +1,532 @@
+﻿#ifndef MYTINYSTL_STRING_VIEW_H_
+#define MYTINYSTL_STRING_VIEW_H_
+
+// 这个头文件包含模板类 char_traits 与 basic_string_view
+// char_traits       : 字符的基本操作，char 的版本以 memcmp、memchr、memcpy 等实现
+// basic_string_view : 指向一段连续字符的只读视图，不拥有内存，复制与传值的代价只是一个指针加一个长度
+
+// notes:
+//
+// 1. basic_string_view 不保证以空字符结尾，data() 不能当作 C 风格字符串使用
+// 2. 视图的生存期不能超过它所指向的字符串
+// 3. 查找与比较都经由 char_traits，char 版本的单字符查找使用 memchr，子串查找先用 memchr 定位首字符，
+//    再用 memcmp 比较剩余部分
+// 4. hash<basic_string_view> 与 hash<basic_string> 对相同的字符序列给出相同的结果
+
+#include <cstring>
+#include <ostream>
+
+#include "exceptdef.h"
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// char_traits
+
+template <class CharType>
+struct char_traits
+{
+  typedef CharType char_type;
+
+  static size_t length(const char_type* str)
+  {
+    size_t len = 0;
+    for (; *str != char_type(0); ++str)
+      ++len;
+    return len;
+  }
+
+  static int compare(const char_type* s1, const char_type* s2, size_t n)
+  {
+    for (; n != 0; --n, ++s1, ++s2)
+    {
+      if (*s1 < *s2)
+        return -1;
+      if (*s2 < *s1)
+        return 1;
+    }
+    return 0;
+  }
+
+  static char_type* copy(char_type* dst, const char_type* src, size_t n)
+  {
+    MYSTL_DEBUG(src + n <= dst || dst + n <= src);
+    char_type* r = dst;
+    for (; n != 0; --n, ++dst, ++src)
+      *dst = *src;
+    return r;
+  }
+
+  static char_type* move(char_type* dst, const char_type* src, size_t n)
+  {
+    char_type* r = dst;
+    if (dst < src)
+    {
+      for (; n != 0; --n, ++dst, ++src)
+        *dst = *src;
+    }
+    else if (src < dst)
+    {
+      dst += n;
+      src += n;
+      for (; n != 0; --n)
+        *--dst = *--src;
+    }
+    return r;
+  }
+
+  static char_type* fill(char_type* dst, char_type ch, size_t count)
+  {
+    char_type* r = dst;
+    for (; count > 0; --count, ++dst)
+      *dst = ch;
+    return r;
+  }
+
+  // 在 [s, s + n) 中查找 ch，找不到时返回 nullptr
+  static const char_type* find(const char_type* s, size_t n, char_type ch)
+  {
+    for (; n != 0; --n, ++s)
+    {
+      if (*s == ch)
+        return s;
+    }
+    return nullptr;
+  }
+};
+
+// Partialized. char_traits<char>
+template <>
+struct char_traits<char>
+{
+  typedef char char_type;
+
+  static size_t length(const char_type* str) noexcept
+  { return std::strlen(str); }
+
+  static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
+  { return n == 0 ? 0 : std::memcmp(s1, s2, n); }
+
+  static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
+  {
+    MYSTL_DEBUG(src + n <= dst || dst + n <= src);
+    return n == 0 ? dst : static_cast<char_type*>(std::memcpy(dst, src, n));
+  }
+
+  static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept
+  { return n == 0 ? dst : static_cast<char_type*>(std::memmove(dst, src, n)); }
+
+  static char_type* fill(char_type* dst, char_type ch, size_t count) noexcept
+  { return count == 0 ? dst : static_cast<char_type*>(std::memset(dst, ch, count)); }
+
+  static const char_type* find(const char_type* s, size_t n, char_type ch) noexcept
+  { return n == 0 ? nullptr : static_cast<const char_type*>(std::memchr(s, ch, n)); }
+};
+
+/*****************************************************************************************/
+
+// 模板类 basic_string_view
+// 参数一代表字符类型，参数二代表萃取字符类型的方式，缺省使用 mystl::char_traits
+template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+class basic_string_view
+{
+public:
+  typedef CharTraits                               traits_type;
+  typedef CharType                                 value_type;
+  typedef const CharType*                          pointer;
+  typedef const CharType*                          const_pointer;
+  typedef const CharType&                          reference;
+  typedef const CharType&                          const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef const CharType*                          iterator;
+  typedef const CharType*                          const_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+  const_pointer data_;  // 指向首字符
+  size_type     size_;  // 字符个数
+
+public:
+  // 构造、复制函数
+  constexpr basic_string_view() noexcept
+    :data_(nullptr), size_(0)
+  {
+  }
+
+  basic_string_view(const_pointer str)
+    :data_(str), size_(traits_type::length(str))
+  {
+  }
+
+  constexpr basic_string_view(const_pointer str, size_type count) noexcept
+    :data_(str), size_(count)
+  {
+  }
+
+  basic_string_view(const basic_string_view& rhs) = default;
+  basic_string_view& operator=(const basic_string_view& rhs) = default;
+
+  // 迭代器相关操作
+  const_iterator         begin()   const noexcept { return data_; }
+  const_iterator         end()     const noexcept { return data_ + size_; }
+  const_iterator         cbegin()  const noexcept { return data_; }
+  const_iterator         cend()    const noexcept { return data_ + size_; }
+  const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept { return rend(); }
+
+  // 容量相关操作
+  constexpr bool      empty()    const noexcept { return size_ == 0; }
+  constexpr size_type size()     const noexcept { return size_; }
+  constexpr size_type length()   const noexcept { return size_; }
+  constexpr size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(CharType); }
+
+  // 访问元素相关操作
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size_);
+    return data_[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(n >= size_, "basic_string_view<Char>::at() subscript out of range");
+    return data_[n];
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return data_[0];
+  }
+  const_reference back() const
+  {
+    MYSTL_DEBUG(!empty());
+    return data_[size_ - 1];
+  }
+  constexpr const_pointer data() const noexcept { return data_; }
+
+  // 修改视图相关操作
+  void remove_prefix(size_type n)
+  {
+    MYSTL_DEBUG(n <= size_);
+    data_ += n;
+    size_ -= n;
+  }
+  void remove_suffix(size_type n)
+  {
+    MYSTL_DEBUG(n <= size_);
+    size_ -= n;
+  }
+  void swap(basic_string_view& rhs) noexcept
+  {
+    mystl::swap(data_, rhs.data_);
+    mystl::swap(size_, rhs.size_);
+  }
+
+  // 返回从 pos 开始、最多 count 个字符的子视图
+  basic_string_view substr(size_type pos = 0, size_type count = npos) const
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string_view<Char>::substr() pos out of range");
+    const size_type rest = size_ - pos;
+    return basic_string_view(data_ + pos, count < rest ? count : rest);
+  }
+
+  // 把从 pos 开始、最多 count 个字符复制到 dst，返回复制的个数
+  size_type copy(CharType* dst, size_type count, size_type pos = 0) const
+  {
+    THROW_OUT_OF_RANGE_IF(pos > size_, "basic_string_view<Char>::copy() pos out of range");
+    const size_type rest = size_ - pos;
+    const size_type len = count < rest ? count : rest;
+    traits_type::copy(dst, data_ + pos, len);
+    return len;
+  }
+
+  // 比较相关操作
+  int compare(basic_string_view rhs) const noexcept
+  {
+    const size_type len = size_ < rhs.size_ ? size_ : rhs.size_;
+    const int r = traits_type::compare(data_, rhs.data_, len);
+    if (r != 0)
+      return r;
+    return size_ < rhs.size_ ? -1 : (rhs.size_ < size_ ? 1 : 0);
+  }
+  int compare(size_type pos, size_type count, basic_string_view rhs) const
+  { return substr(pos, count).compare(rhs); }
+  int compare(const_pointer str) const
+  { return compare(basic_string_view(str)); }
+
+  bool starts_with(basic_string_view sv) const noexcept
+  { return size_ >= sv.size_ && traits_type::compare(data_, sv.data_, sv.size_) == 0; }
+  bool starts_with(CharType ch) const noexcept
+  { return size_ != 0 && data_[0] == ch; }
+  bool ends_with(basic_string_view sv) const noexcept
+  { return size_ >= sv.size_ && traits_type::compare(data_ + size_ - sv.size_, sv.data_, sv.size_) == 0; }
+  bool ends_with(CharType ch) const noexcept
+  { return size_ != 0 && data_[size_ - 1] == ch; }
+
+  // 查找相关操作
+
+  size_type find(basic_string_view sv, size_type pos = 0) const noexcept;
+  size_type find(CharType ch, size_type pos = 0) const noexcept
+  {
+    if (pos >= size_)
+      return npos;
+    const_pointer p = traits_type::find(data_ + pos, size_ - pos, ch);
+    return p == nullptr ? npos : static_cast<size_type>(p - data_);
+  }
+  size_type find(const_pointer str, size_type pos, size_type count) const noexcept
+  { return find(basic_string_view(str, count), pos); }
+  size_type find(const_pointer str, size_type pos = 0) const
+  { return find(basic_string_view(str), pos); }
+
+  size_type rfind(basic_string_view sv, size_type pos = npos) const noexcept;
+  size_type rfind(CharType ch, size_type pos = npos) const noexcept
+  {
+    if (size_ == 0)
+      return npos;
+    size_type i = pos < size_ - 1 ? pos : size_ - 1;
+    for (;; --i)
+    {
+      if (data_[i] == ch)
+        return i;
+      if (i == 0)
+        return npos;
+    }
+  }
+  size_type rfind(const_pointer str, size_type pos, size_type count) const noexcept
+  { return rfind(basic_string_view(str, count), pos); }
+  size_type rfind(const_pointer str, size_type pos = npos) const
+  { return rfind(basic_string_view(str), pos); }
+
+  size_type find_first_of(basic_string_view sv, size_type pos = 0) const noexcept
+  {
+    for (size_type i = pos; i < size_; ++i)
+    {
+      if (traits_type::find(sv.data_, sv.size_, data_[i]) != nullptr)
+        return i;
+    }
+    return npos;
+  }
+  size_type find_first_of(CharType ch, size_type pos = 0) const noexcept
+  { return find(ch, pos); }
+  size_type find_first_of(const_pointer str, size_type pos = 0) const
+  { return find_first_of(basic_string_view(str), pos); }
+
+  size_type find_last_of(basic_string_view sv, size_type pos = npos) const noexcept
+  {
+    if (size_ == 0)
+      return npos;
+    for (size_type i = pos < size_ - 1 ? pos : size_ - 1;; --i)
+    {
+      if (traits_type::find(sv.data_, sv.size_, data_[i]) != nullptr)
+        return i;
+      if (i == 0)
+        return npos;
+    }
+  }
+  size_type find_last_of(CharType ch, size_type pos = npos) const noexcept
+  { return rfind(ch, pos); }
+  size_type find_last_of(const_pointer str, size_type pos = npos) const
+  { return find_last_of(basic_string_view(str), pos); }
+
+  size_type find_first_not_of(basic_string_view sv, size_type pos = 0) const noexcept
+  {
+    for (size_type i = pos; i < size_; ++i)
+    {
+      if (traits_type::find(sv.data_, sv.size_, data_[i]) == nullptr)
+        return i;
+    }
+    return npos;
+  }
+  size_type find_first_not_of(CharType ch, size_type pos = 0) const noexcept
+  { return find_first_not_of(basic_string_view(&ch, 1), pos); }
+  size_type find_first_not_of(const_pointer str, size_type pos = 0) const
+  { return find_first_not_of(basic_string_view(str), pos); }
+
+  size_type find_last_not_of(basic_string_view sv, size_type pos = npos) const noexcept
+  {
+    if (size_ == 0)
+      return npos;
+    for (size_type i = pos < size_ - 1 ? pos : size_ - 1;; --i)
+    {
+      if (traits_type::find(sv.data_, sv.size_, data_[i]) == nullptr)
+        return i;
+      if (i == 0)
+        return npos;
+    }
+  }
+  size_type find_last_not_of(CharType ch, size_type pos = npos) const noexcept
+  { return find_last_not_of(basic_string_view(&ch, 1), pos); }
+  size_type find_last_not_of(const_pointer str, size_type pos = npos) const
+  { return find_last_not_of(basic_string_view(str), pos); }
+
+  size_type count(CharType ch) const noexcept
+  {
+    size_type n = 0;
+    for (size_type i = 0; i < size_; ++i)
+      n += data_[i] == ch ? 1 : 0;
+    return n;
+  }
+};
+
+template <class CharType, class CharTraits>
+constexpr typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::npos;
+
+/*****************************************************************************************/
+
+// 查找子串 sv：先用 traits_type::find 定位首字符，再比较剩余部分
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+find(basic_string_view sv, size_type pos) const noexcept
+{
+  const size_type count = sv.size_;
+  if (count == 0)
+    return pos <= size_ ? pos : npos;
+  if (count > size_ || pos > size_ - count)
+    return npos;
+  const_pointer first = data_ + pos;
+  const_pointer last = data_ + (size_ - count) + 1;  // 可能的起点为 [first, last)
+  const CharType head = sv.data_[0];
+  while (first != last)
+  {
+    first = traits_type::find(first, static_cast<size_type>(last - first), head);
+    if (first == nullptr)
+      return npos;
+    if (traits_type::compare(first + 1, sv.data_ + 1, count - 1) == 0)
+      return static_cast<size_type>(first - data_);
+    ++first;
+  }
+  return npos;
+}
+
+// 从 pos 开始向前查找子串 sv
+template <class CharType, class CharTraits>
+typename basic_string_view<CharType, CharTraits>::size_type
+basic_string_view<CharType, CharTraits>::
+rfind(basic_string_view sv, size_type pos) const noexcept
+{
+  const size_type count = sv.size_;
+  if (count > size_)
+    return npos;
+  for (size_type i = pos < size_ - count ? pos : size_ - count;; --i)
+  {
+    if (traits_type::compare(data_ + i, sv.data_, count) == 0)
+      return i;
+    if (i == 0)
+      return npos;
+  }
+}
+
+// 重载比较操作符
+template <class CharType, class CharTraits>
+bool operator==(basic_string_view<CharType, CharTraits> lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator!=(basic_string_view<CharType, CharTraits> lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+template <class CharType, class CharTraits>
+bool operator<(basic_string_view<CharType, CharTraits> lhs,
+               basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return lhs.compare(rhs) < 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator>(basic_string_view<CharType, CharTraits> lhs,
+               basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return lhs.compare(rhs) > 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator<=(basic_string_view<CharType, CharTraits> lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return lhs.compare(rhs) <= 0;
+}
+
+template <class CharType, class CharTraits>
+bool operator>=(basic_string_view<CharType, CharTraits> lhs,
+                basic_string_view<CharType, CharTraits> rhs) noexcept
+{
+  return lhs.compare(rhs) >= 0;
+}
+
+// 与 C 风格字符串比较
+template <class CharType, class CharTraits>
+bool operator==(basic_string_view<CharType, CharTraits> lhs, const CharType* rhs)
+{
+  return lhs == basic_string_view<CharType, CharTraits>(rhs);
+}
+
+template <class CharType, class CharTraits>
+bool operator==(const CharType* lhs, basic_string_view<CharType, CharTraits> rhs)
+{
+  return basic_string_view<CharType, CharTraits>(lhs) == rhs;
+}
+
+template <class CharType, class CharTraits>
+bool operator!=(basic_string_view<CharType, CharTraits> lhs, const CharType* rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class CharType, class CharTraits>
+bool operator!=(const CharType* lhs, basic_string_view<CharType, CharTraits> rhs)
+{
+  return !(lhs == rhs);
+}
+
+// 重载 operator<<
+template <class CharType, class CharTraits>
+std::basic_ostream<CharType>& operator<<(std::basic_ostream<CharType>& os,
+                                         basic_string_view<CharType, CharTraits> sv)
+{
+  return os.write(sv.data(), static_cast<std::streamsize>(sv.size()));
+}
+
+// 重载 mystl 的 swap
+template <class CharType, class CharTraits>
+void swap(basic_string_view<CharType, CharTraits>& lhs,
+          basic_string_view<CharType, CharTraits>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// 特化 mystl::hash，按字节做 FNV-1a 哈希
+template <class CharType, class CharTraits>
+struct hash<basic_string_view<CharType, CharTraits>>
+{
+  size_t operator()(basic_string_view<CharType, CharTraits> sv) const noexcept
+  {
+    return bitwise_hash(reinterpret_cast<const unsigned char*>(sv.data()),
+                        sv.size() * sizeof(CharType));
+  }
+};
+
+typedef mystl::basic_string_view<char>      string_view;
+typedef mystl::basic_string_view<wchar_t>   wstring_view;
+typedef mystl::basic_string_view<char16_t>  u16string_view;
+typedef mystl::basic_string_view<char32_t>  u32string_view;
+
+} // namespace mystl
+#endif // !MYTINYSTL_STRING_VIEW_H_
+
@@ -0,0 +1,409 @@
+﻿#ifndef MYTINYSTL_THREAD_POOL_H_
+#define MYTINYSTL_THREAD_POOL_H_
+
+// 这个头文件包含两个类 thread_pool 和 task_group
+// thread_pool : 工作窃取线程池，每个工作线程拥有自己的任务队列，空闲时随机选择其它线程窃取任务
+// task_group  : fork/join 任务组，spawn 派生任务，sync 等待所有派生的任务完成
+
+// notes:
+//
+// 1. 工作线程派生的任务放入自己队列的尾部，并从尾部取出执行（后进先出），
+//    窃取者从队列头部取任务（先进先出），因此窃取到的通常是较大的任务
+// 2. 非工作线程提交的任务放入共享队列
+// 3. 等待 future 或 sync 的线程会帮助执行池中的任务，嵌套的并行调用不会使工作线程全部阻塞
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "deque.h"
+#include "memory.h"
+#include "vector.h"
+#include "util.h"
+
+namespace mystl
+{
+
+class thread_pool
+{
+public:
+  typedef size_t                 size_type;
+  typedef std::function<void()>  task_type;
+
+private:
+  // 任务队列，每个队列独占缓存行
+  struct alignas(kCacheLineSize) worker_queue
+  {
+    std::mutex              mutex;
+    mystl::deque<task_type> tasks;
+  };
+
+  // 当前线程所属的线程池与编号，以及随机选择窃取对象的状态
+  struct thread_info
+  {
+    thread_pool* pool;
+    size_type    index;
+    size_type    seed;
+  };
+
+  size_type                       size_;        // 工作线程的数量
+  mystl::vector<std::thread>      workers_;     // 工作线程
+  worker_queue*                   queues_;      // size() 个工作线程队列，最后一个为共享队列
+  std::atomic<size_type>          pending_;     // 队列中等待执行的任务数
+  std::atomic<size_type>          sleepers_;    // 正在休眠的工作线程数
+  std::mutex                      sleep_mutex_;
+  std::condition_variable         sleep_cv_;
+  bool                            stop_;
+
+public:
+  // 构造、析构函数，n 为工作线程的数量，为 0 时使用硬件支持的并发数
+  explicit thread_pool(size_type n = 0);
+  ~thread_pool();
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+public:
+  // 工作线程的数量
+  size_type size() const noexcept { return size_; }
+
+  // 提交一个任务，不关心它的结果
+  void post(task_type task);
+
+  // 提交一个任务，返回与之关联的 future
+  template <class Function>
+  std::future<typename std::result_of<Function()>::type> submit(Function&& f);
+
+  // 对 [first, last) 递归二分，对每个长度不超过 grain 的子区间并行执行 f(begin, end)
+  // grain 为 0 时根据区间长度与线程数自动选择
+  template <class Index, class Function>
+  void parallel_for(Index first, Index last, Function f, Index grain = 0);
+
+  // 在当前线程取出并执行一个等待中的任务，没有任务时返回 false
+  bool run_pending_task();
+
+  // 等待 future 就绪，等待期间帮助执行池中的任务
+  template <class T>
+  void wait(const std::future<T>& f);
+
+  // 当前线程是否为本线程池的工作线程
+  bool in_worker() const noexcept { return current().pool == this; }
+
+  // 默认的线程池，供并行算法使用
+  static thread_pool& default_pool();
+
+private:
+  static thread_info& current();
+
+  bool try_pop(task_type& task);
+  bool pop_back(size_type q, task_type& task);
+  bool pop_front(size_type q, task_type& task);
+  void worker_loop(size_type index);
+};
+
+/*****************************************************************************************/
+// task_group
+// spawn 派生的任务可以被任意工作线程执行，sync 等待它们全部完成并重新抛出第一个异常
+/*****************************************************************************************/
+class task_group
+{
+private:
+  thread_pool&        pool_;
+  std::atomic<size_t> pending_;    // 尚未完成的任务数
+  std::mutex          mutex_;      // 保护 exception_
+  std::exception_ptr  exception_;  // 第一个抛出的异常
+
+public:
+  explicit task_group(thread_pool& pool = thread_pool::default_pool())
+    :pool_(pool), pending_(0)
+  {
+  }
+
+  ~task_group()
+  {
+    wait();
+  }
+
+  task_group(const task_group&) = delete;
+  task_group& operator=(const task_group&) = delete;
+
+public:
+  thread_pool& pool() const noexcept { return pool_; }
+
+  template <class Function>
+  void spawn(Function&& f);
+
+  // 等待所有派生的任务完成，若有任务抛出异常，重新抛出第一个异常
+  void sync();
+
+private:
+  void wait();
+};
+
+/*****************************************************************************************/
+// thread_pool 的实现
+
+// 构造函数
+inline thread_pool::thread_pool(size_type n)
+  :size_(n), pending_(0), sleepers_(0), stop_(false)
+{
+  if (size_ == 0)
+    size_ = std::thread::hardware_concurrency();
+  if (size_ == 0)
+    size_ = 1;
+  n = size_;
+  queues_ = mystl::aligned_allocate<worker_queue>(n + 1);
+  size_type i = 0;
+  try
+  {
+    for (; i <= n; ++i)
+      mystl::construct(queues_ + i);
+  }
+  catch (...)
+  {
+    mystl::destroy(queues_, queues_ + i);
+    mystl::aligned_deallocate(queues_);
+    throw;
+  }
+  workers_.reserve(n);
+  for (i = 0; i < n; ++i)
+    workers_.emplace_back(&thread_pool::worker_loop, this, i);
+}
+
+// 析构函数，执行完剩余的任务后结束所有工作线程
+inline thread_pool::~thread_pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto& t : workers_)
+    t.join();
+  mystl::destroy(queues_, queues_ + size_ + 1);
+  mystl::aligned_deallocate(queues_);
+}
+
+inline void thread_pool::post(task_type task)
+{
+  const auto& info = current();
+  const size_type q = info.pool == this ? info.index : size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[q].mutex);
+    queues_[q].tasks.push_back(mystl::move(task));
+  }
+  pending_.fetch_add(1);
+  if (sleepers_.load() > 0)
+  { // 先获取一次休眠锁，保证唤醒不会在工作线程检查条件与开始等待之间丢失
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    sleep_cv_.notify_one();
+  }
+}
+
+template <class Function>
+std::future<typename std::result_of<Function()>::type>
+thread_pool::submit(Function&& f)
+{
+  typedef typename std::result_of<Function()>::type result_type;
+  auto task = std::make_shared<std::packaged_task<result_type()>>(mystl::forward<Function>(f));
+  auto result = task->get_future();
+  post([task]() { (*task)(); });
+  return result;
+}
+
+template <class Index, class Function>
+void parallel_for_aux(task_group& group, Index first, Index last, Index grain, Function& f)
+{
+  while (last - first > grain)
+  {
+    const Index mid = first + (last - first) / 2;
+    group.spawn([&group, mid, last, grain, &f]()
+                { mystl::parallel_for_aux(group, mid, last, grain, f); });
+    last = mid;
+  }
+  f(first, last);
+}
+
+template <class Index, class Function>
+void thread_pool::parallel_for(Index first, Index last, Function f, Index grain)
+{
+  if (!(first < last))
+    return;
+  if (grain == 0)
+  { // 每个线程大约分到 8 个子区间，便于负载均衡
+    grain = static_cast<Index>((last - first) / (8 * (size() + 1)));
+    if (grain == 0)
+      grain = 1;
+  }
+  task_group group(*this);
+  mystl::parallel_for_aux(group, first, last, grain, f);
+  group.sync();
+}
+
+inline bool thread_pool::run_pending_task()
+{
+  task_type task;
+  if (!try_pop(task))
+    return false;
+  task();
+  return true;
+}
+
+template <class T>
+void thread_pool::wait(const std::future<T>& f)
+{
+  while (f.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+  {
+    if (!run_pending_task())
+      std::this_thread::yield();
+  }
+}
+
+inline thread_pool& thread_pool::default_pool()
+{
+  static thread_pool pool;
+  return pool;
+}
+
+inline thread_pool::thread_info& thread_pool::current()
+{
+  static thread_local thread_info info = { nullptr, 0, 0 };
+  return info;
+}
+
+// 依次尝试：自己队列的尾部、共享队列的头部、从随机选择的线程开始窃取其它队列的头部
+inline bool thread_pool::try_pop(task_type& task)
+{
+  if (pending_.load(std::memory_order_relaxed) == 0)
+    return false;
+  auto& info = current();
+  const size_type n = size();
+  const bool is_worker = info.pool == this;
+  if (is_worker && pop_back(info.index, task))
+    return true;
+  if (pop_front(n, task))
+    return true;
+  if (info.seed == 0)
+    info.seed = reinterpret_cast<size_type>(&info) | 1;
+  info.seed ^= info.seed << 13;
+  info.seed ^= info.seed >> 7;
+  info.seed ^= info.seed << 17;
+  const size_type start = static_cast<size_type>(info.seed % n);
+  for (size_type i = 0; i < n; ++i)
+  {
+    const size_type victim = (start + i) % n;
+    if (is_worker && victim == info.index)
+      continue;
+    if (pop_front(victim, task))
+      return true;
+  }
+  return false;
+}
+
+inline bool thread_pool::pop_back(size_type q, task_type& task)
+{
+  std::lock_guard<std::mutex> lock(queues_[q].mutex);
+  if (queues_[q].tasks.empty())
+    return false;
+  task = mystl::move(queues_[q].tasks.back());
+  queues_[q].tasks.pop_back();
+  pending_.fetch_sub(1);
+  return true;
+}
+
+inline bool thread_pool::pop_front(size_type q, task_type& task)
+{
+  std::lock_guard<std::mutex> lock(queues_[q].mutex);
+  if (queues_[q].tasks.empty())
+    return false;
+  task = mystl::move(queues_[q].tasks.front());
+  queues_[q].tasks.pop_front();
+  pending_.fetch_sub(1);
+  return true;
+}
+
+inline void thread_pool::worker_loop(size_type index)
+{
+  auto& info = current();
+  info.pool = this;
+  info.index = index;
+  info.seed = index * 0x9e3779b97f4a7c15ull + 1;
+  while (true)
+  {
+    task_type task;
+    if (try_pop(task))
+    {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleepers_.fetch_add(1);
+    sleep_cv_.wait(lock, [this] { return stop_ || pending_.load() > 0; });
+    sleepers_.fetch_sub(1);
+    if (stop_ && pending_.load() == 0)
+      return;
+  }
+}
+
+/*****************************************************************************************/
+// task_group 的实现
+
+template <class Function>
+void task_group::spawn(Function&& f)
+{
+  pending_.fetch_add(1);
+  try
+  { // 复制函数对象或者提交任务时抛出异常，任务不会执行，撤销计数，否则 wait 永远等不到它完成
+    auto fn = typename std::decay<Function>::type(mystl::forward<Function>(f));
+    pool_.post([this, fn]() mutable
+    {
+      try
+      {
+        fn();
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!exception_)
+          exception_ = std::current_exception();
+      }
+      pending_.fetch_sub(1);  // 之后不能再访问 this
+    });
+  }
+  catch (...)
+  {
+    pending_.fetch_sub(1);
+    throw;
+  }
+}
+
+inline void task_group::wait()
+{
+  while (pending_.load() != 0)
+  {
+    if (!pool_.run_pending_task())
+      std::this_thread::yield();
+  }
+}
+
+inline void task_group::sync()
+{
+  wait();
+  if (exception_)
+  {
+    auto e = exception_;
+    exception_ = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_THREAD_POOL_H_
+
@@ -6,6 +6,12 @@
 
 // notes:
 //
+// 当 Hash 与 KeyEqual 都声明了 is_transparent 时，find / count / contains / equal_range / erase
+// 可以接受任意能与 key_type 一起求哈希值、比较相等的键值类型
+//
+// incremental_rehash(true) 打开渐进式重建，扩容时的迁移分摊到之后的插入与删除中，
+// 以避免单次插入移动所有元素，查找不会迁移，详见 hashtable.h
+//
 // 异常保证：
 // mystl::unordered_map<Key, T> / mystl::unordered_multimap<Key, T> 满足基本异常保证，对以下等函数做强异常安全保证：
 //   * emplace
@@ -179,6 +185,13 @@ public:
   size_type erase(const key_type& key)
   { return ht_.erase_unique(key); }
 
+  // 只有 Hash 与 KeyEqual 都是透明的才启用，且 K 不能转换为迭代器，避免与 erase(iterator) 混淆
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0,
+    typename std::enable_if<!std::is_convertible<K, iterator>::value &&
+      !std::is_convertible<K, const_iterator>::value, int>::type = 0>
+  size_type erase(const K& key)
+  { return ht_.erase_unique(key); }
+
   void      clear()
   { ht_.clear(); }
 
@@ -228,6 +241,34 @@ public:
   pair<const_iterator, const_iterator> equal_range(const key_type& key) const
   { return ht_.equal_range_unique(key); }
 
+  bool           contains(const key_type& key) const
+  { return ht_.find(key).node != nullptr; }
+
+  // 异构查找：当 Hash 与 KeyEqual 都声明了 is_transparent 时，可以直接用与 key_type 可比较的
+  // 其它类型（如以 string 为键值时的 string_view 或 C 风格字符串）查找，不必构造临时的 key_type
+
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  size_type      count(const K& key) const
+  { return ht_.count(key); }
+
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  iterator       find(const K& key)
+  { return ht_.find(key); }
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  const_iterator find(const K& key)  const
+  { return ht_.find(key); }
+
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  bool           contains(const K& key) const
+  { return ht_.find(key).node != nullptr; }
+
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  pair<iterator, iterator> equal_range(const K& key)
+  { return ht_.equal_range_unique(key); }
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  pair<const_iterator, const_iterator> equal_range(const K& key) const
+  { return ht_.equal_range_unique(key); }
+
   // bucket interface
 
   local_iterator       begin(size_type n)        noexcept
@@ -264,17 +305,21 @@ public:
   void      rehash(size_type count)                 { ht_.rehash(count); }
   void      reserve(size_type count)                { ht_.reserve(count); }
 
+  bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+  void      incremental_rehash(bool enable)         { ht_.incremental_rehash(enable); }
+  bool      rehashing()              const noexcept { return ht_.rehashing(); }
+
   hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
   key_equal key_eq()                 const          { return ht_.key_eq(); }
 
 public:
   friend bool operator==(const unordered_map& lhs, const unordered_map& rhs)
   {
-    return lhs.ht_.equal_range_unique(rhs.ht_);
+    return lhs.ht_.equal_to_unique(rhs.ht_);
   }
   friend bool operator!=(const unordered_map& lhs, const unordered_map& rhs)
   {
-    return !lhs.ht_.equal_range_unique(rhs.ht_);
+    return !lhs.ht_.equal_to_unique(rhs.ht_);
   }
 };
 
@@ -464,6 +509,12 @@ public:
   size_type erase(const key_type& key) 
   { return ht_.erase_multi(key); }
 
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0,
+    typename std::enable_if<!std::is_convertible<K, iterator>::value &&
+      !std::is_convertible<K, const_iterator>::value, int>::type = 0>
+  size_type erase(const K& key)
+  { return ht_.erase_multi(key); }
+
   void      clear()
   { ht_.clear(); }
 
@@ -485,6 +536,31 @@ public:
   pair<const_iterator, const_iterator> equal_range(const key_type& key) const 
   { return ht_.equal_range_multi(key); }
 
+  bool           contains(const key_type& key) const
+  { return ht_.find(key).node != nullptr; }
+
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  size_type      count(const K& key) const
+  { return ht_.count(key); }
+
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  iterator       find(const K& key)
+  { return ht_.find(key); }
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  const_iterator find(const K& key)  const
+  { return ht_.find(key); }
+
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  bool           contains(const K& key) const
+  { return ht_.find(key).node != nullptr; }
+
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  pair<iterator, iterator> equal_range(const K& key)
+  { return ht_.equal_range_multi(key); }
+  template <class K, ht_enable_if_transparent<Hash, KeyEqual, K, int> = 0>
+  pair<const_iterator, const_iterator> equal_range(const K& key) const
+  { return ht_.equal_range_multi(key); }
+
   // bucket interface
 
   local_iterator       begin(size_type n)        noexcept
@@ -521,17 +597,21 @@ public:
   void      rehash(size_type count)                 { ht_.rehash(count); }
   void      reserve(size_type count)                { ht_.reserve(count); }
 
+  bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+  void      incremental_rehash(bool enable)         { ht_.incremental_rehash(enable); }
+  bool      rehashing()              const noexcept { return ht_.rehashing(); }
+
   hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
   key_equal key_eq()                 const          { return ht_.key_eq(); }
 
 public:
   friend bool operator==(const unordered_multimap& lhs, const unordered_multimap& rhs)
   {
-    return lhs.ht_.equal_range_multi(rhs.ht_);
+    return lhs.ht_.equal_to_multi(rhs.ht_);
   }
   friend bool operator!=(const unordered_multimap& lhs, const unordered_multimap& rhs)
   {
-    return !lhs.ht_.equal_range_multi(rhs.ht_);
+    return !lhs.ht_.equal_to_multi(rhs.ht_);
   }
 };
 
@@ -33,6 +33,18 @@ T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
   return static_cast<T&&>(arg);
 }
 
+// move_if_noexcept
+// 移动构造函数不抛出异常或者不能复制时返回右值引用，否则返回 const 左值引用，使构造失败时原对象保持不变
+
+template <class T>
+typename std::conditional<
+  !std::is_nothrow_move_constructible<T>::value && std::is_copy_constructible<T>::value,
+  const T&, T&&>::type
+move_if_noexcept(T& arg) noexcept
+{
+  return mystl::move(arg);
+}
+
 // swap
 
 template <class Tp>
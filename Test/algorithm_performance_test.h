@@ -1,11 +1,20 @@
 ﻿#ifndef MYTINYSTL_ALGORITHM_PERFORMANCE_TEST_H_
 #define MYTINYSTL_ALGORITHM_PERFORMANCE_TEST_H_
 
-// 仅仅针对 sort, binary_search 做了性能测试
+// 仅仅针对 sort, radix_sort, stable_sort, partial_sort, nth_element, binary_search, lower_bound, upper_bound,
+// static_search_index, search, search_n,
+// 向量化的比较算法与数值算法，以及并行算法的扩展性做了性能测试
 
 #include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <thread>
 
 #include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/searcher.h"
+#include "../MyTinySTL/static_search_index.h"
+#include "../MyTinySTL/unordered_map.h"
 #include "test.h"
 
 namespace mystl
@@ -55,6 +64,245 @@ namespace algorithm_performance_test
     delete []arr;                                              \
 } while(0)
 
+// 与 FUN_TEST2 相同，但在有序的数组中查找，查询的值在计时之前生成
+#define SEARCH_FUN_TEST(mode, fun, count) do {                \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    clock_t start, end;                                        \
+    int *arr = new int[count];                                 \
+    int *query = new int[count];                               \
+    for(size_t i = 0; i < count; ++i)  *(arr + i) = rand();    \
+    for(size_t i = 0; i < count; ++i)  *(query + i) = rand();  \
+    std::sort(arr, arr + count);                               \
+    size_t sum = 0;                                            \
+    start = clock();                                           \
+    for(size_t i = 0; i < count; ++i)                          \
+        sum += mode::fun(arr, arr + count, query[i]) - arr;    \
+    end = clock();                                             \
+    perf_sink = sum;                                           \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    delete []arr;                                              \
+    delete []query;                                            \
+} while(0)
+
+// 与 SEARCH_FUN_TEST 相同，但一次调用 lower_bound_batch 完成所有查询
+#define BATCH_FUN_TEST(count) do {                            \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    clock_t start, end;                                        \
+    int *arr = new int[count];                                 \
+    int *query = new int[count];                               \
+    int **result = new int*[count];                            \
+    for(size_t i = 0; i < count; ++i)  *(arr + i) = rand();    \
+    for(size_t i = 0; i < count; ++i)  *(query + i) = rand();  \
+    std::sort(arr, arr + count);                               \
+    start = clock();                                           \
+    mystl::lower_bound_batch(arr, arr + count,                 \
+                             query, query + count, result);    \
+    end = clock();                                             \
+    perf_sink = result[count / 2] - arr;                       \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    delete []arr;                                              \
+    delete []query;                                            \
+    delete []result;                                           \
+} while(0)
+
+// 在 count 个随机数中选出最小的 k 个，fun 为 partial_sort 或 nth_element
+#define TOPK_FUN_TEST(mode, fun, count, k) do {               \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    clock_t start, end;                                        \
+    int *arr = new int[count];                                 \
+    for(size_t i = 0; i < count; ++i)  *(arr + i) = rand();    \
+    start = clock();                                           \
+    mode::fun(arr, arr + (k), arr + count);                    \
+    end = clock();                                             \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    delete []arr;                                              \
+} while(0)
+
+// 与 FUN_TEST1 相同，但可以指定元素的类型以及生成元素的表达式
+#define FUN_TEST3(mode, fun, type, gen, count) do {           \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    clock_t start, end;                                        \
+    type *arr = new type[count];                               \
+    for(size_t i = 0; i < count; ++i)  *(arr + i) = gen;       \
+    start = clock();                                           \
+    mode::fun(arr, arr + count);                               \
+    end = clock();                                             \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    delete []arr;                                              \
+} while(0)
+
+// 并行算法性能测试宏定义，多线程下 clock() 统计的是所有线程的 CPU 时间，因此改用挂钟时间
+// arr 为存放测试数据的数组名，后面的参数可以用这个名字引用该数组（如作为输出区间）
+#define PAR_FUN_TEST(policy, fun, arr, size, ...) do {        \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    int *arr = new int[size];                                  \
+    for(size_t i = 0; i < size; ++i)  *(arr + i) = rand();     \
+    auto start = std::chrono::steady_clock::now();             \
+    mystl::fun(policy, arr, arr + size, __VA_ARGS__);          \
+    auto end = std::chrono::steady_clock::now();               \
+    int n = static_cast<int>(std::chrono::duration_cast<      \
+        std::chrono::milliseconds>(end - start).count());      \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    delete []arr;                                              \
+} while(0)
+
+// 与 PAR_FUN_TEST 相同，但可以指定元素的类型以及生成元素的表达式
+#define PAR_FUN_TEST3(policy, fun, type, gen, size) do {     \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    type *arr = new type[size];                                \
+    for(size_t i = 0; i < size; ++i)  *(arr + i) = gen;        \
+    auto start = std::chrono::steady_clock::now();             \
+    mystl::fun(policy, arr, arr + size);                       \
+    auto end = std::chrono::steady_clock::now();               \
+    int n = static_cast<int>(std::chrono::duration_cast<      \
+        std::chrono::milliseconds>(end - start).count());      \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    delete []arr;                                              \
+} while(0)
+
+// 稳定排序测试用的记录，键值只有 100 种，大量记录的键值相等
+struct record
+{
+  int key;
+  int payload[3];
+
+  bool operator<(const record& rhs) const { return key < rhs.key; }
+};
+
+record make_record()
+{
+  record r;
+  r.key = rand() % 100;
+  r.payload[0] = r.payload[1] = r.payload[2] = rand();
+  return r;
+}
+
+// 在 LEN3 个元素中取 top-k，k 分别为 LEN3 的 0.1%, 1%, 10% 与 50%
+void top_k_test()
+{
+  std::cout << "[----------------- function : top-k of " << LEN3 << " -----------------]" << std::endl;
+  std::cout << "|          k          |";
+  std::cout << std::setw(WIDE) << "0.1%    |" << std::setw(WIDE) << "1%     |"
+            << std::setw(WIDE) << "10%     |" << std::setw(WIDE) << "50%     |" << std::endl;
+  std::cout << "|  std partial_sort   |";
+  TOPK_FUN_TEST(std, partial_sort, LEN3, LEN3 / 1000);
+  TOPK_FUN_TEST(std, partial_sort, LEN3, LEN3 / 100);
+  TOPK_FUN_TEST(std, partial_sort, LEN3, LEN3 / 10);
+  TOPK_FUN_TEST(std, partial_sort, LEN3, LEN3 / 2);
+  std::cout << std::endl << "| mystl partial_sort  |";
+  TOPK_FUN_TEST(mystl, partial_sort, LEN3, LEN3 / 1000);
+  TOPK_FUN_TEST(mystl, partial_sort, LEN3, LEN3 / 100);
+  TOPK_FUN_TEST(mystl, partial_sort, LEN3, LEN3 / 10);
+  TOPK_FUN_TEST(mystl, partial_sort, LEN3, LEN3 / 2);
+  std::cout << std::endl << "|   std nth_element   |";
+  TOPK_FUN_TEST(std, nth_element, LEN3, LEN3 / 1000);
+  TOPK_FUN_TEST(std, nth_element, LEN3, LEN3 / 100);
+  TOPK_FUN_TEST(std, nth_element, LEN3, LEN3 / 10);
+  TOPK_FUN_TEST(std, nth_element, LEN3, LEN3 / 2);
+  std::cout << std::endl << "|  mystl nth_element  |";
+  TOPK_FUN_TEST(mystl, nth_element, LEN3, LEN3 / 1000);
+  TOPK_FUN_TEST(mystl, nth_element, LEN3, LEN3 / 100);
+  TOPK_FUN_TEST(mystl, nth_element, LEN3, LEN3 / 10);
+  TOPK_FUN_TEST(mystl, nth_element, LEN3, LEN3 / 2);
+  std::cout << std::endl;
+}
+
+// 返回 f 的耗时（毫秒）
+template <class Function>
+int elapsed_ms(Function f)
+{
+  clock_t start = clock();
+  f();
+  clock_t end = clock();
+  return static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+#define PERMUTATION_TIME(f) do {                                 \
+    char buf[16];                                                \
+    std::snprintf(buf, sizeof(buf), "%dms   |", elapsed_ms(f));  \
+    std::cout << std::setw(WIDE) << buf;                         \
+} while(0)
+
+// 判断两个互为排列、元素各不相同的区间，逐个计数的 std 版本为 O(n^2)，只测试前两种长度
+// 最后一行为两个只有一组键值的 unordered_multimap 的比较
+void is_permutation_test()
+{
+  const size_t lens[3] = { LEN1 / 100, LEN1 / 10, LEN1 };
+  std::cout << "[------------------- function : is_permutation -----------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  mystl::vector<int> a[3], b[3];
+  mystl::vector<mystl::pair<int, int>> pa[3], pb[3];
+  for (size_t c = 0; c < 3; ++c)
+  {
+    for (size_t i = 0; i < lens[c]; ++i)
+    {
+      a[c].push_back(static_cast<int>(i));
+      pa[c].push_back(mystl::make_pair(static_cast<int>(i % 7), static_cast<int>(i)));
+    }
+    b[c] = a[c];
+    pb[c] = pa[c];
+    std::random_shuffle(b[c].begin(), b[c].end());
+    std::random_shuffle(pb[c].begin(), pb[c].end());
+  }
+  std::cout << "|         std         |";
+  for (size_t c = 0; c < 2; ++c)
+    PERMUTATION_TIME([&]() { perf_sink = std::is_permutation(a[c].begin(), a[c].end(), b[c].begin()); });
+  std::cout << std::setw(WIDE) << "-   |";
+  std::cout << std::endl << "|    mystl (hash)     |";
+  for (size_t c = 0; c < 3; ++c)
+    PERMUTATION_TIME([&]() { perf_sink = mystl::is_permutation(a[c].begin(), a[c].end(),
+                                                                 b[c].begin(), b[c].end()); });
+  std::cout << std::endl << "|    mystl (sort)     |";
+  for (size_t c = 0; c < 3; ++c)
+    PERMUTATION_TIME([&]() { perf_sink = mystl::is_permutation(pa[c].begin(), pa[c].end(),
+                                                                 pb[c].begin(), pb[c].end()); });
+  std::cout << std::endl << "| unordered_multimap  |";
+  for (size_t c = 0; c < 3; ++c)
+  {
+    mystl::unordered_multimap<int, int> m1, m2;
+    for (size_t i = 0; i < lens[c]; ++i)
+    {
+      m1.emplace(0, a[c][i]);
+      m2.emplace(0, b[c][i]);
+    }
+    PERMUTATION_TIME([&]() { perf_sink = m1 == m2; });
+  }
+  std::cout << std::endl;
+}
+
 void binary_search_test()
 {
   std::cout << "[------------------- function : binary_search ------------------]" << std::endl;
@@ -71,6 +319,121 @@ void binary_search_test()
   std::cout << std::endl;
 }
 
+void lower_bound_test()
+{
+  std::cout << "[-------------------- function : lower_bound -------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  std::cout << "|         std         |";
+  SEARCH_FUN_TEST(std, lower_bound, LEN1);
+  SEARCH_FUN_TEST(std, lower_bound, LEN2);
+  SEARCH_FUN_TEST(std, lower_bound, LEN3);
+  std::cout << std::endl << "|        mystl        |";
+  SEARCH_FUN_TEST(mystl, lower_bound, LEN1);
+  SEARCH_FUN_TEST(mystl, lower_bound, LEN2);
+  SEARCH_FUN_TEST(mystl, lower_bound, LEN3);
+  std::cout << std::endl << "|   mystl (branchy)   |";
+  SEARCH_FUN_TEST(mystl, lower_bound_branchy, LEN1);
+  SEARCH_FUN_TEST(mystl, lower_bound_branchy, LEN2);
+  SEARCH_FUN_TEST(mystl, lower_bound_branchy, LEN3);
+  std::cout << std::endl << "|    mystl (batch)    |";
+  BATCH_FUN_TEST(LEN1);
+  BATCH_FUN_TEST(LEN2);
+  BATCH_FUN_TEST(LEN3);
+  std::cout << std::endl;
+}
+
+void upper_bound_test()
+{
+  std::cout << "[-------------------- function : upper_bound -------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  std::cout << "|         std         |";
+  SEARCH_FUN_TEST(std, upper_bound, LEN1);
+  SEARCH_FUN_TEST(std, upper_bound, LEN2);
+  SEARCH_FUN_TEST(std, upper_bound, LEN3);
+  std::cout << std::endl << "|        mystl        |";
+  SEARCH_FUN_TEST(mystl, upper_bound, LEN1);
+  SEARCH_FUN_TEST(mystl, upper_bound, LEN2);
+  SEARCH_FUN_TEST(mystl, upper_bound, LEN3);
+  std::cout << std::endl << "|   mystl (branchy)   |";
+  SEARCH_FUN_TEST(mystl, upper_bound_branchy, LEN1);
+  SEARCH_FUN_TEST(mystl, upper_bound_branchy, LEN2);
+  SEARCH_FUN_TEST(mystl, upper_bound_branchy, LEN3);
+  std::cout << std::endl;
+}
+
+// 对每个查询调用 search，返回耗时（毫秒）
+template <class Search>
+int search_time(const mystl::vector<int>& queries, Search search)
+{
+  size_t sum = 0;
+  clock_t start = clock();
+  for (auto q : queries)
+    sum += search(q);
+  clock_t end = clock();
+  perf_sink = sum;
+  return static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 在不同大小的有序数组上做 LEN2 次随机的 lower_bound，比较经典二分与 static_search_index 的两种布局
+void search_layout_test()
+{
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN3, LEN3 * 10, LEN3 * 100 };
+#else
+  const size_t lens[3] = { LEN1, LEN2, LEN3 };
+#endif
+  const char* names[5] = { "|    std (halving)    |", "|   mystl (branchy)   |",
+                           "| mystl (branchless)  |", "|  mystl (eytzinger)  |",
+                           "|    mystl (btree)    |" };
+  int times[5][3];
+  std::mt19937 gen(static_cast<unsigned>(time(0)));
+  for (size_t c = 0; c < 3; ++c)
+  {
+    const size_t n = lens[c];
+    mystl::vector<int> arr(n);
+    for (size_t i = 0; i < n; ++i)
+      arr[i] = static_cast<int>(i * 2);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(n * 2));
+    mystl::vector<int> queries(LEN2);
+    for (auto& q : queries)
+      q = dist(gen);
+    const int* first = arr.data();
+    const int* last = arr.data() + n;
+    times[0][c] = search_time(queries, [=](int x)
+                              { return static_cast<size_t>(std::lower_bound(first, last, x) - first); });
+    times[1][c] = search_time(queries, [=](int x)
+                              { return static_cast<size_t>(mystl::lower_bound_branchy(first, last, x) - first); });
+    times[2][c] = search_time(queries, [=](int x)
+                              { return static_cast<size_t>(mystl::lower_bound(first, last, x) - first); });
+    {
+      mystl::static_search_index<int> index(first, last, mystl::search_layout::eytzinger);
+      times[3][c] = search_time(queries, [&](int x) { return index.lower_bound(x); });
+    }
+    {
+      mystl::static_search_index<int> index(first, last, mystl::search_layout::btree);
+      times[4][c] = search_time(queries, [&](int x) { return index.lower_bound(x); });
+    }
+  }
+  std::cout << "[---------------- lower_bound : " << LEN2 << " queries ----------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (size_t r = 0; r < 5; ++r)
+  {
+    std::cout << names[r];
+    for (size_t c = 0; c < 3; ++c)
+    {
+      char buf[10];
+      std::snprintf(buf, sizeof(buf), "%d", times[r][c]);
+      std::string t = buf;
+      t += "ms   |";
+      std::cout << std::setw(WIDE) << t;
+    }
+    std::cout << std::endl;
+  }
+}
+
 void sort_test()
 {
   std::cout << "[----------------------- function : sort -----------------------]" << std::endl;
@@ -87,6 +450,455 @@ void sort_test()
   std::cout << std::endl;
 }
 
+void radix_sort_test()
+{
+#if LARGER_TEST_DATA_ON
+  const size_t len1 = SCALE_L(LEN1), len2 = SCALE_L(LEN2), len3 = SCALE_L(LEN3);
+#else
+  const size_t len1 = LEN1, len2 = LEN2, len3 = LEN3;
+#endif
+  std::cout << "[-------------------- function : radix_sort --------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  std::cout << "|      int / sort     |";
+  FUN_TEST3(mystl, sort, int, rand() - RAND_MAX / 2, len1);
+  FUN_TEST3(mystl, sort, int, rand() - RAND_MAX / 2, len2);
+  FUN_TEST3(mystl, sort, int, rand() - RAND_MAX / 2, len3);
+  std::cout << std::endl << "|   int / radix_sort  |";
+  FUN_TEST3(mystl, radix_sort, int, rand() - RAND_MAX / 2, len1);
+  FUN_TEST3(mystl, radix_sort, int, rand() - RAND_MAX / 2, len2);
+  FUN_TEST3(mystl, radix_sort, int, rand() - RAND_MAX / 2, len3);
+  std::cout << std::endl << "|   uint64_t / sort   |";
+  FUN_TEST3(mystl, sort, uint64_t, (uint64_t)rand() << 33 ^ rand(), len1);
+  FUN_TEST3(mystl, sort, uint64_t, (uint64_t)rand() << 33 ^ rand(), len2);
+  FUN_TEST3(mystl, sort, uint64_t, (uint64_t)rand() << 33 ^ rand(), len3);
+  std::cout << std::endl << "|uint64_t / radix_sort|";
+  FUN_TEST3(mystl, radix_sort, uint64_t, (uint64_t)rand() << 33 ^ rand(), len1);
+  FUN_TEST3(mystl, radix_sort, uint64_t, (uint64_t)rand() << 33 ^ rand(), len2);
+  FUN_TEST3(mystl, radix_sort, uint64_t, (uint64_t)rand() << 33 ^ rand(), len3);
+  std::cout << std::endl << "|    double / sort    |";
+  FUN_TEST3(mystl, sort, double, (rand() - RAND_MAX / 2) / 3.0, len1);
+  FUN_TEST3(mystl, sort, double, (rand() - RAND_MAX / 2) / 3.0, len2);
+  FUN_TEST3(mystl, sort, double, (rand() - RAND_MAX / 2) / 3.0, len3);
+  std::cout << std::endl << "| double / radix_sort |";
+  FUN_TEST3(mystl, radix_sort, double, (rand() - RAND_MAX / 2) / 3.0, len1);
+  FUN_TEST3(mystl, radix_sort, double, (rand() - RAND_MAX / 2) / 3.0, len2);
+  FUN_TEST3(mystl, radix_sort, double, (rand() - RAND_MAX / 2) / 3.0, len3);
+  std::cout << std::endl;
+}
+
+void stable_sort_test()
+{
+  std::cout << "[-------------------- function : stable_sort -------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  std::cout << "|         std         |";
+  FUN_TEST3(std, stable_sort, record, make_record(), LEN1);
+  FUN_TEST3(std, stable_sort, record, make_record(), LEN2);
+  FUN_TEST3(std, stable_sort, record, make_record(), LEN3);
+  std::cout << std::endl << "|        mystl        |";
+  FUN_TEST3(mystl, stable_sort, record, make_record(), LEN1);
+  FUN_TEST3(mystl, stable_sort, record, make_record(), LEN2);
+  FUN_TEST3(mystl, stable_sort, record, make_record(), LEN3);
+  std::cout << std::endl << "|     mystl (par)     |";
+  PAR_FUN_TEST3(mystl::execution::par, stable_sort, record, make_record(), LEN1);
+  PAR_FUN_TEST3(mystl::execution::par, stable_sort, record, make_record(), LEN2);
+  PAR_FUN_TEST3(mystl::execution::par, stable_sort, record, make_record(), LEN3);
+  std::cout << std::endl;
+}
+
+// 以 GB/s 为单位输出 f 的吞吐量，bytes 为 f 每次扫描的字节数
+template <class Function>
+void throughput_test(size_t bytes, Function f)
+{
+  const int rounds = 20;
+  char buf[20];
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i)
+    f();
+  auto end = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  std::snprintf(buf, sizeof(buf), "%.2fGB/s", seconds > 0 ? bytes * rounds / seconds / 1e9 : 0.0);
+  std::string t = buf;
+  t += "  |";
+  std::cout << std::setw(WIDE) << t;
+}
+
+// 改用向量化版本之前逐个元素比较的实现
+namespace scalar
+{
+
+template <class T, class U>
+const T* find(const T* first, const T* last, const U& value)
+{
+  while (first != last && *first != value)
+    ++first;
+  return first;
+}
+
+template <class T, class U>
+size_t count(const T* first, const T* last, const U& value)
+{
+  size_t n = 0;
+  for (; first != last; ++first)
+  {
+    if (*first == value)
+      ++n;
+  }
+  return n;
+}
+
+template <class T>
+const T* mismatch(const T* first1, const T* last1, const T* first2)
+{
+  while (first1 != last1 && *first1 == *first2)
+  {
+    ++first1;
+    ++first2;
+  }
+  return first1;
+}
+
+template <class T>
+bool equal(const T* first1, const T* last1, const T* first2)
+{
+  for (; first1 != last1; ++first1, ++first2)
+  {
+    if (*first1 != *first2)
+      return false;
+  }
+  return true;
+}
+
+} // namespace scalar
+
+// 对两个相同的数组做完整扫描：find 查找不存在的值，mismatch 与 equal 比较到末尾
+#define SIMD_THROUGHPUT_TEST(mode, a, b, n) do {                                \
+    throughput_test(n * sizeof(*a), [&]()                                      \
+      { perf_sink = mode::find(a, a + n, 1) - a; });                           \
+    throughput_test(n * sizeof(*a), [&]()                                      \
+      { perf_sink = mode::count(a, a + n, 1); });                              \
+    throughput_test(n * sizeof(*a), [&]()                                      \
+      { perf_sink = mode::mismatch(a, a + n, b) - a; });                       \
+    throughput_test(n * sizeof(*a), [&]()                                      \
+      { perf_sink = mode::equal(a, a + n, b); });                              \
+} while(0)
+
+// std 与 mystl 的 mismatch 返回 pair，包装成与 scalar 相同的接口
+namespace std_mode
+{
+template <class T, class U>
+const T* find(const T* first, const T* last, const U& value)
+{ return std::find(first, last, value); }
+template <class T, class U>
+size_t count(const T* first, const T* last, const U& value)
+{ return std::count(first, last, value); }
+template <class T>
+const T* mismatch(const T* first1, const T* last1, const T* first2)
+{ return std::mismatch(first1, last1, first2).first; }
+template <class T>
+bool equal(const T* first1, const T* last1, const T* first2)
+{ return std::equal(first1, last1, first2); }
+} // namespace std_mode
+
+namespace mystl_mode
+{
+template <class T, class U>
+const T* find(const T* first, const T* last, const U& value)
+{ return mystl::find(first, last, value); }
+template <class T, class U>
+size_t count(const T* first, const T* last, const U& value)
+{ return mystl::count(first, last, value); }
+template <class T>
+const T* mismatch(const T* first1, const T* last1, const T* first2)
+{ return mystl::mismatch(first1, last1, first2).first; }
+template <class T>
+bool equal(const T* first1, const T* last1, const T* first2)
+{ return mystl::equal(first1, last1, first2); }
+} // namespace mystl_mode
+
+// find, count, mismatch, equal 在连续内存上的吞吐量
+void simd_throughput_test()
+{
+  const size_t bytes = LEN3 * 4;
+  const size_t n8 = bytes, n32 = bytes / 4;
+  char *a8 = new char[n8], *b8 = new char[n8];
+  int *a32 = new int[n32], *b32 = new int[n32];
+  std::fill(a8, a8 + n8, 0);
+  std::fill(b8, b8 + n8, 0);
+  std::fill(a32, a32 + n32, 0);
+  std::fill(b32, b32 + n32, 0);
+  std::cout << "[-------------- simd throughput : " << bytes << " bytes --------------]" << std::endl;
+  std::cout << "|      function       |";
+  std::cout << std::setw(WIDE) << "find   |" << std::setw(WIDE) << "count   |"
+    << std::setw(WIDE) << "mismatch   |" << std::setw(WIDE) << "equal   |" << std::endl;
+  std::cout << "|     std / char      |";
+  SIMD_THROUGHPUT_TEST(std_mode, static_cast<const char*>(a8), b8, n8);
+  std::cout << std::endl << "|   scalar / char     |";
+  SIMD_THROUGHPUT_TEST(scalar, static_cast<const char*>(a8), b8, n8);
+  std::cout << std::endl << "|    mystl / char     |";
+  SIMD_THROUGHPUT_TEST(mystl_mode, static_cast<const char*>(a8), b8, n8);
+  std::cout << std::endl << "|      std / int      |";
+  SIMD_THROUGHPUT_TEST(std_mode, static_cast<const int*>(a32), b32, n32);
+  std::cout << std::endl << "|    scalar / int     |";
+  SIMD_THROUGHPUT_TEST(scalar, static_cast<const int*>(a32), b32, n32);
+  std::cout << std::endl << "|     mystl / int     |";
+  SIMD_THROUGHPUT_TEST(mystl_mode, static_cast<const int*>(a32), b32, n32);
+  std::cout << std::endl;
+  delete []a8;
+  delete []b8;
+  delete []a32;
+  delete []b32;
+}
+
+// 以 GFLOP/s 为单位输出 f 的运算速度，ops 为 f 每次执行的算术运算次数
+template <class Function>
+void flops_test(size_t ops, Function f)
+{
+  const int rounds = 20;
+  char buf[20];
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i)
+    f();
+  auto end = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  std::snprintf(buf, sizeof(buf), "%.2fGF/s", seconds > 0 ? ops * rounds / seconds / 1e9 : 0.0);
+  std::string t = buf;
+  t += "  |";
+  std::cout << std::setw(WIDE) << t;
+}
+
+// 求和、内积、前缀和、相邻差分，内积每个元素计 2 次运算，其余计 1 次
+#define NUMERIC_THROUGHPUT_TEST(mode, T, a, b, out, n) do {                     \
+    flops_test(n, [&]() { perf_fsink = static_cast<double>(mode::sum(a, a + n, T())); });          \
+    flops_test(2 * n, [&]() { perf_fsink = static_cast<double>(mode::dot(a, a + n, b, T())); });   \
+    flops_test(n, [&]() { perf_fsink = static_cast<double>(*(mode::scan(a, a + n, out) - 1)); });   \
+    flops_test(n, [&]() { perf_fsink = static_cast<double>(*(mode::diff(a, a + n, out) - 1)); });   \
+} while(0)
+
+// std 使用 accumulate, inner_product, partial_sum, adjacent_difference，
+// mystl 使用允许重新结合的 reduce, transform_reduce, inclusive_scan 与 adjacent_difference
+namespace std_numeric
+{
+template <class T>
+T sum(const T* first, const T* last, T init) { return std::accumulate(first, last, init); }
+template <class T>
+T dot(const T* first1, const T* last1, const T* first2, T init)
+{ return std::inner_product(first1, last1, first2, init); }
+template <class T>
+T* scan(const T* first, const T* last, T* result) { return std::partial_sum(first, last, result); }
+template <class T>
+T* diff(const T* first, const T* last, T* result)
+{ return std::adjacent_difference(first, last, result); }
+} // namespace std_numeric
+
+namespace mystl_numeric
+{
+template <class T>
+T sum(const T* first, const T* last, T init) { return mystl::reduce(first, last, init); }
+template <class T>
+T dot(const T* first1, const T* last1, const T* first2, T init)
+{ return mystl::transform_reduce(first1, last1, first2, init); }
+template <class T>
+T* scan(const T* first, const T* last, T* result) { return mystl::inclusive_scan(first, last, result); }
+template <class T>
+T* diff(const T* first, const T* last, T* result)
+{ return mystl::adjacent_difference(first, last, result); }
+} // namespace mystl_numeric
+
+template <class T>
+void numeric_throughput_row(const char* name, size_t n)
+{
+  mystl::vector<T> a(n), b(n), out(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    a[i] = static_cast<T>(i % 7);
+    b[i] = static_cast<T>(i % 5);
+  }
+  const T* pa = a.data();
+  const T* pb = b.data();
+  T* po = out.data();
+  std::cout << "|" << std::setw(12) << name << " / std    |";
+  NUMERIC_THROUGHPUT_TEST(std_numeric, T, pa, pb, po, n);
+  std::cout << std::endl << "|" << std::setw(12) << name << " / mystl  |";
+  NUMERIC_THROUGHPUT_TEST(mystl_numeric, T, pa, pb, po, n);
+  std::cout << std::endl;
+}
+
+// 数值算法在大数组上的运算速度
+void numeric_throughput_test()
+{
+  const size_t n = LEN3 / 2;
+  std::cout << "[------------- numeric throughput : " << n << " elements ------------]" << std::endl;
+  std::cout << "|      function       |";
+  std::cout << std::setw(WIDE) << "sum   |" << std::setw(WIDE) << "dot   |"
+    << std::setw(WIDE) << "scan   |" << std::setw(WIDE) << "adj_diff  |" << std::endl;
+  numeric_throughput_row<float>("float", n);
+  numeric_throughput_row<double>("double", n);
+  numeric_throughput_row<int>("int", n);
+  numeric_throughput_row<long long>("long long", n);
+}
+
+// 在 text 中查找末尾长度为 m 的子串，按实际扫描的字节数（找到的位置加上 m）统计吞吐量
+template <class Search>
+void substring_throughput(const char* text, size_t n, size_t m, Search search)
+{
+  const size_t scanned = static_cast<size_t>(std::search(text, text + n, text + n - m, text + n) - text) + m;
+  throughput_test(scanned, [&]() { perf_sink = search(text, text + n, text + n - m, text + n) - text; });
+}
+
+// 在 n 个字符集大小为 alphabet 的随机字符中查找，每行分别使用 std::search, mystl::search 以及三种查找器
+#define SUBSTRING_SEARCH_TEST(alphabet) do {                                     \
+    for (size_t i = 0; i < n; ++i)                                             \
+      text[i] = static_cast<char>(rand() % alphabet);                          \
+    std::cout << "|     std / " << std::setw(3) << alphabet << "       |";     \
+    for (auto m : lens)                                                        \
+      substring_throughput(text, n, m, [](const char* f, const char* l, const char* pf, const char* pl) \
+        { return std::search(f, l, pf, pl); });                                \
+    std::cout << std::endl << "|    mystl / " << std::setw(3) << alphabet << "      |"; \
+    for (auto m : lens)                                                        \
+      substring_throughput(text, n, m, [](const char* f, const char* l, const char* pf, const char* pl) \
+        { return mystl::search(f, l, pf, pl); });                              \
+    std::cout << std::endl << "|     bmh / " << std::setw(3) << alphabet << "       |"; \
+    for (auto m : lens)                                                        \
+      substring_throughput(text, n, m, [](const char* f, const char* l, const char* pf, const char* pl) \
+        { return mystl::search(f, l, mystl::make_boyer_moore_horspool_searcher(pf, pl)); }); \
+    std::cout << std::endl << "|   two-way / " << std::setw(3) << alphabet << "     |"; \
+    for (auto m : lens)                                                        \
+      substring_throughput(text, n, m, [](const char* f, const char* l, const char* pf, const char* pl) \
+        { return mystl::search(f, l, mystl::make_two_way_searcher(pf, pl)); }); \
+    std::cout << std::endl << "|    simd / " << std::setw(3) << alphabet << "       |"; \
+    for (auto m : lens)                                                        \
+      substring_throughput(text, n, m, [](const char* f, const char* l, const char* pf, const char* pl) \
+        { return mystl::search(f, l, mystl::make_simd_searcher(pf, pl)); });   \
+    std::cout << std::endl;                                                    \
+} while(0)
+
+// 子串查找的吞吐量，模式串长度为 4, 16, 64, 256，字符集大小为 4, 26, 256
+// 最后两行为在字符集大小为 4 的文本中用 search_n 查找连续 m 个 0，找不到时扫描整个文本
+void substring_search_test()
+{
+  const size_t n = LEN3;
+  const size_t lens[4] = { 4, 16, 64, 256 };
+  char* text = new char[n];
+  std::cout << "[------------- substring search : " << n << " bytes --------------]" << std::endl;
+  std::cout << "|  mode / alphabet    |";
+  std::cout << std::setw(WIDE) << "m = 4   |" << std::setw(WIDE) << "m = 16  |"
+    << std::setw(WIDE) << "m = 64  |" << std::setw(WIDE) << "m = 256  |" << std::endl;
+  SUBSTRING_SEARCH_TEST(4);
+  SUBSTRING_SEARCH_TEST(26);
+  SUBSTRING_SEARCH_TEST(256);
+  for (size_t i = 0; i < n; ++i)
+    text[i] = static_cast<char>(rand() % 4);
+  std::cout << "|   std search_n      |";
+  for (auto m : lens)
+    throughput_test(static_cast<size_t>(std::search_n(text, text + n, m, 0) - text) + m, [&]()
+                    { perf_sink = std::search_n(text, text + n, m, 0) - text; });
+  std::cout << std::endl << "|  mystl search_n     |";
+  for (auto m : lens)
+    throughput_test(static_cast<size_t>(std::search_n(text, text + n, m, 0) - text) + m, [&]()
+                    { perf_sink = mystl::search_n(text, text + n, m, 0) - text; });
+  std::cout << std::endl;
+  delete []text;
+}
+
+// 两个严格递增的 uint32_t 序列求交集，较长的序列有 LEN3 个元素，较短的序列的长度为其 1 / skew，
+// 每个格子为一次交集的平均耗时（微秒）
+template <class Intersect>
+void intersection_time(const mystl::vector<uint32_t>& a, const mystl::vector<uint32_t>& b,
+                       uint32_t* out, Intersect intersect)
+{
+  const size_t work = a.size() + b.size();
+  const size_t rounds = work >= LEN2 ? 3 : LEN2 / work * 3;
+  size_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; ++r)
+    sum += static_cast<size_t>(intersect(a.data(), a.data() + a.size(),
+                                         b.data(), b.data() + b.size(), out) - out);
+  auto end = std::chrono::steady_clock::now();
+  perf_sink = sum;
+  const double us = std::chrono::duration<double, std::micro>(end - start).count() / rounds;
+  char buf[20];
+  std::snprintf(buf, sizeof(buf), "%.1fus  |", us);
+  std::cout << std::setw(WIDE) << buf;
+}
+
+void set_intersection_skew_test()
+{
+  const size_t n = LEN3;
+  const size_t skews[5] = { 1, 10, 100, 1000, 10000 };
+  mystl::vector<uint32_t> large(n);
+  for (size_t i = 0; i < n; ++i)
+    large[i] = static_cast<uint32_t>(i * 2 + rand() % 2);
+  mystl::vector<mystl::vector<uint32_t>> smalls(5);
+  for (size_t c = 0; c < 5; ++c)
+  {
+    const size_t step = skews[c] * 2;
+    smalls[c].resize(n / skews[c]);
+    for (size_t j = 0; j < smalls[c].size(); ++j)
+      smalls[c][j] = static_cast<uint32_t>(j * step + rand() % step);
+  }
+  uint32_t* out = new uint32_t[n];
+  std::cout << "[-------------- set_intersection : " << n << " elements -------------]" << std::endl;
+  std::cout << "|        skew         |";
+  for (auto s : skews)
+  {
+    std::string t = "1:" + std::to_string(s) + "  |";
+    std::cout << std::setw(WIDE) << t;
+  }
+  std::cout << std::endl << "|         std         |";
+  for (auto& s : smalls)
+    intersection_time(large, s, out, [](const uint32_t* f1, const uint32_t* l1,
+                                        const uint32_t* f2, const uint32_t* l2, uint32_t* r)
+                      { return std::set_intersection(f1, l1, f2, l2, r); });
+  std::cout << std::endl << "|        mystl        |";
+  for (auto& s : smalls)
+    intersection_time(large, s, out, [](const uint32_t* f1, const uint32_t* l1,
+                                        const uint32_t* f2, const uint32_t* l2, uint32_t* r)
+                      { return mystl::set_intersection(f1, l1, f2, l2, r); });
+  std::cout << std::endl << "|   mystl adaptive    |";
+  for (auto& s : smalls)
+    intersection_time(large, s, out, [](const uint32_t* f1, const uint32_t* l1,
+                                        const uint32_t* f2, const uint32_t* l2, uint32_t* r)
+                      { return mystl::set_intersection_adaptive(f1, l1, f2, l2, r); });
+  std::cout << std::endl << "|     mystl simd      |";
+  for (auto& s : smalls)
+    intersection_time(large, s, out, [](const uint32_t* f1, const uint32_t* l1,
+                                        const uint32_t* f2, const uint32_t* l2, uint32_t* r)
+                      { return mystl::set_intersection_simd(f1, l1, f2, l2, r); });
+  std::cout << std::endl;
+  delete []out;
+}
+
+// 并行算法在 1..N 个线程下的扩展性
+void parallel_scaling_test()
+{
+  const size_t len = LEN3;
+  size_t max_threads = std::thread::hardware_concurrency();
+  if (max_threads == 0)
+    max_threads = 1;
+  std::cout << "[--------------- parallel scaling : " << len << " elements ------------]" << std::endl;
+  std::cout << "|       threads       |";
+  std::cout << std::setw(WIDE) << "sort   |" << std::setw(WIDE) << "stable_sort  |"
+    << std::setw(WIDE) << "transform   |" << std::setw(WIDE) << "reduce   |"
+    << std::setw(WIDE) << "scan   |" << std::endl;
+  for (size_t threads = 1; ; threads *= 2)
+  {
+    if (threads > max_threads)
+      threads = max_threads;
+    auto policy = mystl::execution::par(threads);
+    std::cout << "|" << std::setw(11) << threads << std::setw(11) << "|";
+    PAR_FUN_TEST(policy, sort, data, len, mystl::less<int>());
+    PAR_FUN_TEST(policy, stable_sort, data, len, mystl::less<int>());
+    PAR_FUN_TEST(policy, transform, data, len, data, [](int x) { return x / 3 + 1; });
+    PAR_FUN_TEST(policy, reduce, data, len, 0LL);
+    PAR_FUN_TEST(policy, inclusive_scan, data, len, data);
+    std::cout << std::endl;
+    if (threads == max_threads)
+      break;
+  }
+}
+
 void algorithm_performance_test()
 {
 
@@ -94,7 +906,19 @@ void algorithm_performance_test()
   std::cout << "[===============================================================]" << std::endl;
   std::cout << "[--------------- Run algorithm performance test ----------------]" << std::endl;
   sort_test();
+  radix_sort_test();
+  stable_sort_test();
+  top_k_test();
+  is_permutation_test();
   binary_search_test();
+  lower_bound_test();
+  upper_bound_test();
+  search_layout_test();
+  simd_throughput_test();
+  numeric_throughput_test();
+  substring_search_test();
+  set_intersection_skew_test();
+  parallel_scaling_test();
   std::cout << "[--------------- End algorithm performance test ----------------]" << std::endl;
   std::cout << "[===============================================================]" << std::endl;
 #endif // PERFORMANCE_TEST_ON
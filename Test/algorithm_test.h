@@ -1,13 +1,19 @@
-#ifndef MYTINYSTL_ALGORITHM_TEST_H_
+﻿#ifndef MYTINYSTL_ALGORITHM_TEST_H_
 #define MYTINYSTL_ALGORITHM_TEST_H_
 
-// 算法测试: 包含了 mystl 的 81 个算法测试
+// 算法测试: 包含了 mystl 的 98 个算法测试
 
 #include <algorithm>
+#include <cstdlib>
 #include <functional>
+#include <iterator>
 #include <numeric>
+#include <sstream>
+#include <string>
 
 #include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/searcher.h"
 #include "../MyTinySTL/vector.h"
 #include "test.h"
 
@@ -38,13 +44,24 @@ namespace algorithm_test
 int  for_each_sum = 0;
 
 int  gen() { return 5; }
-int  r(int i) { return (i * 5 + 1) % 9; }
+int  r(int i) { return (i * 5 + 1) % 9 % i; }
 bool is_odd(int i) { return i & 1; }
 bool is_even(int i) { return !(i & 1); }
 void arr_sum(int i) { for_each_sum += i; }
 bool cmp(const int& a, const int& b) { return b < a; }
 int  unary_op(const int& x) { return x + 1; }
 int  binary_op(const int& x, const int& y) { return x + y; }
+// 以 x / 1000000 为键值比较，低位记录元素的原始位置，用于检验排序的稳定性
+bool key_less(const int& a, const int& b) { return a / 1000000 < b / 1000000; }
+bool key_greater(const int& a, const int& b) { return a / 1000000 > b / 1000000; }
+// 仿射变换 x -> a * x + b，复合满足结合律但不满足交换律，用于检验并行扫描中各块的合并顺序
+struct affine
+{
+  unsigned a, b;
+};
+affine affine_compose(const affine& f, const affine& g) { return affine{ f.a * g.a, f.b * g.a + g.b }; }
+bool operator==(const affine& x, const affine& y) { return x.a == y.a && x.b == y.b; }
+bool operator!=(const affine& x, const affine& y) { return !(x == y); }
 
 // 以下为 80 个函数的简单测试
 
@@ -134,6 +151,14 @@ TEST(equal_test)
             mystl::equal(v1.begin(), v1.end(), arr1));
   EXPECT_EQ(std::equal(v1.begin(), v1.end(), arr2, std::equal_to<int>()),
             mystl::equal(v1.begin(), v1.end(), arr2, std::equal_to<int>()));
+  mystl::vector<int> v3(1000, 7), v4(1000, 7);
+  mystl::vector<float> v5(1000, 0.5f), v6(1000, 0.5f);
+  EXPECT_TRUE(mystl::equal(v3.begin(), v3.end(), v4.begin()));
+  EXPECT_TRUE(mystl::equal(v5.begin(), v5.end(), v6.begin()));
+  v4[999] = 8;
+  v6[500] = -0.5f;
+  EXPECT_FALSE(mystl::equal(v3.begin(), v3.end(), v4.begin()));
+  EXPECT_FALSE(mystl::equal(v5.begin(), v5.end(), v6.begin()));
 }
 
 TEST(fill_test)
@@ -232,6 +257,12 @@ TEST(mismatch_test)
   EXPECT_EQ(p3.second, p4.second);
   EXPECT_EQ(p5.first, p6.first);
   EXPECT_EQ(p5.second, p6.second);
+  mystl::vector<unsigned> v1(1000, 3), v2(1000, 3);
+  v2[600] = 4;
+  auto p7 = std::mismatch(v1.begin(), v1.end(), v2.begin());
+  auto p8 = mystl::mismatch(v1.begin(), v1.end(), v2.begin());
+  EXPECT_EQ(p7.first, p8.first);
+  EXPECT_EQ(p7.second, p8.second);
 }
 
 // numeric test
@@ -244,6 +275,11 @@ TEST(accumulate_test)
             mystl::accumulate(arr1, arr1 + 5, 5));
   EXPECT_EQ(std::accumulate(arr1, arr1 + 5, 0, std::minus<int>()),
             mystl::accumulate(arr1, arr1 + 5, 0, std::minus<int>()));
+  std::vector<long long> v1(1001);
+  for (int i = 0; i < 1001; ++i)
+    v1[i] = (i % 2 ? 1 : -1) * i * 1000000007ll;
+  EXPECT_EQ(std::accumulate(v1.begin(), v1.end(), 3ll),
+            mystl::accumulate(v1.data(), v1.data() + 1001, 3ll));
 }
 
 TEST(adjacent_difference_test)
@@ -257,6 +293,65 @@ TEST(adjacent_difference_test)
   std::adjacent_difference(arr2, arr2 + 5, exp, std::minus<int>());
   mystl::adjacent_difference(arr2, arr2 + 5, act, std::minus<int>());
   EXPECT_CON_EQ(exp, act);
+  std::vector<double> v1(1001), v2(1001);
+  for (int i = 0; i < 1001; ++i)
+    v1[i] = static_cast<double>(i * i) * 0.1;
+  std::adjacent_difference(v1.begin(), v1.end(), v2.begin());
+  mystl::adjacent_difference(v1.data(), v1.data() + 1001, v1.data());
+  EXPECT_CON_EQ(v1, v2);
+}
+
+TEST(exclusive_scan_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9 };
+  int exp1[9], act1[9];
+  int s = 10;
+  for (int i = 0; i < 9; ++i)
+  {
+    exp1[i] = s;
+    s += arr1[i];
+  }
+  EXPECT_EQ(act1 + 9, mystl::exclusive_scan(arr1, arr1 + 9, act1, 10));
+  EXPECT_CON_EQ(exp1, act1);
+  mystl::exclusive_scan(arr1, arr1 + 9, arr1, 10);
+  EXPECT_CON_EQ(exp1, arr1);
+  int arr2[] = { 1,2,3,4,5 };
+  int exp2[] = { 1,1,2,6,24 };
+  int act2[5];
+  mystl::exclusive_scan(arr2, arr2 + 5, act2, 1, std::multiplies<int>());
+  EXPECT_CON_EQ(exp2, act2);
+  std::vector<double> v1(1000), v2(1000), v3(1000);
+  for (int i = 0; i < 1000; ++i)
+    v1[i] = static_cast<double>(i % 17);
+  std::partial_sum(v1.begin(), v1.end() - 1, v2.begin() + 1);
+  mystl::exclusive_scan(v1.data(), v1.data() + 1000, v3.data(), 0.0);
+  EXPECT_CON_EQ(v2, v3);
+}
+
+TEST(inclusive_scan_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9 };
+  int exp1[9], act1[9];
+  std::partial_sum(arr1, arr1 + 9, exp1);
+  EXPECT_EQ(act1 + 9, mystl::inclusive_scan(arr1, arr1 + 9, act1));
+  EXPECT_CON_EQ(exp1, act1);
+  std::partial_sum(arr1, arr1 + 9, exp1, std::multiplies<int>());
+  mystl::inclusive_scan(arr1, arr1 + 9, act1, std::multiplies<int>());
+  EXPECT_CON_EQ(exp1, act1);
+  for (int i = 0; i < 9; ++i)
+    exp1[i] = (i + 1) * (i + 2) / 2 + 100;
+  mystl::inclusive_scan(arr1, arr1 + 9, act1, mystl::plus<int>(), 100);
+  EXPECT_CON_EQ(exp1, act1);
+  mystl::list<int> l1(arr1, arr1 + 9);
+  mystl::list<int> l2(9);
+  mystl::inclusive_scan(l1.begin(), l1.end(), l2.begin(), mystl::plus<int>(), 100);
+  EXPECT_CON_EQ(l2, exp1);
+  std::vector<float> v1(1001), v2(1001);
+  for (int i = 0; i < 1001; ++i)
+    v1[i] = static_cast<float>(i % 5);
+  std::partial_sum(v1.begin(), v1.end(), v2.begin());
+  mystl::inclusive_scan(v1.data(), v1.data() + 1001, v1.data());
+  EXPECT_CON_EQ(v1, v2);
 }
 
 TEST(inner_product_test)
@@ -268,6 +363,14 @@ TEST(inner_product_test)
             mystl::inner_product(arr1, arr1 + 5, arr3, 0));
   EXPECT_EQ(std::inner_product(arr2, arr2 + 5, arr3, 0, std::minus<int>(), std::multiplies<int>()),
             mystl::inner_product(arr2, arr2 + 5, arr3, 0, std::minus<int>(), std::multiplies<int>()));
+  std::vector<unsigned> v1(1001), v2(1001);
+  for (int i = 0; i < 1001; ++i)
+  {
+    v1[i] = static_cast<unsigned>(i) * 2654435761u;
+    v2[i] = static_cast<unsigned>(i) * 40503u + 1u;
+  }
+  EXPECT_EQ(std::inner_product(v1.begin(), v1.end(), v2.begin(), 1u),
+            mystl::inner_product(v1.data(), v1.data() + 1001, v2.data(), 1u));
 }
 
 TEST(iota_test)
@@ -296,6 +399,64 @@ TEST(partial_sum_test)
   std::partial_sum(arr1, arr1 + 9, exp2, std::multiplies<int>());
   mystl::partial_sum(arr1, arr1 + 9, act2, std::multiplies<int>());
   EXPECT_CON_EQ(exp2, act2);
+  std::vector<int> v1(1001), v2(1001);
+  for (int i = 0; i < 1001; ++i)
+    v1[i] = i % 11 - 5;
+  std::partial_sum(v1.begin(), v1.end(), v2.begin());
+  mystl::partial_sum(v1.data(), v1.data() + 1001, v1.data());
+  EXPECT_CON_EQ(v1, v2);
+}
+
+TEST(reduce_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17 };
+  EXPECT_EQ(std::accumulate(arr1, arr1 + 17, 0), mystl::reduce(arr1, arr1 + 17));
+  EXPECT_EQ(std::accumulate(arr1, arr1 + 17, 5), mystl::reduce(arr1, arr1 + 17, 5));
+  EXPECT_EQ(std::accumulate(arr1, arr1 + 5, 1, std::multiplies<int>()),
+            mystl::reduce(arr1, arr1 + 5, 1, std::multiplies<int>()));
+  mystl::list<int> l1(arr1, arr1 + 17);
+  EXPECT_EQ(std::accumulate(arr1, arr1 + 17, 5), mystl::reduce(l1.begin(), l1.end(), 5));
+  std::vector<unsigned> v1(1003);
+  std::vector<double> v2(1003);
+  for (int i = 0; i < 1003; ++i)
+  {
+    v1[i] = static_cast<unsigned>(i) * 2654435761u;
+    v2[i] = static_cast<double>(i % 13) * 0.5;
+  }
+  EXPECT_EQ(std::accumulate(v1.begin(), v1.end(), 7u), mystl::reduce(v1.data(), v1.data() + 1003, 7u));
+  EXPECT_EQ(std::accumulate(v2.begin(), v2.end(), 0.0), mystl::reduce(v2.data(), v2.data() + 1003));
+  EXPECT_EQ(std::accumulate(v2.begin(), v2.end(), 0.0, [](double a, double b) { return a + b; }),
+            mystl::reduce(v2.data(), v2.data() + 1003, 0.0, [](double a, double b) { return a + b; }));
+}
+
+TEST(transform_reduce_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9,10,11 };
+  int arr2[] = { 2,2,2,2,2,2,2,2,2,2,2 };
+  EXPECT_EQ(std::inner_product(arr1, arr1 + 11, arr2, 3),
+            mystl::transform_reduce(arr1, arr1 + 11, arr2, 3));
+  EXPECT_EQ(std::inner_product(arr1, arr1 + 11, arr2, 0, std::plus<int>(), std::minus<int>()),
+            mystl::transform_reduce(arr1, arr1 + 11, arr2, 0, std::plus<int>(), std::minus<int>()));
+  EXPECT_EQ(506, mystl::transform_reduce(arr1, arr1 + 11, 0, std::plus<int>(),
+                                         [](int x) { return x * x; }));
+  mystl::list<int> l1(arr1, arr1 + 11);
+  EXPECT_EQ(std::inner_product(arr1, arr1 + 11, arr2, 3),
+            mystl::transform_reduce(l1.begin(), l1.end(), arr2, 3));
+  EXPECT_EQ(506, mystl::transform_reduce(l1.begin(), l1.end(), 0, std::plus<int>(),
+                                         [](int x) { return x * x; }));
+  std::vector<long long> v1(1001), v2(1001);
+  std::vector<float> v3(1001), v4(1001);
+  for (int i = 0; i < 1001; ++i)
+  {
+    v1[i] = i * 1000003ll;
+    v2[i] = i % 7 - 3;
+    v3[i] = static_cast<float>(i % 4);
+    v4[i] = static_cast<float>(i % 3) * 0.25f;
+  }
+  EXPECT_EQ(std::inner_product(v1.begin(), v1.end(), v2.begin(), 1ll),
+            mystl::transform_reduce(v1.data(), v1.data() + 1001, v2.data(), 1ll));
+  EXPECT_EQ(std::inner_product(v3.begin(), v3.end(), v4.begin(), 0.0f),
+            mystl::transform_reduce(v3.data(), v3.data() + 1001, v4.data(), 0.0f));
 }
 
 // algo test
@@ -349,6 +510,20 @@ TEST(count_test)
             mystl::count(arr1, arr1 + 9, 3));
   EXPECT_EQ(std::count(arr1, arr1 + 9, 6),
             mystl::count(arr1, arr1 + 9, 6));
+  // 较长的连续区间会使用向量化的版本
+  mystl::vector<char> v1;
+  mystl::vector<long long> v2;
+  mystl::vector<double> v3;
+  for (int i = 0; i < 1000; ++i)
+  {
+    v1.push_back(static_cast<char>(rand() % 4));
+    v2.push_back(rand() % 4 - 2);
+    v3.push_back(rand() % 4 * 0.5);
+  }
+  EXPECT_EQ(std::count(v1.begin(), v1.end(), 3), mystl::count(v1.begin(), v1.end(), 3));
+  EXPECT_EQ(std::count(v1.begin(), v1.end(), 259), mystl::count(v1.begin(), v1.end(), 259));
+  EXPECT_EQ(std::count(v2.begin(), v2.end(), -1), mystl::count(v2.begin(), v2.end(), -1));
+  EXPECT_EQ(std::count(v3.begin(), v3.end(), 1.0), mystl::count(v3.begin(), v3.end(), 1.0));
 }
 
 TEST(count_if_test)
@@ -378,6 +553,17 @@ TEST(find_test)
   int arr1[] = { 1,2,3,4,5 };
   EXPECT_EQ(std::find(arr1, arr1 + 5, 3), mystl::find(arr1, arr1 + 5, 3));
   EXPECT_EQ(std::find(arr1, arr1 + 5, 6), mystl::find(arr1, arr1 + 5, 6));
+  mystl::vector<char> v1(1000, 'a');
+  mystl::vector<short> v2(1000, 1);
+  mystl::vector<double> v3(1000, 1.0);
+  v1[777] = 'b';
+  v2[333] = 2;
+  v3[555] = 2.0;
+  EXPECT_EQ(std::find(v1.begin(), v1.end(), 'b'), mystl::find(v1.begin(), v1.end(), 'b'));
+  EXPECT_EQ(std::find(v1.begin(), v1.end(), 'c'), mystl::find(v1.begin(), v1.end(), 'c'));
+  EXPECT_EQ(std::find(v2.begin(), v2.end(), 2), mystl::find(v2.begin(), v2.end(), 2));
+  EXPECT_EQ(std::find(v2.begin(), v2.end(), 65538), mystl::find(v2.begin(), v2.end(), 65538));
+  EXPECT_EQ(std::find(v3.begin(), v3.end(), 2.0), mystl::find(v3.begin(), v3.end(), 2.0));
 }
 
 TEST(find_end_test)
@@ -521,6 +707,40 @@ TEST(lower_bound_test)
             mystl::lower_bound(arr1, arr1 + 7, 3));
   EXPECT_EQ(std::lower_bound(arr1, arr1 + 7, 5, std::less<int>()),
             mystl::lower_bound(arr1, arr1 + 7, 5, std::less<int>()));
+  EXPECT_EQ(std::lower_bound(arr1, arr1 + 7, 3),
+            mystl::lower_bound_branchy(arr1, arr1 + 7, 3));
+  EXPECT_EQ(std::lower_bound(arr1, arr1 + 7, 6, std::less<int>()),
+            mystl::lower_bound_branchy(arr1, arr1 + 7, 6, std::less<int>()));
+}
+
+TEST(lower_bound_batch_test)
+{
+  int arr1[] = { 1,2,3,3,3,4,5 };
+  int query[] = { 0,1,3,4,6,2,5,3,0,1,3,4,6,2,5,3,4,1 };
+  int* exp[18];
+  int* act[18];
+  for (size_t i = 0; i < 18; ++i)
+    exp[i] = std::lower_bound(arr1, arr1 + 7, query[i]);
+  EXPECT_EQ(act + 18, mystl::lower_bound_batch(arr1, arr1 + 7, query, query + 18, act));
+  EXPECT_CON_EQ(exp, act);
+  for (size_t i = 0; i < 18; ++i)
+    exp[i] = std::lower_bound(arr1, arr1 + 7, query[i], std::less<int>());
+  mystl::lower_bound_batch(arr1, arr1 + 7, query, query + 18, act, std::less<int>());
+  EXPECT_CON_EQ(exp, act);
+  mystl::lower_bound_batch(arr1, arr1, query, query + 18, act);
+  EXPECT_EQ(arr1, act[17]);
+  mystl::vector<int> v1;
+  mystl::vector<int> v2;
+  for (int i = 0; i < 1000; ++i)
+    v1.push_back(i / 3);
+  for (int i = -1; i < 340; ++i)
+    v2.push_back(i);
+  mystl::vector<mystl::vector<int>::iterator> v3(v2.size());
+  mystl::lower_bound_batch(v1.begin(), v1.end(), v2.begin(), v2.end(), v3.begin());
+  bool same = true;
+  for (size_t i = 0; i < v2.size(); ++i)
+    same = same && v3[i] == std::lower_bound(v1.begin(), v1.end(), v2[i]);
+  EXPECT_TRUE(same);
 }
 
 TEST(max_elememt_test)
@@ -580,6 +800,55 @@ TEST(is_permutation_test)
             mystl::is_permutation(arr1, arr1 + 5, arr2, arr2 + 5, std::equal_to<int>()));
   EXPECT_EQ(std::is_permutation(arr1, arr1 + 5, arr3, std::equal_to<int>()),
             mystl::is_permutation(arr1, arr1 + 5, arr3, arr3 + 5, std::equal_to<int>()));
+  EXPECT_FALSE(mystl::is_permutation(arr1, arr1 + 5, arr2, arr2 + 4));
+
+  // 较长的区间：哈希计数与排序后比较
+  const int n = 20000;
+  mystl::vector<int> v1, v2;
+  for (int i = 0; i < n; ++i)
+    v1.push_back(i << 16);  // 低位全部相同
+  v2 = v1;
+  std::random_shuffle(v2.begin(), v2.end());
+  EXPECT_TRUE(mystl::is_permutation(v1.begin(), v1.end(), v2.begin(), v2.end()));
+  v2[n / 2] = 1;
+  EXPECT_FALSE(mystl::is_permutation(v1.begin(), v1.end(), v2.begin(), v2.end()));
+  // 元素相同但出现次数不同
+  v1.assign(n, 7);
+  v2.assign(n, 7);
+  v1[0] = 8;
+  v1[1] = 8;
+  v2[n - 1] = 8;
+  v2[n - 2] = 9;
+  EXPECT_FALSE(mystl::is_permutation(v1.begin(), v1.end(), v2.begin(), v2.end()));
+  v2[n - 2] = 8;
+  EXPECT_TRUE(mystl::is_permutation(v1.begin(), v1.end(), v2.begin(), v2.end()));
+  mystl::vector<mystl::pair<int, int>> p1, p2;
+  for (int i = 0; i < n; ++i)
+    p1.push_back(mystl::make_pair(i % 100, i / 100));
+  p2 = p1;
+  std::random_shuffle(p2.begin(), p2.end());
+  EXPECT_TRUE(mystl::is_permutation(p1.begin(), p1.end(), p2.begin(), p2.end()));
+  p2[0].second = -1;
+  EXPECT_FALSE(mystl::is_permutation(p1.begin(), p1.end(), p2.begin(), p2.end()));
+  // second 不支持 operator< 的 pair 既不能哈希也不能排序，只能逐个计数
+  mystl::vector<mystl::pair<int, affine>> a1, a2;
+  for (int i = 0; i < 100; ++i)
+  {
+    a1.push_back(mystl::make_pair(i % 10, affine{ 1, static_cast<unsigned>(i) }));
+    a2.push_back(mystl::make_pair((99 - i) % 10, affine{ 1, static_cast<unsigned>(99 - i) }));
+  }
+  EXPECT_TRUE(mystl::is_permutation(a1.begin(), a1.end(), a2.begin(), a2.end()));
+  a2[0].second.a = 2;
+  EXPECT_FALSE(mystl::is_permutation(a1.begin(), a1.end(), a2.begin(), a2.end()));
+  mystl::list<int> l1, l2;
+  for (int i = 0; i < 1000; ++i)
+  {
+    l1.push_back(i % 37);
+    l2.push_front(i % 37);
+  }
+  EXPECT_TRUE(mystl::is_permutation(l1.begin(), l1.end(), l2.begin(), l2.end()));
+  l2.push_back(1);
+  EXPECT_FALSE(mystl::is_permutation(l1.begin(), l1.end(), l2.begin(), l2.end()));
 }
 
 TEST(next_permutation_test)
@@ -655,6 +924,159 @@ TEST(nth_element_test)
   EXPECT_TRUE(arr3_right_greater);
   EXPECT_TRUE(arr4_left_less);
   EXPECT_TRUE(arr4_right_greater);
+  // 较大的区间，包括大量重复元素以及使三点中值分割恶化的序列
+  mystl::vector<int> v1;
+  for (int i = 0; i < 100000; ++i)
+    v1.push_back(rand() % 100);
+  for (int i = 0; i < 50000; ++i)
+    v1.push_back(i % 2 ? 50000 + i : i + 1);
+  for (int i = 0; i < 50000; ++i)
+    v1.push_back(2 * i + 2);
+  mystl::vector<int> v2(v1);
+  std::sort(v2.begin(), v2.end());
+  const size_t nths[] = { 0, 1000, 100000, 150000, 199999 };
+  bool nth_right = true;
+  for (auto k : nths)
+  {
+    mystl::vector<int> v3(v1);
+    mystl::nth_element(v3.begin(), v3.begin() + k, v3.end());
+    nth_right = nth_right && v3[k] == v2[k] &&
+      *std::max_element(v3.begin(), v3.begin() + k + 1) == v3[k] &&
+      *std::min_element(v3.begin() + k, v3.end()) == v3[k];
+  }
+  EXPECT_TRUE(nth_right);
+  mystl::vector<int> v4(v1);
+  mystl::mom_select(v4.begin(), v4.begin() + 12345, v4.end(), mystl::less<int>());
+  EXPECT_EQ(v2[12345], v4[12345]);
+}
+
+TEST(parallel_policy_test)
+{
+  const size_t n = 100000;
+  mystl::vector<int> v1, v2;
+  for (size_t i = 0; i < n; ++i)
+    v1.push_back(rand() % 1000);
+  auto policy = mystl::execution::par(4);
+
+  v2 = v1;
+  std::sort(v1.begin(), v1.end());
+  mystl::sort(policy, v2.begin(), v2.end());
+  EXPECT_CON_EQ(v1, v2);
+  std::random_shuffle(v1.begin(), v1.end());
+  v2 = v1;
+  std::sort(v1.begin(), v1.end(), std::greater<int>());
+  mystl::sort(mystl::execution::par_unseq(3), v2.begin(), v2.end(), std::greater<int>());
+  EXPECT_CON_EQ(v1, v2);
+
+  EXPECT_EQ(std::count_if(v1.begin(), v1.end(), is_odd),
+            mystl::count_if(policy, v1.begin(), v1.end(), is_odd));
+  EXPECT_EQ(std::accumulate(v1.begin(), v1.end(), 0LL),
+            mystl::accumulate(policy, v1.begin(), v1.end(), 0LL));
+  EXPECT_EQ(std::accumulate(v1.begin(), v1.end(), 0LL),
+            mystl::reduce(mystl::execution::seq, v1.begin(), v1.end(), 0LL));
+  EXPECT_EQ(std::find_if(v1.begin(), v1.end(), is_odd),
+            mystl::find_if(policy, v1.begin(), v1.end(), is_odd));
+  EXPECT_EQ(v1.end(), mystl::find_if(policy, v1.begin(), v1.end(),
+                                     [](int x) { return x < 0; }));
+
+  mystl::vector<int> v3(n), v4(n);
+  mystl::copy(policy, v1.begin(), v1.end(), v3.begin());
+  EXPECT_CON_EQ(v1, v3);
+  std::transform(v1.begin(), v1.end(), v3.begin(), unary_op);
+  mystl::transform(policy, v1.begin(), v1.end(), v4.begin(), unary_op);
+  EXPECT_CON_EQ(v3, v4);
+  std::transform(v1.begin(), v1.end(), v3.begin(), v3.begin(), binary_op);
+  mystl::transform(policy, v1.begin(), v1.end(), v4.begin(), v4.begin(), binary_op);
+  EXPECT_CON_EQ(v3, v4);
+  std::partial_sum(v1.begin(), v1.end(), v3.begin());
+  mystl::partial_sum(policy, v1.begin(), v1.end(), v4.begin());
+  EXPECT_CON_EQ(v3, v4);
+  mystl::fill(policy, v4.begin(), v4.end(), 7);
+  EXPECT_EQ(n, static_cast<size_t>(std::count(v4.begin(), v4.end(), 7)));
+  for_each_sum = 0;
+  mystl::for_each(mystl::execution::seq, v1.begin(), v1.begin() + 10, arr_sum);
+  EXPECT_EQ(std::accumulate(v1.begin(), v1.begin() + 10, 0), for_each_sum);
+  mystl::for_each(policy, v4.begin(), v4.end(), [](int& x) { x *= 2; });
+  EXPECT_EQ(n, static_cast<size_t>(std::count(v4.begin(), v4.end(), 14)));
+}
+
+TEST(parallel_scan_test)
+{
+  const size_t n = 100003;
+  mystl::vector<int> v1(n), v2(n), v3(n);
+  for (size_t i = 0; i < n; ++i)
+    v1[i] = rand() % 1000 - 500;
+  std::partial_sum(v1.begin(), v1.end(), v2.begin());
+  for (size_t threads = 1; threads <= 8; threads *= 2)
+  {
+    auto policy = mystl::execution::par(threads);
+    EXPECT_EQ(v3.end(), mystl::inclusive_scan(policy, v1.begin(), v1.end(), v3.begin()));
+    EXPECT_CON_EQ(v2, v3);
+    mystl::vector<int> v4(v1);
+    mystl::exclusive_scan(policy, v4.begin(), v4.end(), v4.begin(), 7);
+    EXPECT_EQ(7, v4[0]);
+    EXPECT_TRUE(mystl::equal(v2.begin(), v2.end() - 1, v4.begin() + 1,
+                             [](int x, int y) { return x + 7 == y; }));
+    mystl::inclusive_scan(policy, v1.begin(), v1.end(), v3.begin(), mystl::plus<int>(), 7);
+    EXPECT_EQ(v2[n - 1] + 7, v3[n - 1]);
+    v4 = v1;
+    mystl::partial_sum(policy, v4.begin(), v4.end(), v4.begin());
+    EXPECT_CON_EQ(v2, v4);
+  }
+  // 不满足交换律的二元操作，检验各块按顺序合并
+  mystl::vector<affine> f1(n), f2(n), f3(n);
+  for (size_t i = 0; i < n; ++i)
+    f1[i] = affine{ static_cast<unsigned>(rand()) | 1u, static_cast<unsigned>(rand()) };
+  mystl::partial_sum(f1.begin(), f1.end(), f2.begin(), affine_compose);
+  mystl::inclusive_scan(mystl::execution::par(4), f1.begin(), f1.end(), f3.begin(), affine_compose);
+  EXPECT_TRUE(mystl::equal(f2.begin(), f2.end(), f3.begin()));
+  const affine id{ 1u, 0u };
+  mystl::exclusive_scan(mystl::execution::par(3), f1.begin(), f1.end(), f3.begin(), id,
+                        affine_compose);
+  EXPECT_TRUE(f3[0] == id);
+  EXPECT_TRUE(mystl::equal(f2.begin(), f2.end() - 1, f3.begin() + 1));
+  // 字符串的加法满足结合律但不满足交换律，元素个数足以分成多块
+  mystl::vector<std::string> s1(8200), s2(8200), s3(8200);
+  for (size_t i = 0; i < s1.size(); ++i)
+    s1[i] = std::string(1, static_cast<char>('a' + rand() % 26));
+  mystl::partial_sum(s1.begin(), s1.end(), s2.begin());
+  mystl::inclusive_scan(mystl::execution::par(4), s1.begin(), s1.end(), s3.begin());
+  EXPECT_TRUE(mystl::equal(s2.begin(), s2.end(), s3.begin()));
+  mystl::exclusive_scan(mystl::execution::par(4), s1.begin(), s1.end(), s3.begin(), std::string(">"));
+  EXPECT_EQ(std::string(">"), s3[0]);
+  EXPECT_TRUE(mystl::equal(s2.begin(), s2.end() - 1, s3.begin() + 1,
+                           [](const std::string& x, const std::string& y) { return ">" + x == y; }));
+  EXPECT_TRUE(s2.back() == mystl::reduce(mystl::execution::par(4), s1.begin(), s1.end(), std::string()));
+  mystl::list<int> l1(v1.begin(), v1.begin() + 100);
+  mystl::vector<int> v5(100);
+  mystl::inclusive_scan(mystl::execution::par, l1.begin(), l1.end(), v5.begin());
+  EXPECT_TRUE(mystl::equal(v5.begin(), v5.end(), v2.begin()));
+}
+
+TEST(partial_sort_test)
+{
+  int arr1[] = { 9,8,7,6,5,4,3,2,1 };
+  int exp1[] = { 1,2,3,4 };
+  mystl::partial_sort(arr1, arr1 + 4, arr1 + 9);
+  EXPECT_TRUE(std::equal(exp1, exp1 + 4, arr1));
+  int arr2[] = { 3,1,4,1,5,9,2,6,5,3 };
+  int exp2[] = { 9,6,5,5,4,3,3,2,1,1 };
+  mystl::partial_sort(arr2, arr2 + 10, arr2 + 10, std::greater<int>());
+  EXPECT_CON_EQ(exp2, arr2);
+  mystl::vector<int> v1;
+  for (int i = 0; i < 100000; ++i)
+    v1.push_back(rand());
+  mystl::vector<int> v2(v1);
+  std::sort(v2.begin(), v2.end());
+  const size_t ks[] = { 0, 10, 1000, 50000, 100000 };
+  bool same = true;
+  for (auto k : ks)
+  {
+    mystl::vector<int> v3(v1);
+    mystl::partial_sort(v3.begin(), v3.begin() + k, v3.end());
+    same = same && std::equal(v3.begin(), v3.begin() + k, v2.begin());
+  }
+  EXPECT_TRUE(same);
 }
 
 TEST(partition_test)
@@ -688,6 +1110,50 @@ TEST(prev_permutation_test)
   EXPECT_CON_EQ(arr1, arr2);
 }
 
+TEST(radix_sort_test)
+{
+  int arr1[] = { 6,-1,2,5,-4,8,3,2,4,-6,10,2,1,9 };
+  int arr2[] = { 6,-1,2,5,-4,8,3,2,4,-6,10,2,1,9 };
+  std::sort(arr1, arr1 + 14);
+  mystl::radix_sort(arr2, arr2 + 14);
+  EXPECT_CON_EQ(arr1, arr2);
+
+  mystl::vector<int> v1, v2;
+  mystl::vector<uint64_t> v3, v4;
+  mystl::vector<double> v5, v6;
+  for (int i = 0; i < 1000; ++i)
+  {
+    v1.push_back(rand() - RAND_MAX / 2);
+    v3.push_back((static_cast<uint64_t>(rand()) << 33) ^ rand());
+    v5.push_back((rand() - RAND_MAX / 2) / 7.0);
+  }
+  v2 = v1;
+  v4 = v3;
+  v6 = v5;
+  std::sort(v1.begin(), v1.end());
+  mystl::radix_sort(v2.begin(), v2.end());
+  std::sort(v3.begin(), v3.end());
+  mystl::radix_sort(v4.begin(), v4.end());
+  std::sort(v5.begin(), v5.end());
+  mystl::radix_sort(v6.begin(), v6.end());
+  EXPECT_CON_EQ(v1, v2);
+  EXPECT_CON_EQ(v3, v4);
+  EXPECT_CON_EQ(v5, v6);
+
+  // 按键值排序，键值相同的元素保持原有的相对次序
+  mystl::vector<int> keys, idx1, idx2;
+  for (int i = 0; i < 1000; ++i)
+  {
+    keys.push_back(rand() % 100);
+    idx1.push_back(i);
+  }
+  idx2 = idx1;
+  std::stable_sort(idx1.begin(), idx1.end(),
+                   [&keys](int a, int b) { return keys[a] < keys[b]; });
+  mystl::radix_sort(idx2.begin(), idx2.end(), [&keys](int i) { return keys[i]; });
+  EXPECT_CON_EQ(idx1, idx2);
+}
+
 TEST(random_shuffle_test)
 {
   int arr1[] = { 1,2,3,4,5,6,7,8,9 };
@@ -857,6 +1323,64 @@ TEST(rotate_copy_test)
   EXPECT_CON_EQ(exp, act);
 }
 
+// 只能遍历一次的输入迭代器，包装从 std::istream 中读取 int 的 std::istream_iterator
+struct istream_input_iterator :public mystl::iterator<mystl::input_iterator_tag, int>
+{
+  std::istream_iterator<int> it;
+
+  istream_input_iterator() = default;
+  explicit istream_input_iterator(std::istream& in) :it(in) {}
+
+  int operator*() const { return *it; }
+  istream_input_iterator& operator++() { ++it; return *this; }
+  bool operator==(const istream_input_iterator& rhs) const { return it == rhs.it; }
+  bool operator!=(const istream_input_iterator& rhs) const { return it != rhs.it; }
+};
+
+TEST(sample_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9 };
+  int arr2[9] = { 0 };
+  mystl::pcg32 g(2024);
+  // 前向迭代器：输出保持原来的相对顺序
+  EXPECT_EQ(arr2 + 4, mystl::sample(arr1, arr1 + 9, arr2, 4, g));
+  EXPECT_TRUE(std::is_sorted(arr2, arr2 + 4));
+  EXPECT_TRUE(std::includes(arr1, arr1 + 9, arr2, arr2 + 4));
+  EXPECT_EQ(arr2 + 9, mystl::sample(arr1, arr1 + 9, arr2, 20, g));
+  EXPECT_CON_EQ(arr1, arr2);
+  EXPECT_EQ(arr2, mystl::sample(arr1, arr1 + 9, arr2, 0, g));
+  mystl::list<int> l1(arr1, arr1 + 9);
+  EXPECT_EQ(arr2 + 3, mystl::sample(l1.begin(), l1.end(), arr2, 3, g));
+  EXPECT_TRUE(std::is_sorted(arr2, arr2 + 3));
+  // 输入迭代器：蓄水池抽样
+  std::istringstream in1("1 2 3 4 5 6 7 8 9");
+  EXPECT_EQ(arr2 + 4, mystl::sample(istream_input_iterator(in1), istream_input_iterator(), arr2, 4, g));
+  std::sort(arr2, arr2 + 4);
+  EXPECT_TRUE(std::adjacent_find(arr2, arr2 + 4) == arr2 + 4);
+  EXPECT_TRUE(std::includes(arr1, arr1 + 9, arr2, arr2 + 4));
+  std::istringstream in2("1 2 3 4 5 6 7 8 9");
+  EXPECT_EQ(arr2 + 9, mystl::sample(istream_input_iterator(in2), istream_input_iterator(), arr2, 9, g));
+  EXPECT_CON_EQ(arr1, arr2);
+  std::istringstream in3("1 2 3 4 5 6 7 8 9");
+  EXPECT_EQ(arr2 + 9, mystl::sample(istream_input_iterator(in3), istream_input_iterator(), arr2, 20, g));
+  EXPECT_CON_EQ(arr1, arr2);
+
+  // 每个元素被选中的次数应接近 rounds / 3
+  const int rounds = 90000;
+  int count[10] = { 0 };
+  int out[3];
+  for (int i = 0; i < rounds; ++i)
+  {
+    mystl::sample(arr1, arr1 + 9, out, 3, g);
+    for (auto x : out)
+      ++count[x];
+  }
+  bool uniform = true;
+  for (int i = 1; i <= 9; ++i)
+    uniform = uniform && std::abs(count[i] - rounds / 3) < rounds / 100;
+  EXPECT_TRUE(uniform);
+}
+
 TEST(search_test)
 {
   int arr1[] = { 1,2,3,3,3,4,5,6,6, };
@@ -871,6 +1395,24 @@ TEST(search_test)
             mystl::search(arr1, arr1 + 9, arr4, arr4 + 3, std::less<int>()));
   EXPECT_EQ(std::search(arr1, arr1 + 9, arr4, arr4 + 4, std::less<int>()),
             mystl::search(arr1, arr1 + 9, arr4, arr4 + 4, std::less<int>()));
+  // 单字节的连续区间，分别走 memchr、SIMD 筛选与双向查找
+  mystl::vector<char> v1;
+  for (int i = 0; i < 5000; ++i)
+    v1.push_back(static_cast<char>('a' + rand() % 3));
+  const char* s1 = "abcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabc";
+  v1.insert(v1.end(), s1, s1 + 72);
+  const size_t lens[] = { 0, 1, 2, 5, 17, 64, 65, 72 };
+  bool same = true;
+  for (auto m : lens)
+  {
+    same = same && std::search(v1.begin(), v1.end(), s1 + 72 - m, s1 + 72) ==
+      mystl::search(v1.begin(), v1.end(), s1 + 72 - m, s1 + 72);
+    same = same && std::search(v1.begin(), v1.end(), v1.end() - m, v1.end()) ==
+      mystl::search(v1.begin(), v1.end(), v1.end() - m, v1.end());
+  }
+  EXPECT_TRUE(same);
+  mystl::list<int> l1(arr1, arr1 + 9);
+  EXPECT_EQ(2, mystl::distance(l1.begin(), mystl::search(l1.begin(), l1.end(), arr3, arr3 + 2)));
 }
 
 TEST(search_n_test)
@@ -886,6 +1428,193 @@ TEST(search_n_test)
             mystl::search_n(arr1, arr1 + 9, 3, 6, std::less<int>()));
   EXPECT_EQ(std::search_n(arr1, arr1 + 9, 2, 10, std::less<int>()),
             mystl::search_n(arr1, arr1 + 9, 2, 10, std::less<int>()));
+  int arr2[] = { 1,1,2,1,1,1,2,2,1,1,1,1,1,2 };
+  EXPECT_EQ(std::search_n(arr2, arr2 + 14, 4, 1),
+            mystl::search_n(arr2, arr2 + 14, 4, 1));
+  EXPECT_EQ(std::search_n(arr2, arr2 + 14, 6, 1),
+            mystl::search_n(arr2, arr2 + 14, 6, 1));
+  EXPECT_EQ(std::search_n(arr2, arr2 + 14, 2, 2, std::equal_to<int>()),
+            mystl::search_n(arr2, arr2 + 14, 2, 2, std::equal_to<int>()));
+  mystl::list<int> l1(arr2, arr2 + 14);
+  EXPECT_EQ(8, mystl::distance(l1.begin(), mystl::search_n(l1.begin(), l1.end(), 5, 1)));
+}
+
+TEST(searcher_test)
+{
+  const char* s1 = "here is a simple example of the bad character rule, a simple example";
+  const char* s2 = "example";
+  const char* s3 = "examples";
+  const size_t n1 = std::strlen(s1);
+  auto bmh = mystl::make_boyer_moore_horspool_searcher(s2, s2 + 7);
+  auto tw = mystl::make_two_way_searcher(s2, s2 + 7);
+  auto simd = mystl::make_simd_searcher(s2, s2 + 7);
+  EXPECT_EQ(s1 + 17, mystl::search(s1, s1 + n1, bmh));
+  EXPECT_EQ(s1 + 17, mystl::search(s1, s1 + n1, tw));
+  EXPECT_EQ(s1 + 17, mystl::search(s1, s1 + n1, simd));
+  EXPECT_EQ(s1 + 24, simd(s1, s1 + n1).second);
+  EXPECT_EQ(s1 + n1, mystl::search(s1, s1 + n1, mystl::make_boyer_moore_horspool_searcher(s3, s3 + 8)));
+  EXPECT_EQ(s1 + n1, mystl::search(s1, s1 + n1, mystl::make_two_way_searcher(s3, s3 + 8)));
+  EXPECT_EQ(s1 + n1, mystl::search(s1, s1 + n1, mystl::make_simd_searcher(s3, s3 + 8)));
+  EXPECT_EQ(s1, mystl::search(s1, s1 + n1, mystl::make_two_way_searcher(s3, s3)));
+  // 非单字节元素与周期性的模式串
+  mystl::vector<int> v1;
+  for (int i = 0; i < 3000; ++i)
+    v1.push_back(i % 7 == 0 ? 1 : 0);
+  int arr1[] = { 1,0,0,0,0,0,0,1,0,0,0,0,0,0,1 };
+  int arr2[] = { 1,0,0,0,0,0,0,1,0,0,0,0,0,1 };
+  EXPECT_EQ(v1.begin(), mystl::search(v1.begin(), v1.end(),
+                                      mystl::make_boyer_moore_horspool_searcher(arr1, arr1 + 15)));
+  EXPECT_EQ(v1.begin(), mystl::search(v1.begin(), v1.end(),
+                                      mystl::make_two_way_searcher(arr1, arr1 + 15)));
+  EXPECT_EQ(v1.end(), mystl::search(v1.begin(), v1.end(),
+                                    mystl::make_boyer_moore_horspool_searcher(arr2, arr2 + 14)));
+  EXPECT_EQ(v1.end(), mystl::search(v1.begin(), v1.end(),
+                                    mystl::make_two_way_searcher(arr2, arr2 + 14)));
+}
+
+TEST(set_difference_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9 };
+  int arr2[] = { 1,2,3,4,5,6 };
+  int arr3[] = { 1,2,3 };
+  int exp[6] = { 0 }, act[6] = { 0 };
+  std::set_difference(arr1, arr1 + 9, arr2, arr2 + 6, exp);
+  mystl::set_difference(arr1, arr1 + 9, arr2, arr2 + 6, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_difference(arr2, arr2 + 6, arr3, arr3 + 3, exp);
+  mystl::set_difference(arr2, arr2 + 6, arr3, arr3 + 3, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_difference(arr1, arr1 + 9, arr3, arr3 + 3, exp, std::less<int>());
+  mystl::set_difference(arr1, arr1 + 9, arr3, arr3 + 3, act, std::less<int>());
+  EXPECT_CON_EQ(exp, act);
+}
+
+TEST(set_intersection_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9 };
+  int arr2[] = { 1,2,3,4,5,6 };
+  int arr3[] = { 1,2,3 };
+  int exp[9] = { 0 }, act[9] = { 0 };
+  std::set_intersection(arr1, arr1 + 9, arr2, arr2 + 6, exp);
+  mystl::set_intersection(arr1, arr1 + 9, arr2, arr2 + 6, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_intersection(arr2, arr2 + 6, arr3, arr3 + 3, exp);
+  mystl::set_intersection(arr2, arr2 + 6, arr3, arr3 + 3, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_intersection(arr1, arr1 + 9, arr3, arr3 + 3, exp, std::less<int>());
+  mystl::set_intersection(arr1, arr1 + 9, arr3, arr3 + 3, act, std::less<int>());
+  EXPECT_CON_EQ(exp, act);
+
+  // 长度相差悬殊的序列与严格递增的 uint32_t 序列
+  mystl::vector<uint32_t> v1, v2, v3;
+  for (uint32_t i = 0; i < 100000; ++i)
+    v1.push_back(i * 3);
+  for (uint32_t i = 0; i < 1000; ++i)
+    v2.push_back(i * 301 + static_cast<uint32_t>(rand() % 2));
+  for (uint32_t i = 0; i < 50000; ++i)
+    v3.push_back(i * 5 + static_cast<uint32_t>(rand() % 3));
+  std::vector<uint32_t> e(v1.size()), a(v1.size());
+  bool same = true;
+  const mystl::vector<uint32_t>* pairs[][2] = { {&v1, &v2}, {&v2, &v1}, {&v1, &v3}, {&v3, &v2} };
+  for (auto& p : pairs)
+  {
+    const uint32_t* f1 = p[0]->data();
+    const uint32_t* l1 = f1 + p[0]->size();
+    const uint32_t* f2 = p[1]->data();
+    const uint32_t* l2 = f2 + p[1]->size();
+    const size_t n = std::set_intersection(f1, l1, f2, l2, e.data()) - e.data();
+    same = same && n == static_cast<size_t>(
+      mystl::set_intersection_adaptive(f1, l1, f2, l2, a.data()) - a.data());
+    same = same && std::equal(e.data(), e.data() + n, a.data());
+    same = same && n == static_cast<size_t>(
+      mystl::set_intersection_simd(f1, l1, f2, l2, a.data()) - a.data());
+    same = same && std::equal(e.data(), e.data() + n, a.data());
+  }
+  EXPECT_TRUE(same);
+  // 带有重复元素的序列
+  int arr4[] = { 1,1,1,2,2,3,5,5,5,5 };
+  int arr5[] = { 0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+                 2,3,3,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,5,5 };
+  const int n5 = static_cast<int>(sizeof(arr5) / sizeof(int));
+  std::set_intersection(arr5, arr5 + n5, arr4, arr4 + 2, exp);
+  mystl::set_intersection_adaptive(arr5, arr5 + n5, arr4, arr4 + 2, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_intersection(arr4 + 5, arr4 + 10, arr5, arr5 + n5, exp, std::less<int>());
+  mystl::set_intersection_adaptive(arr4 + 5, arr4 + 10, arr5, arr5 + n5, act, std::less<int>());
+  EXPECT_CON_EQ(exp, act);
+}
+
+TEST(set_symmetric_difference_test)
+{
+  int arr1[] = { 1,2,3,4,5 };
+  int arr2[] = { 1,3,5,7,9 };
+  int arr3[] = { 2,4,6,8,10 };
+  int exp[10] = { 0 }, act[10] = { 0 };
+  std::set_symmetric_difference(arr1, arr1 + 5, arr2, arr2 + 5, exp);
+  mystl::set_symmetric_difference(arr1, arr1 + 5, arr2, arr2 + 5, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_symmetric_difference(arr1, arr1 + 5, arr3, arr3 + 5, exp);
+  mystl::set_symmetric_difference(arr1, arr1 + 5, arr3, arr3 + 5, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_symmetric_difference(arr2, arr2 + 5, arr3, arr3 + 5, exp, std::less<int>());
+  mystl::set_symmetric_difference(arr2, arr2 + 5, arr3, arr3 + 5, act, std::less<int>());
+  EXPECT_CON_EQ(exp, act);
+}
+
+TEST(set_union_test)
+{
+  int arr1[] = { 1,2,3,4,5 };
+  int arr2[] = { 1,3,5,7,9 };
+  int arr3[] = { 2,4,6,8,10 };
+  int exp[10] = { 0 }, act[10] = { 0 };
+  std::set_union(arr1, arr1 + 5, arr2, arr2 + 5, exp);
+  mystl::set_union(arr1, arr1 + 5, arr2, arr2 + 5, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_union(arr1, arr1 + 5, arr3, arr3 + 5, exp);
+  mystl::set_union(arr1, arr1 + 5, arr3, arr3 + 5, act);
+  EXPECT_CON_EQ(exp, act);
+  std::set_union(arr2, arr2 + 5, arr3, arr3 + 5, exp, std::less<int>());
+  mystl::set_union(arr2, arr2 + 5, arr3, arr3 + 5, act, std::less<int>());
+  EXPECT_CON_EQ(exp, act);
+}
+
+TEST(shuffle_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9 };
+  int arr2[] = { 1,2,3,4,5,6,7,8,9 };
+  // 相同的种子得到相同的结果
+  mystl::shuffle(arr1, arr1 + 9, mystl::xoshiro256ss(7));
+  mystl::shuffle(arr2, arr2 + 9, mystl::xoshiro256ss(7));
+  EXPECT_CON_EQ(arr1, arr2);
+  std::sort(arr2, arr2 + 9);
+  EXPECT_TRUE(std::is_permutation(arr1, arr1 + 9, arr2));
+  mystl::shuffle(arr1, arr1, mystl::pcg32(7));
+  mystl::shuffle(arr1, arr1 + 1, mystl::pcg32(7));
+
+  // 3 个元素的 6 种排列出现的次数应接近相等，卡方统计量的自由度为 5
+  const int rounds = 60000;
+  int count[6] = { 0 };
+  mystl::pcg32 g(1);
+  for (int i = 0; i < rounds; ++i)
+  {
+    int a[] = { 0,1,2 };
+    mystl::shuffle(a, a + 3, g);
+    ++count[a[0] * 2 + (a[1] > a[2] ? 1 : 0)];
+  }
+  double chi = 0.0;
+  for (auto c : count)
+    chi += (c - rounds / 6.0) * (c - rounds / 6.0) / (rounds / 6.0);
+  EXPECT_TRUE(chi < 20.5);  // p = 0.001
+
+  // 有界随机整数没有偏差
+  int bucket[7] = { 0 };
+  mystl::xoshiro256ss g64(3);
+  for (int i = 0; i < 70000; ++i)
+    ++bucket[mystl::uniform_int(g64, 7)];
+  chi = 0.0;
+  for (auto c : bucket)
+    chi += (c - 10000.0) * (c - 10000.0) / 10000.0;
+  EXPECT_TRUE(chi < 22.5);  // p = 0.001, 自由度为 6
 }
 
 TEST(sort_test)
@@ -905,6 +1634,57 @@ TEST(sort_test)
   EXPECT_CON_EQ(arr1, arr2);
   EXPECT_CON_EQ(arr3, arr4);
   EXPECT_CON_EQ(arr5, arr6);
+  std::vector<int> v1;
+  for (int i = 0; i < 1000; ++i)
+    v1.push_back(rand() % 100);
+  std::vector<int> v2(v1);
+  std::sort(v1.begin(), v1.end());
+  mystl::sort(v2.data(), v2.data() + v2.size());
+  EXPECT_CON_EQ(v1, v2);
+}
+
+TEST(stable_sort_test)
+{
+  int arr1[] = { 3000000,1000001,2000002,1000003,3000004,2000005,1000006 };
+  int arr2[] = { 1000001,1000003,1000006,2000002,2000005,3000000,3000004 };
+  mystl::stable_sort(arr1, arr1 + 7, key_less);
+  EXPECT_CON_EQ(arr1, arr2);
+  int arr3[] = { 6,1,2,5,4,8,3,2,4,6,10,2,1,9 };
+  int arr4[] = { 6,1,2,5,4,8,3,2,4,6,10,2,1,9 };
+  std::stable_sort(arr3, arr3 + 14);
+  mystl::stable_sort(arr4, arr4 + 14);
+  EXPECT_CON_EQ(arr3, arr4);
+
+  // 键值重复很多的记录，稳定排序的结果等于按 (键值, 原始位置) 排序的结果
+  const int n = 100000;
+  mystl::vector<int> v1, v2, v3;
+  for (int i = 0; i < n; ++i)
+    v1.push_back(rand() % 50 * 1000000 + i);
+  v2 = v1;
+  v3 = v1;
+  std::sort(v1.begin(), v1.end());
+  mystl::stable_sort(v2.begin(), v2.end(), key_less);
+  EXPECT_CON_EQ(v1, v2);
+  mystl::stable_sort(mystl::execution::par(4), v3.begin(), v3.end(), key_less);
+  EXPECT_CON_EQ(v1, v3);
+  v2 = v1;
+  v3 = v1;
+  std::stable_sort(v1.begin(), v1.end(), key_greater);
+  mystl::stable_sort(v2.begin(), v2.end(), key_greater);
+  mystl::stable_sort(mystl::execution::par_unseq(3), v3.begin(), v3.end(), key_greater);
+  EXPECT_CON_EQ(v1, v2);
+  EXPECT_CON_EQ(v1, v3);
+
+  mystl::list<int> l1;
+  mystl::vector<int> v4;
+  for (int i = 0; i < 1000; ++i)
+  {
+    l1.push_back(rand() % 10 * 1000000 + i);
+    v4.push_back(l1.back());
+  }
+  std::sort(v4.begin(), v4.end());
+  mystl::stable_sort(l1.begin(), l1.end(), key_less);
+  EXPECT_CON_EQ(v4, l1);
 }
 
 
@@ -978,6 +1758,10 @@ TEST(upper_bound_test)
             mystl::upper_bound(arr1, arr1 + 9, 6, std::less<int>()));
   EXPECT_EQ(std::upper_bound(arr1, arr1 + 9, 7, std::less<int>()),
             mystl::upper_bound(arr1, arr1 + 9, 7, std::less<int>()));
+  EXPECT_EQ(std::upper_bound(arr1, arr1 + 9, 3),
+            mystl::upper_bound_branchy(arr1, arr1 + 9, 3));
+  EXPECT_EQ(std::upper_bound(arr1, arr1 + 9, 0, std::less<int>()),
+            mystl::upper_bound_branchy(arr1, arr1 + 9, 0, std::less<int>()));
 }
 
 } // namespace algorithm_test
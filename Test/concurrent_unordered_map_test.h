@@ -0,0 +1,198 @@
+﻿#ifndef MYTINYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
+#define MYTINYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
+
+// concurrent_unordered_map test : 测试 concurrent_unordered_map 的接口，以及多线程读多写少、写多读少时
+// 相对于用一把互斥锁保护的 unordered_map 的性能
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "../MyTinySTL/concurrent_unordered_map.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace concurrent_unordered_map_test
+{
+
+// 每个线程独立的 xorshift 随机数，rand() 不是线程安全的
+inline uint32_t cmap_next(uint32_t& x)
+{
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+// 启动 threads 个线程，第 t 个线程执行 f(t, ops / threads)，返回挂钟时间（毫秒）
+template <class Function>
+int cmap_run_threads(size_t threads, size_t ops, Function f)
+{
+  mystl::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < threads; ++t)
+    workers.push_back(std::thread(f, t, ops / threads));
+  for (auto& w : workers)
+    w.join();
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+}
+
+// 在 keys 个键值上执行 ops 次随机操作，每 100 次操作中有 writes 次写操作，写操作一半赋值一半删除
+// 分别用一把互斥锁保护的 unordered_map 与 concurrent_unordered_map，耗时写入 ms[0] 与 ms[1]
+void cmap_mixed_time(size_t threads, size_t keys, size_t ops, uint32_t writes, int* ms)
+{
+  mystl::unordered_map<size_t, size_t> um(keys);
+  std::mutex mutex;
+  mystl::concurrent_unordered_map<size_t, size_t> cm;
+  for (size_t i = 0; i < keys; ++i)
+  {
+    um.emplace(i, i);
+    cm.insert(i, i);
+  }
+  std::atomic<size_t> total(0);
+  ms[0] = cmap_run_threads(threads, ops, [&](size_t t, size_t n)
+  {
+    uint32_t x = static_cast<uint32_t>(t * 2654435761u + 1);
+    size_t sum = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      const uint32_t r = cmap_next(x);
+      const size_t key = r % keys;
+      std::lock_guard<std::mutex> lock(mutex);
+      if (r / 7 % 100 >= writes)
+      {
+        auto it = um.find(key);
+        if (it != um.end())
+          sum += it->second;
+      }
+      else if (r / 7 % 2 == 0)
+      {
+        um[key] = i;
+      }
+      else
+      {
+        um.erase(key);
+      }
+    }
+    total += sum;
+  });
+  ms[1] = cmap_run_threads(threads, ops, [&](size_t t, size_t n)
+  {
+    uint32_t x = static_cast<uint32_t>(t * 2654435761u + 1);
+    size_t sum = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      const uint32_t r = cmap_next(x);
+      const size_t key = r % keys;
+      size_t value;
+      if (r / 7 % 100 >= writes)
+      {
+        if (cm.find(key, value))
+          sum += value;
+      }
+      else if (r / 7 % 2 == 0)
+      {
+        cm.insert_or_assign(key, i);
+      }
+      else
+      {
+        cm.erase(key);
+      }
+    }
+    total += sum;
+  });
+  perf_sink = total;
+}
+
+// 比较 1、2、4 个线程下两种做法的性能
+void cmap_mixed_test(const char* name, size_t keys, size_t ops, uint32_t writes)
+{
+  const size_t threads[3] = { 1, 2, 4 };
+  int ms[3][2];
+  for (int i = 0; i < 3; ++i)
+    cmap_mixed_time(threads[i], keys, ops, writes, ms[i]);
+  const char* libs[2] = { " mutex+unordered_map ", "concurrent_unord_map " };
+  std::cout << "|" << name << "|";
+  TEST_LEN(threads[0], threads[1], threads[2], WIDE);
+  for (int lib = 0; lib < 2; ++lib)
+    test_row(libs[lib], ms[0][lib], ms[1][lib], ms[2][lib]);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+void concurrent_unordered_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------- Run container test : concurrent_unordered_map --------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::concurrent_unordered_map<int, int> cm(4);
+  int value = 0;
+  int sum = 0;
+  FUN_VALUE(cm.shard_count());
+  std::cout << std::boolalpha;
+  FUN_VALUE(cm.empty());
+  FUN_VALUE(cm.insert(1, 1));
+  FUN_VALUE(cm.insert(1, 2));
+  FUN_VALUE(cm.insert_or_assign(1, 3));
+  FUN_VALUE(cm.insert_or_assign(2, 4));
+  FUN_VALUE(cm.find(1, value));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(value);
+  std::cout << std::boolalpha;
+  FUN_VALUE(cm.find_and_apply(2, [&](const mystl::pair<const int, int>& p) { value = p.second; }));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(value);
+  std::cout << std::boolalpha;
+  FUN_VALUE(cm.find_and_apply(5, [&](const mystl::pair<const int, int>& p) { value = p.second; }));
+  FUN_VALUE(cm.contains(2));
+  std::cout << std::noboolalpha;
+  mystl::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t)
+  {
+    workers.push_back(std::thread([&cm, t]()
+    {
+      for (int i = 0; i < 1000; ++i)
+        cm.insert_or_assign(t * 1000 + i, i);
+    }));
+  }
+  for (auto& w : workers)
+    w.join();
+  FUN_VALUE(cm.size());
+  cm.for_each([&sum](const mystl::pair<const int, int>& p) { sum += p.second; });
+  FUN_VALUE(sum);
+  std::atomic<int> par_sum(0);
+  cm.for_each(mystl::execution::par, [&par_sum](const mystl::pair<const int, int>& p)
+  {
+    par_sum += p.second;
+  });
+  FUN_VALUE(par_sum.load());
+  FUN_VALUE(cm.erase_if([](const mystl::pair<const int, int>& p) { return p.second >= 500; }));
+  FUN_VALUE(cm.size());
+  FUN_VALUE(cm.erase(0));
+  FUN_VALUE(cm.erase(0));
+  cm.clear();
+  std::cout << std::boolalpha;
+  FUN_VALUE(cm.empty());
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  cmap_mixed_test(" read 95% / write 5% ", SCALE_M(LEN1), SCALE_M(LEN2), 5);
+  cmap_mixed_test(" read 50% / write 50%", SCALE_M(LEN1), SCALE_M(LEN2), 50);
+  PASSED;
+#endif
+  std::cout << "[-------- End container test : concurrent_unordered_map --------]" << std::endl;
+}
+
+} // namespace concurrent_unordered_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
+
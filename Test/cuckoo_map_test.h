@@ -0,0 +1,197 @@
+﻿#ifndef MYTINYSTL_CUCKOO_MAP_TEST_H_
+#define MYTINYSTL_CUCKOO_MAP_TEST_H_
+
+// cuckoo_map test : 测试 cuckoo_map 的接口，以及高装载率下相对于 unordered_map 的查找尾延迟
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "../MyTinySTL/cuckoo_map.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace cuckoo_map_test
+{
+
+inline uint32_t cuckoo_next(uint32_t& x)
+{
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+// 所有键值的哈希值都相同
+struct cuckoo_same_hash
+{
+  size_t operator()(int) const { return 42; }
+};
+
+// 向所有键值哈希值相同的 cuckoo_map 插入 n 个元素，返回插入失败时的异常信息
+std::string same_hash_insert(int n)
+{
+  mystl::cuckoo_map<int, int, cuckoo_same_hash> m;
+  try
+  {
+    for (int i = 0; i < n; ++i)
+      m.emplace(i, i);
+  }
+  catch (const std::length_error& e)
+  {
+    return e.what();
+  }
+  return "no exception, size " + std::to_string(m.size());
+}
+
+// 随机查找 keys 中的键值 keys.size() 次，记录每次查找的耗时
+// p99、p999 与最大耗时（纳秒）分别写入 result[0..2]
+template <class Map>
+void lookup_latency(const Map& m, const mystl::vector<size_t>& keys, int* result)
+{
+  const size_t len = keys.size();
+  mystl::vector<int> ns(len);
+  uint32_t x = 2463534242u;
+  size_t sum = 0;
+  for (size_t i = 0; i < len; ++i)
+  {
+    const size_t key = keys[cuckoo_next(x) % len];
+    auto start = std::chrono::steady_clock::now();
+    sum += m.find(key)->second;
+    auto end = std::chrono::steady_clock::now();
+    ns[i] = static_cast<int>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  }
+  perf_sink = sum;
+  mystl::sort(ns.begin(), ns.end());
+  result[0] = ns[len * 99 / 100];
+  result[1] = ns[len * 999 / 1000];
+  result[2] = ns[len - 1];
+}
+
+// 把 unordered_map 与 cuckoo_map 都填到装载率为 lf%，再测量查找的尾延迟，结果写入 result[0] 与 result[1]
+// skewed 为 true 时键值只落在 unordered_map 的 1/16 的桶中，链表长度约为装载率的 16 倍
+void lookup_latency_time(size_t slots, size_t lf, bool skewed, int (*result)[3])
+{
+  mystl::cuckoo_map<size_t, size_t> cm;
+  cm.rehash(slots / 4);
+  mystl::unordered_map<size_t, size_t> um(cm.capacity());
+  const size_t buckets = um.bucket_count();
+  const size_t m = buckets / 16;
+  mystl::vector<size_t> keys;
+  for (size_t i = 0; i < buckets * lf / 100; ++i)
+  {
+    const size_t key = skewed ? (i / m) * buckets + i % m : i * 2654435761u;
+    um.emplace(key, i);
+    keys.push_back(key);
+  }
+  lookup_latency(um, keys, result[0]);
+  keys.clear();
+  for (size_t i = 0; i < cm.capacity() * lf / 100; ++i)
+  {
+    const size_t key = skewed ? (i / m) * buckets + i % m : i * 2654435761u;
+    cm.emplace(key, i);
+    keys.push_back(key);
+  }
+  lookup_latency(cm, keys, result[1]);
+}
+
+// 比较装载率为 50%、75%、90% 时两者的查找尾延迟
+void lookup_latency_test(const char* name, size_t slots, bool skewed)
+{
+  const size_t lfs[3] = { 50, 75, 90 };
+  int result[3][2][3];
+  for (int i = 0; i < 3; ++i)
+    lookup_latency_time(slots, lfs[i], skewed, result[i]);
+  const char* names[2][3] = {
+    { " unordered_map p99   ", " unordered_map p999  ", " unordered_map max   " },
+    { "  cuckoo_map p99     ", "  cuckoo_map p999    ", "  cuckoo_map max     " }
+  };
+  std::cout << "|" << name << "|";
+  TEST_LEN(lfs[0], lfs[1], lfs[2], WIDE);
+  for (int lib = 0; lib < 2; ++lib)
+  {
+    for (int row = 0; row < 3; ++row)
+      test_row(names[lib][row], result[0][lib][row], result[1][lib][row], result[2][lib][row], "ns");
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+void cuckoo_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------------- Run container test : cuckoo_map --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::cuckoo_map<int, int> cm1;
+  mystl::cuckoo_map<int, int> cm2(100);
+  mystl::cuckoo_map<int, int> cm3{ mystl::pair<const int, int>(1, 1), mystl::pair<const int, int>(2, 2) };
+  mystl::cuckoo_map<int, int> cm4(cm3);
+  mystl::cuckoo_map<int, int> cm5(std::move(cm4));
+  int sum = 0;
+  FUN_VALUE(cm1.bucket_count());
+  FUN_VALUE(cm2.bucket_count());
+  FUN_VALUE(cm3.size());
+  FUN_VALUE(cm5.size());
+  std::cout << std::boolalpha;
+  FUN_VALUE(cm1.empty());
+  FUN_VALUE(cm1.insert(mystl::pair<const int, int>(1, 10)).second);
+  FUN_VALUE(cm1.insert(mystl::pair<const int, int>(1, 20)).second);
+  FUN_VALUE(cm1.emplace(2, 30).second);
+  FUN_VALUE(cm1.insert_or_assign(2, 40).second);
+  std::cout << std::noboolalpha;
+  FUN_VALUE(cm1.find(1)->second);
+  FUN_VALUE(cm1.at(2));
+  FUN_VALUE(cm1[3]);
+  for (int i = 0; i < 1000; ++i)
+    cm1[i] += i;
+  FUN_VALUE(cm1.size());
+  FUN_VALUE(cm1.bucket_count());
+  FUN_VALUE(cm1.capacity());
+  FUN_VALUE(cm1.count(999));
+  std::cout << std::boolalpha;
+  FUN_VALUE(cm1.contains(500));
+  FUN_VALUE((cm1.find(1000) == cm1.end()));
+  std::cout << std::noboolalpha;
+  for (auto& p : cm1)
+    sum += p.second;
+  FUN_VALUE(sum);
+  FUN_VALUE(cm1.erase(500));
+  FUN_VALUE(cm1.erase(500));
+  cm1.erase(cm1.find(0));
+  FUN_VALUE(cm1.size());
+  cm2 = cm1;
+  std::cout << std::boolalpha;
+  FUN_VALUE((cm2 == cm1));
+  std::cout << std::noboolalpha;
+  cm2.rehash(4096);
+  FUN_VALUE(cm2.bucket_count());
+  FUN_VALUE(cm2.load_factor());
+  std::cout << std::boolalpha;
+  FUN_VALUE((cm2 == cm1));
+  std::cout << std::noboolalpha;
+  cm1.clear();
+  FUN_VALUE(cm1.size());
+  cm1.swap(cm5);
+  FUN_VALUE(cm1.size());
+  FUN_VALUE(same_hash_insert(8));
+  FUN_VALUE(same_hash_insert(9));
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  lookup_latency_test("  uniform keys, lf%  ", SCALE_S(LEN2), false);
+  lookup_latency_test("  skewed keys, lf%   ", SCALE_S(LEN2), true);
+  PASSED;
+#endif
+  std::cout << "[---------------- End container test : cuckoo_map --------------]" << std::endl;
+}
+
+} // namespace cuckoo_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_CUCKOO_MAP_TEST_H_
+
@@ -0,0 +1,258 @@
+﻿#ifndef MYTINYSTL_EBR_TEST_H_
+#define MYTINYSTL_EBR_TEST_H_
+
+// ebr test : 测试 ebr 与 ebr_guard 的接口，多线程读写时被读取的对象不会提前释放，
+// 以及 ebr_guard 的开销与负载下延迟回收占用的对象数
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "../MyTinySTL/ebr.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace ebr_test
+{
+
+std::atomic<size_t> ebr_destroyed(0);
+
+// 析构时清除标记并计数，用来检查对象是否在仍被读取时释放
+struct ebr_object
+{
+  size_t magic;
+  size_t value;
+
+  explicit ebr_object(size_t v) :magic(0x5AFE), value(v) {}
+  ~ebr_object()
+  {
+    magic = 0;
+    ++ebr_destroyed;
+  }
+};
+
+ebr_object* ebr_make(size_t v)
+{
+  ebr_object* p = mystl::allocator<ebr_object>::allocate();
+  mystl::construct(p, v);
+  return p;
+}
+
+// 每个线程独立的 xorshift 随机数，rand() 不是线程安全的
+inline uint32_t ebr_next(uint32_t& x)
+{
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+// 启动 threads 个线程，第 t 个线程执行 f(t)，返回挂钟时间（毫秒）
+template <class Function>
+int ebr_run_threads(size_t threads, Function f)
+{
+  mystl::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < threads; ++t)
+    workers.push_back(std::thread(f, t));
+  for (auto& w : workers)
+    w.join();
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+}
+
+// 压力测试：threads 个线程共享 slots 个指针，每个线程在 ebr_guard 内随机读取或替换一个指针，
+// 替换下来的对象交给 ebr 回收，检查读到的对象都未被析构，返回出错的次数
+size_t ebr_stress(size_t threads, size_t n)
+{
+  const size_t slots = 16;
+  std::atomic<ebr_object*> shared[slots];
+  for (size_t i = 0; i < slots; ++i)
+    shared[i].store(ebr_make(i));
+  std::atomic<size_t> errors(0);
+  ebr_run_threads(threads, [&](size_t t)
+  {
+    uint32_t x = static_cast<uint32_t>(t * 2654435761u + 1);
+    for (size_t i = 0; i < n; ++i)
+    {
+      mystl::ebr_guard guard;
+      const uint32_t r = ebr_next(x);
+      std::atomic<ebr_object*>& slot = shared[r % slots];
+      if (r / 7 % 4 == 0)
+      {
+        ebr_object* old = slot.exchange(ebr_make(i));
+        mystl::ebr::retire(old);
+      }
+      else
+      {
+        ebr_object* p = slot.load(std::memory_order_acquire);
+        for (int k = 0; k < 4; ++k)
+        {
+          if (p->magic != 0x5AFE)
+            ++errors;
+        }
+      }
+    }
+  });
+  mystl::ebr_guard guard;
+  for (size_t i = 0; i < slots; ++i)
+    mystl::ebr::retire(shared[i].load());
+  return errors.load();
+}
+
+// 单线程执行 n 次空循环、进出 ebr_guard 与加解互斥锁，耗时（毫秒）分别写入 ms[0]、ms[1] 与 ms[2]
+void ebr_guard_time(size_t n, int* ms)
+{
+  std::atomic<size_t> word(1);
+  std::mutex mutex;
+  size_t sum = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; ++i)
+    sum += word.load(std::memory_order_acquire);
+  auto t1 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; ++i)
+  {
+    mystl::ebr_guard guard;
+    sum += word.load(std::memory_order_acquire);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; ++i)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sum += word.load(std::memory_order_acquire);
+  }
+  auto t3 = std::chrono::steady_clock::now();
+  perf_sink = sum;
+  ms[0] = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count());
+  ms[1] = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count());
+  ms[2] = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count());
+}
+
+void ebr_guard_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  int ms[3][3];
+  for (int i = 0; i < 3; ++i)
+    ebr_guard_time(lens[i], ms[i]);
+  const char* libs[3] = { "      no guard       ", "      ebr_guard      ", "     std::mutex      " };
+  std::cout << "|    enter + leave    |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  for (int lib = 0; lib < 3; ++lib)
+    test_row(libs[lib], ms[0][lib], ms[1][lib], ms[2][lib]);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+// threads 个线程共执行 ops 次替换，每次替换在 ebr_guard 内摘除一个对象并交给 ebr，
+// 耗时与运行期间观察到的最多待回收对象数分别写入 result[0] 与 result[1]
+void ebr_held_time(size_t threads, size_t ops, size_t* result)
+{
+  const size_t slots = 1024;
+  std::atomic<size_t*> shared[slots];
+  for (size_t i = 0; i < slots; ++i)
+    shared[i].store(mystl::allocator<size_t>::allocate());
+  std::atomic<size_t> peak(0);
+  result[0] = static_cast<size_t>(ebr_run_threads(threads, [&](size_t t)
+  {
+    uint32_t x = static_cast<uint32_t>(t * 2654435761u + 1);
+    size_t local_peak = 0;
+    for (size_t i = 0; i < ops / threads; ++i)
+    {
+      {
+        mystl::ebr_guard guard;
+        size_t* old = shared[ebr_next(x) % slots].exchange(mystl::allocator<size_t>::allocate());
+        mystl::ebr::retire(old);
+      }
+      if (i % 1024 == 0)
+      {
+        const size_t held = mystl::ebr::pending();
+        local_peak = held > local_peak ? held : local_peak;
+      }
+    }
+    size_t cur = peak.load();
+    while (local_peak > cur && !peak.compare_exchange_weak(cur, local_peak)) {}
+  }));
+  result[1] = peak.load();
+  mystl::ebr_guard guard;
+  for (size_t i = 0; i < slots; ++i)
+    mystl::ebr::retire(shared[i].load());
+}
+
+// 比较 1、2、4 个线程下的耗时、延迟回收占用的对象数，以及线程退出后 flush 剩下的对象数
+void ebr_held_test(size_t ops)
+{
+  const size_t threads[3] = { 1, 2, 4 };
+  size_t result[3][3];
+  for (int i = 0; i < 3; ++i)
+  {
+    ebr_held_time(threads[i], ops, result[i]);
+    mystl::ebr::flush();
+    result[i][2] = mystl::ebr::pending();
+  }
+  const char* names[3] = { "    retire time      ", "  peak pending objs  ", " pending after flush " };
+  const char* units[3] = { "ms", "", "" };
+  std::cout << "|  threads (retire)   |";
+  TEST_LEN(threads[0], threads[1], threads[2], WIDE);
+  for (int row = 0; row < 3; ++row)
+  {
+    test_row(names[row], static_cast<int>(result[0][row]), static_cast<int>(result[1][row]),
+             static_cast<int>(result[2][row]), units[row]);
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+void ebr_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------------- Run container test : ebr -----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::ebr::register_thread();
+  std::cout << std::boolalpha;
+  FUN_VALUE(mystl::ebr::is_pinned());
+  {
+    mystl::ebr_guard g1;
+    FUN_VALUE(mystl::ebr::is_pinned());
+    {
+      mystl::ebr_guard g2;
+      FUN_VALUE(mystl::ebr::is_pinned());
+    }
+    FUN_VALUE(mystl::ebr::is_pinned());
+  }
+  FUN_VALUE(mystl::ebr::is_pinned());
+  std::cout << std::noboolalpha;
+  mystl::ebr::flush();
+  const size_t before = mystl::ebr::pending();
+  ebr_destroyed = 0;
+  {
+    mystl::ebr_guard guard;
+    for (size_t i = 0; i < 100; ++i)
+      mystl::ebr::retire(ebr_make(i));
+    FUN_VALUE(mystl::ebr::pending() - before);
+    FUN_VALUE(ebr_destroyed.load());
+  }
+  mystl::ebr::flush();
+  FUN_VALUE(ebr_destroyed.load());
+  FUN_VALUE(mystl::ebr::pending() - before);
+  FUN_VALUE(ebr_stress(4, 20000));
+  mystl::ebr::flush();
+  mystl::ebr::unregister_thread();
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  ebr_guard_test(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+  ebr_held_test(SCALE_M(LEN2));
+  PASSED;
+#endif
+  std::cout << "[-------------------- End container test : ebr -----------------]" << std::endl;
+}
+
+} // namespace ebr_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_EBR_TEST_H_
+
@@ -0,0 +1,299 @@
+﻿#ifndef MYTINYSTL_FLAT_MAP_TEST_H_
+#define MYTINYSTL_FLAT_MAP_TEST_H_
+
+// flat_map test : 测试 flat_map, flat_set 的接口，以及 flat_map 批量构造与查找相对于 map 的性能
+
+#include <map>
+#include <stdexcept>
+
+#include "../MyTinySTL/flat_map.h"
+#include "../MyTinySTL/flat_set.h"
+#include "../MyTinySTL/map.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace flat_map_test
+{
+
+// pair 的宏定义
+#define FPAIR   mystl::pair<int, int>
+
+// flat_map 的遍历输出
+#define FMAP_COUT(m) do { \
+    std::string m_name = #m; \
+    std::cout << " " << m_name << " :"; \
+    for (auto it : m)    std::cout << " <" << it.first << "," << it.second << ">"; \
+    std::cout << std::endl; \
+} while(0)
+
+// flat_map 的函数操作
+#define FMAP_FUN_AFTER(con, fun) do { \
+    std::string str = #fun; \
+    std::cout << " After " << str << " :" << std::endl; \
+    fun; \
+    FMAP_COUT(con); \
+} while(0)
+
+// flat_map 的函数值
+#define FMAP_VALUE(fun) do { \
+    std::string str = #fun; \
+    auto it = fun; \
+    std::cout << " " << str << " : <" << it.first << "," << it.second << ">\n"; \
+} while(0)
+
+// 比较次数达到 flat_throw_after 时抛出异常的比较函数，flat_throw_after 为负数时不抛出异常
+int flat_throw_after = -1;
+
+struct flat_throwing_less
+{
+  bool operator()(int a, int b) const
+  {
+    if (flat_throw_after >= 0 && flat_throw_after-- == 0)
+      throw std::runtime_error("flat_throwing_less");
+    return a < b;
+  }
+};
+
+// 向 c 批量插入[first, last)，第 n 次比较时抛出异常，返回抛出异常之后 c 是否保持不变
+template <class Container, class Iter>
+bool throwing_insert_unchanged(Container c, Iter first, Iter last, int n)
+{
+  const Container old(c);
+  flat_throw_after = n;
+  try
+  {
+    c.insert_range(first, last);
+  }
+  catch (const std::runtime_error&)
+  {
+  }
+  flat_throw_after = -1;
+  return c == old;
+}
+
+// 以 values 建立一个 Map：node-based 的 map 逐个插入，flat_map 使用批量构造
+template <class Map>
+void flat_map_build(Map& m, const mystl::vector<FPAIR>& values)
+{
+  for (auto& v : values)
+    m.insert(typename Map::value_type(v.first, v.second));
+}
+
+inline void flat_map_build(mystl::flat_map<int, int>& m, const mystl::vector<FPAIR>& values)
+{
+  mystl::flat_map<int, int> tmp(values.begin(), values.end());
+  m.swap(tmp);
+}
+
+// 以 values 建立一个 Map 并逐个查找其中的键值，建立与查找的耗时（毫秒）写入 ms
+template <class Map>
+void flat_map_ops_time(const mystl::vector<FPAIR>& values, int* ms)
+{
+  Map m;
+  size_t sum = 0;
+  clock_t t0 = clock();
+  flat_map_build(m, values);
+  clock_t t1 = clock();
+  for (auto& v : values)
+    sum += m.find(v.first)->second;
+  clock_t t2 = clock();
+  perf_sink = sum;
+  ms[0] = static_cast<int>(static_cast<double>(t1 - t0) / CLOCKS_PER_SEC * 1000);
+  ms[1] = static_cast<int>(static_cast<double>(t2 - t1) / CLOCKS_PER_SEC * 1000);
+}
+
+// 与 std::map、mystl::map 比较批量建立与查找的性能
+void flat_map_ops_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  int ms[3][3][2];
+  for (int i = 0; i < 3; ++i)
+  {
+    mystl::vector<FPAIR> values;
+    values.reserve(lens[i]);
+    for (size_t j = 0; j < lens[i]; ++j)
+    {
+      const int k = rand();
+      values.push_back(FPAIR(k, k));
+    }
+    flat_map_ops_time<std::map<int, int>>(values, ms[0][i]);
+    flat_map_ops_time<mystl::map<int, int>>(values, ms[1][i]);
+    flat_map_ops_time<mystl::flat_map<int, int>>(values, ms[2][i]);
+  }
+  const char* names[2] = { "      bulk load      ", "        find         " };
+  const char* libs[3] = { "      std::map       ", "     mystl::map      ", "   mystl::flat_map   " };
+  for (int op = 0; op < 2; ++op)
+  {
+    std::cout << "|" << names[op] << "|";
+    TEST_LEN(len1, len2, len3, WIDE);
+    for (int lib = 0; lib < 3; ++lib)
+      test_row(libs[lib], ms[lib][0][op], ms[lib][1][op], ms[lib][2][op]);
+    std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  }
+}
+
+void flat_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------------- Run container test : flat_map ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::vector<FPAIR> v;
+  for (int i = 4; i >= 0; --i)
+    v.push_back(FPAIR(i, i));
+  v.push_back(FPAIR(2, 7));
+  mystl::flat_map<int, int> m1;
+  mystl::flat_map<int, int, mystl::greater<int>> m2(v.begin(), v.end());
+  mystl::flat_map<int, int> m3(v.begin(), v.end());
+  mystl::flat_map<int, int> m4(v.begin(), v.end());
+  mystl::flat_map<int, int> m5(m3);
+  mystl::flat_map<int, int> m6(std::move(m3));
+  mystl::flat_map<int, int> m7;
+  m7 = m4;
+  mystl::flat_map<int, int> m8;
+  m8 = std::move(m4);
+  mystl::flat_map<int, int> m9{ FPAIR(1,1),FPAIR(3,2),FPAIR(2,3) };
+  mystl::flat_map<int, int> m10;
+  m10 = { FPAIR(1,1),FPAIR(3,2),FPAIR(2,3) };
+  mystl::flat_map<int, int> m11(mystl::vector<int>{ 3,1,2,1 }, mystl::vector<int>{ 30,10,20,11 });
+  FMAP_COUT(m2);
+  FMAP_COUT(m6);
+  FMAP_COUT(m11);
+
+  for (int i = 5; i > 0; --i)
+  {
+    FMAP_FUN_AFTER(m1, m1.emplace(i, i));
+  }
+  FMAP_FUN_AFTER(m1, m1.emplace_hint(m1.begin(), 0, 0));
+  FMAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+  FMAP_FUN_AFTER(m1, m1.erase(0));
+  FMAP_FUN_AFTER(m1, m1.erase(1));
+  FMAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.end()));
+  for (int i = 0; i < 5; ++i)
+  {
+    FMAP_FUN_AFTER(m1, m1.insert(FPAIR(i, i)));
+  }
+  FMAP_FUN_AFTER(m1, m1.insert(v.begin(), v.end()));
+  FMAP_FUN_AFTER(m1, m1.insert(m1.end(), FPAIR(5, 5)));
+  FMAP_FUN_AFTER(m1, m1.insert_range(m11.begin(), m11.end()));
+  FMAP_FUN_AFTER(m1, m1.insert_range(m9.begin(), m9.end()));
+  FUN_VALUE(m1.count(1));
+  FMAP_VALUE(*m1.find(3));
+  FMAP_VALUE(*m1.lower_bound(3));
+  FMAP_VALUE(*m1.upper_bound(2));
+  auto first = *m1.equal_range(2).first;
+  auto second = *m1.equal_range(2).second;
+  std::cout << " m1.equal_range(2) : from <" << first.first << ", " << first.second
+    << "> to <" << second.first << ", " << second.second << ">" << std::endl;
+  FMAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+  FMAP_FUN_AFTER(m1, m1.erase(1));
+  FMAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.find(3)));
+  FMAP_FUN_AFTER(m1, m1.clear());
+  FMAP_FUN_AFTER(m1, m1.swap(m9));
+  FMAP_VALUE(*m1.begin());
+  FMAP_VALUE(*m1.rbegin());
+  FUN_VALUE(m1.begin()->second);
+  FUN_VALUE(m1[1]);
+  FMAP_FUN_AFTER(m1, m1[1] = 3);
+  FMAP_FUN_AFTER(m1, m1[4] = 4);
+  FUN_VALUE(m1.at(1));
+  std::cout << std::boolalpha;
+  FUN_VALUE(m1.empty());
+  FUN_VALUE(m1.contains(4));
+  FUN_VALUE((m5 == m6));
+  FUN_VALUE((m1 != m10));
+  mystl::flat_map<int, int, flat_throwing_less> m12(v.begin(), v.end());
+  FUN_VALUE(throwing_insert_unchanged(m12, m11.begin(), m11.end(), 0));
+  FUN_VALUE(throwing_insert_unchanged(m12, m11.begin(), m11.end(), 5));
+  FUN_VALUE(throwing_insert_unchanged(m12, m11.begin(), m11.end(), 10));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(m1.size());
+  FUN_VALUE(m1.max_size());
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  flat_map_ops_test(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+  PASSED;
+#endif
+  std::cout << "[---------------- End container test : flat_map ----------------]" << std::endl;
+}
+
+void flat_set_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------------- Run container test : flat_set ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,4,3,2,1,3 };
+  mystl::flat_set<int> s1;
+  mystl::flat_set<int, mystl::greater<int>> s2(a, a + 6);
+  mystl::flat_set<int> s3(a, a + 6);
+  mystl::flat_set<int> s4(a, a + 6);
+  mystl::flat_set<int> s5(s3);
+  mystl::flat_set<int> s6(std::move(s3));
+  mystl::flat_set<int> s7;
+  s7 = s4;
+  mystl::flat_set<int> s8;
+  s8 = std::move(s4);
+  mystl::flat_set<int> s9{ 1,2,3,4,5 };
+  mystl::flat_set<int> s10;
+  s10 = { 1,2,3,4,5 };
+  mystl::flat_set<int> s11(mystl::vector<int>{ 9,7,8,7 });
+  COUT(s2);
+  COUT(s6);
+  COUT(s11);
+
+  for (int i = 5; i > 0; --i)
+  {
+    FUN_AFTER(s1, s1.emplace(i));
+  }
+  FUN_AFTER(s1, s1.emplace_hint(s1.begin(), 0));
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(0));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.end()));
+  for (int i = 0; i < 5; ++i)
+  {
+    FUN_AFTER(s1, s1.insert(i));
+  }
+  FUN_AFTER(s1, s1.insert(a, a + 6));
+  FUN_AFTER(s1, s1.insert(5));
+  FUN_AFTER(s1, s1.insert(s1.end(), 6));
+  FUN_AFTER(s1, s1.insert_range(s11.begin(), s11.end()));
+  FUN_VALUE(s1.count(5));
+  FUN_VALUE(*s1.find(3));
+  FUN_VALUE(*s1.lower_bound(3));
+  FUN_VALUE(*s1.upper_bound(3));
+  auto first = *s1.equal_range(3).first;
+  auto second = *s1.equal_range(3).second;
+  std::cout << " s1.equal_range(3) : from " << first << " to " << second << std::endl;
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(3)));
+  FUN_AFTER(s1, s1.clear());
+  FUN_AFTER(s1, s1.swap(s5));
+  FUN_VALUE(*s1.begin());
+  FUN_VALUE(*s1.rbegin());
+  std::cout << std::boolalpha;
+  FUN_VALUE(s1.empty());
+  FUN_VALUE((s1 == s6));
+  FUN_VALUE((s9 == s10));
+  FUN_VALUE((s1 != s9));
+  mystl::flat_set<int, flat_throwing_less> s12(a, a + 6);
+  FUN_VALUE(throwing_insert_unchanged(s12, s11.begin(), s11.end(), 0));
+  FUN_VALUE(throwing_insert_unchanged(s12, s11.begin(), s11.end(), 1));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(s1.size());
+  FUN_VALUE(s1.max_size());
+  PASSED;
+  std::cout << "[---------------- End container test : flat_set ----------------]" << std::endl;
+}
+
+} // namespace flat_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_MAP_TEST_H_
+
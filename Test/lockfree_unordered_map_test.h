@@ -0,0 +1,214 @@
+﻿#ifndef MYTINYSTL_LOCKFREE_UNORDERED_MAP_TEST_H_
+#define MYTINYSTL_LOCKFREE_UNORDERED_MAP_TEST_H_
+
+// lockfree_unordered_map test : 测试 lockfree_unordered_map 的接口，多线程插入、查找、删除的正确性，
+// 以及读多写少时相对于用一把互斥锁保护的 unordered_map 的扩展性
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "../MyTinySTL/lockfree_unordered_map.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace lockfree_unordered_map_test
+{
+
+// 每个线程独立的 xorshift 随机数，rand() 不是线程安全的
+inline uint32_t lfmap_next(uint32_t& x)
+{
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+// 启动 threads 个线程，第 t 个线程执行 f(t)，返回挂钟时间（毫秒）
+template <class Function>
+int lfmap_run_threads(size_t threads, Function f)
+{
+  mystl::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < threads; ++t)
+    workers.push_back(std::thread(f, t));
+  for (auto& w : workers)
+    w.join();
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+}
+
+// 压力测试：threads 个线程各自插入、查找、删除互不相交的 n 个键值若干轮，同时随机查找其它线程的键值
+// 最后一轮只删除一半，检查每个操作的返回值与最终剩下的元素，返回出错的次数
+size_t lfmap_stress(size_t threads, size_t n)
+{
+  mystl::lockfree_unordered_map<size_t, size_t> m(2);
+  std::atomic<size_t> errors(0);
+  lfmap_run_threads(threads, [&](size_t t)
+  {
+    uint32_t x = static_cast<uint32_t>(t * 2654435761u + 1);
+    size_t value;
+    for (int round = 0; round < 3; ++round)
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (!m.insert(i * threads + t, i))
+          ++errors;
+      }
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (!m.find(i * threads + t, value) || value != i)
+          ++errors;
+        m.contains(lfmap_next(x) % (n * threads));
+      }
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (round == 2 && i % 2 == 1)
+          continue;
+        if (!m.erase(i * threads + t))
+          ++errors;
+      }
+    }
+  });
+  if (m.size() != threads * n / 2)
+    ++errors;
+  for (size_t k = 0; k < threads * n; ++k)
+  {
+    if (m.contains(k) != (k / threads % 2 == 1))
+      ++errors;
+  }
+  return errors.load();
+}
+
+// 在 keys 个键值上执行 ops 次随机操作，每 100 次操作中有 writes 次写操作，写操作一半插入一半删除
+// 分别用一把互斥锁保护的 unordered_map 与 lockfree_unordered_map，耗时写入 ms[0] 与 ms[1]
+void lfmap_mixed_time(size_t threads, size_t keys, size_t ops, uint32_t writes, int* ms)
+{
+  mystl::unordered_map<size_t, size_t> um(keys);
+  std::mutex mutex;
+  mystl::lockfree_unordered_map<size_t, size_t> lm(keys);
+  for (size_t i = 0; i < keys; ++i)
+  {
+    um.emplace(i, i);
+    lm.insert(i, i);
+  }
+  std::atomic<size_t> total(0);
+  ms[0] = lfmap_run_threads(threads, [&](size_t t)
+  {
+    uint32_t x = static_cast<uint32_t>(t * 2654435761u + 1);
+    size_t sum = 0;
+    for (size_t i = 0; i < ops / threads; ++i)
+    {
+      const uint32_t r = lfmap_next(x);
+      const size_t key = r % keys;
+      std::lock_guard<std::mutex> lock(mutex);
+      if (r / 7 % 100 >= writes)
+      {
+        auto it = um.find(key);
+        if (it != um.end())
+          sum += it->second;
+      }
+      else if (r / 7 % 2 == 0)
+      {
+        um.emplace(key, i);
+      }
+      else
+      {
+        um.erase(key);
+      }
+    }
+    total += sum;
+  });
+  ms[1] = lfmap_run_threads(threads, [&](size_t t)
+  {
+    uint32_t x = static_cast<uint32_t>(t * 2654435761u + 1);
+    size_t sum = 0;
+    size_t value;
+    for (size_t i = 0; i < ops / threads; ++i)
+    {
+      const uint32_t r = lfmap_next(x);
+      const size_t key = r % keys;
+      if (r / 7 % 100 >= writes)
+      {
+        if (lm.find(key, value))
+          sum += value;
+      }
+      else if (r / 7 % 2 == 0)
+      {
+        lm.insert(key, i);
+      }
+      else
+      {
+        lm.erase(key);
+      }
+    }
+    total += sum;
+  });
+  perf_sink = total;
+}
+
+// 比较 1、2、4 个线程下两种做法的性能
+void lfmap_mixed_test(const char* name, size_t keys, size_t ops, uint32_t writes)
+{
+  const size_t threads[3] = { 1, 2, 4 };
+  int ms[3][2];
+  for (int i = 0; i < 3; ++i)
+    lfmap_mixed_time(threads[i], keys, ops, writes, ms[i]);
+  const char* libs[2] = { " mutex+unordered_map ", "lockfree_unorder_map " };
+  std::cout << "|" << name << "|";
+  TEST_LEN(threads[0], threads[1], threads[2], WIDE);
+  for (int lib = 0; lib < 2; ++lib)
+    test_row(libs[lib], ms[0][lib], ms[1][lib], ms[2][lib]);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+void lockfree_unordered_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------- Run container test : lockfree_unordered_map ----------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::lockfree_unordered_map<int, int> lm(4);
+  int value = 0;
+  FUN_VALUE(lm.bucket_count());
+  std::cout << std::boolalpha;
+  FUN_VALUE(lm.empty());
+  FUN_VALUE(lm.insert(1, 10));
+  FUN_VALUE(lm.insert(1, 20));
+  FUN_VALUE(lm.insert(2, 30));
+  FUN_VALUE(lm.find(1, value));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(value);
+  std::cout << std::boolalpha;
+  FUN_VALUE(lm.find(3, value));
+  FUN_VALUE(lm.contains(2));
+  FUN_VALUE(lm.erase(2));
+  FUN_VALUE(lm.erase(2));
+  FUN_VALUE(lm.contains(2));
+  std::cout << std::noboolalpha;
+  for (int i = 0; i < 1000; ++i)
+    lm.insert(i, i);
+  FUN_VALUE(lm.size());
+  FUN_VALUE(lm.bucket_count());
+  FUN_VALUE(lfmap_stress(4, 20000));
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  lfmap_mixed_test(" read 99% / write 1% ", SCALE_M(LEN1), SCALE_M(LEN2), 1);
+  lfmap_mixed_test(" read 90% / write 10%", SCALE_M(LEN1), SCALE_M(LEN2), 10);
+  PASSED;
+#endif
+  std::cout << "[-------- End container test : lockfree_unordered_map ----------]" << std::endl;
+}
+
+} // namespace lockfree_unordered_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_LOCKFREE_UNORDERED_MAP_TEST_H_
+
@@ -1,7 +1,7 @@
 ﻿#ifndef MYTINYSTL_MAP_TEST_H_
 #define MYTINYSTL_MAP_TEST_H_
 
-// map test : 测试 map, multimap 的接口与它们 insert 的性能
+// map test : 测试 map, multimap 的接口与它们 insert 的性能，以及 map 的 find、区间扫描与 erase 的性能
 
 #include <map>
 
@@ -42,6 +42,63 @@ namespace map_test
     std::cout << " " << str << " : <" << it.first << "," << it.second << ">\n"; \
 } while(0)
 
+// 以 keys 中的键值依次测试 insert、find、区间扫描与 erase 的耗时（毫秒），结果写入 ms
+// 区间扫描从 keys 中每隔 128 个取一个起点，沿迭代器向后读取 128 个元素
+template <class Map>
+void map_ops_time(const mystl::vector<int>& keys, int* ms)
+{
+  Map m;
+  size_t sum = 0;
+  clock_t t0 = clock();
+  for (auto k : keys)
+    m.insert(typename Map::value_type(k, k));
+  clock_t t1 = clock();
+  for (auto k : keys)
+    sum += m.find(k)->second;
+  clock_t t2 = clock();
+  for (size_t i = 0; i < keys.size(); i += 128)
+  {
+    auto it = m.lower_bound(keys[i]);
+    for (int j = 0; j < 128 && it != m.end(); ++j, ++it)
+      sum += it->second;
+  }
+  clock_t t3 = clock();
+  for (auto k : keys)
+    sum += m.erase(k);
+  clock_t t4 = clock();
+  perf_sink = sum;
+  const clock_t t[5] = { t0, t1, t2, t3, t4 };
+  for (int i = 0; i < 4; ++i)
+    ms[i] = static_cast<int>(static_cast<double>(t[i + 1] - t[i]) / CLOCKS_PER_SEC * 1000);
+}
+
+// 与 std::map 比较 insert、find、区间扫描与 erase 的性能
+void map_ops_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  int ms[2][3][4];
+  for (int i = 0; i < 3; ++i)
+  {
+    mystl::vector<int> keys;
+    keys.reserve(lens[i]);
+    for (size_t j = 0; j < lens[i]; ++j)
+      keys.push_back(rand());
+    map_ops_time<std::map<int, int>>(keys, ms[0][i]);
+    map_ops_time<mystl::map<int, int>>(keys, ms[1][i]);
+  }
+  const char* names[4] = { "       insert        ", "        find         ",
+                           "     range scan      ", "        erase        " };
+  const char* libs[2] = { "         std         ", "        mystl        " };
+  for (int op = 0; op < 4; ++op)
+  {
+    std::cout << "|" << names[op] << "|";
+    TEST_LEN(len1, len2, len3, WIDE);
+    for (int lib = 0; lib < 2; ++lib)
+      test_row(libs[lib], ms[lib][0][op], ms[lib][1][op], ms[lib][2][op]);
+    std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  }
+}
+
 void map_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -114,6 +171,7 @@ void map_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  map_ops_test(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
   PASSED;
 #endif
   std::cout << "[------------------ End container test : map -------------------]" << std::endl;
@@ -0,0 +1,151 @@
+﻿#ifndef MYTINYSTL_ORDER_STATISTIC_TREE_TEST_H_
+#define MYTINYSTL_ORDER_STATISTIC_TREE_TEST_H_
+
+// order_statistic_tree test : 测试 order_statistic_tree 的接口，以及边插入边查询第 k 小、排名与区间计数时
+// 相对于每次查询前重新排序 vector 的性能
+
+#include "../MyTinySTL/algo.h"
+#include "../MyTinySTL/order_statistic_tree.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace order_statistic_tree_test
+{
+
+// 插入 len 个随机数，每插入 len / queries 个元素做一次查询：取中位数、求一个键值的排名、统计一个区间内的元素个数
+// 一种做法是把元素追加到 vector 末尾，查询前重新排序；另一种做法是直接插入 order_statistic_tree
+// 两种做法的耗时（毫秒）分别写入 ms[0] 与 ms[1]
+void ost_query_time(size_t len, size_t queries, int* ms)
+{
+  mystl::vector<int> keys;
+  keys.reserve(len);
+  for (size_t i = 0; i < len; ++i)
+    keys.push_back(rand());
+  const size_t step = len / queries == 0 ? 1 : len / queries;
+  size_t sum = 0;
+
+  clock_t t0 = clock();
+  mystl::vector<int> v;
+  for (size_t i = 0; i < len; ++i)
+  {
+    v.push_back(keys[i]);
+    if ((i + 1) % step == 0)
+    {
+      mystl::sort(v.begin(), v.end());
+      const int lo = keys[i / 2], hi = keys[i];
+      sum += v[v.size() / 2];
+      sum += mystl::lower_bound(v.begin(), v.end(), hi) - v.begin();
+      if (lo < hi)
+        sum += mystl::lower_bound(v.begin(), v.end(), hi) - mystl::lower_bound(v.begin(), v.end(), lo);
+    }
+  }
+  clock_t t1 = clock();
+  mystl::order_statistic_tree<int> t;
+  for (size_t i = 0; i < len; ++i)
+  {
+    t.insert_multi(keys[i]);
+    if ((i + 1) % step == 0)
+    {
+      const int lo = keys[i / 2], hi = keys[i];
+      sum += *t.nth(t.size() / 2);
+      sum += t.rank(hi);
+      sum += t.count_range(lo, hi);
+    }
+  }
+  clock_t t2 = clock();
+  perf_sink = sum;
+  ms[0] = static_cast<int>(static_cast<double>(t1 - t0) / CLOCKS_PER_SEC * 1000);
+  ms[1] = static_cast<int>(static_cast<double>(t2 - t1) / CLOCKS_PER_SEC * 1000);
+}
+
+// 比较每次重新排序与 order_statistic_tree 的性能
+void ost_query_test(size_t len1, size_t len2, size_t len3, size_t queries)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  int ms[3][2];
+  for (int i = 0; i < 3; ++i)
+    ost_query_time(lens[i], queries, ms[i]);
+  const char* libs[2] = { "    vector + sort    ", " order_statistic_tree" };
+  std::cout << "|   insert + query    |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  for (int lib = 0; lib < 2; ++lib)
+    test_row(libs[lib], ms[0][lib], ms[1][lib], ms[2][lib]);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+void order_statistic_tree_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------- Run container test : order_statistic_tree ----------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,4,3,2,1,3 };
+  mystl::order_statistic_tree<int> t1;
+  mystl::order_statistic_tree<int, mystl::greater<int>> t2;
+  mystl::order_statistic_tree<int> t3;
+  t3.insert_multi(a, a + 6);
+  mystl::order_statistic_tree<int> t4(t3);
+  mystl::order_statistic_tree<int> t5(std::move(t4));
+  mystl::order_statistic_tree<int> t6;
+  t6 = t3;
+  mystl::order_statistic_tree<int> t7;
+  t7 = std::move(t6);
+  t2.insert_unique(a, a + 6);
+  COUT(t2);
+  COUT(t3);
+  COUT(t5);
+
+  for (int i = 5; i > 0; --i)
+  {
+    FUN_AFTER(t1, t1.emplace_unique(i));
+  }
+  FUN_AFTER(t1, t1.insert_unique(3));
+  FUN_AFTER(t1, t1.insert_multi(3));
+  FUN_AFTER(t1, t1.insert_multi(a, a + 6));
+  FUN_AFTER(t1, t1.emplace_multi(0));
+  FUN_VALUE(t1.size());
+  FUN_VALUE(t1.count_multi(3));
+  FUN_VALUE(t1.count_unique(6));
+  FUN_VALUE(*t1.nth(0));
+  FUN_VALUE(*t1.nth(6));
+  FUN_VALUE(*t1.nth(t1.size() - 1));
+  FUN_VALUE(t1.rank(3));
+  FUN_VALUE(t1.rank_upper(3));
+  FUN_VALUE(t1.rank(10));
+  FUN_VALUE(t1.index(t1.find(4)));
+  FUN_VALUE(t1.count_range(2, 4));
+  FUN_VALUE(t1.count_range(2, 4, true));
+  FUN_VALUE(t1.count_range(4, 2));
+  FUN_VALUE(*t1.lower_bound(3));
+  FUN_VALUE(*t1.upper_bound(3));
+  FUN_AFTER(t1, t1.erase(t1.nth(3)));
+  FUN_AFTER(t1, t1.erase_multi(3));
+  FUN_AFTER(t1, t1.erase_unique(5));
+  FUN_AFTER(t1, t1.erase(t1.begin(), t1.nth(2)));
+  FUN_VALUE(*t1.rbegin());
+  FUN_AFTER(t1, t1.swap(t7));
+  std::cout << std::boolalpha;
+  FUN_VALUE((t1.nth(t1.size()) == t1.end()));
+  FUN_VALUE((t1 == t3));
+  FUN_VALUE((t1 != t7));
+  FUN_AFTER(t1, t1.clear());
+  FUN_VALUE(t1.empty());
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  ost_query_test(SCALE_SSS(LEN1), SCALE_SSS(LEN2), SCALE_SSS(LEN3), 100);
+  PASSED;
+#endif
+  std::cout << "[---------- End container test : order_statistic_tree ----------]" << std::endl;
+}
+
+} // namespace order_statistic_tree_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_ORDER_STATISTIC_TREE_TEST_H_
+
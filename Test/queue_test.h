@@ -0,0 +1,279 @@
+﻿#ifndef MYTINYSTL_QUEUE_TEST_H_
+#define MYTINYSTL_QUEUE_TEST_H_
+
+// queue test : 测试 priority_queue 的接口，以及不同叉数的 heap 在 push 与 Dijkstra 最短路中的性能
+
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "../MyTinySTL/queue.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace queue_test
+{
+
+// priority_queue 的遍历输出，复制一份后依次弹出
+#define PQUEUE_COUT(pq) do {                     \
+    auto t = pq;                                 \
+    std::string pq_name = #pq;                   \
+    std::cout << " " << pq_name << " :";         \
+    while (!t.empty())                           \
+    {                                            \
+      std::cout << " " << t.top();               \
+      t.pop();                                   \
+    }                                            \
+    std::cout << std::endl;                      \
+} while(0)
+
+#define PQUEUE_FUN_AFTER(con, fun) do {          \
+    std::string fun_name = #fun;                 \
+    std::cout << " After " << fun_name << " :\n"; \
+    fun;                                         \
+    PQUEUE_COUT(con);                            \
+} while(0)
+
+// 依次弹出所有元素，检查是否按从大到小的顺序输出
+template <class Queue>
+bool pops_in_order(Queue q)
+{
+  while (q.size() > 1)
+  {
+    auto x = q.top();
+    q.pop();
+    if (x < q.top())
+      return false;
+  }
+  return true;
+}
+
+// 以 CSR 格式保存的有向图，节点 i 的出边为 [offset[i], offset[i + 1])
+struct graph
+{
+  mystl::vector<size_t>   offset;
+  mystl::vector<uint32_t> target;
+  mystl::vector<uint32_t> weight;
+};
+
+// n 个节点，每个节点 degree 条随机的出边，另有一条指向下一个节点的边保证连通
+graph make_graph(uint32_t n, uint32_t degree)
+{
+  graph g;
+  g.offset.reserve(n + 1);
+  g.target.reserve(static_cast<size_t>(n) * (degree + 1));
+  g.weight.reserve(static_cast<size_t>(n) * (degree + 1));
+  uint32_t x = 2463534242u;  // xorshift32
+  auto next = [&x]() { x ^= x << 13; x ^= x >> 17; x ^= x << 5; return x; };
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    g.offset.push_back(g.target.size());
+    g.target.push_back((i + 1) % n);
+    g.weight.push_back(next() % 1000 + 1);
+    for (uint32_t k = 0; k < degree; ++k)
+    {
+      g.target.push_back(next() % n);
+      g.weight.push_back(next() % 1000 + 1);
+    }
+  }
+  g.offset.push_back(g.target.size());
+  return g;
+}
+
+struct dijkstra_entry
+{
+  uint64_t dist;
+  uint32_t node;
+};
+
+// 距离小的优先
+struct entry_greater
+{
+  bool operator()(const dijkstra_entry& a, const dijkstra_entry& b) const
+  {
+    return a.dist > b.dist;
+  }
+};
+
+// 延迟删除的 Dijkstra：每次松弛都 push 一个新的条目，pop 出过期的条目时跳过，返回所有最短距离之和
+template <class Queue>
+uint64_t dijkstra(const graph& g, Queue& q)
+{
+  const size_t n = g.offset.size() - 1;
+  mystl::vector<uint64_t> dist(n, UINT64_MAX);
+  dist[0] = 0;
+  q.push(dijkstra_entry{ 0, 0 });
+  while (!q.empty())
+  {
+    const dijkstra_entry e = q.top();
+    q.pop();
+    if (e.dist > dist[e.node])
+      continue;
+    for (size_t i = g.offset[e.node]; i < g.offset[e.node + 1]; ++i)
+    {
+      const uint64_t nd = e.dist + g.weight[i];
+      if (nd < dist[g.target[i]])
+      {
+        dist[g.target[i]] = nd;
+        q.push(dijkstra_entry{ nd, g.target[i] });
+      }
+    }
+  }
+  uint64_t sum = 0;
+  for (auto d : dist)
+    sum += d;
+  return sum;
+}
+
+#define DIJKSTRA_TEST(queue_type, g) do {                                 \
+    queue_type q;                                                        \
+    auto start = std::chrono::steady_clock::now();                       \
+    perf_sink = dijkstra(g, q);                                          \
+    auto end = std::chrono::steady_clock::now();                         \
+    int n = static_cast<int>(std::chrono::duration_cast<                 \
+        std::chrono::milliseconds>(end - start).count());                \
+    std::snprintf(buf, sizeof(buf), "%d", n);                            \
+    std::string t = buf;                                                 \
+    t += "ms    |";                                                      \
+    std::cout << std::setw(WIDE) << t;                                   \
+} while(0)
+
+typedef std::priority_queue<dijkstra_entry, std::vector<dijkstra_entry>, entry_greater>
+  std_dijkstra_queue;
+template <size_t Arity>
+using mystl_dijkstra_queue =
+  mystl::priority_queue<dijkstra_entry, mystl::vector<dijkstra_entry>, entry_greater, Arity>;
+
+void priority_queue_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------- Run container test : priority_queue -------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,3,4,5,6,7,8,9 };
+  mystl::vector<int> v{ 5,3,8,1,9 };
+  mystl::priority_queue<int> p1;
+  mystl::priority_queue<int> p2(5);
+  mystl::priority_queue<int> p3(5, 1);
+  mystl::priority_queue<int> p4(a, a + 9);
+  mystl::priority_queue<int> p5(v);
+  mystl::priority_queue<int> p6(mystl::move(v));
+  mystl::priority_queue<int> p7(p4);
+  mystl::priority_queue<int> p8(mystl::move(p7));
+  mystl::priority_queue<int> p9;
+  p9 = p3;
+  mystl::priority_queue<int> p10;
+  p10 = mystl::move(p9);
+  mystl::priority_queue<int> p11{ 9,8,7,6,5,4,3,2,1 };
+  mystl::priority_queue<int> p12;
+  p12 = { 1,2,3,4,5,6,7,8,9 };
+  mystl::priority_queue<int, mystl::vector<int>, mystl::greater<int>, 2> p13(a, a + 9);
+  mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>, 8> p14(a, a + 9);
+
+  PQUEUE_FUN_AFTER(p1, p1.push(1));
+  PQUEUE_FUN_AFTER(p1, p1.push(5));
+  PQUEUE_FUN_AFTER(p1, p1.push(3));
+  PQUEUE_FUN_AFTER(p1, p1.emplace(7));
+  PQUEUE_FUN_AFTER(p1, p1.pop());
+  PQUEUE_FUN_AFTER(p1, p1.push_range(a, a + 3));
+  PQUEUE_FUN_AFTER(p1, p1.push_range(a + 3, a + 9));
+  PQUEUE_FUN_AFTER(p1, p1.reserve(100));
+  PQUEUE_FUN_AFTER(p1, p1.swap(p6));
+  PQUEUE_FUN_AFTER(p1, p1.clear());
+  PQUEUE_COUT(p4);
+  PQUEUE_COUT(p13);
+  PQUEUE_COUT(p14);
+  std::cout << std::boolalpha;
+  FUN_VALUE(p1.empty());
+  FUN_VALUE(p6.size());
+  FUN_VALUE(p6.top());
+  FUN_VALUE(p11.top());
+  FUN_VALUE(p13.top());
+  FUN_VALUE((p6.capacity() >= 100));
+  FUN_VALUE((p4 == p8));
+  FUN_VALUE((p11 != p12));
+  {
+    mystl::vector<int> r;
+    for (int i = 0; i < 2000; ++i)
+      r.push_back(rand() % 500);
+    mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>, 2> q2(r.begin(), r.end());
+    mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>, 3> q3;
+    mystl::priority_queue<int> q4;
+    mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>, 8> q8;
+    for (auto x : r)
+      q3.push(x);
+    q4.push_range(r.begin(), r.begin() + 1500);
+    q4.push_range(r.begin() + 1500, r.end());
+    q8.push_range(r.begin(), r.end());
+    FUN_VALUE(pops_in_order(q2));
+    FUN_VALUE(pops_in_order(q3));
+    FUN_VALUE(pops_in_order(q4));
+    FUN_VALUE(pops_in_order(q8));
+    mystl::dary_make_heap<4>(r.begin(), r.end());
+    FUN_VALUE((mystl::dary_is_heap<4>(r.begin(), r.end())));
+    mystl::dary_sort_heap<4>(r.begin(), r.end());
+    FUN_VALUE((mystl::is_sorted(r.begin(), r.end())));
+    // 四种队列求出的最短距离相同
+    const graph g = make_graph(2000, 4);
+    std_dijkstra_queue s;
+    mystl_dijkstra_queue<2> d2;
+    mystl_dijkstra_queue<4> d4;
+    mystl_dijkstra_queue<8> d8;
+    const uint64_t expect = dijkstra(g, s);
+    FUN_VALUE((dijkstra(g, d2) == expect));
+    FUN_VALUE((dijkstra(g, d4) == expect));
+    FUN_VALUE((dijkstra(g, d8) == expect));
+  }
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        push         |";
+#if LARGER_TEST_DATA_ON
+  CON_TEST_P1(priority_queue<int>, push, rand(), SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
+#else
+  CON_TEST_P1(priority_queue<int>, push, rand(), SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   dijkstra nodes    |";
+  TEST_LEN(LEN1 / 10, LEN2 / 10, LEN3 / 10, WIDE);
+  {
+    const graph g1 = make_graph(LEN1 / 10, 8);
+    const graph g2 = make_graph(LEN2 / 10, 8);
+    const graph g3 = make_graph(LEN3 / 10, 8);
+    char buf[10];
+    std::cout << "|     std binary      |";
+    DIJKSTRA_TEST(std_dijkstra_queue, g1);
+    DIJKSTRA_TEST(std_dijkstra_queue, g2);
+    DIJKSTRA_TEST(std_dijkstra_queue, g3);
+    std::cout << std::endl << "|    mystl 2-ary      |";
+    DIJKSTRA_TEST(mystl_dijkstra_queue<2>, g1);
+    DIJKSTRA_TEST(mystl_dijkstra_queue<2>, g2);
+    DIJKSTRA_TEST(mystl_dijkstra_queue<2>, g3);
+    std::cout << std::endl << "|    mystl 4-ary      |";
+    DIJKSTRA_TEST(mystl_dijkstra_queue<4>, g1);
+    DIJKSTRA_TEST(mystl_dijkstra_queue<4>, g2);
+    DIJKSTRA_TEST(mystl_dijkstra_queue<4>, g3);
+    std::cout << std::endl << "|    mystl 8-ary      |";
+    DIJKSTRA_TEST(mystl_dijkstra_queue<8>, g1);
+    DIJKSTRA_TEST(mystl_dijkstra_queue<8>, g2);
+    DIJKSTRA_TEST(mystl_dijkstra_queue<8>, g3);
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------- End container test : priority_queue -------------]" << std::endl;
+}
+
+} // namespace queue_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_QUEUE_TEST_H_
+
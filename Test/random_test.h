@@ -0,0 +1,204 @@
+﻿#ifndef MYTINYSTL_RANDOM_TEST_H_
+#define MYTINYSTL_RANDOM_TEST_H_
+
+// random test : 测试随机数引擎的输出与参考实现是否一致，以及引擎、有界随机整数与 shuffle 的性能
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "../MyTinySTL/algo.h"
+#include "../MyTinySTL/random.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace random_test
+{
+
+// 每秒生成的随机数个数（百万）
+template <class Function>
+void random_rate(size_t count, Function f)
+{
+  uint64_t sum = 0;
+  clock_t start = clock();
+  for (size_t i = 0; i < count; ++i)
+    sum += f();
+  clock_t end = clock();
+  perf_sink = sum;
+  const double sec = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+  char buf[20];
+  std::snprintf(buf, sizeof(buf), "%.0fM/s  |", sec > 0 ? count / sec / 1e6 : 0.0);
+  std::cout << std::setw(WIDE) << buf;
+}
+
+#define SHUFFLE_TEST(shuffle, engine, len) do {           \
+    mystl::vector<int> v(len);                             \
+    for (size_t i = 0; i < len; ++i)                       \
+      v[i] = static_cast<int>(i);                          \
+    engine g(1);                                           \
+    clock_t start = clock();                               \
+    shuffle(v.begin(), v.end(), g);                        \
+    clock_t end = clock();                                 \
+    int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                            \
+    std::snprintf(buf, sizeof(buf), "%d", n);              \
+    std::string t = buf;                                   \
+    t += "ms   |";                                         \
+    std::cout << std::setw(WIDE) << t;                     \
+} while(0)
+
+// 每个线程用 thread_engine() 生成 count / threads 个数，返回耗时（毫秒）
+int thread_streams_time(size_t threads, size_t count)
+{
+  std::vector<std::thread> workers;
+  mystl::vector<uint64_t> sums(threads * 8);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < threads; ++t)
+  {
+    workers.push_back(std::thread([&sums, t, threads, count]()
+    {
+      auto& g = mystl::thread_engine();
+      uint64_t sum = 0;
+      for (size_t i = 0; i < count / threads; ++i)
+        sum += mystl::uniform_int(g, 1000);
+      sums[t * 8] = sum;  // 每个线程的结果相隔一个缓存行
+    }));
+  }
+  for (auto& w : workers)
+    w.join();
+  perf_sink = sums[0];
+  return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start).count());
+}
+
+void random_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------------ Run container test : random ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::splitmix64 s1(0);
+  mystl::xoshiro256ss x1(42);
+  mystl::xoshiro256ss x2(42);
+  mystl::pcg32 p1(42, 54);
+  mystl::pcg32 p2(42, 54);
+  std::cout << std::hex;
+  FUN_VALUE(s1());
+  FUN_VALUE(x1());
+  FUN_VALUE(p1());
+  FUN_VALUE(p1());
+  std::cout << std::dec << std::boolalpha;
+  // 与参考实现的输出比较
+  FUN_VALUE((mystl::splitmix64(0)() == 0xe220a8397b1dcdafull));
+  FUN_VALUE((mystl::xoshiro256ss(42)() == 0x15780b2e0c2ec716ull));
+  FUN_VALUE((mystl::pcg32(42, 54)() == 0xa15c02b7u));
+  x1();
+  x1();
+  x1.jump();
+  FUN_VALUE((x1() == 0x03a5c66424702131ull));
+  FUN_VALUE((x1 != x2));
+  FUN_VALUE((mystl::xoshiro256ss(7) == mystl::xoshiro256ss(7)));
+  for (int i = 0; i < 1000; ++i)
+    p1();
+  p2.discard(1002);
+  FUN_VALUE((p1 == p2));
+  FUN_VALUE((mystl::make_stream(1, 0)() != mystl::make_stream(1, 1)()));
+  FUN_VALUE((&mystl::thread_engine() == &mystl::thread_engine()));
+  FUN_VALUE((mystl::uniform_int(x2, 1) == 0));
+  FUN_VALUE((mystl::uniform_int(p2, 3ull << 62) < (3ull << 62)));
+  std::mt19937 mt(1);
+  FUN_VALUE((mystl::uniform_int(mt, 10) < 10));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  const size_t count = LEN3 * 5;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       engine        |   raw bits  |  [0, 1000)  | [0, 2^31+1) |" << std::endl;
+  {
+    std::mt19937 g(1);
+    std::uniform_int_distribution<uint32_t> d1(0, 999), d2(0, 1u << 31);
+    std::cout << "|     std mt19937     |";
+    random_rate(count, [&]() { return static_cast<uint64_t>(g()); });
+    random_rate(count, [&]() { return static_cast<uint64_t>(d1(g)); });
+    random_rate(count, [&]() { return static_cast<uint64_t>(d2(g)); });
+    std::cout << std::endl;
+  }
+  {
+    std::mt19937_64 g(1);
+    std::uniform_int_distribution<uint64_t> d1(0, 999), d2(0, 1u << 31);
+    std::cout << "|   std mt19937_64    |";
+    random_rate(count, [&]() { return static_cast<uint64_t>(g()); });
+    random_rate(count, [&]() { return d1(g); });
+    random_rate(count, [&]() { return d2(g); });
+    std::cout << std::endl;
+  }
+  {
+    mystl::splitmix64 g(1);
+    std::cout << "|     splitmix64      |";
+    random_rate(count, [&]() { return g(); });
+    random_rate(count, [&]() { return mystl::uniform_int(g, 1000); });
+    random_rate(count, [&]() { return mystl::uniform_int(g, (1ull << 31) + 1); });
+    std::cout << std::endl;
+  }
+  {
+    mystl::xoshiro256ss g(1);
+    std::cout << "|    xoshiro256**     |";
+    random_rate(count, [&]() { return g(); });
+    random_rate(count, [&]() { return mystl::uniform_int(g, 1000); });
+    random_rate(count, [&]() { return mystl::uniform_int(g, (1ull << 31) + 1); });
+    std::cout << std::endl;
+  }
+  {
+    mystl::pcg32 g(1);
+    std::cout << "|        pcg32        |";
+    random_rate(count, [&]() { return static_cast<uint64_t>(g()); });
+    random_rate(count, [&]() { return mystl::uniform_int(g, 1000); });
+    random_rate(count, [&]() { return mystl::uniform_int(g, (1ull << 31) + 1); });
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       shuffle       |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  char buf[10];
+  std::cout << "|  std / mt19937_64   |";
+  SHUFFLE_TEST(std::shuffle, std::mt19937_64, LEN1);
+  SHUFFLE_TEST(std::shuffle, std::mt19937_64, LEN2);
+  SHUFFLE_TEST(std::shuffle, std::mt19937_64, LEN3);
+  std::cout << std::endl << "| mystl / xoshiro256**|";
+  SHUFFLE_TEST(mystl::shuffle, mystl::xoshiro256ss, LEN1);
+  SHUFFLE_TEST(mystl::shuffle, mystl::xoshiro256ss, LEN2);
+  SHUFFLE_TEST(mystl::shuffle, mystl::xoshiro256ss, LEN3);
+  std::cout << std::endl << "|    mystl / pcg32    |";
+  SHUFFLE_TEST(mystl::shuffle, mystl::pcg32, LEN1);
+  SHUFFLE_TEST(mystl::shuffle, mystl::pcg32, LEN2);
+  SHUFFLE_TEST(mystl::shuffle, mystl::pcg32, LEN3);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   thread streams    |";
+  size_t max_threads = std::thread::hardware_concurrency();
+  if (max_threads == 0)
+    max_threads = 1;
+  const size_t thread_counts[3] = { 1, max_threads < 2 ? max_threads : 2, max_threads };
+  for (auto t : thread_counts)
+  {
+    std::snprintf(buf, sizeof(buf), "%d", thread_streams_time(t, count));
+    std::string s = std::to_string(t) + "t: " + buf + "ms |";
+    std::cout << std::setw(WIDE) << s;
+  }
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------------ End container test : random ----------------]" << std::endl;
+}
+
+} // namespace random_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_RANDOM_TEST_H_
+
@@ -0,0 +1,89 @@
+﻿#ifndef MYTINYSTL_STATIC_SEARCH_INDEX_TEST_H_
+#define MYTINYSTL_STATIC_SEARCH_INDEX_TEST_H_
+
+// static_search_index test : 测试 static_search_index 的接口，并与 lower_bound, upper_bound 的结果比较
+
+#include "../MyTinySTL/algo.h"
+#include "../MyTinySTL/static_search_index.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace static_search_index_test
+{
+
+// 对含有重复元素的有序序列建立索引，查询 [-1, 2 * n + 1] 中的每个值，结果与二分查找比较
+template <class T, class Compare>
+bool check_layout(size_t n, mystl::search_layout layout, Compare comp)
+{
+  mystl::vector<T> v;
+  for (size_t i = 0; i < n; ++i)
+    v.push_back(static_cast<T>(i - i % 3));
+  mystl::sort(v.begin(), v.end(), comp);
+  mystl::static_search_index<T, Compare> index(v.begin(), v.end(), layout, comp);
+  for (long long x = -1; x <= static_cast<long long>(2 * n + 1); ++x)
+  {
+    const T value = static_cast<T>(x);
+    const size_t lb = static_cast<size_t>(mystl::lower_bound(v.begin(), v.end(), value, comp) - v.begin());
+    const size_t ub = static_cast<size_t>(mystl::upper_bound(v.begin(), v.end(), value, comp) - v.begin());
+    if (index.lower_bound(value) != lb || index.upper_bound(value) != ub)
+      return false;
+  }
+  return true;
+}
+
+template <class T, class Compare>
+bool check_all(Compare comp)
+{
+  const size_t lens[] = { 0, 1, 2, 3, 15, 16, 17, 100, 1000, 4097 };
+  for (auto n : lens)
+  {
+    if (!check_layout<T>(n, mystl::search_layout::eytzinger, comp) ||
+        !check_layout<T>(n, mystl::search_layout::btree, comp))
+      return false;
+  }
+  return true;
+}
+
+void static_search_index_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[----------- Run container test : static_search_index ----------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,2,3,5,8,8,8,13,21 };
+  mystl::static_search_index<int> s1;
+  mystl::static_search_index<int> s2(a, a + 10);
+  mystl::static_search_index<int> s3(a, a + 10, mystl::search_layout::btree);
+  mystl::static_search_index<int, mystl::greater<int>> s4(a, a, mystl::search_layout::eytzinger,
+                                                          mystl::greater<int>());
+  FUN_VALUE(s1.size());
+  FUN_VALUE(s1.empty());
+  FUN_VALUE(s2.size());
+  FUN_VALUE((s3.layout() == mystl::search_layout::btree));
+  FUN_VALUE(s2.lower_bound(8));
+  FUN_VALUE(s2.upper_bound(8));
+  FUN_VALUE(s3.lower_bound(8));
+  FUN_VALUE(s3.upper_bound(8));
+  FUN_VALUE(s2.lower_bound(22));
+  FUN_VALUE(s3.equal_range(2).first);
+  FUN_VALUE(s3.equal_range(2).second);
+  FUN_VALUE(s2.contains(4));
+  FUN_VALUE(s3.contains(13));
+  FUN_VALUE(s4.empty());
+  FUN_VALUE((check_all<int>(mystl::less<int>())));
+  FUN_VALUE((check_all<int>(mystl::greater<int>())));
+  FUN_VALUE((check_all<long long>(mystl::less<long long>())));
+  FUN_VALUE((check_all<double>(mystl::less<double>())));
+  FUN_VALUE((check_all<char>(mystl::less<char>())));
+  PASSED;
+  std::cout << "[----------- End container test : static_search_index ----------]" << std::endl;
+}
+
+} // namespace static_search_index_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_STATIC_SEARCH_INDEX_TEST_H_
+
@@ -0,0 +1,217 @@
+﻿#ifndef MYTINYSTL_STRING_TEST_H_
+#define MYTINYSTL_STRING_TEST_H_
+
+// string test : 测试 string, string_view 的接口，以及以短字符串为键值的哈希表相对于 std::string 的性能
+
+#include <string>
+#include <functional>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/string_view.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace string_test
+{
+
+// 生成 len 个形如 "user:123456" 的短键值，构造并复制到 vector 中，再插入哈希表并逐个查找
+// 构造键值与哈希表插入、查找的耗时（毫秒）分别写入 ms[0] 与 ms[1]
+template <class Str, class Hash>
+void short_key_time(size_t len, int* ms)
+{
+  char buf[32];
+  size_t sum = 0;
+  clock_t t0 = clock();
+  mystl::vector<Str> keys;
+  keys.reserve(len);
+  for (size_t i = 0; i < len; ++i)
+  {
+    const int n = std::snprintf(buf, sizeof(buf), "user:%d", static_cast<int>(i * 7919 % len));
+    Str key(buf, static_cast<size_t>(n));
+    keys.push_back(key);
+  }
+  clock_t t1 = clock();
+  mystl::unordered_map<Str, size_t, Hash> m(len);
+  for (size_t i = 0; i < len; ++i)
+    m.emplace(keys[i], i);
+  for (size_t i = 0; i < len; ++i)
+    sum += m.find(keys[i])->second;
+  clock_t t2 = clock();
+  perf_sink = sum;
+  ms[0] = static_cast<int>(static_cast<double>(t1 - t0) / CLOCKS_PER_SEC * 1000);
+  ms[1] = static_cast<int>(static_cast<double>(t2 - t1) / CLOCKS_PER_SEC * 1000);
+}
+
+// 比较 std::string 与 mystl::string 作为 mystl::unordered_map 的键值时的性能
+void short_key_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  int ms[2][3][2];
+  for (int i = 0; i < 3; ++i)
+  {
+    short_key_time<std::string, std::hash<std::string>>(lens[i], ms[0][i]);
+    short_key_time<mystl::string, mystl::hash<mystl::string>>(lens[i], ms[1][i]);
+  }
+  const char* names[2] = { "   make short keys   ", "  map insert + find  " };
+  const char* libs[2] = { "     std::string     ", "    mystl::string    " };
+  for (int op = 0; op < 2; ++op)
+  {
+    std::cout << "|" << names[op] << "|";
+    TEST_LEN(len1, len2, len3, WIDE);
+    for (int lib = 0; lib < 2; ++lib)
+      test_row(libs[lib], ms[lib][0][op], ms[lib][1][op], ms[lib][2][op]);
+    std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  }
+}
+
+void string_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------------ Run container test : string ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  const char* s = "abcdefg";
+  mystl::string str;
+  mystl::string str1(5, 'a');
+  mystl::string str2(str1, 3);
+  mystl::string str3(str1, 0, 3);
+  mystl::string str4("abc");
+  mystl::string str5("abcde", 3);
+  mystl::string str6(s, s + 5);
+  mystl::string str7(str1);
+  mystl::string str8(std::move(str1));
+  mystl::string str9;
+  str9 = str2;
+  mystl::string str10;
+  str10 = std::move(str2);
+  mystl::string str11;
+  str11 = "123";
+  mystl::string str12;
+  str12 = 'A';
+  mystl::string str13{ 'x','y','z' };
+  mystl::string str14(mystl::string_view("a long string that does not fit in the small buffer"));
+
+  STR_FUN_AFTER(str, str = 'a');
+  STR_FUN_AFTER(str, str = "string");
+  FUN_VALUE(*str.begin());
+  FUN_VALUE(*str.rbegin());
+  FUN_VALUE(*(str.end() - 1));
+  FUN_VALUE(*(str.rend() - 1));
+  FUN_VALUE(str.front());
+  FUN_VALUE(str.back());
+  FUN_VALUE(str[1]);
+  FUN_VALUE(str.at(2));
+  STR_COUT(str.data());
+  STR_COUT(str.c_str());
+  std::cout << std::boolalpha;
+  FUN_VALUE(str.empty());
+  std::cout << std::noboolalpha;
+  FUN_VALUE(str.size());
+  FUN_VALUE(str.length());
+  FUN_VALUE(str.capacity());
+  FUN_VALUE(str14.size());
+  FUN_VALUE((str14.capacity() >= str14.size()));
+  STR_FUN_AFTER(str, str.reserve(50));
+  FUN_VALUE(str.capacity());
+  STR_FUN_AFTER(str, str.shrink_to_fit());
+  FUN_VALUE(str.capacity());
+  STR_FUN_AFTER(str, str.insert(str.begin(), 'a'));
+  STR_FUN_AFTER(str, str.insert(str.end(), 3, 'x'));
+  STR_FUN_AFTER(str, str.insert(str.end(), s, s + 3));
+  STR_FUN_AFTER(str, str.insert(0, "<<"));
+  STR_FUN_AFTER(str, str.erase(str.begin()));
+  STR_FUN_AFTER(str, str.erase(str.begin(), str.begin() + 1));
+  STR_FUN_AFTER(str, str.erase(0, 2));
+  STR_FUN_AFTER(str, str.clear());
+  STR_FUN_AFTER(str, str.push_back('s'));
+  STR_FUN_AFTER(str, str.push_back('t'));
+  STR_FUN_AFTER(str, str.pop_back());
+  STR_FUN_AFTER(str, str.append(1, 't'));
+  STR_FUN_AFTER(str, str.append(str4));
+  STR_FUN_AFTER(str, str.append(str4, 1));
+  STR_FUN_AFTER(str, str.append(str4, 2, 1));
+  STR_FUN_AFTER(str, str.append("str"));
+  STR_FUN_AFTER(str, str.append("inging", 3));
+  STR_FUN_AFTER(str, str.append(s, s + 3));
+  STR_FUN_AFTER(str, str.append(str.data(), 4));
+  STR_FUN_AFTER(str, str.resize(10));
+  FUN_VALUE(str.size());
+  STR_FUN_AFTER(str, str.resize(20, 'x'));
+  FUN_VALUE(str.size());
+  STR_FUN_AFTER(str, str.clear());
+  STR_FUN_AFTER(str, str = "string");
+  STR_FUN_AFTER(str3, str3 = "astrings");
+  FUN_VALUE(str.compare(str3));
+  FUN_VALUE(str.compare(0, 6, str3));
+  FUN_VALUE(str.compare("atringgg"));
+  FUN_VALUE(str.compare(0, 6, "ztrings"));
+  STR_COUT(str.substr(0));
+  STR_COUT(str.substr(3));
+  STR_COUT(str.substr(0, 3));
+  STR_FUN_AFTER(str, str.replace(0, 6, str3));
+  STR_FUN_AFTER(str, str.replace(str.end() - 1, str.end(), " "));
+  STR_FUN_AFTER(str, str.replace(0, 1, "'s "));
+  STR_FUN_AFTER(str, str.replace(0, 2, 3, 'x'));
+  STR_FUN_AFTER(str, str.replace(0, 3, str.data() + 3, 4));
+  STR_FUN_AFTER(str, str.swap(str3));
+  FUN_VALUE(str.find('s'));
+  FUN_VALUE(str.find("str"));
+  FUN_VALUE(str.find(str4));
+  FUN_VALUE(str.find('s', 2));
+  FUN_VALUE(str.rfind('s'));
+  FUN_VALUE(str.rfind("ing"));
+  FUN_VALUE(str.find_first_of("ring"));
+  FUN_VALUE(str.find_first_of('s'));
+  FUN_VALUE(str.find_first_not_of("ast"));
+  FUN_VALUE(str.find_last_of("ast"));
+  FUN_VALUE(str.find_last_not_of("gns"));
+  FUN_VALUE(str.count('s'));
+  std::cout << std::boolalpha;
+  FUN_VALUE(str.starts_with("astr"));
+  FUN_VALUE(str.ends_with('s'));
+  FUN_VALUE((str == "astrings"));
+  FUN_VALUE((str4 < str));
+  FUN_VALUE((str13 != str4));
+  std::cout << std::noboolalpha;
+  STR_COUT((str4 + "def" + 'g' + str5));
+  STR_COUT(("<" + str5 + ">"));
+  STR_COUT(str14);
+  PASSED;
+
+  std::cout << "[-------------------------- string_view -------------------------]" << std::endl;
+  mystl::string_view sv(str);
+  mystl::string_view sv1("hello, world");
+  mystl::string_view sv2(s, 3);
+  STR_COUT(sv);
+  STR_COUT(sv1.substr(7));
+  STR_COUT(sv2);
+  FUN_VALUE(sv1.size());
+  FUN_VALUE(sv1.find("world"));
+  FUN_VALUE(sv1.find(','));
+  FUN_VALUE(sv1.rfind('o'));
+  STR_FUN_AFTER(sv1, sv1.remove_prefix(7));
+  STR_FUN_AFTER(sv1, sv1.remove_suffix(1));
+  std::cout << std::boolalpha;
+  FUN_VALUE((sv1 == "worl"));
+  FUN_VALUE((sv2 < sv1));
+  FUN_VALUE((mystl::hash<mystl::string>()(str) == mystl::hash<mystl::string_view>()(sv)));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  short_key_test(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+  PASSED;
+#endif
+  std::cout << "[------------------ End container test : string ----------------]" << std::endl;
+}
+
+} // namespace string_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_STRING_TEST_H_
+
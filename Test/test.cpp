@@ -13,7 +13,20 @@
 #include "vector_test.h"
 #include "list_test.h"
 #include "deque_test.h"
+#include "queue_test.h"
+#include "map_test.h"
+#include "set_test.h"
+#include "flat_map_test.h"
+#include "order_statistic_tree_test.h"
+#include "string_test.h"
 #include "unordered_map_test.h"
+#include "cuckoo_map_test.h"
+#include "concurrent_unordered_map_test.h"
+#include "ebr_test.h"
+#include "lockfree_unordered_map_test.h"
+#include "static_search_index_test.h"
+#include "random_test.h"
+#include "thread_pool_test.h"
 
 int main()
 {
@@ -27,7 +40,23 @@ int main()
   vector_test::vector_test();
   list_test::list_test();
   deque_test::deque_test();
+  queue_test::priority_queue_test();
+  map_test::map_test();
+  map_test::multimap_test();
+  set_test::set_test();
+  set_test::multiset_test();
+  flat_map_test::flat_map_test();
+  flat_map_test::flat_set_test();
+  order_statistic_tree_test::order_statistic_tree_test();
+  string_test::string_test();
   unordered_map_test::unordered_map_test();
+  cuckoo_map_test::cuckoo_map_test();
+  concurrent_unordered_map_test::concurrent_unordered_map_test();
+  ebr_test::ebr_test();
+  lockfree_unordered_map_test::lockfree_unordered_map_test();
+  static_search_index_test::static_search_index_test();
+  random_test::random_test();
+  thread_pool_test::thread_pool_test();
 
 #if defined(_MSC_VER) && defined(_DEBUG)
   _CrtDumpMemoryLeaks();
@@ -573,6 +573,25 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
 #define TEST_LEN(len1, len2, len3, wide) \
   test_len(len1, len2, len3, wide)
 
+// 性能测试把计算结果写入 perf_sink，浮点数结果写入 perf_fsink，避免被测的计算被编译器优化掉
+volatile size_t perf_sink;
+volatile double perf_fsink;
+
+// 输出性能测试表格中的一行：name 为行名（不含两侧的 |），之后依次为三个数据量下的结果，
+// unit 为结果的单位，如 "ms"、"ns"，为空字符串时只输出数值
+void test_row(const char* name, int v1, int v2, int v3, const char* unit = "ms")
+{
+  const int values[3] = { v1, v2, v3 };
+  char buf[20];
+  std::cout << "|" << name << "|";
+  for (int i = 0; i < 3; ++i)
+  {
+    std::snprintf(buf, sizeof(buf), "%d%s    |", values[i], unit);
+    std::cout << std::setw(WIDE) << buf;
+  }
+  std::cout << std::endl;
+}
+
 // 常用测试性能的宏
 #define FUN_TEST_FORMAT1(mode, fun, arg, count) do {         \
   srand((int)time(0));                                       \
@@ -0,0 +1,194 @@
+﻿#ifndef MYTINYSTL_THREAD_POOL_TEST_H_
+#define MYTINYSTL_THREAD_POOL_TEST_H_
+
+// thread_pool test : 测试 thread_pool, task_group 的接口，以及任务派生的开销与递归并行的性能
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+#include "../MyTinySTL/thread_pool.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace thread_pool_test
+{
+
+// 多线程下 clock() 统计的是所有线程的 CPU 时间，因此使用挂钟时间
+#define POOL_TIME_TEST(stmt) do {                            \
+  char buf[10];                                              \
+  auto start = std::chrono::steady_clock::now();             \
+  stmt;                                                      \
+  auto end = std::chrono::steady_clock::now();               \
+  int n = static_cast<int>(std::chrono::duration_cast<       \
+      std::chrono::milliseconds>(end - start).count());      \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+long long fib(int n)
+{
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+// fork/join 方式递归计算斐波那契数，n 不超过 cutoff 时顺序计算
+long long parallel_fib(int n, int cutoff)
+{
+  if (n <= cutoff)
+    return fib(n);
+  long long x = 0;
+  mystl::task_group group;
+  group.spawn([&x, n, cutoff]() { x = parallel_fib(n - 1, cutoff); });
+  long long y = parallel_fib(n - 2, cutoff);
+  group.sync();
+  return x + y;
+}
+
+// 派生 count 个空任务并等待它们完成
+void spawn_empty(size_t count)
+{
+  mystl::task_group group;
+  for (size_t i = 0; i < count; ++i)
+    group.spawn([]() {});
+  group.sync();
+}
+
+// 提交 count 个空任务并等待它们的 future
+void submit_empty(size_t count)
+{
+  auto& pool = mystl::thread_pool::default_pool();
+  mystl::vector<std::future<void>> futures;
+  futures.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    futures.push_back(pool.submit([]() {}));
+  for (auto& f : futures)
+    pool.wait(f);
+}
+
+// 以粒度 1 对 [0, count) 执行 parallel_for
+void parallel_for_empty(size_t count)
+{
+  mystl::thread_pool::default_pool().parallel_for(static_cast<size_t>(0), count,
+                                                  [](size_t, size_t) {},
+                                                  static_cast<size_t>(1));
+}
+
+long long parallel_for_sum(mystl::thread_pool& pool, long long n)
+{
+  std::atomic<long long> sum(0);
+  pool.parallel_for(0LL, n, [&sum](long long b, long long e)
+  {
+    long long s = 0;
+    for (long long i = b; i < e; ++i)
+      s += i;
+    sum += s;
+  }, 1000LL);
+  return sum.load();
+}
+
+int submit_answer(mystl::thread_pool& pool)
+{
+  return pool.submit([]() { return 42; }).get();
+}
+
+std::string sync_exception()
+{
+  mystl::task_group group;
+  group.spawn([]() { throw std::runtime_error("task failed"); });
+  try
+  {
+    group.sync();
+  }
+  catch (const std::runtime_error& e)
+  {
+    return e.what();
+  }
+  return "no exception";
+}
+
+// 复制时抛出异常的函数对象
+struct throwing_copy
+{
+  throwing_copy() {}
+  throwing_copy(const throwing_copy&) { throw std::runtime_error("copy failed"); }
+  void operator()() const {}
+};
+
+// spawn 复制函数对象时抛出异常，之后 sync 仍然可以返回
+std::string spawn_copy_exception()
+{
+  mystl::task_group group;
+  throwing_copy f;
+  std::string result = "no exception";
+  try
+  {
+    group.spawn(f);
+  }
+  catch (const std::runtime_error& e)
+  {
+    result = e.what();
+  }
+  group.sync();
+  return result + ", synced";
+}
+
+void thread_pool_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : thread_pool ---------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::thread_pool pool(4);
+  FUN_VALUE(pool.size());
+  FUN_VALUE(submit_answer(pool));
+  FUN_VALUE(parallel_for_sum(pool, 1000000LL));
+  FUN_VALUE(parallel_fib(20, 10));
+  FUN_VALUE(sync_exception());
+  FUN_VALUE(spawn_copy_exception());
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     spawn + sync    |";
+  TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+  std::cout << "|     task_group      |";
+  POOL_TIME_TEST(spawn_empty(SCALE_S(LEN1)));
+  POOL_TIME_TEST(spawn_empty(SCALE_S(LEN2)));
+  POOL_TIME_TEST(spawn_empty(SCALE_S(LEN3)));
+  std::cout << "\n|   submit + future   |";
+  POOL_TIME_TEST(submit_empty(SCALE_S(LEN1)));
+  POOL_TIME_TEST(submit_empty(SCALE_S(LEN2)));
+  POOL_TIME_TEST(submit_empty(SCALE_S(LEN3)));
+  std::cout << "\n|    parallel_for     |";
+  POOL_TIME_TEST(parallel_for_empty(SCALE_S(LEN1)));
+  POOL_TIME_TEST(parallel_for_empty(SCALE_S(LEN2)));
+  POOL_TIME_TEST(parallel_for_empty(SCALE_S(LEN3)));
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       fib(n)        |";
+  TEST_LEN(30, 33, 36, WIDE);
+  std::cout << "|     sequential      |";
+  POOL_TIME_TEST(perf_sink = fib(30));
+  POOL_TIME_TEST(perf_sink = fib(33));
+  POOL_TIME_TEST(perf_sink = fib(36));
+  std::cout << "\n|     task_group      |";
+  POOL_TIME_TEST(perf_sink = parallel_fib(30, 15));
+  POOL_TIME_TEST(perf_sink = parallel_fib(33, 15));
+  POOL_TIME_TEST(perf_sink = parallel_fib(36, 15));
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------------- End container test : thread_pool ---------------]" << std::endl;
+}
+
+} // namespace thread_pool_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_THREAD_POOL_TEST_H_
+
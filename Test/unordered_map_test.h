@@ -1,11 +1,15 @@
 ﻿#ifndef MYTINYSTL_UNORDERED_MAP_TEST_H_
 #define MYTINYSTL_UNORDERED_MAP_TEST_H_
 
-// unordered_map test : 测试 unordered_map, unordered_multimap 的接口与它们 insert 的性能
+// unordered_map test : 测试 unordered_map, unordered_multimap 的接口与它们 insert 的性能，
+// 以 string 为键值时异构查找相对于构造临时键值的性能，以及渐进式重建对插入尾延迟的影响
 
+#include <chrono>
 #include <unordered_map>
 
+#include "../MyTinySTL/astring.h"
 #include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
 #include "test.h"
 
 namespace mystl
@@ -40,6 +44,98 @@ namespace unordered_map_test
     std::cout << " " << str << " : <" << it.first << "," << it.second << ">\n"; \
 } while(0)
 
+// 以 len 个超过 string 短字符串缓冲区长度的键值建立哈希表，再用 C 风格字符串逐个查找
+// 分别先构造临时的 string、转换为 string_view、直接传入 const char* 来查找，耗时（毫秒）写入 ms[0..2]
+// 后两种做法走异构查找，不分配内存
+void transparent_lookup_time(size_t len, int* ms)
+{
+  const size_t stride = 64;  // 能容纳 size_t 取最大值时的键值
+  mystl::vector<char> text(len * stride);
+  mystl::unordered_map<mystl::string, size_t, mystl::string_hash, mystl::string_equal> m(len);
+  for (size_t i = 0; i < len; ++i)
+  {
+    char* p = &text[i * stride];
+    std::snprintf(p, stride, "session:%016zu:user:%08zu", i * 2654435761u % len, i);
+    m.emplace(mystl::string(p), i);
+  }
+  size_t sum = 0;
+  clock_t t0 = clock();
+  for (size_t i = 0; i < len; ++i)
+    sum += m.find(mystl::string(&text[i * stride]))->second;
+  clock_t t1 = clock();
+  for (size_t i = 0; i < len; ++i)
+    sum += m.find(mystl::string_view(&text[i * stride]))->second;
+  clock_t t2 = clock();
+  for (size_t i = 0; i < len; ++i)
+    sum += m.find(static_cast<const char*>(&text[i * stride]))->second;
+  clock_t t3 = clock();
+  perf_sink = sum;
+  ms[0] = static_cast<int>(static_cast<double>(t1 - t0) / CLOCKS_PER_SEC * 1000);
+  ms[1] = static_cast<int>(static_cast<double>(t2 - t1) / CLOCKS_PER_SEC * 1000);
+  ms[2] = static_cast<int>(static_cast<double>(t3 - t2) / CLOCKS_PER_SEC * 1000);
+}
+
+// 比较构造临时键值与异构查找的性能
+void transparent_lookup_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  int ms[3][3];
+  for (int i = 0; i < 3; ++i)
+    transparent_lookup_time(lens[i], ms[i]);
+  const char* libs[3] = { "  find(string(key))  ", "  find(string_view)  ", "  find(const char*)  " };
+  std::cout << "|  find by long key   |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  for (int lib = 0; lib < 3; ++lib)
+    test_row(libs[lib], ms[0][lib], ms[1][lib], ms[2][lib]);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+// 从空表开始逐个插入 len 个元素并记录每次插入的耗时
+// p99、p999（纳秒）与最大耗时（微秒）分别写入 result[0..2]
+void insert_latency_time(size_t len, bool incremental, int* result)
+{
+  mystl::unordered_map<size_t, size_t> m;
+  m.incremental_rehash(incremental);
+  mystl::vector<int> ns(len);
+  for (size_t i = 0; i < len; ++i)
+  {
+    const size_t key = i * 2654435761u;
+    auto start = std::chrono::steady_clock::now();
+    m.emplace(key, i);
+    auto end = std::chrono::steady_clock::now();
+    ns[i] = static_cast<int>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  }
+  perf_sink = m.size();
+  mystl::sort(ns.begin(), ns.end());
+  result[0] = ns[len * 99 / 100];
+  result[1] = ns[len * 999 / 1000];
+  result[2] = ns[len - 1] / 1000;
+}
+
+// 比较一次完成重建与渐进式重建时插入的尾延迟
+void insert_latency_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  int result[2][3][3];
+  for (int i = 0; i < 3; ++i)
+  {
+    insert_latency_time(lens[i], false, result[0][i]);
+    insert_latency_time(lens[i], true, result[1][i]);
+  }
+  const char* names[2][3] = {
+    { " full rehash p99(ns) ", " full rehash p999(ns)", " full rehash max(us) " },
+    { " incremental p99(ns) ", " incremental p999(ns)", " incremental max(us) " }
+  };
+  const char* units[3] = { "ns", "ns", "us" };
+  std::cout << "|   insert latency    |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  for (int lib = 0; lib < 2; ++lib)
+  {
+    for (int row = 0; row < 3; ++row)
+      test_row(names[lib][row], result[lib][0][row], result[lib][1][row], result[lib][2][row], units[row]);
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
 
 void unordered_map_test()
 {
@@ -115,6 +211,49 @@ void unordered_map_test()
   FUN_VALUE(um1.max_load_factor());
   MAP_FUN_AFTER(um1, um1.max_load_factor(1.5f));
   FUN_VALUE(um1.max_load_factor());
+  std::cout << std::boolalpha;
+  FUN_VALUE((um9 == um11));
+  FUN_VALUE((um13 == um14));
+  FUN_VALUE((um9 != um13));
+  FUN_VALUE(um1.contains(3));
+  FUN_VALUE(um1.contains(100));
+  std::cout << std::noboolalpha;
+
+  mystl::unordered_map<int, int> um15;
+  um15.incremental_rehash(true);
+  for (int i = 0; i < 102; ++i)
+    um15.emplace(i, i);
+  std::cout << std::boolalpha;
+  FUN_VALUE(um15.incremental_rehash());
+  FUN_VALUE(um15.rehashing());
+  std::cout << std::noboolalpha;
+  FUN_VALUE(um15.bucket_count());
+  FUN_VALUE(um15.size());
+  FUN_VALUE(um15.find(50)->second);
+  FUN_VALUE(um15.erase(101));
+  FUN_VALUE(mystl::distance(um15.begin(), um15.end()));
+  um15.incremental_rehash(false);
+  std::cout << std::boolalpha;
+  FUN_VALUE(um15.rehashing());
+  std::cout << std::noboolalpha;
+  FUN_VALUE(um15.bucket_size(um15.bucket(50)));
+
+  mystl::unordered_map<mystl::string, int, mystl::string_hash, mystl::string_equal> sm;
+  sm.emplace("apple", 1);
+  sm.emplace("banana", 2);
+  sm.emplace("a key that is too long for the small string buffer", 3);
+  const char* key = "banana";
+  FUN_VALUE(sm.find(key)->second);
+  FUN_VALUE(sm.find(mystl::string_view("apple"))->second);
+  FUN_VALUE(sm.count("a key that is too long for the small string buffer"));
+  FUN_VALUE(sm.count("cherry"));
+  std::cout << std::boolalpha;
+  FUN_VALUE(sm.contains("apple"));
+  FUN_VALUE((sm.equal_range(mystl::string_view("banana")).first == sm.find(key)));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(sm.erase("apple"));
+  FUN_VALUE(sm.erase(mystl::string_view("cherry")));
+  FUN_VALUE(sm.size());
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -127,6 +266,8 @@ void unordered_map_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  transparent_lookup_test(SCALE_SS(LEN1), SCALE_SS(LEN2), SCALE_SS(LEN3));
+  insert_latency_test(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
   PASSED;
 #endif
   std::cout << "[-------------- End container test : unordered_map -------------]" << std::endl;
@@ -204,6 +345,21 @@ void unordered_multimap_test()
   FUN_VALUE(um1.max_load_factor());
   MAP_FUN_AFTER(um1, um1.max_load_factor(1.5f));
   FUN_VALUE(um1.max_load_factor());
+  std::cout << std::boolalpha;
+  FUN_VALUE((um9 == um11));
+  FUN_VALUE((um13 == um14));
+  FUN_VALUE((um9 != um13));
+  std::cout << std::noboolalpha;
+
+  mystl::unordered_multimap<mystl::string, int, mystl::string_hash, mystl::string_equal> smm;
+  smm.emplace("apple", 1);
+  smm.emplace("apple", 2);
+  smm.emplace("banana", 3);
+  FUN_VALUE(smm.count("apple"));
+  FUN_VALUE(mystl::distance(smm.equal_range(mystl::string_view("apple")).first,
+                            smm.equal_range(mystl::string_view("apple")).second));
+  FUN_VALUE(smm.erase("apple"));
+  FUN_VALUE(smm.size());
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;